@@ -18,11 +18,27 @@
 #include <SPI.h>
 #include <SD.h>
 #include "config.h"
+#include "hal.h"
 #include "display.h"
 #include "menu.h"
 #include "ir_handler.h"
 #include "touch_input.h"
 #include "sd_manager.h"
+#include "device_store.h"
+#include "device_list.h"
+#include "screen_cache.h"
+#include "overlay.h"
+#include "serial_console.h"
+#include "usage_stats.h"
+#include "scheduler.h"
+#include "kv_store.h"
+#include "boot_timeline.h"
+#include "touch_trace.h"
+#include "profiler.h"
+#include "memory_monitor.h"
+#include "event_log.h"
+#include "loop_watchdog.h"
+#include "ring_buffer.h"
 
 // Module instances
 Display display;
@@ -32,11 +48,24 @@ unsigned long lastTouchTime = 0;
 int loadingFrame = 0;
 unsigned long lastLoadingUpdate = 0;
 
+// Touch IR sends not sent yet, in touch order
+struct PendingSend {
+  uint8_t function;
+  uint32_t touchTime;
+};
+RingBuffer<PendingSend, IR_PENDING_SENDS> pendingSends;
+
 void setup() {
+  // Before anything else runs deep on the stack
+  memoryMonitor.begin();
+  
   Serial.begin(115200);
   
   // Wait for serial connection (optional, remove for standalone operation)
-  while (!Serial && millis() < 3000);
+  #if !FAST_BOOT
+    while (!Serial && hal.clock->millis() < 3000);
+  #endif
+  bootTimeline.mark(BOOT_SERIAL);
   
   Serial.println(F("=================================="));
   Serial.println(F("VHC Universal Remote v1.0"));
@@ -45,158 +74,284 @@ void setup() {
   Serial.println(F("=================================="));
   Serial.println(F("Initializing..."));
   
+  #if PROFILER_ENABLED
+    profiler.begin();
+  #endif
+  
+  // Saved settings and state (calibration, backlight, last screen)
+  kvStore.begin();
+  
   // Initialize display first
   Serial.print(F("Display... "));
   display.begin();
+  uint8_t brightness;
+  if (kvStore.get(KV_BACKLIGHT, &brightness, sizeof(brightness))) {
+    display.setBacklight(brightness);
+  }
   display.drawSplashScreen();
+  deviceList.begin();
+  screenCache.begin(display.getShadow());
   Serial.println(F("OK"));
+  bootTimeline.mark(BOOT_DISPLAY);
   
   // Initialize SD card manager
   Serial.print(F("SD Card... "));
-  if (!sdManager.begin()) {
+  if (sdManager.begin()) {
+    Serial.println(F("OK"));
+  } else {
+    // Bundled devices still load; without any the menu shows ERROR_NO_SD
     Serial.println(F("FAILED"));
-    display.drawErrorScreen(ERROR_NO_SD);
-    while (1) {
-      delay(1000);
-    }
   }
-  Serial.println(F("OK"));
+  
+  // Device database in program flash, read at the first device load
+  deviceStore.begin();
+  bootTimeline.mark(BOOT_SD);
+  
+  // Binary event log, drained in the background (can write to SD)
+  eventLog.begin();
   
   // Initialize touch input
   Serial.print(F("Touch... "));
   touchInput.begin();
   Serial.println(F("OK"));
+  bootTimeline.mark(BOOT_TOUCH);
   
   // Initialize IR handler
   Serial.print(F("IR... "));
   irHandler.begin();
   Serial.println(F("OK"));
+  bootTimeline.mark(BOOT_IR);
+  
+  // Device usage ranking (orders the main menu)
+  usageStats.begin();
   
   // Initialize menu system
   Serial.print(F("Menu... "));
   menu.begin();
   Serial.println(F("OK"));
+  bootTimeline.mark(BOOT_INIT);
+  
+  // Stall checks start with the first loop pass
+  loopWatchdog.begin();
   
   Serial.println(F("Setup complete!"));
   Serial.println(F("=================================="));
 }
 
 void loop() {
+  loopWatchdog.kick();
+  
   // Update modules
   touchInput.update();
+  touchTrace.update();
+  overlays.update();
+  usageStats.update();
+  
+  // Debug commands (some draw over the current screen) and host
+  // frames (an uploaded device changes the table)
+  if ((serialConsole.update() || menu.needsRefresh()) && menu.getCurrentScreen() != SCREEN_SPLASH) {
+    requestRedraw(0);
+  }
   
   // Handle splash screen animation
   if (menu.getCurrentScreen() == SCREEN_SPLASH) {
+    // Touches during the splash are not meant for the main menu
+    touchInput.flushEvents();
+    
     // Update loading animation
-    if (millis() - lastLoadingUpdate > 500) {
+    if (hal.clock->millis() - lastLoadingUpdate > 500) {
       display.updateLoadingAnimation(loadingFrame++);
-      lastLoadingUpdate = millis();
+      lastLoadingUpdate = hal.clock->millis();
     }
     
     // Check if time to advance
     if (menu.isTimeToAdvance()) {
+      bootTimeline.mark(BOOT_SPLASH);
+      
       // Load devices from SD card
       int deviceCount = menu.loadDevices();
+      bootTimeline.mark(BOOT_SCAN);
       if (deviceCount < 0) {
         // Error loading devices, error screen already set
         updateDisplay();
       } else {
-        menu.setScreen(SCREEN_MAIN);
+        // Back where the remote was left, or the first page
+        if (!menu.restoreState()) {
+          menu.setScreen(SCREEN_MAIN);
+        }
         updateDisplay();
       }
+      bootTimeline.mark(BOOT_FIRST_FRAME);
+      bootTimeline.finish();
     }
     return;
   }
   
-  // Handle touch input
-  int touchX, touchY;
-  bool touched = touchInput.getTouchPoint(touchX, touchY);
-  TouchEvent event = menu.processTouchInput(touchX, touchY, touched);
+  // Keep the device strip's flick/snap animation moving
+  if (menu.getCurrentScreen() == SCREEN_MAIN) {
+    deviceList.update();
+  }
   
-  if (event != TOUCH_NONE) {
-    // Store the last touch position for command processing
-    menu.handleTouch(touchX, touchY, event);
+  // Handle touch events in the order they happened. They only queue
+  // work: IR sends run before the redraws they cause
+  TouchRecord touch;
+  while (touchInput.getEvent(touch)) {
+    // Navigation, and the action under the touch for IR commands
+    Action action = menu.handleTouch(touch);
     
-    // Process any IR commands based on current screen and touch
-    processIRCommands(touchX, touchY, event);
+    // Process any IR commands for that action
+    processIRCommands(action, touch);
     
     // Update display if needed
     if (menu.needsRefresh()) {
-      updateDisplay();
+      requestRedraw(touch.time);
     }
   }
   
-  // Small delay to prevent overwhelming the system
-  delay(10);
+  // Run queued work, then sleep until the next interrupt
+  scheduler.runReady();
+  scheduler.sleep();
 }
 
-void processIRCommands(int x, int y, TouchEvent event) {
-  Screen currentScreen = menu.getCurrentScreen();
+void processIRCommands(Action action, const TouchRecord& touch) {
+  // Up/down buttons repeat while held; HOLD events are already paced
+  // at REPEAT_DELAY, a finger sliding on the button is rate limited
+  TouchEvent event = touch.type;
+  bool repeat = event == TOUCH_TAP || event == TOUCH_HOLD || (event == TOUCH_DRAG && irHandler.canRepeat());
   
-  // Check for power button press from any screen
-  if (currentScreen != SCREEN_SPLASH && menu.isInZone(x, y, 240, 10, 70, 30)) {
-    if (event == TOUCH_TAP) {
-      irHandler.sendPowerCommand();
-      display.drawPowerButton(true);
-      delay(100);
-      display.drawPowerButton(false);
-    }
-    return;
-  }
-  
-  // Handle screen-specific commands
-  switch (currentScreen) {
-    case SCREEN_DEVICE:
-      if (event == TOUCH_TAP && menu.isInZone(x, y, 20, 140, 120, 30)) {
-        // Input button pressed
-        irHandler.sendCommand("input");
+  switch (action) {
+    case ACTION_POWER:
+      if (event == TOUCH_TAP) {
+        sendIRFunction(IR_FN_POWER, touch.time);
+        scheduler.post(powerFeedbackTask, PRIORITY_DISPLAY, 1);
       }
       break;
       
-    case SCREEN_VOLUME:
-      if (event == TOUCH_TAP || (event == TOUCH_HOLD && irHandler.canRepeat())) {
-        if (menu.isInZone(x, y, 20, 60, 120, 30)) {
-          irHandler.sendCommand("volUp");
-        } else if (menu.isInZone(x, y, 20, 100, 120, 30)) {
-          irHandler.sendCommand("volDown");
-        }
+    case ACTION_INPUT:
+      if (event == TOUCH_TAP) {
+        sendIRFunction(IR_FN_INPUT, touch.time);
       }
       break;
       
-    case SCREEN_CHANNEL:
-      if (event == TOUCH_TAP || (event == TOUCH_HOLD && irHandler.canRepeat())) {
-        if (menu.isInZone(x, y, 20, 60, 120, 30)) {
-          irHandler.sendCommand("chUp");
-        } else if (menu.isInZone(x, y, 20, 100, 120, 30)) {
-          irHandler.sendCommand("chDown");
-        }
-      }
+    case ACTION_VOL_UP:
+      if (repeat) sendIRFunction(IR_FN_VOL_UP, touch.time);
       break;
+      
+    case ACTION_VOL_DOWN:
+      if (repeat) sendIRFunction(IR_FN_VOL_DOWN, touch.time);
+      break;
+      
+    case ACTION_CH_UP:
+      if (repeat) sendIRFunction(IR_FN_CH_UP, touch.time);
+      break;
+      
+    case ACTION_CH_DOWN:
+      if (repeat) sendIRFunction(IR_FN_CH_DOWN, touch.time);
+      break;
+      
+    default:
+      break;
+  }
+}
+
+void sendIRFunction(IRFunction function, unsigned long touchTime) {
+  // One task sends the queue in order, so a send made while Sony/JVC
+  // repeats are going out can't overtake an earlier one. A full queue
+  // (seconds of frames behind) drops the send
+  PendingSend send = {(uint8_t)function, (uint32_t)touchTime};
+  if (pendingSends.push(send) && !scheduler.isPending(irSendTask)) {
+    scheduler.post(irSendTask, PRIORITY_IR, 0, touchTime);
+  }
+}
+
+void irSendTask(uint32_t) {
+  // Wait for the repeats of a Sony/JVC send to finish first
+  if (irHandler.isBusy()) {
+    scheduler.postDelayed(irSendTask, PRIORITY_IR, irHandler.busyFor());
+    return;
+  }
+  
+  PendingSend send;
+  if (!pendingSends.pop(send)) {
+    return;
+  }
+  bool success = irHandler.sendFunction((IRFunction)send.function);
+  if (success) {
+    unsigned long latency = hal.clock->millis() - send.touchTime;
+    irHandler.recordLatency(latency);
+    touchTrace.noteIR((IRFunction)send.function, latency);
+    if (!scheduler.isPending(sendingOverlayTask)) {
+      scheduler.post(sendingOverlayTask, PRIORITY_DISPLAY);
+    }
+  }
+  reportIRResult(success);
+  
+  if (!pendingSends.isEmpty()) {
+    scheduler.post(irSendTask, PRIORITY_IR);
+  }
+}
+
+void sendingOverlayTask(uint32_t) {
+  overlays.show(OVERLAY_SENDING, "Sending...", OVERLAY_SENDING_MS);
+}
+
+void powerFeedbackTask(uint32_t pressed) {
+  WATCHDOG_STAGE(STAGE_DISPLAY);
+  
+  // Show the power button pressed briefly, without blocking
+  display.drawPowerButton(pressed);
+  if (pressed) {
+    scheduler.postDelayed(powerFeedbackTask, PRIORITY_DISPLAY, POWER_FEEDBACK_MS, 0);
+  }
+}
+
+void requestRedraw(unsigned long touchTime) {
+  // Several changes in one pass share a single redraw
+  if (!scheduler.isPending(redrawTask)) {
+    scheduler.post(redrawTask, PRIORITY_DISPLAY, 0, touchTime);
+  }
+}
+
+void redrawTask(uint32_t) {
+  updateDisplay();
+  touchTrace.noteFrame(hal.clock->millis() - scheduler.currentStamp());
+}
+
+void reportIRResult(bool success) {
+  if (!success) {
+    overlays.show(OVERLAY_ERROR, irHandler.getLastError(), OVERLAY_ERROR_MS);
   }
 }
 
 void updateDisplay() {
+  WATCHDOG_STAGE(STAGE_DISPLAY);
+  
   Screen currentScreen = menu.getCurrentScreen();
   
+  // Screens shown recently come back from a snapshot instead of a redraw
+  uint32_t cacheKey = menu.getScreenKey();
+  if (cacheKey) {
+    // Snapshots are stored unscrolled
+    display.resetScroll();
+  }
+  if (cacheKey && screenCache.restore(cacheKey)) {
+    if (currentScreen == SCREEN_MAIN) {
+      display.setScrollArea(SCREEN_WIDTH - LIST_FIXED_WIDTH);
+      deviceList.attach(menu.getCurrentPage());
+    }
+    overlays.recomposite();
+    return;
+  }
+  unsigned long drawStart = micros();
+  
   switch (currentScreen) {
     case SCREEN_SPLASH:
       display.drawSplashScreen();
       break;
       
     case SCREEN_MAIN:
-      {
-        // Build device list for current page
-        const char* deviceList[DEVICES_PER_PAGE];
-        int startIdx = menu.getCurrentPage() * DEVICES_PER_PAGE;
-        int count = 0;
-        
-        for (int i = 0; i < DEVICES_PER_PAGE && (startIdx + i) < menu.getDeviceCount(); i++) {
-          deviceList[i] = menu.getDeviceName(startIdx + i);
-          count++;
-        }
-        
-        display.drawMainMenu(deviceList, count, menu.getCurrentPage(), menu.getTotalPages());
-      }
+      display.drawMainMenu(menu.getCurrentPage(), menu.getTotalPages());
+      deviceList.show(menu.getCurrentPage());
       break;
       
     case SCREEN_DEVICE:
@@ -220,4 +375,11 @@ void updateDisplay() {
       display.drawErrorScreen(menu.getErrorMessage());
       break;
   }
+  
+  if (cacheKey) {
+    screenCache.store(cacheKey, micros() - drawStart);
+  }
+  
+  // Overlays go back on top of the new screen (after the snapshot)
+  overlays.recomposite();
 }
\ No newline at end of file
@@ -7,14 +7,14 @@
 #define ASCII_ART_H
 
 // Small logo for menu corners (3x3)
-const char* LOGO_SMALL[] = {
+const char* const LOGO_SMALL[] = {
   "VHC",
   "===", 
   "UR "
 };
 
 // Block-style logo using ASCII block characters
-const char* LOGO_MEDIUM[] = {
+const char* const LOGO_MEDIUM[] = {
   "██    ██ ██   ██  ████",
   "██    ██ ██   ██ ██   ",
   "██    ██ ███████ ██   ",
@@ -24,7 +24,7 @@ const char* LOGO_MEDIUM[] = {
 };
 
 // Alternative block logo with more geometric style
-const char* LOGO_MODERN[] = {
+const char* const LOGO_MODERN[] = {
   "▌█▐ ▌█▐ ▌██▐",
   "▌█▐ ▌█▐ ▌█ ▐",
   "▌█████▐ ▌█ ▐",
@@ -33,7 +33,7 @@ const char* LOGO_MODERN[] = {
 };
 
 // Minimalist block logo
-const char* LOGO_MINIMAL[] = {
+const char* const LOGO_MINIMAL[] = {
   "▀▄   ▄▀ █ █ ▄▄▄",
   " ▀▄▄▄▀  █▄█ █  ",
   "  ▀█▀   █ █ ▀▀▀",
@@ -41,7 +41,7 @@ const char* LOGO_MINIMAL[] = {
 };
 
 // Pure block design
-const char* LOGO_BLOCKS[] = {
+const char* const LOGO_BLOCKS[] = {
   "████ ████ ████",
   "█  █ █  █ █   ",
   "█  █ ████ █   ",
@@ -51,17 +51,17 @@ const char* LOGO_BLOCKS[] = {
 };
 
 // Full splash screen text
-const char* SPLASH_TITLE = "UNIVERSAL REMOTE";
-const char* SPLASH_CREATOR = "Created by Trent Von Holten";
-const char* SPLASH_LOADING = "Loading";
+const char* const SPLASH_TITLE = "UNIVERSAL REMOTE";
+const char* const SPLASH_CREATOR = "Created by Trent Von Holten";
+const char* const SPLASH_LOADING = "Loading";
 
 // Alternative compact logos for different screen sizes
-const char* LOGO_COMPACT_1[] = {
+const char* const LOGO_COMPACT_1[] = {
   " VHC ",
   "[UR]"
 };
 
-const char* LOGO_COMPACT_2[] = {
+const char* const LOGO_COMPACT_2[] = {
   "VonHolten",
   " Codes   ",
   "Universal", 
@@ -69,7 +69,7 @@ const char* LOGO_COMPACT_2[] = {
 };
 
 // Stylized VHC for larger displays
-const char* LOGO_LARGE[] = {
+const char* const LOGO_LARGE[] = {
   "__      ___    _  _____ ",
   "\\ \\    / / |  | |/ ____|",
   " \\ \\  / /| |__| | |     ",
@@ -79,14 +79,14 @@ const char* LOGO_LARGE[] = {
 };
 
 // Loading animation frames (cycle through these)
-const char* LOADING_FRAMES[] = {
+const char* const LOADING_FRAMES[] = {
   "Loading.  ",
   "Loading.. ",
   "Loading..."
 };
 
 // Alternative loading spinner
-const char* SPINNER_FRAMES[] = {
+const char* const SPINNER_FRAMES[] = {
   "[-]",
   "[\\]",
   "[|]", 
@@ -94,15 +94,15 @@ const char* SPINNER_FRAMES[] = {
 };
 
 // Error messages with style
-const char* ERROR_NO_SD = "! INSERT SD CARD !";
-const char* ERROR_NO_DEVICES = "! NO DEVICES FOUND !";
-const char* ERROR_READ_FAIL = "! FILE READ ERROR !";
+const char* const ERROR_NO_SD = "! INSERT SD CARD !";
+const char* const ERROR_NO_DEVICES = "! NO DEVICES FOUND !";
+const char* const ERROR_READ_FAIL = "! FILE READ ERROR !";
 
 // Menu headers
-const char* HEADER_DEVICES = "DEVICES:";
-const char* HEADER_VOLUME = "VOLUME CONTROL";
-const char* HEADER_CHANNEL = "CHANNEL CONTROL";
-const char* HEADER_SETTINGS = "SETTINGS";
+const char* const HEADER_DEVICES = "DEVICES:";
+const char* const HEADER_VOLUME = "VOLUME CONTROL";
+const char* const HEADER_CHANNEL = "CHANNEL CONTROL";
+const char* const HEADER_SETTINGS = "SETTINGS";
 
 // Special characters for terminal feel
 const char PROMPT = '>';
@@ -0,0 +1,181 @@
+/*
+ * VHC Universal Remote - Boot Timeline Implementation
+ */
+
+#include "boot_timeline.h"
+#include "hal.h"
+#include "sd_manager.h"
+#include "loop_watchdog.h"
+
+// Global boot timeline instance
+BootTimeline bootTimeline;
+
+#define BOOT_BASELINE_FILE "/bench/boot_base.csv"
+#define BOOT_HISTORY_FILE  "/bench/boot.csv"
+
+const char* const bootPhaseNames[BOOT_PHASE_COUNT] = {
+  "serial",
+  "display",
+  "sd",
+  "touch",
+  "ir",
+  "init",
+  "splash",
+  "scan",
+  "parse",
+  "first_frame"
+};
+
+BootTimeline::BootTimeline() {
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    durations[i] = 0;
+  }
+  lastMark = 0;  // micros() counts from reset
+  charged = 0;
+  total = 0;
+  complete = false;
+}
+
+void BootTimeline::mark(BootPhase phase) {
+  if (complete) return;
+  
+  uint32_t now = micros();
+  uint32_t elapsed = now - lastMark;
+  durations[phase] += (elapsed > charged) ? elapsed - charged : 0;
+  lastMark = now;
+  charged = 0;
+}
+
+void BootTimeline::add(BootPhase phase, uint32_t us) {
+  // Later device reloads are not part of boot
+  if (complete) return;
+  
+  durations[phase] += us;
+  charged += us;
+}
+
+void BootTimeline::finish() {
+  if (complete) return;
+  
+  total = micros();
+  complete = true;
+  print();
+  
+  #if BOOT_TIMELINE_SD
+    appendHistory();
+  #endif
+}
+
+bool BootTimeline::print() {
+  uint32_t baseline[BOOT_PHASE_COUNT];
+  bool haveBaseline = readBaseline(baseline);
+  bool passed = true;
+  
+  Serial.println(F("BOOT,phase,us,baseline,status"));
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    const char* status = "ok";
+    if (!haveBaseline) {
+      status = "no-baseline";
+    } else if (i != BOOT_SERIAL &&
+               (uint64_t)durations[i] * 100 > (uint64_t)baseline[i] * (100 + BOOT_REGRESSION_PCT)) {
+      // Serial wait depends on the host, not on the firmware
+      status = "REGRESSION";
+      passed = false;
+    }
+    
+    Serial.print(F("BOOT,"));
+    Serial.print(bootPhaseNames[i]);
+    Serial.print(',');
+    Serial.print(durations[i]);
+    Serial.print(',');
+    Serial.print(haveBaseline ? baseline[i] : 0);
+    Serial.print(',');
+    Serial.println(status);
+  }
+  Serial.print(F("BOOT,total,"));
+  Serial.println(total);
+  
+  return passed;
+}
+
+bool BootTimeline::saveBaseline() {
+  WATCHDOG_STAGE(STAGE_SD);
+  
+  if (!complete) return false;
+  
+  hal.storage->fs().mkdir("/bench");
+  hal.storage->fs().remove(BOOT_BASELINE_FILE);
+  File file = hal.storage->fs().open(BOOT_BASELINE_FILE, FILE_WRITE);
+  if (!file) return false;
+  
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    file.print(bootPhaseNames[i]);
+    file.print(',');
+    file.println(durations[i]);
+  }
+  file.close();
+  return true;
+}
+
+void BootTimeline::appendHistory() {
+  WATCHDOG_STAGE(STAGE_SD);
+  
+  // Boots without a card (bundled devices only) keep no history
+  if (!sdManager.isReady()) return;
+  
+  // One row per boot, so regressions show up across builds
+  hal.storage->fs().mkdir("/bench");
+  bool exists = hal.storage->fs().exists(BOOT_HISTORY_FILE);
+  File file = hal.storage->fs().open(BOOT_HISTORY_FILE, FILE_WRITE);
+  if (!file) return;
+  
+  if (!exists) {
+    file.print(F("fast_boot,total"));
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+      file.print(',');
+      file.print(bootPhaseNames[i]);
+    }
+    file.println();
+  }
+  
+  file.print(FAST_BOOT);
+  file.print(',');
+  file.print(total);
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    file.print(',');
+    file.print(durations[i]);
+  }
+  file.println();
+  file.close();
+}
+
+bool BootTimeline::readBaseline(uint32_t baseline[BOOT_PHASE_COUNT]) {
+  File file = hal.storage->fs().open(BOOT_BASELINE_FILE);
+  if (!file) return false;
+  
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+    baseline[i] = 0;
+  }
+  
+  char line[48];
+  while (file.available()) {
+    int n = 0;
+    while (file.available() && n < 47) {
+      char c = file.read();
+      if (c == '\n') break;
+      if (c != '\r') line[n++] = c;
+    }
+    line[n] = '\0';
+    
+    char* field = strtok(line, ",");
+    char* value = strtok(NULL, ",");
+    if (!field || !value) continue;
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+      if (strcmp(field, bootPhaseNames[i]) == 0) {
+        baseline[i] = strtoul(value, NULL, 10);
+      }
+    }
+  }
+  file.close();
+  return true;
+}
@@ -0,0 +1,60 @@
+/*
+ * VHC Universal Remote - Boot Timeline
+ * Per-phase timing of setup() and the first loop passes
+ */
+
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Boot phases, in the order they run
+enum BootPhase {
+  BOOT_SERIAL,       // Waiting for the USB serial connection
+  BOOT_DISPLAY,      // Display init and splash
+  BOOT_SD,           // SD card mount
+  BOOT_TOUCH,
+  BOOT_IR,
+  BOOT_INIT,         // Usage stats, menu
+  BOOT_SPLASH,       // Splash shown until it may advance
+  BOOT_SCAN,         // Directory scan and menu ordering
+  BOOT_PARSE,        // CSV parsing (measured inside the scan)
+  BOOT_FIRST_FRAME,  // First menu screen drawn
+  BOOT_PHASE_COUNT
+};
+
+// mark() closes a phase: the time since the previous mark is charged to
+// it, minus anything add() charged to other phases in between (so parse
+// time measured per file comes out of the scan). Once the first frame is
+// up, finish() prints the timeline as BOOT CSV lines, compares it with
+// the baseline saved by "boot save", and appends it to the SD history.
+class BootTimeline {
+private:
+  uint32_t durations[BOOT_PHASE_COUNT];  // Microseconds
+  uint32_t lastMark;
+  uint32_t charged;   // add()ed since the last mark
+  uint32_t total;     // micros() at finish
+  bool complete;
+  
+public:
+  BootTimeline();
+  
+  void mark(BootPhase phase);
+  void add(BootPhase phase, uint32_t us);
+  void finish();
+  bool isComplete() { return complete; }
+  
+  // Print the timeline against the baseline; false on a regression
+  bool print();
+  bool saveBaseline();
+  
+private:
+  void appendHistory();
+  bool readBaseline(uint32_t baseline[BOOT_PHASE_COUNT]);
+};
+
+// Global boot timeline instance
+extern BootTimeline bootTimeline;
+
+#endif // BOOT_TIMELINE_H
@@ -17,6 +17,7 @@
 
 // Touch controller pins (XPT2046)
 #define TOUCH_CS 8   // Touch chip select
+#define TOUCH_IRQ 2  // Touch pen interrupt (T_IRQ, active low)
 
 // IR LED pin
 #define IR_LED   6   // Connected through transistor
@@ -28,12 +29,24 @@
 #define SCREEN_WIDTH  320
 #define SCREEN_HEIGHT 240
 
+// Most pixels in one display SPI transaction. The touch sampler is held off
+// while one is open, so large fills and window streams go out in bands
+// (ten full rows: under 2 ms at 30 MHz, 6.4 ms at 8 MHz)
+#define DISPLAY_BAND_PIXELS 3200
+
 // Touch calibration values (adjust after testing)
 #define TS_MINX 200
 #define TS_MAXX 3800
 #define TS_MINY 200
 #define TS_MAXY 3800
 
+// Touch sampling (timer driven while the pen is down)
+#define TOUCH_SAMPLE_US      4000  // Sample period while pressed (250 Hz)
+#define TOUCH_PRESSURE_MIN   400   // Raw Z below this counts as no contact
+#define TOUCH_RELEASE_COUNT  3     // Consecutive light samples before release
+#define TOUCH_FILTER_SHIFT   1     // IIR weight of each new sample (1/2^n)
+#define TOUCH_QUEUE_SIZE     64    // Touch events buffered between loop passes
+
 // UI Color scheme (red-on-black terminal style)
 #define COLOR_BACKGROUND ILI9341_BLACK
 #define COLOR_TEXT       ILI9341_RED
@@ -47,18 +60,103 @@
 #define REPEAT_DELAY     200   // Button repeat delay in ms
 #define DEBOUNCE_DELAY   50    // Touch debounce
 
+// Boot timeline and fast boot
+#define FAST_BOOT            0     // Skip the serial wait and the fixed splash time
+#define SPLASH_FAST_DURATION 0     // Splash time in fast boot (devices still load behind it)
+#define BOOT_TIMELINE_SD     1     // Append each boot's timeline to /bench/boot.csv
+#define BOOT_REGRESSION_PCT  20    // Allowed growth of a phase over the saved baseline
+
+// Scheduler (cooperative tasks, see scheduler.h)
+#define SCHEDULER_MAX_TASKS   24   // Tasks queued or waiting on a timer
+#define SCHEDULER_WHEEL_SLOTS 64   // Timer wheel slots of 1 ms
+#define POWER_FEEDBACK_MS     100  // Power button shown pressed
+#define IR_SONY_REPEAT_MS     40   // Gap between the three Sony frames
+#define IR_JVC_REPEAT_MS      50   // Gap before the headerless JVC repeat
+#define IR_PENDING_SENDS      16   // Touch sends waiting their turn (power of two)
+#define HISTOGRAM_BUCKETS     128  // 1 ms buckets, the last one collects overflow
+
 // Menu configuration
 #define DEVICES_PER_PAGE 4
 #define MAX_DEVICES      20
 #define MAX_COMMANDS     10
 
+// Main menu device strip (hardware scrolled)
+#define LIST_FIXED_WIDTH   88    // Right-hand column that does not scroll
+#define LIST_BAND_WIDTH    16    // Columns rasterized per off-screen band
+#define LIST_DRAG_START    6     // Pixels of movement before a touch becomes a drag
+#define LIST_FLICK_MIN     0.3   // Release speed (px/ms) that starts momentum
+#define LIST_FRICTION      0.92  // Momentum kept per 16 ms frame
+#define LIST_SNAP_RATE     0.35  // Fraction of remaining distance covered per snap frame
+
+// Screen snapshot cache (compressed framebuffer copies of recent screens)
+#define SCREEN_CACHE_BYTES   32768 // Byte budget for all snapshots
+#define SCREEN_CACHE_ENTRIES 6     // Screens kept at most
+#define SCREEN_CACHE_COLORS  8     // Palette size per snapshot
+
+// Overlays (toasts drawn over a screen with save-under)
+#define OVERLAY_MAX          4     // Overlays stacked at once
+#define OVERLAY_SAVE_PIXELS  30000 // Save-under buffer (DMAMEM)
+#define OVERLAY_SENDING_MS   300   // "Sending" indicator lifetime
+#define OVERLAY_ERROR_MS     2000  // Error toast lifetime
+
+// Device usage ranking (main menu order)
+#ifndef USAGE_SORT_MENU
+#define USAGE_SORT_MENU      1     // Most used devices first (0 = SD card order)
+#endif
+#define USAGE_EEPROM_ADDR    64    // Start of the usage table in EEPROM
+#define USAGE_ENTRIES        32    // Devices remembered
+#define USAGE_HALF_LIFE      64    // Scores halve every this many sends
+#define USAGE_FLUSH_MS       30000 // Batch EEPROM writes for this long
+
+// Persistent key/value store (journaled, two EEPROM banks)
+#define KV_EEPROM_ADDR       512   // Start of bank 0 (after the usage table)
+#define KV_BANK_SIZE         512   // Bytes per bank; bank 1 follows bank 0
+#define KV_MAX_VALUE         16    // Largest value in bytes
+#define STATE_SAVE_DELAY_MS  2000  // Screen/page/device saved once unchanged this long
+
+// Render benchmark (serial "render" command)
+#define RENDER_REGRESSION_PCT 10   // Allowed growth over the saved baseline
+
+// Stack painting (serial "mem" command)
+#define STACK_PAINT_MARGIN    512   // Bytes below the stack pointer left unpainted
+
+// Touch trace record/replay (serial "trace" command)
+#define TRACE_SETTLE_MS       500   // Replay ends this long after the last sample
+
+// Micro benchmarks (serial "bench" command)
+#define MICRO_BENCH_LINES     256   // Generated IRDB lines
+#define MICRO_BENCH_MIN_US    20000 // Minimum run time per benchmark
+#define MICRO_BENCH_REGRESSION_PCT 15 // Allowed ns/op growth over the saved baseline
+
+// Binary event log (serial "log" command, decode with tools/log_decode)
+#define LOG_RING_SIZE         128   // Records buffered (power of two)
+#define LOG_DRAIN_MS          20    // Background drain period
+#define EVENT_LOG_OUTPUT      0     // Output at boot: 0 off, 1 Serial, 2 SD (/log/events.bin)
+
+// Main loop stall watchdog (serial "stall" command)
+#define WATCHDOG_BUDGET_MS    100   // A loop pass longer than this is a stall
+#define WATCHDOG_CHECK_MS     10    // Check interrupt period
+#define WATCHDOG_BUCKET_MS    10    // Stall histogram bucket width
+
+// Host link (framed serial protocol, see remote_protocol.h)
+#define HOST_QUEUE_SIZE       64    // Queued sends from the host
+#define PROTO_BYTE_TIMEOUT_MS 50    // A frame pausing longer than this is dropped
+#define UPLOAD_BUFFER_BYTES   4096  // Uploaded bytes waiting for SD (power of two)
+
+// Device database in program flash (serial "flashdb" command, see flash_db.h)
+#define FLASH_DB_ENABLED      1     // Load devices from flash, SD as the fallback and source
+#define FLASH_DB_BYTES        131072 // Top of program flash reserved (4 KB sectors)
+#define FLASH_DB_MAX_DEVICES  64    // Devices indexed
+
 // File paths (IRDB format only)
 #define CONFIG_FILE      "config.txt"
 
 // Debug settings
 #define DEBUG_SERIAL     1    // Enable serial debug output
-#define DEBUG_TOUCH      0    // Show touch coordinates
-#define DEBUG_IR         0    // Show IR codes being sent
+#define DEBUG_TOUCH      0    // Log touch samples and events (event log)
+#define DEBUG_IR         0    // Log IR codes being sent (event log)
+#define EVENT_LOG_ENABLED 1   // Binary event log calls, 0 compiles them out
+#define PROFILER_ENABLED 1    // Scoped cycle counters (serial "prof"), 0 compiles them out
 
 // Logo style selection (0=Block text, 1=Modern, 2=Minimal, 3=Graphical blocks)
 #define LOGO_STYLE       3    // Change this to select different logo styles
@@ -0,0 +1,41 @@
+/*
+ * VHC Universal Remote - Device Bundle
+ * Devices compiled into the firmware, already converted from IRDB CSVs
+ *
+ * GENERATED by tools/device_bundle/device_bundle_gen.cpp - do not edit by hand.
+ * Sources: examples/Sony_TV.csv
+ * Merged with the SD card devices by Menu::loadDevices().
+ */
+
+#ifndef DEVICE_BUNDLE_H
+#define DEVICE_BUNDLE_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#elif !defined(PROGMEM)
+#define PROGMEM  // Host builds
+#endif
+#include "ir_device.h"
+
+// Table layout the bundle was generated for
+static_assert(MAX_COMMANDS == 10 && IR_FN_COUNT == 25, "Regenerate device_bundle.h");
+
+constexpr int BUNDLED_DEVICE_COUNT = 1;
+
+// name, {command, code, protocol}..., commandCount, slots per IRFunction
+constexpr Device BUNDLED_DEVICES[] PROGMEM = {
+  {"Sony TV", {
+    {"power", 0x00000095UL, "SONY12"},
+    {"volUp", 0x00000092UL, "SONY12"},
+    {"volDown", 0x00000093UL, "SONY12"},
+    {"chUp", 0x00000090UL, "SONY12"},
+    {"chDown", 0x00000091UL, "SONY12"},
+    {"mute", 0x00000094UL, "SONY12"},
+    {"input", 0x000000A5UL, "SONY12"},
+    {"menu", 0x000000E0UL, "SONY12"},
+    {"ok", 0x000000E5UL, "SONY12"},
+    {"1", 0x00000080UL, "SONY12"},
+  }, 10, {0, 1, 2, 3, 4, 5, 6, -1, -1, -1, -1, -1, -1, 7, 8, -1, 9, -1, -1, -1, -1, -1, -1, -1, -1}},
+};
+
+#endif // DEVICE_BUNDLE_H
@@ -0,0 +1,268 @@
+/*
+ * VHC Universal Remote - Device List Implementation
+ */
+
+#include "device_list.h"
+#include "display.h"
+#include "menu.h"
+#include "overlay.h"
+#include "hal.h"
+#include "loop_watchdog.h"
+
+// Display instance lives in the main sketch
+extern Display display;
+
+// Global device list instance
+DeviceList deviceList;
+
+// Momentum and snap run in 16 ms frames
+#define LIST_FRAME_MS 16
+
+DeviceList::DeviceList() {
+  band = nullptr;
+  scrollWidth = SCREEN_WIDTH - LIST_FIXED_WIDTH;
+  shownOffset = 0;
+  position = 0;
+  velocity = 0;
+  dragging = false;
+  moved = false;
+  animating = false;
+  snapping = false;
+  snapTarget = 0;
+  dragLastX = 0;
+  dragLastTime = 0;
+  lastFrame = 0;
+  scrollSteps = 0;
+  columnsRasterized = 0;
+}
+
+void DeviceList::begin() {
+  band = new GFXcanvas16(LIST_BAND_WIDTH, SCREEN_HEIGHT);
+  // Text running off a band's right edge is picked up by the next band;
+  // wrapping would draw it again on the lines below
+  band->setTextWrap(false);
+}
+
+void DeviceList::show(int page) {
+  if (!band) return;
+  
+  dragging = false;
+  animating = false;
+  velocity = 0;
+  
+  // Page boundaries are multiples of the scroll width, so a settled page
+  // always sits at scroll start 0 and panel memory matches the screen
+  shownOffset = page * scrollWidth;
+  position = shownOffset;
+  rasterize(shownOffset, shownOffset + scrollWidth);
+  display.setScrollStart(0);
+}
+
+void DeviceList::attach(int page) {
+  dragging = false;
+  animating = false;
+  velocity = 0;
+  shownOffset = page * scrollWidth;
+  position = shownOffset;
+}
+
+void DeviceList::press(int x, unsigned long time) {
+  dragging = true;
+  moved = false;
+  animating = false;
+  velocity = 0;
+  dragLastX = x;
+  dragLastTime = time;
+  position = shownOffset;
+  scrollSteps = 0;
+  columnsRasterized = 0;
+}
+
+void DeviceList::drag(int x, unsigned long time) {
+  if (!dragging) return;
+  
+  int dx = x - dragLastX;
+  if (!moved && abs(dx) < LIST_DRAG_START) return;
+  moved = true;
+  
+  // Sample times, so a queued drag still yields the real finger speed
+  unsigned long dt = time - dragLastTime;
+  if (dt > 0) {
+    // Smoothed finger speed; the strip moves opposite to the finger
+    float instant = -(float)dx / dt;
+    velocity = velocity * 0.5 + instant * 0.5;
+  }
+  dragLastX = x;
+  dragLastTime = time;
+  
+  position -= dx;
+  if (position < 0) position = 0;
+  if (position > maxOffset()) position = maxOffset();
+  scrollTo((int)position);
+}
+
+bool DeviceList::release(unsigned long time) {
+  if (!dragging) return false;
+  dragging = false;
+  
+  if (!moved) {
+    // A tap while the strip was still moving just lets it finish settling
+    if (shownOffset % scrollWidth == 0) {
+      return true;
+    }
+    snapping = true;
+    snapTarget = getPage() * scrollWidth;
+    animating = true;
+    lastFrame = hal.clock->millis();
+    return false;
+  }
+  
+  // A stale finger speed means the finger stopped before lifting
+  if (time - dragLastTime > 100) {
+    velocity = 0;
+  }
+  snapping = fabs(velocity) < LIST_FLICK_MIN;
+  if (snapping) {
+    snapTarget = getPage() * scrollWidth;
+  }
+  animating = true;
+  lastFrame = hal.clock->millis();
+  return false;
+}
+
+void DeviceList::scrollToPage(int page) {
+  int pages = menu.getTotalPages();
+  if (page < 0 || page >= pages) return;
+  
+  snapTarget = page * scrollWidth;
+  snapping = true;
+  animating = true;
+  velocity = 0;
+  scrollSteps = 0;
+  columnsRasterized = 0;
+  lastFrame = hal.clock->millis();
+}
+
+void DeviceList::update() {
+  WATCHDOG_STAGE(STAGE_DISPLAY);
+  
+  if (!animating) return;
+  
+  unsigned long now = hal.clock->millis();
+  if (now - lastFrame < LIST_FRAME_MS) return;
+  lastFrame = now;
+  
+  if (!snapping) {
+    // Flick momentum with friction, then snap to the nearest page
+    position += velocity * LIST_FRAME_MS;
+    velocity *= LIST_FRICTION;
+    if (position <= 0 || position >= maxOffset() || fabs(velocity) < LIST_FLICK_MIN / 4) {
+      if (position < 0) position = 0;
+      if (position > maxOffset()) position = maxOffset();
+      velocity = 0;
+      snapping = true;
+      snapTarget = ((int)position + scrollWidth / 2) / scrollWidth * scrollWidth;
+    }
+  } else {
+    float remaining = snapTarget - position;
+    if (fabs(remaining) < 1.5) {
+      position = snapTarget;
+    } else {
+      position += remaining * LIST_SNAP_RATE;
+    }
+  }
+  
+  scrollTo((int)(position + 0.5));
+  
+  if (snapping && shownOffset == snapTarget) {
+    settle();
+  }
+}
+
+int DeviceList::getPage() {
+  int page = (shownOffset + scrollWidth / 2) / scrollWidth;
+  int pages = menu.getTotalPages();
+  if (page >= pages) page = pages > 0 ? pages - 1 : 0;
+  return page;
+}
+
+int DeviceList::maxOffset() {
+  int pages = menu.getTotalPages();
+  return pages > 1 ? (pages - 1) * scrollWidth : 0;
+}
+
+void DeviceList::scrollTo(int offset) {
+  if (offset == shownOffset) return;
+  
+  // Overlays would be dragged along with the strip; put the screen back first
+  if (overlays.getCount() > 0) {
+    overlays.dismissAll();
+  }
+  
+  // Rasterize only the columns scrolling into view; they reuse the panel
+  // memory lines of the columns scrolling out
+  int delta = offset - shownOffset;
+  if (abs(delta) >= scrollWidth) {
+    rasterize(offset, offset + scrollWidth);
+  } else if (delta > 0) {
+    rasterize(shownOffset + scrollWidth, offset + scrollWidth);
+  } else {
+    rasterize(offset, shownOffset);
+  }
+  
+  shownOffset = offset;
+  display.setScrollStart(shownOffset % scrollWidth);
+  scrollSteps++;
+}
+
+void DeviceList::rasterize(int fromColumn, int toColumn) {
+  const char* names[DEVICES_PER_PAGE];
+  
+  while (fromColumn < toColumn) {
+    // Stop each band at the wrap point of the scroll area
+    int memoryColumn = fromColumn % scrollWidth;
+    int width = toColumn - fromColumn;
+    if (width > LIST_BAND_WIDTH) width = LIST_BAND_WIDTH;
+    if (width > scrollWidth - memoryColumn) width = scrollWidth - memoryColumn;
+    
+    band->fillScreen(COLOR_BACKGROUND);
+    int firstPage = fromColumn / scrollWidth;
+    int lastPage = (fromColumn + width - 1) / scrollWidth;
+    for (int page = firstPage; page <= lastPage && page < menu.getTotalPages(); page++) {
+      int startIdx = page * DEVICES_PER_PAGE;
+      int count = 0;
+      for (int i = 0; i < DEVICES_PER_PAGE && (startIdx + i) < menu.getDeviceCount(); i++) {
+        names[i] = menu.getDeviceName(startIdx + i);
+        count++;
+      }
+      display.drawDevicePage(band, page * scrollWidth - fromColumn, names, count);
+    }
+    display.pushColumns(memoryColumn, band, width);
+    
+    columnsRasterized += width;
+    fromColumn += width;
+  }
+}
+
+void DeviceList::settle() {
+  animating = false;
+  snapping = false;
+  
+  int page = getPage();
+  if (page != menu.getCurrentPage()) {
+    menu.setPage(page);
+    display.drawPageIndicator(page, menu.getTotalPages());
+  }
+  
+  #if DEBUG_SERIAL
+    if (scrollSteps > 0) {
+      Serial.print(F("List scroll: "));
+      Serial.print(scrollSteps);
+      Serial.print(F(" steps, "));
+      Serial.print(columnsRasterized);
+      Serial.print(F(" columns rasterized ("));
+      Serial.print(columnsRasterized / scrollSteps);
+      Serial.println(F(" per step)"));
+    }
+  #endif
+}
@@ -0,0 +1,75 @@
+/*
+ * VHC Universal Remote - Device List
+ * Hardware-scrolled main menu strip with drag and flick scrolling
+ */
+
+#ifndef DEVICE_LIST_H
+#define DEVICE_LIST_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "config.h"
+
+// Pages of DEVICES_PER_PAGE buttons sit side by side on a virtual strip.
+// In landscape the ILI9341 vertical-scroll registers shift screen columns,
+// so dragging moves the strip in hardware and only the columns that scroll
+// into view are rasterized (through a narrow off-screen band).
+class DeviceList {
+private:
+  GFXcanvas16* band;
+  int scrollWidth;        // Width of the hardware scroll area
+  int shownOffset;        // Strip column currently at the left edge
+  float position;         // Target offset while dragging/animating
+  float velocity;         // px per ms
+  bool dragging;
+  bool moved;
+  bool animating;
+  bool snapping;
+  int snapTarget;
+  int dragLastX;
+  unsigned long dragLastTime;
+  unsigned long lastFrame;
+  
+  // Per-gesture rasterization stats (debug output and tests)
+  unsigned long scrollSteps;
+  unsigned long columnsRasterized;
+  
+public:
+  DeviceList();
+  void begin();
+  
+  // Draw the visible strip for a page (after Display::drawMainMenu)
+  void show(int page);
+  
+  // Take over a strip already on the panel (restored from the screen cache)
+  void attach(int page);
+  
+  // Touch gestures (screen X coordinates, millis() of the touch sample)
+  void press(int x, unsigned long time);
+  void drag(int x, unsigned long time);
+  bool release(unsigned long time); // Returns true if the touch was a tap, not a drag
+  bool isDragging() { return dragging; }
+  
+  // Animated move to a page (Next/Back buttons)
+  void scrollToPage(int page);
+  
+  // Advance momentum/snap animation; call every loop pass on the main menu
+  void update();
+  bool isSettled() { return !dragging && !animating; }
+  int getPage();
+  
+  // Scroll steps and columns rasterized since the last press or page scroll
+  unsigned long getScrollSteps() { return scrollSteps; }
+  unsigned long getColumnsRasterized() { return columnsRasterized; }
+  
+private:
+  int maxOffset();
+  void scrollTo(int offset);
+  void rasterize(int fromColumn, int toColumn);
+  void settle();
+};
+
+// Global device list instance
+extern DeviceList deviceList;
+
+#endif // DEVICE_LIST_H
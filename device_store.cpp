@@ -0,0 +1,242 @@
+/*
+ * VHC Universal Remote - Device Store Implementation
+ */
+
+#include "device_store.h"
+#include "flash_db.h"
+#include "sd_manager.h"
+#include "hal.h"
+#include "kv_store.h"
+#include "loop_watchdog.h"
+
+// Global device store instance
+DeviceStore deviceStore;
+
+// Name hashes seen on SD during a sync; syncedCount keeps counting past
+// the array, which then no longer lists every device on the card
+static uint32_t syncedHashes[FLASH_DB_MAX_DEVICES];
+static int syncedCount;
+
+// Benchmark table (large, not speed critical)
+DMAMEM static Device benchDevices[MAX_DEVICES];
+
+DeviceStore::DeviceStore() {
+  lastSyncMs = 0;
+  lastSynced = 0;
+  lastPruned = 0;
+}
+
+void DeviceStore::begin() {
+  #if FLASH_DB_ENABLED
+    WATCHDOG_STAGE(STAGE_FLASH);
+    bool ready = flashDB.begin(hal.flash);
+    
+    #if DEBUG_SERIAL
+      Serial.print(F("Flash DB: "));
+      if (ready) {
+        Serial.print(flashDB.getCount());
+        Serial.println(F(" devices"));
+      } else {
+        Serial.println(F("unavailable (sketch overlaps the region?)"));
+      }
+    #else
+      (void)ready;
+    #endif
+  #endif
+}
+
+// The SD catalog flash was last brought in line with
+static void saveCatalog() {
+  uint32_t catalog = sdManager.getCatalogHash();
+  kvStore.set(KV_SD_CATALOG, &catalog, sizeof(catalog));
+}
+
+static bool catalogChanged() {
+  uint32_t catalog;
+  return !kvStore.get(KV_SD_CATALOG, &catalog, sizeof(catalog)) || catalog != sdManager.getCatalogHash();
+}
+
+int DeviceStore::loadDevices(Device* devices, int maxDevices) {
+  #if FLASH_DB_ENABLED
+    if (flashDB.getCount() > 0) {
+      // With a card in, files added, removed or edited on it since flash
+      // was filled are synced first (a directory walk, no parsing, when
+      // nothing changed)
+      if (sdManager.isReady() && catalogChanged()) {
+        int synced = sync();
+        
+        #if DEBUG_SERIAL
+          Serial.print(F("Flash DB: SD changed, "));
+          Serial.print(synced);
+          Serial.print(F(" read, "));
+          Serial.print(lastPruned);
+          Serial.println(F(" pruned"));
+        #else
+          (void)synced;
+        #endif
+      }
+      
+      WATCHDOG_STAGE(STAGE_FLASH);
+      int loaded = flashDB.loadDevices(devices, maxDevices);
+      if (loaded > 0) return loaded;
+    }
+  #endif
+  
+  int loaded = sdManager.loadDevices(devices, maxDevices);
+  
+  #if FLASH_DB_ENABLED
+    // Filled on demand: the next boot reads flash. A full table may have
+    // left files out, so only then does the catalog stay unrecorded
+    if (loaded > 0 && flashDB.isReady()) {
+      WATCHDOG_STAGE(STAGE_FLASH);
+      for (int i = 0; i < loaded; i++) {
+        flashDB.store(devices[i], i);
+      }
+      if (loaded < maxDevices) {
+        saveCatalog();
+      }
+    }
+  #endif
+  return loaded;
+}
+
+void DeviceStore::store(const Device& device) {
+  #if FLASH_DB_ENABLED
+    WATCHDOG_STAGE(STAGE_FLASH);
+    flashDB.store(device);
+  #else
+    (void)device;
+  #endif
+}
+
+void DeviceStore::syncDevice(const Device& device) {
+  // Called in card order, so the count so far is its place in it
+  flashDB.store(device, syncedCount);
+  if (syncedCount < FLASH_DB_MAX_DEVICES) {
+    syncedHashes[syncedCount] = hashName(device.name);
+  }
+  syncedCount++;
+}
+
+int DeviceStore::sync() {
+  #if FLASH_DB_ENABLED
+    if (!flashDB.isReady()) return -1;
+    WATCHDOG_STAGE(STAGE_FLASH);
+    uint32_t start = hal.clock->millis();
+    
+    syncedCount = 0;
+    int synced = sdManager.forEachDevice(syncDevice);
+    if (synced < 0) return -1;
+    
+    // Past FLASH_DB_MAX_DEVICES the hash list misses devices that are
+    // still on the card, so nothing is pruned
+    if (syncedCount <= FLASH_DB_MAX_DEVICES) {
+      lastPruned = flashDB.prune(syncedHashes, syncedCount);
+    } else {
+      lastPruned = 0;
+      #if DEBUG_SERIAL
+        Serial.print(F("Flash DB: "));
+        Serial.print(syncedCount);
+        Serial.println(F(" devices on SD, more than indexed; not pruning"));
+      #endif
+    }
+    saveCatalog();
+    lastSynced = synced;
+    lastSyncMs = hal.clock->millis() - start;
+    return synced;
+  #else
+    return -1;
+  #endif
+}
+
+void DeviceStore::benchmark() {
+  #if FLASH_DB_ENABLED
+    WATCHDOG_STAGE(STAGE_FLASH);
+    Serial.println(F("FLASHDB,bench,flash_us,sd_us,devices"));
+    
+    // Whole table, as at boot
+    uint32_t start = micros();
+    int flashCount = flashDB.loadDevices(benchDevices, MAX_DEVICES);
+    uint32_t flashUs = micros() - start;
+    start = micros();
+    int sdCount = sdManager.loadDevices(benchDevices, MAX_DEVICES);
+    uint32_t sdUs = micros() - start;
+    
+    Serial.print(F("FLASHDB,load,"));
+    Serial.print(flashUs);
+    Serial.print(',');
+    Serial.print(sdUs);
+    Serial.print(',');
+    Serial.print(flashCount);
+    Serial.print('/');
+    Serial.println(sdCount);
+    
+    // One device by name, averaged over the SD devices (the table now
+    // holds those): hash lookup against opening its file
+    if (sdCount <= 0) return;
+    Device device;
+    int flashFound = 0;
+    int sdFound = 0;
+    flashUs = 0;
+    sdUs = 0;
+    for (int i = 0; i < sdCount; i++) {
+      start = micros();
+      flashFound += flashDB.find(benchDevices[i].name, &device);
+      flashUs += micros() - start;
+      start = micros();
+      sdFound += sdManager.loadDevice(benchDevices[i].name, &device);
+      sdUs += micros() - start;
+    }
+    
+    Serial.print(F("FLASHDB,lookup,"));
+    Serial.print(flashUs / sdCount);
+    Serial.print(',');
+    Serial.print(sdUs / sdCount);
+    Serial.print(',');
+    Serial.print(flashFound);
+    Serial.print('/');
+    Serial.println(sdFound);
+  #else
+    Serial.println(F("Flash DB disabled (FLASH_DB_ENABLED 0)"));
+  #endif
+}
+
+void DeviceStore::printStats() {
+  #if FLASH_DB_ENABLED
+    if (!flashDB.isReady()) {
+      Serial.println(F("FLASHDB,ready,0"));
+      return;
+    }
+    FlashDBStats s = flashDB.getStats();
+    Serial.println(F("FLASHDB,ready,1"));
+    Serial.print(F("FLASHDB,devices,"));
+    Serial.println(s.devices);
+    Serial.print(F("FLASHDB,live_bytes,"));
+    Serial.print(s.liveBytes);
+    Serial.print('/');
+    Serial.println(s.capacity);
+    Serial.print(F("FLASHDB,head_sector,"));
+    Serial.println(s.head);
+    Serial.print(F("FLASHDB,sector_erases,"));
+    Serial.print(s.minErases);
+    Serial.print('-');
+    Serial.println(s.maxErases);
+    Serial.print(F("FLASHDB,stores,"));
+    Serial.println(s.stores);
+    Serial.print(F("FLASHDB,unchanged,"));
+    Serial.println(s.unchanged);
+    Serial.print(F("FLASHDB,relocated,"));
+    Serial.println(s.relocated);
+    Serial.print(F("FLASHDB,erases,"));
+    Serial.println(s.erases);
+    Serial.print(F("FLASHDB,last_sync,"));
+    Serial.print(lastSynced);
+    Serial.print(F(" read, "));
+    Serial.print(lastPruned);
+    Serial.print(F(" pruned, "));
+    Serial.print(lastSyncMs);
+    Serial.println(F(" ms"));
+  #else
+    Serial.println(F("Flash DB disabled (FLASH_DB_ENABLED 0)"));
+  #endif
+}
@@ -0,0 +1,52 @@
+/*
+ * VHC Universal Remote - Device Store
+ * Device tables from the flash database, with the SD card as fallback and source
+ */
+
+#ifndef DEVICE_STORE_H
+#define DEVICE_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "ir_device.h"
+
+// Boot loads the devices from flash (flash_db.h): an index lookup and a
+// record decode per device instead of a directory scan and CSV parsing,
+// in the same order as the card lists them.
+// While flash holds none - first boot, new firmware, FLASH_DB_ENABLED 0 -
+// they come from SD as before and are copied to flash. The card stays
+// the source: uploads are stored in both, and when the card's CSV names
+// or sizes differ from the last sync (a hash kept in the key/value
+// store) boot syncs before loading. "flashdb sync" does the same by hand.
+class DeviceStore {
+private:
+  uint32_t lastSyncMs;
+  int lastSynced;      // Devices read from SD by the last sync
+  int lastPruned;      // Devices dropped from flash, gone from SD
+  
+  static void syncDevice(const Device& device);
+  
+public:
+  DeviceStore();
+  void begin();
+  
+  // Count loaded, -1 without a card when flash holds no devices either
+  int loadDevices(Device* devices, int maxDevices);
+  
+  // An uploaded device, once it is saved to SD
+  void store(const Device& device);
+  
+  // Stores every SD device in flash and drops the ones not on SD;
+  // returns the number read from SD, -1 without a card
+  int sync();
+  
+  // Load and single-device lookup times, flash against SD
+  void benchmark();
+  
+  void printStats();
+};
+
+// Global device store instance
+extern DeviceStore deviceStore;
+
+#endif // DEVICE_STORE_H
@@ -0,0 +1,224 @@
+/*
+ * VHC Universal Remote - Device Upload Implementation
+ */
+
+#include "device_upload.h"
+#include "hal.h"
+#include "sd_manager.h"
+#include "device_store.h"
+#include "irdb_parser.h"
+#include "host_link.h"
+#include "scheduler.h"
+#include "loop_watchdog.h"
+#include "remote_protocol.h"
+
+#define UPLOAD_TEMP_FILE  "/upload.tmp"
+#define UPLOAD_WRITE_SIZE 512   // Bytes per background write
+
+// Global device upload instance
+DeviceUpload deviceUpload;
+
+DeviceUpload::DeviceUpload() {
+  active = false;
+  ended = false;
+  fileName[0] = '\0';
+  lineLength = 0;
+  expected = 0;
+  received = 0;
+  startTime = 0;
+  saving = false;
+  lastBytes = 0;
+  lastElapsed = 0;
+  lastUsable = 0;
+  lastSaved = 0;
+  lastResult = PROTO_OK;
+}
+
+uint8_t DeviceUpload::begin(const uint8_t* payload, int length) {
+  if (length < 5 || memchr(payload + 4, '/', length - 4)) return PROTO_BAD_FRAME;
+  
+  // The last file is still going to SD; its UPLOAD_SAVED comes first
+  if (active && ended) return PROTO_BUSY;
+  
+  // A new upload replaces one still receiving
+  abort();
+  
+  int nameLength = min(length - 4, (int)sizeof(fileName) - 1);
+  memcpy(fileName, payload + 4, nameLength);
+  fileName[nameLength] = '\0';
+  
+  char deviceName[32];
+  IRDBParser::deviceNameFromFile(fileName, deviceName);
+  IRDBParser::beginDevice(&device, deviceName);
+  
+  expected = protoGet32(payload);
+  received = 0;
+  lineLength = 0;
+  pending.clear();
+  startTime = hal.clock->millis();
+  active = true;
+  ended = false;
+  
+  // Without a card the device is still usable until the next boot
+  saving = false;
+  if (sdManager.isReady()) {
+    hal.storage->fs().remove(UPLOAD_TEMP_FILE);
+    file = hal.storage->fs().open(UPLOAD_TEMP_FILE, FILE_WRITE);
+    saving = (bool)file;
+  }
+  return PROTO_OK;
+}
+
+uint8_t DeviceUpload::write(const uint8_t* data, int length) {
+  if (!active || ended) return PROTO_NO_UPLOAD;
+  if (saving && UPLOAD_BUFFER_BYTES - 1 - pending.count() < length) {
+    return PROTO_BUSY;
+  }
+  
+  for (int i = 0; i < length; i++) {
+    char c = data[i];
+    if (saving) {
+      pending.push(c);
+    }
+    
+    // Same line rules as SDManager::readLine
+    if (c == '\n' || c == '\r') {
+      parseLine();
+    } else if (lineLength < (int)sizeof(line) - 1) {
+      line[lineLength++] = c;
+    }
+  }
+  received += length;
+  
+  if (saving && !scheduler.isPending(writeTask)) {
+    scheduler.post(writeTask, PRIORITY_BACKGROUND);
+  }
+  return PROTO_OK;
+}
+
+void DeviceUpload::parseLine() {
+  if (lineLength == 0) return;
+  line[lineLength] = '\0';
+  IRDBParser::addLine(line, &device);
+  lineLength = 0;
+}
+
+uint8_t DeviceUpload::finish() {
+  if (!active || ended) return PROTO_NO_UPLOAD;
+  
+  // The last line may have no line end
+  parseLine();
+  
+  uint8_t result = PROTO_OK;
+  if (received != expected) {
+    result = PROTO_BAD_SIZE;
+  } else if (device.commandCount == 0) {
+    result = PROTO_NO_COMMANDS;
+  } else if (menu.addDevice(device) < 0) {
+    result = PROTO_TABLE_FULL;
+  }
+  
+  uint32_t now = hal.clock->millis();
+  lastBytes = received;
+  lastElapsed = now - startTime;
+  lastUsable = (result == PROTO_OK) ? now - startTime : 0;
+  lastSaved = 0;
+  lastResult = result;
+  
+  uint8_t reply[PROTO_UPLOAD_DONE_SIZE];
+  reply[0] = result;
+  reply[1] = device.commandCount;
+  protoPut32(reply + 2, lastBytes);
+  protoPut32(reply + 6, lastElapsed);
+  protoPut32(reply + 10, lastUsable);
+  hostLink.send(PROTO_UPLOAD_DONE, reply, sizeof(reply));
+  
+  if (result != PROTO_OK) {
+    abort();
+  } else if (!saving) {
+    active = false;
+    saved(PROTO_SD_FAILED);
+  } else {
+    // The write task finishes the file
+    ended = true;
+    if (!scheduler.isPending(writeTask)) {
+      scheduler.post(writeTask, PRIORITY_BACKGROUND);
+    }
+  }
+  return result;
+}
+
+void DeviceUpload::writeTask(uint32_t) {
+  WATCHDOG_STAGE(STAGE_SD);
+  DeviceUpload& up = deviceUpload;
+  if (!up.saving) return;
+  
+  // One block per run so input and drawing get their turn in between
+  uint8_t block[UPLOAD_WRITE_SIZE];
+  int n = 0;
+  while (n < UPLOAD_WRITE_SIZE && up.pending.pop(block[n])) {
+    n++;
+  }
+  if (n > 0 && up.file.write(block, n) != (size_t)n) {
+    up.abort();
+    up.saved(PROTO_SD_FAILED);
+    return;
+  }
+  
+  if (!up.pending.isEmpty()) {
+    scheduler.post(writeTask, PRIORITY_BACKGROUND);
+  } else if (up.ended) {
+    up.file.close();
+    up.saving = false;
+    up.active = false;
+    
+    char path[48];
+    snprintf(path, sizeof(path), "/%.*s.csv", (int)sizeof(up.fileName) - 1, up.fileName);
+    hal.storage->fs().remove(path);
+    bool renamed = hal.storage->fs().rename(UPLOAD_TEMP_FILE, path);
+    
+    // Flash follows the card, so only what SD holds goes there too
+    if (renamed) {
+      deviceStore.store(up.device);
+    }
+    up.saved(renamed ? PROTO_OK : PROTO_SD_FAILED);
+  }
+}
+
+void DeviceUpload::saved(uint8_t result) {
+  lastSaved = hal.clock->millis() - startTime;
+  if (result != PROTO_OK) lastResult = result;
+  
+  uint8_t reply[PROTO_UPLOAD_SAVED_SIZE];
+  reply[0] = result;
+  protoPut32(reply + 1, lastSaved);
+  hostLink.send(PROTO_UPLOAD_SAVED, reply, sizeof(reply));
+}
+
+void DeviceUpload::abort() {
+  if (saving) {
+    file.close();
+    hal.storage->fs().remove(UPLOAD_TEMP_FILE);
+    saving = false;
+  }
+  pending.clear();
+  active = false;
+  ended = false;
+}
+
+void DeviceUpload::printStats() {
+  Serial.print(F("UPLOAD,active,"));
+  Serial.println(active ? fileName : "-");
+  Serial.print(F("UPLOAD,bytes,"));
+  Serial.println(lastBytes);
+  Serial.print(F("UPLOAD,elapsed_ms,"));
+  Serial.println(lastElapsed);
+  Serial.print(F("UPLOAD,bytes_per_s,"));
+  Serial.println(lastElapsed ? (uint32_t)((uint64_t)lastBytes * 1000 / lastElapsed) : 0);
+  Serial.print(F("UPLOAD,usable_ms,"));
+  Serial.println(lastUsable);
+  Serial.print(F("UPLOAD,saved_ms,"));
+  Serial.println(lastSaved);
+  Serial.print(F("UPLOAD,result,"));
+  Serial.println(lastResult);
+}
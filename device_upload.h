@@ -0,0 +1,68 @@
+/*
+ * VHC Universal Remote - Device Upload
+ * IRDB CSV files streamed over the host link into the live device table
+ */
+
+#ifndef DEVICE_UPLOAD_H
+#define DEVICE_UPLOAD_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "menu.h"
+#include "ring_buffer.h"
+
+// Chunks (UPLOAD_DATA frames) are parsed line by line as they arrive,
+// into a device of its own; only the current partial line is kept. At
+// UPLOAD_END the device goes into the menu's table (replacing one of the
+// same name) and can be used straight away. The raw bytes also go
+// through a buffer to a background task that writes them to
+// /upload.tmp, renamed to /<name>.csv once complete, so the device is
+// there after a reboot too. A chunk that does not fit the buffer is
+// refused with PROTO_BUSY and sent again by the host, and so is an
+// UPLOAD_BEGIN while the previous file is still being saved.
+class DeviceUpload {
+private:
+  bool active;
+  bool ended;             // UPLOAD_END seen, the file may still be writing
+  char fileName[32];      // Without .csv
+  Device device;
+  char line[256];
+  int lineLength;
+  uint32_t expected;
+  uint32_t received;
+  uint32_t startTime;
+  
+  RingBuffer<uint8_t, UPLOAD_BUFFER_BYTES> pending;  // Bytes not on SD yet
+  File file;
+  bool saving;
+  
+  // Last finished upload
+  uint32_t lastBytes;
+  uint32_t lastElapsed;
+  uint32_t lastUsable;
+  uint32_t lastSaved;
+  uint8_t lastResult;
+  
+public:
+  DeviceUpload();
+  
+  // Frame handlers; return a ProtoResult for the ack
+  uint8_t begin(const uint8_t* payload, int length);
+  uint8_t write(const uint8_t* data, int length);
+  uint8_t finish();
+  bool isReceiving() { return active && !ended; }
+  
+  void printStats();
+  
+private:
+  void parseLine();
+  void abort();
+  void saved(uint8_t result);
+  static void writeTask(uint32_t);
+};
+
+// Global device upload instance
+extern DeviceUpload deviceUpload;
+
+#endif // DEVICE_UPLOAD_H
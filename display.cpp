@@ -4,38 +4,49 @@
 
 #include "display.h"
 #include "ascii_art.h"
+#include "overlay.h"
+#include "profiler.h"
+
+// RAM copy of the panel (150 KB, kept out of the fast DTCM)
+DMAMEM static uint16_t frameBuffer[SCREEN_WIDTH * SCREEN_HEIGHT];
+
+// Placed statically; the hal table is ready before any constructor runs
+static ShadowGFX shadowGFX(hal.panel, frameBuffer);
 
 Display::Display() {
-  tft = new Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
+  panel = hal.panel;
+  shadow = &shadowGFX;
+  gfx = shadow;
+  scrollActive = false;
   currentTextSize = 1;
   currentTextColor = COLOR_TEXT;
 }
 
 void Display::begin() {
-  pinMode(TFT_LED, OUTPUT);
-  setBacklight(255);
-  
-  tft->begin();
-  tft->setRotation(1); // Landscape mode
+  panel->begin();
+  panel->gfx().setRotation(1); // Landscape mode
   clear();
 }
 
 void Display::clear() {
-  tft->fillScreen(COLOR_BACKGROUND);
+  if (scrollActive) {
+    resetScroll();
+  }
+  gfx->fillScreen(COLOR_BACKGROUND);
 }
 
 void Display::drawText(int x, int y, const char* text, uint16_t color, int size) {
-  tft->setCursor(x, y);
-  tft->setTextColor(color);
-  tft->setTextSize(size);
-  tft->print(text);
+  gfx->setCursor(x, y);
+  gfx->setTextColor(color);
+  gfx->setTextSize(size);
+  gfx->print(text);
 }
 
 void Display::drawCenteredText(int y, const char* text, uint16_t color, int size) {
   int16_t x1, y1;
   uint16_t w, h;
-  tft->setTextSize(size);
-  tft->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  gfx->setTextSize(size);
+  gfx->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
   int x = (SCREEN_WIDTH - w) / 2;
   drawText(x, y, text, color, size);
 }
@@ -46,7 +57,7 @@ void Display::drawButton(int x, int y, int w, int h, const char* label, bool pre
   uint16_t borderColor = COLOR_TEXT;
   
   // Clear button area
-  tft->fillRect(x, y, w, h, bgColor);
+  gfx->fillRect(x, y, w, h, bgColor);
   
   // Draw button border with ASCII style
   drawBorder(x, y, w, h, borderColor);
@@ -54,8 +65,8 @@ void Display::drawButton(int x, int y, int w, int h, const char* label, bool pre
   // Center the label in the button
   int16_t x1, y1;
   uint16_t tw, th;
-  tft->setTextSize(1);
-  tft->getTextBounds(label, 0, 0, &x1, &y1, &tw, &th);
+  gfx->setTextSize(1);
+  gfx->getTextBounds(label, 0, 0, &x1, &y1, &tw, &th);
   
   int textX = x + (w - tw) / 2;
   int textY = y + (h - th) / 2;
@@ -65,38 +76,76 @@ void Display::drawButton(int x, int y, int w, int h, const char* label, bool pre
 void Display::drawBorder(int x, int y, int w, int h, uint16_t color) {
   // Draw ASCII-style border
   // Top line
-  tft->drawFastHLine(x + 1, y, w - 2, color);
+  gfx->drawFastHLine(x + 1, y, w - 2, color);
   // Bottom line
-  tft->drawFastHLine(x + 1, y + h - 1, w - 2, color);
+  gfx->drawFastHLine(x + 1, y + h - 1, w - 2, color);
   // Left line
-  tft->drawFastVLine(x, y + 1, h - 2, color);
+  gfx->drawFastVLine(x, y + 1, h - 2, color);
   // Right line
-  tft->drawFastVLine(x + w - 1, y + 1, h - 2, color);
+  gfx->drawFastVLine(x + w - 1, y + 1, h - 2, color);
   
   // Corners
-  tft->drawPixel(x, y, color);                    // Top-left
-  tft->drawPixel(x + w - 1, y, color);           // Top-right
-  tft->drawPixel(x, y + h - 1, color);           // Bottom-left
-  tft->drawPixel(x + w - 1, y + h - 1, color);   // Bottom-right
+  gfx->drawPixel(x, y, color);                    // Top-left
+  gfx->drawPixel(x + w - 1, y, color);           // Top-right
+  gfx->drawPixel(x, y + h - 1, color);           // Bottom-left
+  gfx->drawPixel(x + w - 1, y + h - 1, color);   // Bottom-right
 }
 
 void Display::drawHeader() {
   // VHC branding on left
-  drawText(10, 10, "VHC", COLOR_TEXT, 2);
-  drawText(10, 30, "===", COLOR_TEXT, 1);
-  drawText(10, 40, "UR", COLOR_TEXT, 2);
+  drawLogo(0);
   
   // POWER button on right
   drawPowerButton(false);
 }
 
+void Display::drawLogo(int originX) {
+  drawText(originX + 10, 10, "VHC", COLOR_TEXT, 2);
+  drawText(originX + 10, 30, "===", COLOR_TEXT, 1);
+  drawText(originX + 10, 40, "UR", COLOR_TEXT, 2);
+}
+
 void Display::drawPowerButton(bool pressed) {
-  int x = 240;
-  int y = 10;
-  int w = 70;
-  int h = 30;
-  
-  drawButton(x, y, w, h, "POWER", pressed);
+  drawWidget(POWER_BUTTON, 0, nullptr, pressed);
+}
+
+void Display::drawWidget(const Widget& widget, int originX, const char* label, bool pressed) {
+  int x = originX + widget.x;
+  if (!label) label = widget.label;
+  
+  switch (widget.style) {
+    case WIDGET_BUTTON:
+    case WIDGET_PAGED:
+      drawButton(x, widget.y, widget.w, widget.h, label, pressed);
+      break;
+      
+    case WIDGET_ARROW_UP:
+    case WIDGET_ARROW_DOWN:
+      gfx->fillRect(x, widget.y, widget.w, widget.h, COLOR_BACKGROUND);
+      drawBorder(x, widget.y, widget.w, widget.h, COLOR_TEXT);
+      drawText(x + 10, widget.y + 10, label, COLOR_TEXT, 1);
+      if (widget.style == WIDGET_ARROW_UP) {
+        drawUpArrow(x + widget.w - 35, widget.y + widget.h / 2, COLOR_TEXT);
+      } else {
+        drawDownArrow(x + widget.w - 35, widget.y + widget.h / 2, COLOR_TEXT);
+      }
+      break;
+      
+    case WIDGET_ZONE:
+      break;
+  }
+}
+
+void Display::drawLayout(LayoutId id, bool paged) {
+  // Draws every widget that has its own label; paged buttons only when
+  // there is more than one page
+  const ScreenLayout& layout = getLayout(id);
+  for (int i = 0; i < layout.count; i++) {
+    const Widget& widget = layout.widgets[i];
+    if (!widget.label) continue;
+    if (widget.style == WIDGET_PAGED && !paged) continue;
+    drawWidget(widget);
+  }
 }
 
 void Display::drawSplashScreen() {
@@ -134,95 +183,114 @@ void Display::updateLoadingAnimation(int frame) {
   };
   
   // Clear loading area
-  tft->fillRect(0, 180, SCREEN_WIDTH, 20, COLOR_BACKGROUND);
+  gfx->fillRect(0, 180, SCREEN_WIDTH, 20, COLOR_BACKGROUND);
   
   // Draw current frame
   drawCenteredText(180, loadingFrames[frame % 4], COLOR_TEXT, 1);
 }
 
-void Display::drawMainMenu(const char* devices[], int count, int currentPage, int totalPages) {
+void Display::drawMainMenu(int currentPage, int totalPages) {
+  PROFILE_SCOPE(PROF_DRAW_MAIN);
+  
   clear();
-  drawHeader();
   
-  drawText(10, 70, "Devices:", COLOR_TEXT, 1);
+  // Fixed column on the right; the device strip to its left is filled in
+  // by DeviceList through drawDevicePage()
+  drawLayout(LAYOUT_MAIN, totalPages > 1);
+  drawPageIndicator(currentPage, totalPages);
   
-  // Draw device buttons
-  int buttonY = 90;
-  for (int i = 0; i < count && i < DEVICES_PER_PAGE; i++) {
-    drawButton(20, buttonY + (i * 35), 200, 30, devices[i], false);
-  }
+  setScrollArea(SCREEN_WIDTH - LIST_FIXED_WIDTH);
+}
+
+void Display::drawPageIndicator(int currentPage, int totalPages) {
+  char label[24];
+  snprintf(label, sizeof(label), "%d/%d", currentPage + 1, totalPages > 0 ? totalPages : 1);
   
-  // Navigation buttons
-  if (totalPages > 1) {
-    if (currentPage < totalPages - 1) {
-      drawButton(20, 220, 80, 20, "Next >", false);
-    }
-    drawButton(240, 220, 70, 20, "Back", false);
+  gfx->fillRect(240, 120, 70, 20, COLOR_BACKGROUND);
+  int16_t x1, y1;
+  uint16_t w, h;
+  gfx->setTextSize(1);
+  gfx->getTextBounds(label, 0, 0, &x1, &y1, &w, &h);
+  drawText(240 + (70 - w) / 2, 126, label, COLOR_TEXT, 1);
+}
+
+void Display::drawDevicePage(Adafruit_GFX* target, int originX, const char* devices[], int count) {
+  // Render one page of the device strip into target, shifted by originX.
+  // Used with off-screen bands, so everything here must clip cleanly.
+  Adafruit_GFX* previous = gfx;
+  gfx = target;
+  
+  drawLogo(originX);
+  drawText(originX + 10, 70, "Devices:", COLOR_TEXT, 1);
+  
+  const ScreenLayout& rows = getLayout(LAYOUT_DEVICE_PAGE);
+  for (int i = 0; i < count && i < rows.count; i++) {
+    drawWidget(rows.widgets[i], originX, devices[i]);
   }
+  
+  gfx = previous;
+}
+
+void Display::setScrollArea(int scrollWidth) {
+  // In landscape the ILI9341 scroll lines run along screen X, so the
+  // scroll area is a band of columns starting at the left edge
+  panel->setScrollMargins(0, SCREEN_WIDTH - scrollWidth);
+  panel->scrollTo(0);
+  scrollActive = true;
+}
+
+void Display::setScrollStart(int column) {
+  panel->scrollTo(column);
+}
+
+void Display::resetScroll() {
+  panel->setScrollMargins(0, 0);
+  panel->scrollTo(0);
+  scrollActive = false;
+}
+
+void Display::pushColumns(int column, GFXcanvas16* band, int width) {
+  // Write the first width columns of band straight into panel memory
+  shadow->pushPixels(column, 0, width, band->height(), band->getBuffer(), band->width());
 }
 
 void Display::drawDeviceMenu(const char* deviceName) {
+  PROFILE_SCOPE(PROF_DRAW_DEVICE);
+  
   clear();
-  drawHeader();
+  drawLogo(0);
   
   // Device name
   char title[40];
   snprintf(title, 40, "Device: %s", deviceName);
   drawText(10, 70, title, COLOR_TEXT, 1);
   
-  // Control buttons
-  drawButton(20, 100, 200, 30, "Volume", false);
-  drawButton(20, 140, 200, 30, "Channel", false);
-  drawButton(20, 180, 200, 30, "Input", false);
-  
-  // Back button
-  drawButton(240, 220, 70, 20, "Back", false);
+  // Power, control and back buttons
+  drawLayout(LAYOUT_DEVICE);
 }
 
 void Display::drawVolumeMenu() {
+  PROFILE_SCOPE(PROF_DRAW_VOLUME);
+  
   clear();
-  drawHeader();
+  drawLogo(0);
   
   drawText(10, 70, "Volume Control", COLOR_TEXT, 1);
   
-  // Volume up button with arrow
-  tft->fillRect(20, 100, 200, 30, COLOR_BACKGROUND);
-  drawBorder(20, 100, 200, 30, COLOR_TEXT);
-  drawText(30, 110, "Vol Up", COLOR_TEXT, 1);
-  // Draw up arrow using triangle
-  drawUpArrow(185, 115, COLOR_TEXT);
-  
-  // Volume down button with arrow
-  tft->fillRect(20, 150, 200, 30, COLOR_BACKGROUND);
-  drawBorder(20, 150, 200, 30, COLOR_TEXT);
-  drawText(30, 160, "Vol Down", COLOR_TEXT, 1);
-  // Draw down arrow using triangle
-  drawDownArrow(185, 165, COLOR_TEXT);
-  
-  // Back button
-  drawButton(240, 220, 70, 20, "Back", false);
+  // Power, up/down arrows and back button
+  drawLayout(LAYOUT_VOLUME);
 }
 
 void Display::drawChannelMenu() {
+  PROFILE_SCOPE(PROF_DRAW_CHANNEL);
+  
   clear();
-  drawHeader();
+  drawLogo(0);
   
   drawText(10, 70, "Channel Control", COLOR_TEXT, 1);
   
-  // Channel up button with arrow
-  tft->fillRect(20, 100, 200, 30, COLOR_BACKGROUND);
-  drawBorder(20, 100, 200, 30, COLOR_TEXT);
-  drawText(30, 110, "Ch Up", COLOR_TEXT, 1);
-  drawUpArrow(185, 115, COLOR_TEXT);
-  
-  // Channel down button with arrow
-  tft->fillRect(20, 150, 200, 30, COLOR_BACKGROUND);
-  drawBorder(20, 150, 200, 30, COLOR_TEXT);
-  drawText(30, 160, "Ch Down", COLOR_TEXT, 1);
-  drawDownArrow(185, 165, COLOR_TEXT);
-  
-  // Back button
-  drawButton(240, 220, 70, 20, "Back", false);
+  // Power, up/down arrows and back button
+  drawLayout(LAYOUT_CHANNEL);
 }
 
 void Display::drawErrorScreen(const char* message) {
@@ -234,29 +302,34 @@ void Display::drawErrorScreen(const char* message) {
 }
 
 void Display::setBacklight(uint8_t brightness) {
-  analogWrite(TFT_LED, brightness);
+  panel->setBacklight(brightness);
 }
 
 void Display::showMessage(const char* message, int duration) {
-  // Save current screen area where message will be displayed
-  int msgY = SCREEN_HEIGHT - 30;
-  
+  // Drawn as an overlay: the area underneath is saved and put back when
+  // the message expires (OverlayManager::update)
+  overlays.show(OVERLAY_MESSAGE, message, duration);
+}
+
+void Display::drawMessageBox(int x, int y, int w, int h, const char* message, uint16_t fill, uint16_t textColor) {
   // Draw message box
-  tft->fillRect(10, msgY, SCREEN_WIDTH - 20, 25, COLOR_BUTTON);
-  tft->drawRect(10, msgY, SCREEN_WIDTH - 20, 25, COLOR_TEXT);
-  
-  // Draw message
-  drawCenteredText(msgY + 8, message, COLOR_BUTTON_TEXT, 1);
+  gfx->fillRect(x, y, w, h, fill);
+  gfx->drawRect(x, y, w, h, COLOR_TEXT);
   
-  // Note: Caller is responsible for restoring screen after duration
+  // Draw message centered in the box
+  int16_t x1, y1;
+  uint16_t tw, th;
+  gfx->setTextSize(1);
+  gfx->getTextBounds(message, 0, 0, &x1, &y1, &tw, &th);
+  drawText(x + (w - tw) / 2, y + (h - th) / 2, message, textColor, 1);
 }
 
 void Display::drawUpArrow(int x, int y, uint16_t color) {
   // Draw triangle pointing up
-  tft->fillTriangle(x, y - 5, x - 5, y + 5, x + 5, y + 5, color);
+  gfx->fillTriangle(x, y - 5, x - 5, y + 5, x + 5, y + 5, color);
 }
 
 void Display::drawDownArrow(int x, int y, uint16_t color) {
   // Draw triangle pointing down
-  tft->fillTriangle(x, y + 5, x - 5, y - 5, x + 5, y - 5, color);
-}
\ No newline at end of file
+  gfx->fillTriangle(x, y + 5, x - 5, y - 5, x + 5, y - 5, color);
+}
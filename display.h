@@ -12,10 +12,15 @@
 #include "ascii_art.h"
 #include "ui_icons.h"
 #include "logo_graphics.h"
+#include "shadow_gfx.h"
+#include "layout.h"
 
 class Display {
 private:
-  Adafruit_ILI9341* tft;
+  Panel* panel;
+  ShadowGFX* shadow;     // Panel plus its RAM copy
+  Adafruit_GFX* gfx;     // Current draw target (the shadow or an off-screen band)
+  bool scrollActive;
   int currentTextSize;
   uint16_t currentTextColor;
   
@@ -30,11 +35,16 @@ public:
   void drawButton(int x, int y, int w, int h, const char* label, bool pressed = false);
   void drawBorder(int x, int y, int w, int h, uint16_t color);
   void drawHeader();
+  void drawLogo(int originX);
   void drawPowerButton(bool pressed = false);
+  void drawWidget(const Widget& widget, int originX = 0, const char* label = nullptr, bool pressed = false);
+  void drawLayout(LayoutId id, bool paged = false);
   
   // Screen-specific drawing functions
   void drawSplashScreen();
-  void drawMainMenu(const char* devices[], int deviceCount, int page, int totalPages);
+  void drawMainMenu(int page, int totalPages);
+  void drawPageIndicator(int page, int totalPages);
+  void drawDevicePage(Adafruit_GFX* target, int originX, const char* devices[], int deviceCount);
   void drawDeviceMenu(const char* deviceName);
   void drawVolumeMenu();
   void drawChannelMenu();
@@ -45,12 +55,20 @@ public:
   void drawUpArrow(int x, int y, uint16_t color);
   void drawDownArrow(int x, int y, uint16_t color);
   
+  // Hardware scrolling (main menu device strip)
+  void setScrollArea(int scrollWidth);
+  void setScrollStart(int column);
+  void resetScroll();
+  void pushColumns(int column, GFXcanvas16* band, int width);
+  
   // Utility functions
   void setBacklight(uint8_t brightness);
   void showMessage(const char* message, int duration = 2000);
+  void drawMessageBox(int x, int y, int w, int h, const char* message, uint16_t fill, uint16_t textColor);
   
-  // Get the display object for direct drawing
-  Adafruit_ILI9341* getDisplay() { return tft; }
+  // Get the panel for direct drawing
+  Panel* getPanel() { return panel; }
+  ShadowGFX* getShadow() { return shadow; }
 };
 
 #endif // DISPLAY_H
\ No newline at end of file
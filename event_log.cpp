@@ -0,0 +1,226 @@
+/*
+ * VHC Universal Remote - Event Log Implementation
+ */
+
+#include "event_log.h"
+#include "hal.h"
+#include "scheduler.h"
+#include "loop_watchdog.h"
+
+#define LOG_FILE         "/log/events.bin"
+#define LOG_FLUSH_MS     1000  // SD output is flushed this often
+
+// Global event log instance
+EventLog eventLog;
+
+static const char* const logFormatText[LOG_FORMAT_COUNT] = {
+  LOG_FORMATS(LOG_FORMAT_TEXT)
+};
+
+EventLog::EventLog() {
+  head = 0;
+  tail = 0;
+  dropped = 0;
+  written = 0;
+  output = (LogOutput)EVENT_LOG_OUTPUT;
+  lastFlush = 0;
+  frameLength = 0;
+  frameSeq = 0;
+  for (int i = 0; i < LOG_RING_SIZE; i++) {
+    ring[i].ready = 0;
+  }
+}
+
+void EventLog::begin() {
+  // Which arguments of each format are strings, taken from the record text
+  for (int f = 0; f < LOG_FORMAT_COUNT; f++) {
+    stringArgs[f] = 0;
+    int arg = 0;
+    for (const char* p = logFormatText[f]; *p; p++) {
+      if (*p != '%') continue;
+      p++;
+      if (*p == '%') continue;
+      while (*p && strchr("-+ #0123456789.l", *p)) p++;
+      if (*p == 's') stringArgs[f] |= (1 << arg);
+      arg++;
+    }
+  }
+  
+  if (output != LOG_OUTPUT_OFF && !setOutput(output)) {
+    output = LOG_OUTPUT_OFF;
+  }
+  scheduler.postDelayed(drainTask, PRIORITY_BACKGROUND, LOG_DRAIN_MS);
+}
+
+bool EventLog::setOutput(LogOutput newOutput) {
+  if (output == LOG_OUTPUT_SERIAL) {
+    flushFrame();
+  }
+  if (file) {
+    file.close();
+  }
+  output = newOutput;
+  
+  if (output == LOG_OUTPUT_SD) {
+    hal.storage->fs().mkdir("/log");
+    file = hal.storage->fs().open(LOG_FILE, FILE_WRITE);
+    if (!file) {
+      output = LOG_OUTPUT_OFF;
+      return false;
+    }
+    lastFlush = hal.clock->millis();
+  }
+  
+  // Marks where a capture starts and what was lost before it
+  if (output != LOG_OUTPUT_OFF) {
+    logEvent(LOG_STARTED, dropped);
+  }
+  return true;
+}
+
+void EventLog::drainTask(uint32_t) {
+  eventLog.drain();
+  scheduler.postDelayed(drainTask, PRIORITY_BACKGROUND, LOG_DRAIN_MS);
+}
+
+void EventLog::drain() {
+  if (output == LOG_OUTPUT_OFF) {
+    discard();
+    return;
+  }
+  WATCHDOG_STAGE(output == LOG_OUTPUT_SD ? STAGE_SD : STAGE_LOOP);
+  
+  while (true) {
+    LogRecord& r = ring[tail & (LOG_RING_SIZE - 1)];
+    // Stops at a slot still being written, even if later ones are ready
+    if (!__atomic_load_n(&r.ready, __ATOMIC_ACQUIRE)) break;
+    
+    // Never block on a slow host; the rest goes out next time. Room
+    // for a whole frame, in case this record completes one
+    if (output == LOG_OUTPUT_SERIAL && Serial.availableForWrite() < PROTO_MAX_FRAME) break;
+    
+    emit(r);
+    r.ready = 0;
+    __atomic_store_n(&tail, tail + 1, __ATOMIC_RELEASE);
+    written++;
+  }
+  
+  // A part-filled frame goes out now if it can, else with the next drain
+  if (output == LOG_OUTPUT_SERIAL && Serial.availableForWrite() >= PROTO_MAX_FRAME) {
+    flushFrame();
+  }
+  
+  if (output == LOG_OUTPUT_SD && hal.clock->millis() - lastFlush >= LOG_FLUSH_MS) {
+    file.flush();
+    lastFlush = hal.clock->millis();
+  }
+}
+
+void EventLog::discard() {
+  while (true) {
+    LogRecord& r = ring[tail & (LOG_RING_SIZE - 1)];
+    if (!__atomic_load_n(&r.ready, __ATOMIC_ACQUIRE)) break;
+    r.ready = 0;
+    __atomic_store_n(&tail, tail + 1, __ATOMIC_RELEASE);
+  }
+}
+
+static int putU32(uint8_t* out, uint32_t value) {
+  out[0] = value;
+  out[1] = value >> 8;
+  out[2] = value >> 16;
+  out[3] = value >> 24;
+  return 4;
+}
+
+void EventLog::emit(const LogRecord& r) {
+  uint8_t buf[8 + LOG_MAX_ARGS * 4 + LOG_TEXT_BYTES];
+  int n = 0;
+  buf[n++] = LOG_SYNC;
+  buf[n++] = r.format;
+  buf[n++] = r.format >> 8;
+  buf[n++] = r.argCount;
+  n += putU32(buf + n, r.time);
+  
+  uint32_t strings = (r.format < LOG_FORMAT_COUNT) ? stringArgs[r.format] : 0;
+  for (int i = 0; i < r.argCount; i++) {
+    if (strings & (1 << i)) {
+      int len = strnlen(r.text, LOG_TEXT_BYTES - 1);
+      buf[n++] = len;
+      memcpy(buf + n, r.text, len);
+      n += len;
+    } else {
+      n += putU32(buf + n, r.args[i]);
+    }
+  }
+  
+  if (output == LOG_OUTPUT_SERIAL) {
+    if (frameLength + n > PROTO_MAX_PAYLOAD) {
+      flushFrame();
+    }
+    memcpy(framePayload + frameLength, buf, n);
+    frameLength += n;
+  } else {
+    file.write(buf, n);
+  }
+}
+
+void EventLog::flushFrame() {
+  if (frameLength == 0) return;
+  
+  // Host tools skip it whole, like any frame not meant for them; the
+  // sequence numbers show a decoder which frames went missing
+  uint8_t frame[PROTO_MAX_FRAME];
+  int n = protoFrame(frame, frameSeq++, PROTO_LOG, framePayload, frameLength);
+  Serial.write(frame, n);
+  frameLength = 0;
+}
+
+void EventLog::printStats() {
+  static const char* const outputNames[] = {"off", "serial", "sd"};
+  Serial.print(F("LOG,output,"));
+  Serial.println(outputNames[output]);
+  Serial.print(F("LOG,written,"));
+  Serial.println(written);
+  Serial.print(F("LOG,queued,"));
+  Serial.println(head - tail);
+  Serial.print(F("LOG,dropped,"));
+  Serial.println(dropped);
+}
+
+void EventLog::benchmark() {
+  // The same IR send line both ways: a record in the ring, and the
+  // Serial.print chain sendCommand used before. Batches stay below the
+  // ring size and are discarded between runs, so no call takes the drop
+  // path and nothing reaches the output.
+  const int batch = LOG_RING_SIZE / 2;
+  const int rounds = 32;
+  const char* name = "bench";
+  uint32_t logUs = 0;
+  
+  for (int r = 0; r < rounds; r++) {
+    discard();
+    uint32_t start = micros();
+    for (int i = 0; i < batch; i++) {
+      logEvent(LOG_IR_SEND, name, 0x20DF10EF + i, 0, 32);
+    }
+    logUs += micros() - start;
+  }
+  discard();
+  
+  uint32_t start = micros();
+  for (int i = 0; i < batch; i++) {
+    Serial.print(F("Sending IR: "));
+    Serial.print(name);
+    Serial.print(F(" Code: 0x"));
+    Serial.print(0x20DF10EF + i, HEX);
+    Serial.print(F(" Protocol: "));
+    Serial.println(F("NEC"));
+  }
+  uint32_t printUs = micros() - start;
+  
+  Serial.print(F("LOG,log_call_ns,"));
+  Serial.println((uint32_t)((uint64_t)logUs * 1000 / (batch * rounds)));
+  Serial.print(F("LOG,serial_print_ns,"));
+  Serial.println((uint32_t)((uint64_t)printUs * 1000 / batch));
+}
@@ -0,0 +1,146 @@
+/*
+ * VHC Universal Remote - Event Log
+ * Binary log records in a lock-free ring, formatted off-device
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "log_formats.h"
+#include "remote_protocol.h"
+
+enum LogOutput {
+  LOG_OUTPUT_OFF,     // Records are drained and discarded
+  LOG_OUTPUT_SERIAL,  // Binary stream on Serial (decode with tools/log_decode)
+  LOG_OUTPUT_SD       // Appended to /log/events.bin
+};
+
+struct LogRecord {
+  uint32_t time;                // micros()
+  uint16_t format;              // LogFormat
+  uint8_t argCount;
+  volatile uint8_t ready;       // Set last by the writer
+  uint32_t args[LOG_MAX_ARGS];
+  char text[LOG_TEXT_BYTES];    // The %s argument, copied by the writer
+};
+
+// write() is safe from the loop and from interrupt handlers at the same
+// time: a writer claims a slot by compare-and-swap on the head, fills it
+// and marks it ready, so a handler that interrupts another writer just
+// takes the next slot. Nothing is formatted or printed on the caller's
+// path, except copying a %s argument, so the caller's buffer may change
+// before the drain. When the ring is full the record is dropped and
+// counted. A background task drains ready records in order to the
+// selected output; on Serial they go out in PROTO_LOG frames.
+class EventLog {
+private:
+  LogRecord ring[LOG_RING_SIZE];
+  volatile uint32_t head;       // Next slot to claim (writers)
+  volatile uint32_t tail;       // Next slot to drain (drain task only)
+  volatile uint32_t dropped;
+  uint32_t written;
+  LogOutput output;
+  File file;
+  uint32_t lastFlush;
+  uint32_t stringArgs[LOG_FORMAT_COUNT];  // Bit n set: argument n is %s
+  uint8_t framePayload[PROTO_MAX_PAYLOAD];  // Serial records not yet sent
+  int frameLength;
+  uint8_t frameSeq;
+  
+public:
+  EventLog();
+  void begin();
+  
+  void write(LogFormat format, uint8_t argCount, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3,
+             const char* text) {
+    uint32_t index = __atomic_load_n(&head, __ATOMIC_RELAXED);
+    do {
+      if (index - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= LOG_RING_SIZE) {
+        __atomic_fetch_add(&dropped, 1, __ATOMIC_RELAXED);
+        return;
+      }
+    } while (!__atomic_compare_exchange_n(&head, &index, index + 1, true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+    
+    LogRecord& r = ring[index & (LOG_RING_SIZE - 1)];
+    r.time = micros();
+    r.format = format;
+    r.argCount = argCount;
+    r.args[0] = a0;
+    r.args[1] = a1;
+    r.args[2] = a2;
+    r.args[3] = a3;
+    int length = 0;
+    if (text) {
+      while (length < LOG_TEXT_BYTES - 1 && text[length]) {
+        r.text[length] = text[length];
+        length++;
+      }
+    }
+    r.text[length] = '\0';
+    __atomic_store_n(&r.ready, 1, __ATOMIC_RELEASE);
+  }
+  
+  bool setOutput(LogOutput output);
+  LogOutput getOutput() { return output; }
+  
+  // Drain side (main loop only)
+  void drain();
+  void discard();
+  
+  void printStats();
+  void benchmark();  // Per-call cost of a log record against a Serial print chain
+  
+private:
+  static void drainTask(uint32_t);
+  void emit(const LogRecord& r);
+  void flushFrame();
+};
+
+// Global event log instance
+extern EventLog eventLog;
+
+// Numbers go in the arguments; a string (one per format at most) goes
+// in the record's text instead of as a pointer
+template <typename T> static inline uint32_t logArg(T value) { return (uint32_t)value; }
+static inline uint32_t logArg(const char*) { return 0; }
+static inline uint32_t logArg(char*) { return 0; }
+template <typename T> static inline const char* logText(T) { return nullptr; }
+static inline const char* logText(const char* text) { return text; }
+static inline const char* logText(char* text) { return text; }
+
+static inline const char* logText(const char* a, const char* b, const char* c = nullptr, const char* d = nullptr) {
+  return a ? a : b ? b : c ? c : d;
+}
+
+static inline void logEvent(LogFormat f) {
+  eventLog.write(f, 0, 0, 0, 0, 0, nullptr);
+}
+template <typename A>
+static inline void logEvent(LogFormat f, A a) {
+  eventLog.write(f, 1, logArg(a), 0, 0, 0, logText(a));
+}
+template <typename A, typename B>
+static inline void logEvent(LogFormat f, A a, B b) {
+  eventLog.write(f, 2, logArg(a), logArg(b), 0, 0, logText(logText(a), logText(b)));
+}
+template <typename A, typename B, typename C>
+static inline void logEvent(LogFormat f, A a, B b, C c) {
+  eventLog.write(f, 3, logArg(a), logArg(b), logArg(c), 0, logText(logText(a), logText(b), logText(c)));
+}
+template <typename A, typename B, typename C, typename D>
+static inline void logEvent(LogFormat f, A a, B b, C c, D d) {
+  eventLog.write(f, 4, logArg(a), logArg(b), logArg(c), logArg(d),
+                 logText(logText(a), logText(b), logText(c), logText(d)));
+}
+
+#if EVENT_LOG_ENABLED
+  #define LOG_EVENT(...) logEvent(__VA_ARGS__)
+#else
+  #define LOG_EVENT(...) do {} while (0)
+#endif
+
+#endif // EVENT_LOG_H
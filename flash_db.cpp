@@ -0,0 +1,563 @@
+/*
+ * VHC Universal Remote - Flash Device Database Implementation
+ */
+
+#include "flash_db.h"
+#include <stddef.h>
+#include <string.h>
+#include "irdb_parser.h"
+
+// Global flash database instance
+FlashDB flashDB;
+
+#define FLASH_SECTOR_MAGIC 0x31424456UL  // "VDB1"
+#define FLASH_RECORD_MAGIC 0xD85A
+#define FLASH_UNSET        0xFFFFFFFFUL
+#define FLASH_RECORD_MAX   192           // Largest payload (see encode)
+
+enum FlashRecordType {
+  FLASH_DEVICE = 1,
+  FLASH_DELETE = 2
+};
+
+// Written after an erase; openSequence is programmed when the sector
+// becomes the head, which orders the sectors round the ring
+struct FlashSectorHeader {
+  uint32_t magic;
+  uint32_t eraseCount;
+  uint32_t openSequence;
+  uint32_t openCheck;   // ~openSequence, so a torn one is not trusted
+};
+
+struct FlashRecordHeader {
+  uint16_t magic;
+  uint16_t length;      // Payload bytes
+  uint32_t sequence;
+  uint32_t hash;        // hashName() of the device name
+  uint8_t type;
+  uint8_t position;     // IndexEntry::position, FLASH_DB_UNPLACED if none
+  uint16_t crc;         // Over the header up to here, then the payload
+};
+
+static uint32_t align4(uint32_t n) {
+  return (n + 3) & ~3UL;
+}
+
+static bool isBlank(const uint8_t* p, uint32_t length) {
+  for (uint32_t i = 0; i < length; i++) {
+    if (p[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+static bool isOpen(const FlashSectorHeader* header) {
+  return header->magic == FLASH_SECTOR_MAGIC && header->openSequence != FLASH_UNSET &&
+         header->openCheck == ~header->openSequence;
+}
+
+static uint16_t crc16(uint16_t crc, const uint8_t* data, uint32_t length) {
+  // CRC-16/CCITT
+  for (uint32_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint16_t recordCRC(const FlashRecordHeader* header, const uint8_t* payload) {
+  uint16_t crc = crc16(0xFFFF, (const uint8_t*)header, offsetof(FlashRecordHeader, crc));
+  return crc16(crc, payload, header->length);
+}
+
+FlashDB::FlashDB() {
+  flash = nullptr;
+  base = nullptr;
+  sectorBytes = 0;
+  sectors = 0;
+  count = 0;
+  head = 0;
+  writePos = 0;
+  sequence = 0;
+  maxErases = 0;
+  memset(&stats, 0, sizeof(stats));
+  ready = false;
+}
+
+bool FlashDB::begin(FlashRegion* region) {
+  flash = region;
+  ready = false;
+  if (!flash || !flash->begin()) return false;
+  
+  // Two sectors are the reserve the ring needs to reclaim one
+  base = flash->data();
+  sectorBytes = flash->sectorSize();
+  sectors = flash->sectorCount();
+  if (sectors < 4) return false;
+  
+  scan();
+  ready = true;
+  return true;
+}
+
+void FlashDB::scan() {
+  count = 0;
+  sequence = 0;
+  maxErases = 0;
+  memset(&stats, 0, sizeof(stats));
+  
+  // The head is the sector opened last
+  bool found = false;
+  uint32_t headSequence = 0;
+  for (uint32_t s = 0; s < sectors; s++) {
+    const FlashSectorHeader* header = (const FlashSectorHeader*)(base + s * sectorBytes);
+    if (header->magic != FLASH_SECTOR_MAGIC) continue;
+    if (header->eraseCount != FLASH_UNSET && header->eraseCount > maxErases) {
+      maxErases = header->eraseCount;
+    }
+    if (!isOpen(header)) continue;
+    
+    if (!found || header->openSequence > headSequence) {
+      headSequence = header->openSequence;
+      head = s;
+      found = true;
+    }
+    if (header->openSequence > sequence) sequence = header->openSequence;
+    indexSector(s);
+  }
+  
+  // Delete records have done their job once the index is built
+  for (int i = count - 1; i >= 0; i--) {
+    if (index[i].deleted) removeEntry(i);
+  }
+  for (int i = 0; i < count; i++) {
+    stats.liveBytes += recordSize(index[i].offset);
+  }
+  
+  if (!found) {
+    // Empty region: the first store opens sector 0
+    head = sectors - 1;
+    writePos = sectorBytes;
+    return;
+  }
+  
+  // Appends go after the last programmed byte, torn records included
+  const uint8_t* sector = base + head * sectorBytes;
+  writePos = sectorBytes;
+  while (writePos > sizeof(FlashSectorHeader) && sector[writePos - 1] == 0xFF) {
+    writePos--;
+  }
+  writePos = align4(writePos);
+  
+  // Cut off while reclaiming: finish moving the oldest sector out
+  uint32_t next = (head + 1) % sectors;
+  const FlashSectorHeader* nextHeader = (const FlashSectorHeader*)(base + next * sectorBytes);
+  if (isOpen(nextHeader)) {
+    reclaim(next);
+  }
+}
+
+bool FlashDB::validRecord(uint32_t offset) {
+  const FlashRecordHeader* header = (const FlashRecordHeader*)(base + offset);
+  if (header->magic != FLASH_RECORD_MAGIC) return false;
+  uint32_t size = align4(sizeof(FlashRecordHeader) + header->length);
+  if (offset % sectorBytes + size > sectorBytes) return false;
+  return header->crc == recordCRC(header, (const uint8_t*)(header + 1));
+}
+
+uint32_t FlashDB::nextRecord(uint32_t sector, uint32_t pos) {
+  // Steps over blank space and records torn by a power cut; records
+  // written after a torn one are still found
+  while (pos + sizeof(FlashRecordHeader) <= sectorBytes) {
+    if (validRecord(sector * sectorBytes + pos)) return pos;
+    pos += 4;
+  }
+  return sectorBytes;
+}
+
+void FlashDB::indexSector(uint32_t sector) {
+  uint32_t pos = nextRecord(sector, sizeof(FlashSectorHeader));
+  while (pos < sectorBytes) {
+    const FlashRecordHeader* header = (const FlashRecordHeader*)(base + sector * sectorBytes + pos);
+    indexRecord(header->hash, sector * sectorBytes + pos, header->sequence, header->position, header->type == FLASH_DELETE);
+    if (header->sequence > sequence) sequence = header->sequence;
+    pos = nextRecord(sector, pos + recordSize(sector * sectorBytes + pos));
+  }
+}
+
+int FlashDB::findEntry(uint32_t hash) {
+  // Binary search, the index is sorted by hash
+  int low = 0;
+  int high = count - 1;
+  while (low <= high) {
+    int mid = (low + high) / 2;
+    if (index[mid].hash == hash) return mid;
+    if (index[mid].hash < hash) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return -1;
+}
+
+bool FlashDB::indexRecord(uint32_t hash, uint32_t offset, uint32_t recordSequence, uint8_t listPosition, bool deleted) {
+  // The newest record for a name wins, whatever order they are found in
+  int position = findEntry(hash);
+  if (position >= 0) {
+    if (recordSequence > index[position].sequence) {
+      index[position].offset = offset;
+      index[position].sequence = recordSequence;
+      index[position].position = listPosition;
+      index[position].deleted = deleted;
+    }
+    return true;
+  }
+  if (count >= FLASH_DB_MAX_DEVICES) return false;
+  
+  position = count;
+  while (position > 0 && index[position - 1].hash > hash) {
+    index[position] = index[position - 1];
+    position--;
+  }
+  index[position].hash = hash;
+  index[position].offset = offset;
+  index[position].sequence = recordSequence;
+  index[position].position = listPosition;
+  index[position].deleted = deleted;
+  count++;
+  return true;
+}
+
+void FlashDB::removeEntry(int position) {
+  memmove(&index[position], &index[position + 1], (count - position - 1) * sizeof(IndexEntry));
+  count--;
+}
+
+uint32_t FlashDB::recordSize(uint32_t offset) {
+  const FlashRecordHeader* header = (const FlashRecordHeader*)(base + offset);
+  return align4(sizeof(FlashRecordHeader) + header->length);
+}
+
+uint8_t FlashDB::nextPosition() {
+  // After every placed device, as a file added to the card lists last
+  int next = 0;
+  for (int i = 0; i < count; i++) {
+    if (index[i].position != FLASH_DB_UNPLACED && index[i].position >= next) {
+      next = index[i].position + 1;
+    }
+  }
+  return next < FLASH_DB_UNPLACED ? next : FLASH_DB_UNPLACED - 1;
+}
+
+bool FlashDB::appendHere(uint8_t type, uint32_t hash, uint8_t position, const uint8_t* payload, uint32_t length, uint32_t& offset) {
+  uint32_t size = align4(sizeof(FlashRecordHeader) + length);
+  if (writePos + size > sectorBytes) return false;
+  offset = head * sectorBytes + writePos;
+  
+  FlashRecordHeader header;
+  header.magic = FLASH_RECORD_MAGIC;
+  header.length = length;
+  header.sequence = ++sequence;
+  header.hash = hash;
+  header.type = type;
+  header.position = position;
+  header.crc = recordCRC(&header, payload);
+  
+  // Payload first: until the header lands the slot still reads as blank
+  if (length > 0 && !flash->program(offset + sizeof(header), payload, length)) return false;
+  if (!flash->program(offset, &header, sizeof(header))) return false;
+  writePos += size;
+  return true;
+}
+
+bool FlashDB::append(uint8_t type, uint32_t hash, uint8_t position, const uint8_t* payload, uint32_t length) {
+  // Each advance reclaims a sector, so this ends once one had dead records
+  for (uint32_t tries = 0; tries < sectors; tries++) {
+    uint32_t offset;
+    if (appendHere(type, hash, position, payload, length, offset)) {
+      if (!indexRecord(hash, offset, sequence, position, type == FLASH_DELETE)) return false;
+      if (type == FLASH_DELETE) {
+        removeEntry(findEntry(hash));
+      }
+      stats.stores++;
+      return true;
+    }
+    if (!advance()) return false;
+  }
+  return false;
+}
+
+bool FlashDB::advance() {
+  // The sector after the head is kept free of live records
+  uint32_t next = (head + 1) % sectors;
+  for (int i = 0; i < count; i++) {
+    if (index[i].offset / sectorBytes == next) return false;
+  }
+  if (!openSector(next)) return false;
+  head = next;
+  writePos = sizeof(FlashSectorHeader);
+  
+  // Make the next one free again: it is the oldest in the ring
+  uint32_t oldest = (head + 1) % sectors;
+  const FlashSectorHeader* header = (const FlashSectorHeader*)(base + oldest * sectorBytes);
+  if (isOpen(header)) {
+    return reclaim(oldest);
+  }
+  return true;
+}
+
+bool FlashDB::openSector(uint32_t sector) {
+  const uint8_t* start = base + sector * sectorBytes;
+  const FlashSectorHeader* header = (const FlashSectorHeader*)start;
+  bool erased = header->magic == FLASH_SECTOR_MAGIC && header->openSequence == FLASH_UNSET &&
+                header->openCheck == FLASH_UNSET &&
+                isBlank(start + sizeof(FlashSectorHeader), sectorBytes - sizeof(FlashSectorHeader));
+  if (!erased) {
+    // Unknown counts (never formatted, or cut off mid-erase) continue from the highest
+    uint32_t erases = (header->magic == FLASH_SECTOR_MAGIC && header->eraseCount != FLASH_UNSET) ?
+                      header->eraseCount : maxErases;
+    if (!eraseSector(sector, erases + 1)) return false;
+  }
+  
+  uint32_t openSequence = ++sequence;
+  uint32_t open[2] = {openSequence, ~openSequence};
+  return flash->program(sector * sectorBytes + offsetof(FlashSectorHeader, openSequence), open, sizeof(open));
+}
+
+bool FlashDB::reclaim(uint32_t sector) {
+  // Copy the live records to the head, then erase
+  const uint8_t* start = base + sector * sectorBytes;
+  const FlashSectorHeader* header = (const FlashSectorHeader*)start;
+  uint32_t erases = header->eraseCount;
+  uint32_t pos = nextRecord(sector, sizeof(FlashSectorHeader));
+  while (pos < sectorBytes) {
+    const FlashRecordHeader* record = (const FlashRecordHeader*)(start + pos);
+    uint32_t offset = sector * sectorBytes + pos;
+    int position = findEntry(record->hash);
+    if (record->type == FLASH_DEVICE && position >= 0 && index[position].offset == offset) {
+      uint32_t moved;
+      if (!appendHere(FLASH_DEVICE, record->hash, record->position, start + pos + sizeof(FlashRecordHeader),
+                      record->length, moved)) {
+        return false;
+      }
+      index[position].offset = moved;
+      index[position].sequence = sequence;
+      stats.relocated++;
+    }
+    pos = nextRecord(sector, pos + recordSize(offset));
+  }
+  
+  // Delete records are not copied: every older record for their name
+  // is in this sector or in ones already erased
+  return eraseSector(sector, (erases == FLASH_UNSET ? maxErases : erases) + 1);
+}
+
+bool FlashDB::eraseSector(uint32_t sector, uint32_t eraseCount) {
+  // Void the header first: an erase cut short leaves any bits behind,
+  // and old records must not come back as valid ones
+  const FlashSectorHeader* current = (const FlashSectorHeader*)(base + sector * sectorBytes);
+  if (current->magic == FLASH_SECTOR_MAGIC) {
+    uint32_t voided = 0;
+    if (!flash->program(sector * sectorBytes, &voided, sizeof(voided))) return false;
+  }
+  if (!flash->erase(sector)) return false;
+  stats.erases++;
+  if (eraseCount > maxErases) maxErases = eraseCount;
+  
+  // The magic goes last, after the count it vouches for; openSequence
+  // and openCheck stay 0xFF until the sector is opened
+  uint32_t magic = FLASH_SECTOR_MAGIC;
+  uint32_t at = sector * sectorBytes;
+  return flash->program(at + offsetof(FlashSectorHeader, eraseCount), &eraseCount, sizeof(eraseCount)) &&
+         flash->program(at, &magic, sizeof(magic));
+}
+
+int FlashDB::encode(const Device& device, uint8_t* payload) {
+  // name length, name, command count, then per command: function id,
+  // code (little endian), protocol length, protocol. Command names are
+  // the standard function names, so the id stands in for them.
+  int n = 0;
+  int nameLength = strnlen(device.name, sizeof(device.name) - 1);
+  payload[n++] = nameLength;
+  memcpy(payload + n, device.name, nameLength);
+  n += nameLength;
+  
+  int countAt = n++;
+  int commands = 0;
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    int slot = device.slots[f];
+    if (slot < 0 || slot >= device.commandCount) continue;
+    const IRCommand& cmd = device.commands[slot];
+    payload[n++] = f;
+    uint32_t code = cmd.code;
+    for (int b = 0; b < 4; b++) {
+      payload[n++] = code >> (8 * b);
+    }
+    int protocolLength = strnlen(cmd.protocol, sizeof(cmd.protocol) - 1);
+    payload[n++] = protocolLength;
+    memcpy(payload + n, cmd.protocol, protocolLength);
+    n += protocolLength;
+    commands++;
+  }
+  payload[countAt] = commands;
+  return n;
+}
+
+bool FlashDB::decode(const uint8_t* payload, uint32_t length, Device* device) {
+  uint32_t n = 0;
+  char name[32];
+  uint8_t nameLength = payload[n++];
+  if (nameLength >= sizeof(name) || n + nameLength + 1 > length) return false;
+  memcpy(name, payload + n, nameLength);
+  name[nameLength] = '\0';
+  n += nameLength;
+  IRDBParser::beginDevice(device, name);
+  
+  // Stored in function order; commands go back in that order
+  uint8_t commands = payload[n++];
+  for (int c = 0; c < commands && c < MAX_COMMANDS; c++) {
+    if (n + 6 > length) return false;
+    uint8_t function = payload[n++];
+    uint32_t code = 0;
+    for (int b = 0; b < 4; b++) {
+      code |= (uint32_t)payload[n++] << (8 * b);
+    }
+    uint8_t protocolLength = payload[n++];
+    if (function >= IR_FN_COUNT || protocolLength > 7 || n + protocolLength > length) return false;
+    
+    IRCommand* cmd = &device->commands[device->commandCount];
+    strncpy(cmd->command, getFunctionName((IRFunction)function), sizeof(cmd->command) - 1);
+    cmd->command[sizeof(cmd->command) - 1] = '\0';
+    cmd->code = code;
+    memcpy(cmd->protocol, payload + n, protocolLength);
+    cmd->protocol[protocolLength] = '\0';
+    n += protocolLength;
+    device->slots[function] = device->commandCount++;
+  }
+  return true;
+}
+
+bool FlashDB::find(const char* name, Device* device) {
+  if (!ready) return false;
+  int position = findEntry(hashName(name));
+  if (position < 0) return false;
+  
+  const FlashRecordHeader* header = (const FlashRecordHeader*)(base + index[position].offset);
+  if (!decode((const uint8_t*)(header + 1), header->length, device)) return false;
+  
+  // Another name with the same hash is not a match
+  return strcmp(device->name, name) == 0;
+}
+
+int FlashDB::loadDevices(Device* devices, int maxDevices) {
+  if (!ready) return 0;
+  
+  // Index positions in card order; the insertion sort keeps hash order
+  // among equal (unplaced) ones
+  uint8_t order[FLASH_DB_MAX_DEVICES];
+  for (int i = 0; i < count; i++) {
+    int j = i;
+    while (j > 0 && index[order[j - 1]].position > index[i].position) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = i;
+  }
+  
+  int loaded = 0;
+  for (int i = 0; i < count && loaded < maxDevices; i++) {
+    const FlashRecordHeader* header = (const FlashRecordHeader*)(base + index[order[i]].offset);
+    if (decode((const uint8_t*)(header + 1), header->length, &devices[loaded])) {
+      loaded++;
+    }
+  }
+  return loaded;
+}
+
+bool FlashDB::store(const Device& device, int listPosition) {
+  if (!ready) return false;
+  
+  uint8_t payload[FLASH_RECORD_MAX];
+  int length = encode(device, payload);
+  uint32_t hash = hashName(device.name);
+  uint32_t replaced = 0;
+  int position = findEntry(hash);
+  uint8_t place;
+  if (listPosition >= 0) {
+    place = listPosition < FLASH_DB_UNPLACED ? listPosition : FLASH_DB_UNPLACED - 1;
+  } else {
+    place = position >= 0 ? index[position].position : nextPosition();
+  }
+  
+  if (position >= 0) {
+    // Re-syncing unchanged devices costs no flash writes
+    const FlashRecordHeader* header = (const FlashRecordHeader*)(base + index[position].offset);
+    const uint8_t* stored = (const uint8_t*)(header + 1);
+    if (header->length == length && header->position == place && memcmp(stored, payload, length) == 0) {
+      stats.unchanged++;
+      return true;
+    }
+    
+    // Same hash, different name: refuse rather than replace it
+    if (stored[0] != payload[0] || memcmp(stored + 1, payload + 1, payload[0]) != 0) return false;
+    replaced = recordSize(index[position].offset);
+  } else if (count >= FLASH_DB_MAX_DEVICES) {
+    return false;
+  }
+  
+  uint32_t size = align4(sizeof(FlashRecordHeader) + length);
+  if (stats.liveBytes - replaced + size > getStats().capacity) return false;
+  if (!append(FLASH_DEVICE, hash, place, payload, length)) return false;
+  stats.liveBytes += size - replaced;
+  return true;
+}
+
+bool FlashDB::remove(const char* name) {
+  if (!ready) return false;
+  uint32_t hash = hashName(name);
+  int position = findEntry(hash);
+  if (position < 0) return false;
+  
+  uint32_t size = recordSize(index[position].offset);
+  if (!append(FLASH_DELETE, hash, FLASH_DB_UNPLACED, nullptr, 0)) return false;
+  stats.liveBytes -= size;
+  return true;
+}
+
+int FlashDB::prune(const uint32_t* keep, int keepCount) {
+  if (!ready) return 0;
+  int removed = 0;
+  for (int i = count - 1; i >= 0; i--) {
+    bool kept = false;
+    for (int k = 0; k < keepCount && !kept; k++) {
+      kept = (keep[k] == index[i].hash);
+    }
+    if (kept) continue;
+    
+    uint32_t size = recordSize(index[i].offset);
+    if (!append(FLASH_DELETE, index[i].hash, FLASH_DB_UNPLACED, nullptr, 0)) break;
+    stats.liveBytes -= size;
+    removed++;
+  }
+  return removed;
+}
+
+FlashDBStats FlashDB::getStats() {
+  FlashDBStats s = stats;
+  s.devices = count;
+  s.head = head;
+  s.capacity = sectors > 2 ? (sectors - 2) * (sectorBytes - sizeof(FlashSectorHeader)) : 0;
+  s.minErases = FLASH_UNSET;
+  s.maxErases = 0;
+  for (uint32_t i = 0; i < sectors; i++) {
+    const FlashSectorHeader* header = (const FlashSectorHeader*)(base + i * sectorBytes);
+    uint32_t erases = (header->magic == FLASH_SECTOR_MAGIC) ? header->eraseCount : 0;
+    if (erases == FLASH_UNSET) erases = 0;
+    if (erases < s.minErases) s.minErases = erases;
+    if (erases > s.maxErases) s.maxErases = erases;
+  }
+  if (s.minErases == FLASH_UNSET) s.minErases = 0;
+  return s;
+}
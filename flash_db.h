@@ -0,0 +1,113 @@
+/*
+ * VHC Universal Remote - Flash Device Database
+ * Indexed device records in a flash region, shared by the firmware and host tools
+ */
+
+#ifndef FLASH_DB_H
+#define FLASH_DB_H
+
+#include <stdint.h>
+#include "config.h"
+#include "ir_device.h"
+#include "flash_region.h"
+
+#define FLASH_DB_UNPLACED 0xFF  // Record position: not from a card listing
+
+struct FlashDBStats {
+  int devices;
+  uint32_t liveBytes;     // Records the index points at
+  uint32_t capacity;      // Live bytes allowed (two sectors stay in reserve)
+  uint32_t head;          // Sector being appended to
+  uint32_t minErases;     // Erase counts over the region's sectors
+  uint32_t maxErases;
+  uint32_t stores;        // Records written since begin()
+  uint32_t unchanged;     // Stores skipped, the record was already current
+  uint32_t relocated;     // Live records copied out of a sector before its erase
+  uint32_t erases;
+};
+
+// The region is a ring of sectors used as a log. Every store appends a
+// compact record (name, then function/code/protocol per command) at the
+// head; a newer record for the same name supersedes the old one and a
+// delete record removes it. Opening the next sector reclaims the oldest
+// one: its live records move to the head, then it is erased. Every
+// sector is erased once per trip round the ring, so wear spreads evenly.
+//
+// A RAM index (name hash to record, sorted by hash) is rebuilt by
+// scanning the log in begin(), and lookups read the record in place.
+// Each record also keeps the device's place in the SD card listing it
+// was stored from, so the table loads in the card's order, not the
+// index's.
+// Records carry a CRC and are written payload first, header last, so a
+// power cut at any point leaves either the old or the new record.
+class FlashDB {
+private:
+  struct IndexEntry {
+    uint32_t hash;
+    uint32_t offset;    // Record in the region
+    uint32_t sequence;
+    uint8_t position;   // Place in the card listing
+    bool deleted;       // Delete record, only while scanning
+  };
+  
+  FlashRegion* flash;
+  const uint8_t* base;
+  uint32_t sectorBytes;
+  uint32_t sectors;
+  IndexEntry index[FLASH_DB_MAX_DEVICES];
+  int count;
+  uint32_t head;
+  uint32_t writePos;      // Offset in the head sector
+  uint32_t sequence;      // Last one written
+  uint32_t maxErases;
+  FlashDBStats stats;
+  bool ready;
+  
+  int findEntry(uint32_t hash);  // Index position, -1 if not indexed
+  bool indexRecord(uint32_t hash, uint32_t offset, uint32_t sequence, uint8_t position, bool deleted);
+  void removeEntry(int position);
+  uint32_t recordSize(uint32_t offset);
+  
+  void scan();
+  bool validRecord(uint32_t offset);
+  uint32_t nextRecord(uint32_t sector, uint32_t pos);  // sectorBytes if none left
+  void indexSector(uint32_t sector);
+  uint8_t nextPosition();
+  bool append(uint8_t type, uint32_t hash, uint8_t position, const uint8_t* payload, uint32_t length);
+  bool appendHere(uint8_t type, uint32_t hash, uint8_t position, const uint8_t* payload, uint32_t length, uint32_t& offset);
+  bool advance();
+  bool openSector(uint32_t sector);
+  bool reclaim(uint32_t sector);
+  bool eraseSector(uint32_t sector, uint32_t eraseCount);
+  
+  static int encode(const Device& device, uint8_t* payload);
+  static bool decode(const uint8_t* payload, uint32_t length, Device* device);
+  
+public:
+  FlashDB();
+  bool begin(FlashRegion* region);  // Scans the log and rebuilds the index
+  bool isReady() { return ready; }
+  int getCount() { return count; }
+  
+  // Random access by name (hash lookup, then one record decode)
+  bool find(const char* name, Device* device);
+  
+  // Up to maxDevices, in card order; unplaced ones last, by name hash
+  int loadDevices(Device* devices, int maxDevices);
+  
+  // Adds or replaces by name; an identical record is not rewritten.
+  // position is the device's place in the card listing; -1 keeps the
+  // stored one, or puts a new device after the others
+  bool store(const Device& device, int position = -1);
+  bool remove(const char* name);
+  
+  // Removes every device whose hash is not in keep; returns how many
+  int prune(const uint32_t* keep, int keepCount);
+  
+  FlashDBStats getStats();
+};
+
+// Global flash database instance
+extern FlashDB flashDB;
+
+#endif // FLASH_DB_H
@@ -0,0 +1,25 @@
+/*
+ * VHC Universal Remote - Flash Region
+ * Raw NOR flash interface, shared by the firmware HAL and host tools
+ */
+
+#ifndef FLASH_REGION_H
+#define FLASH_REGION_H
+
+#include <stdint.h>
+
+// A run of whole erase sectors. Reads go straight through data() (the
+// Teensy maps its flash into the address space). Erasing sets a sector
+// to 0xFF; programming can only clear bits, so each byte is written
+// once between erases.
+class FlashRegion {
+public:
+  virtual bool begin() = 0;  // False if the region is not available
+  virtual uint32_t sectorSize() = 0;
+  virtual uint32_t sectorCount() = 0;
+  virtual const uint8_t* data() = 0;
+  virtual bool erase(uint32_t sector) = 0;
+  virtual bool program(uint32_t offset, const void* bytes, uint32_t length) = 0;
+};
+
+#endif // FLASH_REGION_H
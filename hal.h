@@ -0,0 +1,96 @@
+/*
+ * VHC Universal Remote - Hardware Abstraction Layer
+ * Interfaces for the clock, panel, touch, IR output, storage, EEPROM and flash
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <SD.h>
+#include "config.h"
+#include "ir_output.h"
+#include "flash_region.h"
+
+// Modules reach the hardware only through these interfaces (via the hal
+// table below), so another implementation of them - fakes over RAM and a
+// virtual clock - can stand in for the Teensy drivers. The Teensy
+// implementations live in hal_teensy.cpp.
+
+class Clock {
+public:
+  virtual uint32_t millis() = 0;
+  virtual void delay(uint32_t ms) = 0;
+  virtual void sleep() = 0;  // Until the next interrupt
+};
+
+// ILI9341-style panel: Adafruit_GFX drawing plus windowed pixel writes
+// and the vertical scroll registers
+class Panel {
+public:
+  virtual void begin() = 0;
+  virtual Adafruit_GFX& gfx() = 0;
+  virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) = 0;
+  virtual void writePixels(uint16_t* colors, uint32_t length) = 0;
+  virtual void writeColor(uint16_t color, uint32_t length) = 0;
+  virtual void setScrollMargins(uint16_t top, uint16_t bottom) = 0;
+  virtual void scrollTo(uint16_t line) = 0;
+  virtual void setBacklight(uint8_t brightness) = 0;
+};
+
+struct RawTouch {
+  int16_t x, y, z;  // Controller units, z is pressure
+};
+
+class TouchPanel {
+public:
+  virtual void begin() = 0;
+  virtual RawTouch read() = 0;
+  virtual void attachPenInterrupt(void (*isr)()) = 0;  // Called on pen down
+  
+  // Periodic sampling interrupt on an IRQ of its own (samplingIrq), so
+  // SPI.usingInterrupt() can hold it off during display transactions
+  // without holding off every other timer
+  virtual void startSampling(void (*isr)(), uint32_t periodUs) = 0;
+  virtual void stopSampling() = 0;
+  virtual int samplingIrq() = 0;
+};
+
+// Files go through the Arduino FS interface, which SD and LittleFS share
+class Storage {
+public:
+  virtual bool begin() = 0;
+  virtual FS& fs() = 0;
+};
+
+class PersistentMemory {
+public:
+  virtual uint8_t read(int address) = 0;
+  virtual void update(int address, uint8_t value) = 0;  // Skips unchanged bytes
+  virtual int length() = 0;
+  
+  template<typename T> void get(int address, T& value) {
+    uint8_t* bytes = (uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) bytes[i] = read(address + i);
+  }
+  template<typename T> void put(int address, const T& value) {
+    const uint8_t* bytes = (const uint8_t*)&value;
+    for (size_t i = 0; i < sizeof(T); i++) update(address + i, bytes[i]);
+  }
+};
+
+struct Hal {
+  Clock* clock;
+  Panel* panel;
+  TouchPanel* touch;
+  IROutput* irOut;
+  Storage* storage;
+  PersistentMemory* memory;
+  FlashRegion* flash;     // Spare program flash (flash_db.h)
+};
+
+// Hardware in use, defined by the platform implementation
+extern Hal hal;
+
+#endif // HAL_H
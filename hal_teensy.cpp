@@ -0,0 +1,226 @@
+/*
+ * VHC Universal Remote - Teensy 4.1 HAL Implementation
+ */
+
+#include "hal_teensy.h"
+
+static TeensyClock teensyClock;
+static TeensyPanel teensyPanel;
+static TeensyTouch teensyTouch;
+static TeensyIR teensyIR;
+static TeensySD teensySD;
+static TeensyEEPROM teensyEEPROM;
+static TeensyFlash teensyFlash;
+
+// Only addresses are taken, so the table is constant-initialized and
+// safe to read from other globals' constructors
+Hal hal = {
+  &teensyClock,
+  &teensyPanel,
+  &teensyTouch,
+  &teensyIR,
+  &teensySD,
+  &teensyEEPROM,
+  &teensyFlash
+};
+
+// Clock
+
+uint32_t TeensyClock::millis() {
+  return ::millis();
+}
+
+void TeensyClock::delay(uint32_t ms) {
+  ::delay(ms);
+}
+
+void TeensyClock::sleep() {
+  // Any interrupt (systick every 1 ms, touch, serial) wakes the core
+  __asm__ volatile("wfi");
+}
+
+// Panel (ILI9341)
+
+TeensyPanel::TeensyPanel() : tft(TFT_CS, TFT_DC, TFT_RST) {
+}
+
+void TeensyPanel::begin() {
+  pinMode(TFT_LED, OUTPUT);
+  setBacklight(255);
+  tft.begin();
+}
+
+void TeensyPanel::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  tft.setAddrWindow(x, y, w, h);
+}
+
+void TeensyPanel::writePixels(uint16_t* colors, uint32_t length) {
+  tft.writePixels(colors, length);
+}
+
+void TeensyPanel::writeColor(uint16_t color, uint32_t length) {
+  tft.writeColor(color, length);
+}
+
+void TeensyPanel::setScrollMargins(uint16_t top, uint16_t bottom) {
+  tft.setScrollMargins(top, bottom);
+}
+
+void TeensyPanel::scrollTo(uint16_t line) {
+  tft.scrollTo(line);
+}
+
+void TeensyPanel::setBacklight(uint8_t brightness) {
+  analogWrite(TFT_LED, brightness);
+}
+
+// Touch (XPT2046)
+
+TeensyTouch::TeensyTouch() : ts(TOUCH_CS) {
+}
+
+void TeensyTouch::begin() {
+  ts.begin();
+  ts.setRotation(1); // Match display rotation
+}
+
+RawTouch TeensyTouch::read() {
+  TS_Point p = ts.getPoint();
+  RawTouch raw = {p.x, p.y, p.z};
+  return raw;
+}
+
+void TeensyTouch::attachPenInterrupt(void (*isr)()) {
+  pinMode(TOUCH_IRQ, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_IRQ), isr, FALLING);
+}
+
+// Sampling runs on GPT1 rather than an IntervalTimer: all of those share
+// IRQ_PIT, the loop watchdog's check among them, and masking it for the
+// display's SPI transactions would hold them all off
+static void (*sampleIsr)() = nullptr;
+
+static void gpt1ISR() {
+  GPT1_SR = GPT_SR_OF1;
+  sampleIsr();
+  asm volatile("dsb");
+}
+
+void TeensyTouch::startSampling(void (*isr)(), uint32_t periodUs) {
+  sampleIsr = isr;
+  CCM_CCGR1 |= CCM_CCGR1_GPT1_BUS(CCM_CCGR_ON) | CCM_CCGR1_GPT1_SERIAL(CCM_CCGR_ON);
+  GPT1_CR = 0;
+  GPT1_PR = 0;
+  GPT1_SR = 0x3F;
+  GPT1_OCR1 = 24 * periodUs - 1;  // 24 MHz peripheral clock, as the PIT's
+  GPT1_IR = GPT_IR_OF1IE;
+  attachInterruptVector(IRQ_GPT1, gpt1ISR);
+  NVIC_SET_PRIORITY(IRQ_GPT1, 128);
+  NVIC_ENABLE_IRQ(IRQ_GPT1);
+  // Restart mode: the counter starts over at each compare
+  GPT1_CR = GPT_CR_EN | GPT_CR_CLKSRC(1);
+}
+
+void TeensyTouch::stopSampling() {
+  GPT1_CR = 0;
+  NVIC_DISABLE_IRQ(IRQ_GPT1);
+}
+
+// IR output (IRremote)
+
+TeensyIR::TeensyIR() : irsend(IR_LED) {
+}
+
+void TeensyIR::begin() {
+  irsend.begin();
+}
+
+void TeensyIR::sendNEC(uint32_t code, int bits) {
+  irsend.sendNEC(code, bits);
+}
+
+void TeensyIR::sendSony(uint32_t code, int bits) {
+  irsend.sendSony(code, bits);
+}
+
+void TeensyIR::sendRC5(uint32_t code, int bits) {
+  irsend.sendRC5(code, bits);
+}
+
+void TeensyIR::sendRC6(uint32_t code, int bits) {
+  irsend.sendRC6(code, bits);
+}
+
+void TeensyIR::sendPanasonic(uint16_t address, uint32_t command) {
+  irsend.sendPanasonic(address, command);
+}
+
+void TeensyIR::sendJVC(uint32_t code, int bits, bool repeat) {
+  irsend.sendJVC(code, bits, repeat);
+}
+
+// Storage (built-in SD slot)
+
+bool TeensySD::begin() {
+  return SD.begin(SD_CS);
+}
+
+// Persistent memory (emulated EEPROM)
+
+uint8_t TeensyEEPROM::read(int address) {
+  return EEPROM.read(address);
+}
+
+void TeensyEEPROM::update(int address, uint8_t value) {
+  EEPROM.update(address, value);
+}
+
+int TeensyEEPROM::length() {
+  return EEPROM.length();
+}
+
+// Program flash (Teensy 4.1: 8 MB at 0x60000000, the top 256 KB hold
+// the EEPROM emulation). Erase and program go through the core's
+// EEPROM routines, which run from RAM while the flash is busy.
+
+extern "C" {
+  extern unsigned long _flashimagelen;
+  void eepromemu_flash_write(void* addr, const void* data, uint32_t len);
+  void eepromemu_flash_erase_sector(void* addr);
+}
+
+#define FLASH_BASE      0x60000000UL
+#define FLASH_DB_END    0x607C0000UL
+#define FLASH_DB_START  (FLASH_DB_END - FLASH_DB_BYTES)
+#define FLASH_PAGE      256
+
+bool TeensyFlash::begin() {
+  // The sketch must end below the region
+  return FLASH_BASE + (uintptr_t)&_flashimagelen <= FLASH_DB_START;
+}
+
+const uint8_t* TeensyFlash::data() {
+  return (const uint8_t*)FLASH_DB_START;
+}
+
+bool TeensyFlash::erase(uint32_t sector) {
+  if (sector >= sectorCount()) return false;
+  eepromemu_flash_erase_sector((void*)(FLASH_DB_START + sector * sectorSize()));
+  return true;
+}
+
+bool TeensyFlash::program(uint32_t offset, const void* bytes, uint32_t length) {
+  if (offset + length > FLASH_DB_BYTES) return false;
+  
+  // A page program must not cross a page boundary
+  const uint8_t* data = (const uint8_t*)bytes;
+  while (length > 0) {
+    uint32_t chunk = FLASH_PAGE - (offset % FLASH_PAGE);
+    if (chunk > length) chunk = length;
+    eepromemu_flash_write((void*)(FLASH_DB_START + offset), data, chunk);
+    offset += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+  return true;
+}
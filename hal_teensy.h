@@ -0,0 +1,91 @@
+/*
+ * VHC Universal Remote - Teensy 4.1 HAL
+ * Interface implementations over the Teensy drivers
+ */
+
+#ifndef HAL_TEENSY_H
+#define HAL_TEENSY_H
+
+#include <Adafruit_ILI9341.h>
+#include <XPT2046_Touchscreen.h>
+#include <IRremote.hpp>
+#include <EEPROM.h>
+#include "hal.h"
+
+class TeensyClock : public Clock {
+public:
+  uint32_t millis() override;
+  void delay(uint32_t ms) override;
+  void sleep() override;
+};
+
+class TeensyPanel : public Panel {
+private:
+  Adafruit_ILI9341 tft;
+  
+public:
+  TeensyPanel();
+  void begin() override;
+  Adafruit_GFX& gfx() override { return tft; }
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void writePixels(uint16_t* colors, uint32_t length) override;
+  void writeColor(uint16_t color, uint32_t length) override;
+  void setScrollMargins(uint16_t top, uint16_t bottom) override;
+  void scrollTo(uint16_t line) override;
+  void setBacklight(uint8_t brightness) override;
+};
+
+class TeensyTouch : public TouchPanel {
+private:
+  XPT2046_Touchscreen ts;
+  
+public:
+  TeensyTouch();
+  void begin() override;
+  RawTouch read() override;
+  void attachPenInterrupt(void (*isr)()) override;
+  void startSampling(void (*isr)(), uint32_t periodUs) override;
+  void stopSampling() override;
+  int samplingIrq() override { return IRQ_GPT1; }
+};
+
+class TeensyIR : public IROutput {
+private:
+  IRsend irsend;
+  
+public:
+  TeensyIR();
+  void begin() override;
+  void sendNEC(uint32_t code, int bits) override;
+  void sendSony(uint32_t code, int bits) override;
+  void sendRC5(uint32_t code, int bits) override;
+  void sendRC6(uint32_t code, int bits) override;
+  void sendPanasonic(uint16_t address, uint32_t command) override;
+  void sendJVC(uint32_t code, int bits, bool repeat) override;
+};
+
+class TeensySD : public Storage {
+public:
+  bool begin() override;
+  FS& fs() override { return SD; }
+};
+
+class TeensyEEPROM : public PersistentMemory {
+public:
+  uint8_t read(int address) override;
+  void update(int address, uint8_t value) override;
+  int length() override;
+};
+
+// The top FLASH_DB_BYTES of program flash, below the EEPROM emulation
+class TeensyFlash : public FlashRegion {
+public:
+  bool begin() override;
+  uint32_t sectorSize() override { return 4096; }
+  uint32_t sectorCount() override { return FLASH_DB_BYTES / 4096; }
+  const uint8_t* data() override;
+  bool erase(uint32_t sector) override;
+  bool program(uint32_t offset, const void* bytes, uint32_t length) override;
+};
+
+#endif // HAL_TEENSY_H
@@ -0,0 +1,66 @@
+/*
+ * VHC Universal Remote - Histogram Implementation
+ */
+
+#include "histogram.h"
+
+Histogram::Histogram() {
+  bucketMs = 1;
+  reset();
+}
+
+void Histogram::add(uint32_t ms) {
+  uint32_t index = ms / bucketMs;
+  int bucket = (index < HISTOGRAM_BUCKETS) ? index : HISTOGRAM_BUCKETS - 1;
+  if (buckets[bucket] < 0xFFFF) {
+    buckets[bucket]++;
+  }
+  count++;
+  if (ms > maxValue) {
+    maxValue = ms;
+  }
+}
+
+void Histogram::reset() {
+  memset(buckets, 0, sizeof(buckets));
+  count = 0;
+  maxValue = 0;
+}
+
+uint32_t Histogram::percentile(int pct) {
+  uint32_t total = 0;
+  for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    total += buckets[i];
+  }
+  if (total == 0) return 0;
+  
+  // The top of the bucket the target sample falls in: every sample in
+  // it is at or below that, and none above the largest one seen
+  uint32_t target = (total * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (int i = 0; i < HISTOGRAM_BUCKETS - 1; i++) {
+    seen += buckets[i];
+    if (seen >= target) {
+      uint32_t top = (i + 1) * bucketMs - 1;
+      return (top < maxValue) ? top : maxValue;
+    }
+  }
+  return maxValue;
+}
+
+void Histogram::print(const char* label) {
+  Serial.print(label);
+  Serial.print(F(": n="));
+  Serial.print(count);
+  Serial.print(F(" p50="));
+  Serial.print(percentile(50));
+  Serial.print(F(" p90="));
+  Serial.print(percentile(90));
+  Serial.print(F(" p95="));
+  Serial.print(percentile(95));
+  Serial.print(F(" p99="));
+  Serial.print(percentile(99));
+  Serial.print(F(" max="));
+  Serial.print(maxValue);
+  Serial.println(F(" ms"));
+}
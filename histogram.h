@@ -0,0 +1,37 @@
+/*
+ * VHC Universal Remote - Histogram
+ * Millisecond latency histogram with percentiles
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class Histogram {
+private:
+  uint16_t buckets[HISTOGRAM_BUCKETS];  // bucketMs each, last one is "or more"
+  uint16_t bucketMs;
+  uint32_t count;
+  uint32_t maxValue;
+  
+public:
+  Histogram();
+  void add(uint32_t ms);
+  void reset();
+  
+  // Wider buckets for longer times (1 ms by default); call before adding
+  void setBucketMs(uint16_t ms) { bucketMs = ms; }
+  
+  // A value pct percent of the samples are at or below: the top of its
+  // bucket (capped at the maximum), so less than bucketMs above the exact one
+  uint32_t percentile(int pct);
+  uint32_t getCount() { return count; }
+  uint32_t getMax() { return maxValue; }
+  
+  // One line: label n=.. p50=.. p90=.. p95=.. p99=.. max=..
+  void print(const char* label);
+};
+
+#endif // HISTOGRAM_H
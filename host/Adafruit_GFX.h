@@ -0,0 +1,102 @@
+/*
+ * VHC Universal Remote - Host Adafruit_GFX Stand-in
+ * Adafruit_GFX and GFXcanvas16 for the host build
+ *
+ * Same virtual interface and rasterization as the library (classic 6x8
+ * text cells, no custom fonts), so the firmware draws on the host exactly
+ * the pixels it sends to the panel. The built-in font covers printable
+ * ASCII; other character codes draw blank.
+ */
+
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print {
+protected:
+  int16_t WIDTH, HEIGHT;    // Raw size, rotation 0
+  int16_t _width, _height;  // Size with the current rotation
+  int16_t cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor;
+  uint8_t textsize_x, textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  bool _cp437;
+
+public:
+  Adafruit_GFX(int16_t w, int16_t h);
+  
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  
+  // Transaction API, overridden by panel drivers
+  virtual void startWrite(void) {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void endWrite(void) {}
+  
+  virtual void setRotation(uint8_t r);
+  virtual void invertDisplay(bool i) { (void)i; }
+  
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  virtual void fillScreen(uint16_t color);
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint16_t color);
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+  void drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+  void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color);
+  void drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+  void fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg);
+  void drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h);
+  
+  // Text
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+  void getTextBounds(const char* string, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+  void getTextBounds(const __FlashStringHelper* string, int16_t x, int16_t y, int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h);
+  void setTextSize(uint8_t s) { setTextSize(s, s); }
+  void setTextSize(uint8_t sx, uint8_t sy);
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textcolor = c; textbgcolor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  void cp437(bool x = true) { _cp437 = x; }
+  using Print::write;
+  size_t write(uint8_t c) override;
+  
+  int16_t width(void) const { return _width; }
+  int16_t height(void) const { return _height; }
+  uint8_t getRotation(void) const { return rotation; }
+  int16_t getCursorX(void) const { return cursor_x; }
+  int16_t getCursorY(void) const { return cursor_y; }
+
+protected:
+  void charBounds(unsigned char c, int16_t* x, int16_t* y, int16_t* minx, int16_t* miny, int16_t* maxx, int16_t* maxy);
+};
+
+// 16-bit canvas in RAM
+class GFXcanvas16 : public Adafruit_GFX {
+private:
+  uint16_t* buffer;
+
+public:
+  GFXcanvas16(uint16_t w, uint16_t h);
+  ~GFXcanvas16();
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  uint16_t* getBuffer(void) const { return buffer; }
+};
+
+#endif // HOST_ADAFRUIT_GFX_H
@@ -0,0 +1,205 @@
+/*
+ * VHC Universal Remote - Host Arduino Stand-in Implementation
+ */
+
+#include "Arduino.h"
+#include <stdarg.h>
+#include "SPI.h"
+#include "hal_host.h"
+
+HostSerial Serial;
+SPIClass SPI;
+
+// Print
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+int Print::printf(const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) return length;
+  write((const uint8_t*)buffer, strlen(buffer));
+  return length;
+}
+
+size_t Print::printSigned(long long n, int base) {
+  // Bases other than 10 print the 32-bit pattern, as on the Teensy
+  if (base != DEC) return printNumber((uint32_t)n, base);
+  if (n < 0) return print('-') + printNumber((unsigned long long)(-n), DEC);
+  return printNumber((unsigned long long)n, DEC);
+}
+
+size_t Print::printNumber(unsigned long long n, int base) {
+  char buffer[66];
+  char* p = buffer + sizeof(buffer) - 1;
+  *p = '\0';
+  if (base < 2) base = DEC;
+  do {
+    int digit = n % base;
+    *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    n /= base;
+  } while (n);
+  return write(p);
+}
+
+size_t Print::printFloat(double number, int digits) {
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0 || number < -4294967040.0) return print("ovf");
+  
+  size_t n = 0;
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+  
+  double rounding = 0.5;
+  for (int i = 0; i < digits; i++) {
+    rounding /= 10.0;
+  }
+  number += rounding;
+  
+  unsigned long intPart = (unsigned long)number;
+  double remainder = number - (double)intPart;
+  n += print(intPart);
+  if (digits > 0) {
+    n += print('.');
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    int digit = (int)remainder;
+    n += print(digit);
+    remainder -= digit;
+  }
+  return n;
+}
+
+// Stream
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  // Nothing arrives while the host waits, so no timeout
+  size_t count = 0;
+  while (count < length && available() > 0) {
+    buffer[count++] = (char)read();
+  }
+  return count;
+}
+
+// Serial
+
+int HostSerial::read() {
+  if (input.empty()) return -1;
+  uint8_t b = input.front();
+  input.pop_front();
+  return b;
+}
+
+size_t HostSerial::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t HostSerial::write(const uint8_t* buffer, size_t size) {
+  output.append((const char*)buffer, size);
+  if (echo) {
+    fwrite(buffer, 1, size, stdout);
+  }
+  return size;
+}
+
+// Time
+
+uint32_t millis() {
+  return hostClock.millis();
+}
+
+uint32_t micros() {
+  return hostClock.micros();
+}
+
+void delay(uint32_t ms) {
+  hostClock.delay(ms);
+}
+
+void delayMicroseconds(uint32_t us) {
+  hostClock.advance(us);
+}
+
+void yield() {
+}
+
+void noInterrupts() {
+  hostClock.disableInterrupts();
+}
+
+void interrupts() {
+  hostClock.enableInterrupts();
+}
+
+bool IntervalTimer::begin(void (*callback)(), unsigned long microseconds) {
+  end();
+  id = hostClock.startTimer(callback, microseconds, IRQ_PIT);
+  return true;
+}
+
+void IntervalTimer::end() {
+  if (id >= 0) {
+    hostClock.stopTimer(id);
+    id = -1;
+  }
+}
+
+// SPI
+
+void SPIClass::beginTransaction(SPISettings settings) {
+  (void)settings;
+  if (irq >= 0) hostClock.maskIrq(irq);
+}
+
+void SPIClass::endTransaction() {
+  if (irq >= 0) hostClock.unmaskIrq(irq);
+}
+
+// Pins
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  (void)pin;
+  (void)value;
+}
+
+int digitalRead(uint8_t pin) {
+  (void)pin;
+  return HIGH;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  (void)pin;
+  (void)value;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  (void)pin;
+  (void)isr;
+  (void)mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  (void)pin;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
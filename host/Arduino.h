@@ -0,0 +1,185 @@
+/*
+ * VHC Universal Remote - Host Arduino Stand-in
+ * The parts of the Teensy core the firmware uses, for builds on a PC
+ *
+ * Time comes from the virtual clock in hal_host.h: millis()/micros() read
+ * it, delay() advances it, and IntervalTimer callbacks run as "interrupts"
+ * when the clock passes their due time. Serial output is captured (and
+ * echoed to stdout when asked); input is whatever was injected.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <math.h>
+#include <ctype.h>
+#include <string>
+#include <deque>
+#include <type_traits>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Memory placement attributes mean nothing here
+#define PROGMEM
+#define DMAMEM
+#define EXTMEM
+#define FASTRUN
+#define FLASHMEM
+
+#define PI 3.1415926535897932384626433832795
+
+#define BIN 2
+#define OCT 8
+#define DEC 10
+#define HEX 16
+
+#define LOW  0
+#define HIGH 1
+#define INPUT        0
+#define OUTPUT       1
+#define INPUT_PULLUP 2
+#define CHANGE  4
+#define FALLING 2
+#define RISING  3
+
+#define F_CPU        600000000
+#define F_CPU_ACTUAL 600000000
+
+// Interrupt numbers used with SPI.usingInterrupt
+#define IRQ_GPT1 100
+#define IRQ_PIT 122
+
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)   (*(void* const*)(addr))
+
+class __FlashStringHelper;
+#define F(string_literal) ((const __FlashStringHelper*)(string_literal))
+
+// Time (virtual clock)
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// Interrupts: masked sources are held and run when unmasked
+void noInterrupts();
+void interrupts();
+#define __disable_irq() noInterrupts()
+#define __enable_irq()  interrupts()
+
+// Pins do nothing; the fakes in hal_host.h stand in for the devices
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+#define digitalPinToInterrupt(pin) (pin)
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+template<class A, class B> static inline auto min(A a, B b) -> typename std::common_type<A, B>::type { return a < b ? a : b; }
+template<class A, class B> static inline auto max(A a, B b) -> typename std::common_type<A, B>::type { return a > b ? a : b; }
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+  
+  size_t print(const char* s) { return write(s); }
+  size_t print(const __FlashStringHelper* s) { return write((const char*)s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned int n, int base = DEC) { return printNumber(n, base); }
+  size_t print(long n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(long long n, int base = DEC) { return printSigned(n, base); }
+  size_t print(unsigned long long n, int base = DEC) { return printNumber(n, base); }
+  size_t print(double n, int digits = 2) { return printFloat(n, digits); }
+  
+  size_t println() { return write("\r\n"); }
+  template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+  template<typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+  
+  int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+private:
+  size_t printSigned(long long n, int base);
+  size_t printNumber(unsigned long long n, int base);
+  size_t printFloat(double number, int digits);
+};
+
+class Stream : public Print {
+protected:
+  unsigned long timeout;
+
+public:
+  Stream() { timeout = 1000; }
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long ms) { timeout = ms; }
+  size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+};
+
+// USB serial: output is kept for tests to inspect, input is injected
+class HostSerial : public Stream {
+private:
+  std::string output;
+  std::deque<uint8_t> input;
+  bool echo;
+
+public:
+  HostSerial() { echo = false; }
+  void begin(long baud) { (void)baud; }
+  operator bool() { return true; }
+  
+  int available() override { return (int)input.size(); }
+  int read() override;
+  int peek() override { return input.empty() ? -1 : input.front(); }
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int availableForWrite() override { return 4096; }
+  
+  // Host side
+  void setEcho(bool on) { echo = on; }
+  void inject(const char* text) { inject((const uint8_t*)text, strlen(text)); }
+  void inject(const uint8_t* bytes, size_t length) { input.insert(input.end(), bytes, bytes + length); }
+  const std::string& getOutput() const { return output; }
+  void clearOutput() { output.clear(); }
+};
+
+extern HostSerial Serial;
+
+// Periodic timer; the callback runs from the virtual clock as a PIT
+// interrupt (IRQ_PIT, for SPI.usingInterrupt())
+class IntervalTimer {
+private:
+  int id;
+
+public:
+  IntervalTimer() { id = -1; }
+  bool begin(void (*callback)(), unsigned long microseconds);
+  void end();
+  void priority(uint8_t level) { (void)level; }
+};
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,207 @@
+/*
+ * VHC Universal Remote - Host SD Stand-in Implementation
+ */
+
+#include "SD.h"
+
+SDClass SD;
+
+// File
+
+File::File(FS* fs, std::shared_ptr<HostFileNode> node, bool writable, bool append) {
+  handle = std::make_shared<HostFileHandle>();
+  handle->fs = fs;
+  handle->node = node;
+  size_t slash = node->path.rfind('/');
+  handle->name = node->path == "/" ? "/" : node->path.substr(slash + 1);
+  handle->pos = append ? node->data.size() : 0;
+  handle->writable = writable;
+  handle->nextChild = 0;
+}
+
+int File::available() {
+  if (!handle || handle->node->directory) return 0;
+  uint64_t size = handle->node->data.size();
+  return handle->pos < size ? (int)(size - handle->pos) : 0;
+}
+
+int File::read() {
+  if (available() <= 0) return -1;
+  return handle->node->data[handle->pos++];
+}
+
+int File::peek() {
+  if (available() <= 0) return -1;
+  return handle->node->data[handle->pos];
+}
+
+int File::read(void* buffer, size_t length) {
+  int count = available();
+  if (count <= 0) return 0;
+  if ((size_t)count > length) count = (int)length;
+  memcpy(buffer, handle->node->data.data() + handle->pos, count);
+  handle->pos += count;
+  return count;
+}
+
+size_t File::write(uint8_t b) {
+  return write(&b, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+  if (!handle || !handle->writable) return 0;
+  std::vector<uint8_t>& data = handle->node->data;
+  if (handle->pos + length > data.size()) {
+    data.resize(handle->pos + length);
+  }
+  memcpy(data.data() + handle->pos, buffer, length);
+  handle->pos += length;
+  if (handle->fs->onWrite) handle->fs->onWrite(length);
+  return length;
+}
+
+File File::openNextFile(uint8_t mode) {
+  if (!handle || !handle->node->directory) return File();
+  HostFileNode* dir = handle->node.get();
+  while (handle->nextChild < dir->children.size()) {
+    std::string path = (dir->path == "/" ? "" : dir->path) + "/" + dir->children[handle->nextChild++];
+    std::shared_ptr<HostFileNode> child = handle->fs->find(path);
+    if (child) {
+      return File(handle->fs, child, mode != FILE_READ && !child->directory, mode == FILE_WRITE);
+    }
+  }
+  return File();
+}
+
+bool File::seek(uint64_t position) {
+  if (!handle || position > handle->node->data.size()) return false;
+  handle->pos = position;
+  return true;
+}
+
+bool File::truncate(uint64_t size) {
+  if (!handle || !handle->writable) return false;
+  handle->node->data.resize(size);
+  if (handle->pos > size) handle->pos = size;
+  return true;
+}
+
+// FS
+
+FS::FS() {
+  clear();
+}
+
+void FS::clear() {
+  nodes.clear();
+  std::shared_ptr<HostFileNode> root = std::make_shared<HostFileNode>();
+  root->path = "/";
+  root->directory = true;
+  nodes["/"] = root;
+}
+
+std::string FS::normalize(const char* path) {
+  std::string p = (path[0] == '/') ? path : std::string("/") + path;
+  while (p.size() > 1 && p.back() == '/') p.pop_back();
+  return p;
+}
+
+std::string FS::parentOf(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+std::string FS::baseName(const std::string& path) {
+  return path.substr(path.rfind('/') + 1);
+}
+
+std::shared_ptr<HostFileNode> FS::find(const std::string& path) {
+  auto it = nodes.find(path);
+  return it == nodes.end() ? nullptr : it->second;
+}
+
+File FS::open(const char* path, uint8_t mode) {
+  std::string p = normalize(path);
+  std::shared_ptr<HostFileNode> node = find(p);
+  if (!node) {
+    if (mode == FILE_READ) return File();
+    std::shared_ptr<HostFileNode> parent = find(parentOf(p));
+    if (!parent || !parent->directory) return File();
+    node = std::make_shared<HostFileNode>();
+    node->path = p;
+    node->directory = false;
+    nodes[p] = node;
+    parent->children.push_back(baseName(p));
+  }
+  if (node->directory) return File(this, node, false, false);
+  return File(this, node, mode != FILE_READ, mode == FILE_WRITE);
+}
+
+bool FS::exists(const char* path) {
+  return find(normalize(path)) != nullptr;
+}
+
+bool FS::remove(const char* path) {
+  std::string p = normalize(path);
+  std::shared_ptr<HostFileNode> node = find(p);
+  if (!node || node->directory) return false;
+  std::vector<std::string>& siblings = find(parentOf(p))->children;
+  for (size_t i = 0; i < siblings.size(); i++) {
+    if (siblings[i] == baseName(p)) {
+      siblings.erase(siblings.begin() + i);
+      break;
+    }
+  }
+  nodes.erase(p);
+  return true;
+}
+
+bool FS::mkdir(const char* path) {
+  std::string p = normalize(path);
+  if (find(p)) return false;
+  std::shared_ptr<HostFileNode> parent = find(parentOf(p));
+  if (!parent || !parent->directory) return false;
+  std::shared_ptr<HostFileNode> node = std::make_shared<HostFileNode>();
+  node->path = p;
+  node->directory = true;
+  nodes[p] = node;
+  parent->children.push_back(baseName(p));
+  return true;
+}
+
+bool FS::rmdir(const char* path) {
+  std::string p = normalize(path);
+  std::shared_ptr<HostFileNode> node = find(p);
+  if (!node || !node->directory || !node->children.empty() || p == "/") return false;
+  std::vector<std::string>& siblings = find(parentOf(p))->children;
+  for (size_t i = 0; i < siblings.size(); i++) {
+    if (siblings[i] == baseName(p)) {
+      siblings.erase(siblings.begin() + i);
+      break;
+    }
+  }
+  nodes.erase(p);
+  return true;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  // Like FAT: the target must not exist
+  std::string a = normalize(from);
+  std::string b = normalize(to);
+  std::shared_ptr<HostFileNode> node = find(a);
+  std::shared_ptr<HostFileNode> parent = find(parentOf(b));
+  if (!node || node->directory || find(b) || !parent || !parent->directory) return false;
+  remove(from);
+  node->path = b;
+  nodes[b] = node;
+  parent->children.push_back(baseName(b));
+  return true;
+}
+
+uint64_t FS::usedSize() {
+  uint64_t used = 0;
+  for (auto& entry : nodes) {
+    used += entry.second->data.size();
+  }
+  return used;
+}
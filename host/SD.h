@@ -0,0 +1,109 @@
+/*
+ * VHC Universal Remote - Host SD Stand-in
+ * Arduino File/FS over an in-memory directory tree
+ *
+ * Behaves like the Teensy SD library where the firmware relies on it:
+ * FILE_WRITE creates the file and appends, directories list their
+ * entries in creation order, opening a file in a missing directory fails.
+ */
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include <Arduino.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ        0
+#define FILE_WRITE       1
+#define FILE_WRITE_BEGIN 2
+
+#define BUILTIN_SDCARD 254
+
+struct HostFileNode {
+  std::string path;
+  bool directory;
+  std::vector<uint8_t> data;
+  std::vector<std::string> children;  // Names, in creation order
+};
+
+class FS;
+
+// An open file; copies of a File share it (and the position)
+struct HostFileHandle {
+  FS* fs;
+  std::shared_ptr<HostFileNode> node;
+  std::string name;
+  uint64_t pos;
+  bool writable;
+  size_t nextChild;
+};
+
+class File : public Stream {
+private:
+  std::shared_ptr<HostFileHandle> handle;
+
+public:
+  File() {}
+  File(FS* fs, std::shared_ptr<HostFileNode> node, bool writable, bool append);
+  
+  const char* name() { return handle ? handle->name.c_str() : ""; }
+  bool isDirectory() { return handle && handle->node->directory; }
+  
+  int available() override;
+  int read() override;
+  int peek() override;
+  int read(void* buffer, size_t length);
+  size_t write(uint8_t b) override;
+  size_t write(const uint8_t* buffer, size_t length) override;
+  using Print::write;
+  int availableForWrite() override { return (handle && handle->writable) ? 4096 : 0; }
+  
+  void close() { handle.reset(); }
+  File openNextFile(uint8_t mode = FILE_READ);
+  void rewindDirectory() { if (handle) handle->nextChild = 0; }
+  uint64_t size() { return handle ? handle->node->data.size() : 0; }
+  bool seek(uint64_t position);
+  uint64_t position() { return handle ? handle->pos : 0; }
+  void flush() override {}
+  bool truncate(uint64_t size = 0);
+  operator bool() { return handle != nullptr; }
+};
+
+class FS {
+private:
+  std::map<std::string, std::shared_ptr<HostFileNode>> nodes;
+
+public:
+  FS();
+  File open(const char* path, uint8_t mode = FILE_READ);
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool mkdir(const char* path);
+  bool rmdir(const char* path);
+  bool rename(const char* from, const char* to);
+  uint64_t totalSize() { return 32ULL << 30; }
+  uint64_t usedSize();
+  
+  // Host side
+  void clear();
+  std::shared_ptr<HostFileNode> find(const std::string& path);
+  std::function<void(size_t)> onWrite;  // Bytes written, for card timing
+
+private:
+  static std::string normalize(const char* path);
+  static std::string parentOf(const std::string& path);
+  static std::string baseName(const std::string& path);
+};
+
+class SDClass : public FS {
+public:
+  bool begin(uint8_t csPin = BUILTIN_SDCARD) { (void)csPin; return true; }
+};
+
+extern SDClass SD;
+
+#endif // HOST_SD_H
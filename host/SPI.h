@@ -0,0 +1,39 @@
+/*
+ * VHC Universal Remote - Host SPI Stand-in
+ * Transactions mask the interrupts registered with usingInterrupt()
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0x00
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
+    (void)clock;
+    (void)bitOrder;
+    (void)dataMode;
+  }
+};
+
+class SPIClass {
+private:
+  int irq;
+
+public:
+  SPIClass() { irq = -1; }
+  void begin() {}
+  void usingInterrupt(int interruptNumber) { irq = interruptNumber; }
+  void beginTransaction(SPISettings settings);
+  void endTransaction();
+  uint8_t transfer(uint8_t data) { return data; }
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
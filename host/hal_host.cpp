@@ -0,0 +1,658 @@
+/*
+ * VHC Universal Remote - Host HAL Implementation
+ */
+
+#include "hal_host.h"
+#include <Adafruit_ILI9341.h>
+#include <SPI.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+FakeClock hostClock;
+FakePanel hostPanel;
+FakeTouch hostTouch;
+FakeIR hostIR;
+FakeStorage hostSD;
+FakeEEPROM hostEEPROM;
+FakeFlash hostFlash;
+
+Hal hal = {
+  &hostClock,
+  &hostPanel,
+  &hostTouch,
+  &hostIR,
+  &hostSD,
+  &hostEEPROM,
+  &hostFlash
+};
+
+// The ILI9341 driver's default SPI clock on a Teensy 4
+#define PANEL_SPI_HZ       8000000ULL
+#define PANEL_WINDOW_BYTES 11         // CASET + 4, PASET + 4, RAMWR
+
+#define CLOCK_READ_COST_NS 100
+
+// Clock
+
+FakeClock::FakeClock() {
+  readCostNs = CLOCK_READ_COST_NS;
+  reset();
+}
+
+static uint64_t realNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FakeClock::reset() {
+  nowNs = 0;
+  timers.clear();
+  events.clear();
+  masks.clear();
+  disableDepth = 0;
+  inInterrupt = false;
+  wallClock = false;
+  wallStartNs = 0;
+  wallStartClockNs = 0;
+}
+
+void FakeClock::setWallClock(bool on) {
+  wallClock = on;
+  wallStartNs = realNs();
+  wallStartClockNs = nowNs;
+}
+
+uint32_t FakeClock::millis() {
+  advanceNs(readCost());
+  return (uint32_t)(nowNs / 1000000);
+}
+
+uint32_t FakeClock::micros() {
+  advanceNs(readCost());
+  return (uint32_t)(nowNs / 1000);
+}
+
+uint64_t FakeClock::readCost() {
+  if (!wallClock) return readCostNs;
+  
+  // Catch up with real time; never backwards, waits may have run ahead
+  uint64_t now = wallStartClockNs + (realNs() - wallStartNs);
+  return (now > nowNs) ? now - nowNs : 0;
+}
+
+void FakeClock::delay(uint32_t ms) {
+  advance((uint64_t)ms * 1000);
+}
+
+void FakeClock::sleep() {
+  uint64_t tick = (nowNs / 1000000 + 1) * 1000000;
+  advanceNs(tick - nowNs);
+}
+
+void FakeClock::runUntil(uint64_t us) {
+  if (us * 1000 > nowNs) {
+    advanceNs(us * 1000 - nowNs);
+  }
+}
+
+void FakeClock::advanceNs(uint64_t ns) {
+  uint64_t target = nowNs + ns;
+  
+  // Interrupts do not nest and wait out noInterrupts()
+  while (!inInterrupt && disableDepth == 0) {
+    int timer = -1;
+    uint64_t due = target + 1;
+    for (size_t i = 0; i < timers.size(); i++) {
+      if (timers[i].active && timers[i].due < due && !isMasked(timers[i].irq)) {
+        timer = (int)i;
+        due = timers[i].due;
+      }
+    }
+    bool event = !events.empty() && events.begin()->first < due;
+    if (timer < 0 && !event) break;
+    
+    if (event) {
+      if (events.begin()->first > nowNs) nowNs = events.begin()->first;
+      std::function<void()> run = events.begin()->second;
+      events.erase(events.begin());
+      inInterrupt = true;
+      run();
+      inInterrupt = false;
+    } else {
+      // A timer held back by a mask fires once, then keeps its phase
+      Timer& t = timers[timer];
+      if (t.due > nowNs) nowNs = t.due;
+      while (t.due <= nowNs) t.due += t.period;
+      void (*isr)() = t.isr;
+      inInterrupt = true;
+      isr();
+      inInterrupt = false;
+    }
+  }
+  if (target > nowNs) nowNs = target;
+}
+
+int FakeClock::startTimer(void (*isr)(), uint32_t periodUs, int irq) {
+  if (periodUs == 0) periodUs = 1;
+  Timer timer = {true, irq, nowNs + (uint64_t)periodUs * 1000, (uint64_t)periodUs * 1000, isr};
+  for (size_t i = 0; i < timers.size(); i++) {
+    if (!timers[i].active) {
+      timers[i] = timer;
+      return (int)i;
+    }
+  }
+  timers.push_back(timer);
+  return (int)timers.size() - 1;
+}
+
+void FakeClock::stopTimer(int id) {
+  if (id >= 0 && id < (int)timers.size()) {
+    timers[id].active = false;
+  }
+}
+
+void FakeClock::schedule(uint64_t atUs, std::function<void()> event) {
+  events.insert(std::make_pair(atUs * 1000, event));
+}
+
+void FakeClock::disableInterrupts() {
+  disableDepth++;
+}
+
+void FakeClock::enableInterrupts() {
+  // Like the Teensy, interrupts() does not count nesting
+  disableDepth = 0;
+  advanceNs(0);
+}
+
+void FakeClock::maskIrq(int irq) {
+  masks[irq]++;
+}
+
+void FakeClock::unmaskIrq(int irq) {
+  auto it = masks.find(irq);
+  if (it != masks.end() && --it->second <= 0) {
+    masks.erase(it);
+    advanceNs(0);
+  }
+}
+
+bool FakeClock::isMasked(int irq) const {
+  return masks.count(irq) > 0;
+}
+
+// Panel
+
+FakePanel::Driver::Driver(FakePanel* panel) : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {
+  this->panel = panel;
+}
+
+void FakePanel::Driver::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+void FakePanel::Driver::startWrite(void) {
+  panel->beginTransaction();
+}
+
+void FakePanel::Driver::endWrite(void) {
+  panel->endTransaction();
+}
+
+void FakePanel::Driver::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  panel->window(x, y, 1, 1);
+  panel->put(color, 1, nullptr);
+}
+
+void FakePanel::Driver::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // Clipped the way Adafruit_SPITFT does it
+  if (w < 0) {
+    x += w + 1;
+    w = -w;
+  }
+  if (h < 0) {
+    y += h + 1;
+    h = -h;
+  }
+  if (w == 0 || h == 0 || x >= _width || y >= _height) return;
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+  if (x2 < 0 || y2 < 0) return;
+  if (x < 0) {
+    x = 0;
+    w = x2 + 1;
+  }
+  if (y < 0) {
+    y = 0;
+    h = y2 + 1;
+  }
+  if (x2 >= _width) w = _width - x;
+  if (y2 >= _height) h = _height - y;
+  panel->window(x, y, w, h);
+  panel->put(color, (uint32_t)w * h, nullptr);
+}
+
+void FakePanel::Driver::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void FakePanel::Driver::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void FakePanel::Driver::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+void FakePanel::Driver::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  startWrite();
+  writeFillRect(x, y, 1, h, color);
+  endWrite();
+}
+
+void FakePanel::Driver::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  startWrite();
+  writeFillRect(x, y, w, 1, color);
+  endWrite();
+}
+
+FakePanel::FakePanel() : driver(this) {
+  gram = new uint16_t[SCREEN_WIDTH * SCREEN_HEIGHT]();
+  writeDepth = 0;
+  winX = winY = 0;
+  winW = SCREEN_WIDTH;
+  winH = SCREEN_HEIGHT;
+  winPos = 0;
+  topFixed = 0;
+  scrollLines = SCREEN_WIDTH;
+  bottomFixed = 0;
+  scrollStart = 0;
+  backlight = 0;
+  transactionStartNs = 0;
+  setBusTiming(16000000000ULL / PANEL_SPI_HZ, PANEL_WINDOW_BYTES * 8000000000ULL / PANEL_SPI_HZ);
+  resetCounters();
+}
+
+void FakePanel::begin() {
+  // Power-on state: scrolling off, memory left as it was
+  topFixed = 0;
+  scrollLines = SCREEN_WIDTH;
+  bottomFixed = 0;
+  scrollStart = 0;
+  backlight = 255;
+}
+
+void FakePanel::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  window(x, y, w, h);
+}
+
+void FakePanel::writePixels(uint16_t* colors, uint32_t length) {
+  put(0, length, colors);
+}
+
+void FakePanel::writeColor(uint16_t color, uint32_t length) {
+  put(color, length, nullptr);
+}
+
+void FakePanel::setScrollMargins(uint16_t top, uint16_t bottom) {
+  // VSCRDEF: the three areas must add up to the 320 panel lines
+  if (top + bottom <= SCREEN_WIDTH) {
+    topFixed = top;
+    scrollLines = SCREEN_WIDTH - top - bottom;
+    bottomFixed = bottom;
+  }
+}
+
+void FakePanel::scrollTo(uint16_t line) {
+  // VSCRSADD: memory line shown at the top of the scroll area
+  if (line < topFixed || line >= topFixed + scrollLines) {
+    scrollErrors++;
+  }
+  scrollStart = line;
+}
+
+int FakePanel::visibleColumn(int16_t x) const {
+  if (x < topFixed || x >= topFixed + scrollLines) return x;
+  return topFixed + (x - topFixed + scrollStart - topFixed) % scrollLines;
+}
+
+uint16_t FakePanel::memoryPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return 0;
+  return gram[(uint32_t)y * SCREEN_WIDTH + x];
+}
+
+uint16_t FakePanel::visiblePixel(int16_t x, int16_t y) const {
+  return memoryPixel(visibleColumn(x), y);
+}
+
+void FakePanel::readVisible(uint16_t* out) const {
+  for (int16_t y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int16_t x = 0; x < SCREEN_WIDTH; x++) {
+      *out++ = visiblePixel(x, y);
+    }
+  }
+}
+
+bool FakePanel::writePPM(const char* path) const {
+  FILE* out = fopen(path, "wb");
+  if (!out) return false;
+  fprintf(out, "P6\n%d %d\n255\n", SCREEN_WIDTH, SCREEN_HEIGHT);
+  for (int16_t y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int16_t x = 0; x < SCREEN_WIDTH; x++) {
+      uint16_t c = visiblePixel(x, y);
+      uint8_t rgb[3] = {
+        (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+        (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+        (uint8_t)((c & 0x1F) * 255 / 31)
+      };
+      fwrite(rgb, 1, 3, out);
+    }
+  }
+  return fclose(out) == 0;
+}
+
+void FakePanel::setBusTiming(uint32_t pixelNs, uint32_t windowNs) {
+  nsPerPixel = pixelNs;
+  nsPerWindow = windowNs;
+}
+
+void FakePanel::resetCounters() {
+  windows = 0;
+  pixels = 0;
+  transactions = 0;
+  longestTransactionUs = 0;
+  scrollErrors = 0;
+}
+
+void FakePanel::window(int16_t x, int16_t y, int16_t w, int16_t h) {
+  winX = x;
+  winY = y;
+  winW = w > 0 ? w : 1;
+  winH = h > 0 ? h : 1;
+  winPos = 0;
+  windows++;
+  hostClock.advanceNs(nsPerWindow);
+}
+
+void FakePanel::put(uint16_t color, uint32_t count, const uint16_t* colors) {
+  // The write pointer runs along window rows and wraps to the start
+  uint32_t size = (uint32_t)winW * winH;
+  for (uint32_t i = 0; i < count; i++) {
+    int16_t x = winX + winPos % winW;
+    int16_t y = winY + winPos / winW;
+    if (x >= 0 && y >= 0 && x < SCREEN_WIDTH && y < SCREEN_HEIGHT) {
+      gram[(uint32_t)y * SCREEN_WIDTH + x] = colors ? colors[i] : color;
+    }
+    if (++winPos == size) winPos = 0;
+  }
+  charge(count);
+}
+
+void FakePanel::charge(uint32_t count) {
+  pixels += count;
+  hostClock.advanceNs((uint64_t)count * nsPerPixel);
+}
+
+void FakePanel::beginTransaction() {
+  if (writeDepth++ == 0) {
+    transactions++;
+    transactionStartNs = hostClock.nanos();
+    SPI.beginTransaction(SPISettings(PANEL_SPI_HZ, MSBFIRST, SPI_MODE0));
+  }
+}
+
+void FakePanel::endTransaction() {
+  if (writeDepth > 0 && --writeDepth == 0) {
+    uint32_t us = (uint32_t)((hostClock.nanos() - transactionStartNs) / 1000);
+    if (us > longestTransactionUs) longestTransactionUs = us;
+    SPI.endTransaction();
+  }
+}
+
+// Touch
+
+FakeTouch::FakeTouch() {
+  current.x = 0;
+  current.y = 0;
+  current.z = 0;
+  penIsr = nullptr;
+  sampleTimer = -1;
+  reads = 0;
+}
+
+void FakeTouch::startSampling(void (*isr)(), uint32_t periodUs) {
+  stopSampling();
+  sampleTimer = hostClock.startTimer(isr, periodUs, IRQ_GPT1);
+}
+
+void FakeTouch::stopSampling() {
+  if (sampleTimer >= 0) {
+    hostClock.stopTimer(sampleTimer);
+    sampleTimer = -1;
+  }
+}
+
+RawTouch FakeTouch::read() {
+  reads++;
+  return current;
+}
+
+void FakeTouch::set(int16_t x, int16_t y, int16_t z) {
+  // Called as an interrupt: PENIRQ falls when contact starts
+  bool penDown = current.z == 0 && z > 0;
+  current.x = x;
+  current.y = y;
+  current.z = z;
+  if (penDown && penIsr) {
+    if (hostClock.inIsr()) {
+      penIsr();
+    } else {
+      hostClock.schedule(hostClock.nanos() / 1000, penIsr);
+      hostClock.advanceNs(0);
+    }
+  }
+}
+
+void FakeTouch::setAt(uint64_t atUs, int16_t x, int16_t y, int16_t z) {
+  hostClock.schedule(atUs, [this, x, y, z]() { set(x, y, z); });
+}
+
+void FakeTouch::tapAt(uint64_t atUs, int x, int y, uint32_t holdMs) {
+  setAt(atUs, rawX(x), rawY(y), 1000);
+  setAt(atUs + (uint64_t)holdMs * 1000, 0, 0, 0);
+}
+
+int16_t FakeTouch::rawX(int x) {
+  // Middle of the raw range that maps to x
+  return TS_MINX + (x * (TS_MAXX - TS_MINX) + (TS_MAXX - TS_MINX) / 2) / SCREEN_WIDTH;
+}
+
+int16_t FakeTouch::rawY(int y) {
+  return TS_MINY + (y * (TS_MAXY - TS_MINY) + (TS_MAXY - TS_MINY) / 2) / SCREEN_HEIGHT;
+}
+
+// IR output
+
+void FakeIR::record(const char* protocol, uint32_t code, uint16_t address, int bits, bool repeat) {
+  IRSent frame = {protocol, code, address, bits, repeat, (uint32_t)(hostClock.nanos() / 1000000)};
+  sent.push_back(frame);
+  hostClock.advance(frameUs);
+}
+
+// Storage
+
+void FakeStorage::setWriteSpeed(uint32_t kbps) {
+  if (kbps == 0) {
+    files.onWrite = nullptr;
+    return;
+  }
+  uint64_t nsPerByte = 1000000000ULL / (kbps * 1024ULL);
+  files.onWrite = [nsPerByte](size_t bytes) { hostClock.advanceNs(bytes * nsPerByte); };
+}
+
+bool FakeStorage::addFile(const char* path, const char* contents) {
+  return addFile(path, (const uint8_t*)contents, strlen(contents));
+}
+
+bool FakeStorage::addFile(const char* path, const uint8_t* bytes, size_t length) {
+  // Missing directories on the way are created
+  std::string p = path;
+  for (size_t slash = p.find('/', 1); slash != std::string::npos; slash = p.find('/', slash + 1)) {
+    files.mkdir(p.substr(0, slash).c_str());
+  }
+  files.remove(path);
+  File file = files.open(path, FILE_WRITE);
+  if (!file) return false;
+  bool ok = file.write(bytes, length) == length;
+  file.close();
+  return ok;
+}
+
+int FakeStorage::loadDirectory(const char* hostDir, const char* suffix, const char* cardDir) {
+  // Sorted, so the card lists them in the same order every run
+  std::vector<std::filesystem::path> paths;
+  std::error_code error;
+  std::filesystem::directory_iterator dir(hostDir, error);
+  if (error) return -1;
+  for (auto& entry : dir) {
+    std::string name = entry.path().filename().string();
+    if (entry.is_regular_file() && name.size() >= strlen(suffix) &&
+        name.compare(name.size() - strlen(suffix), std::string::npos, suffix) == 0) {
+      paths.push_back(entry.path());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  
+  int count = 0;
+  for (auto& path : paths) {
+    FILE* in = fopen(path.string().c_str(), "rb");
+    if (!in) continue;
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+      bytes.insert(bytes.end(), chunk, chunk + n);
+    }
+    fclose(in);
+    std::string target = cardDir;
+    if (target.empty() || target.back() != '/') target += "/";
+    target += path.filename().string();
+    if (addFile(target.c_str(), bytes.data(), bytes.size())) count++;
+  }
+  return count;
+}
+
+int FakeStorage::saveDirectory(const char* cardDir, const char* hostDir) {
+  File dir = files.open(cardDir);
+  if (!dir || !dir.isDirectory()) return -1;
+  std::error_code error;
+  std::filesystem::create_directories(hostDir, error);
+  
+  int count = 0;
+  for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+    if (file.isDirectory()) continue;
+    std::string path = std::string(hostDir) + "/" + file.name();
+    FILE* out = fopen(path.c_str(), "wb");
+    if (!out) return -1;
+    uint8_t chunk[4096];
+    int n;
+    while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+      fwrite(chunk, 1, n, out);
+    }
+    if (fclose(out) == 0) count++;
+  }
+  return count;
+}
+
+// EEPROM
+
+#define EEPROM_BYTES 4284
+
+FakeEEPROM::FakeEEPROM() {
+  cutAfter = -1;
+  erase();
+}
+
+uint8_t FakeEEPROM::read(int address) {
+  if (address < 0 || address >= (int)bytes.size()) return 0xFF;
+  return bytes[address];
+}
+
+void FakeEEPROM::update(int address, uint8_t value) {
+  if (address < 0 || address >= (int)bytes.size() || bytes[address] == value) return;
+  if (cutAfter >= 0 && cutAfter-- == 0) {
+    throw PowerCut();
+  }
+  bytes[address] = value;
+  writes[address]++;
+  totalWrites++;
+}
+
+void FakeEEPROM::erase() {
+  bytes.assign(EEPROM_BYTES, 0xFF);
+  resetCounters();
+}
+
+void FakeEEPROM::resetCounters() {
+  writes.assign(EEPROM_BYTES, 0);
+  totalWrites = 0;
+}
+
+// Flash
+
+FakeFlash::FakeFlash() {
+  cutAfter = -1;
+  seed = 1;
+  eraseAll();
+}
+
+void FakeFlash::eraseAll() {
+  image.assign(FLASH_DB_BYTES, 0xFF);
+  erases.assign(FLASH_DB_BYTES / 4096, 0);
+  violations = 0;
+}
+
+uint32_t FakeFlash::random() {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16;
+}
+
+bool FakeFlash::erase(uint32_t sector) {
+  if (sector >= sectorCount()) return false;
+  uint8_t* start = &image[sector * 4096];
+  if (cutAfter >= 0 && cutAfter-- == 0) {
+    // Part of the sector erased
+    for (int i = 0; i < 4096; i++) {
+      if (random() & 1) start[i] = 0xFF;
+    }
+    throw PowerCut();
+  }
+  memset(start, 0xFF, 4096);
+  erases[sector]++;
+  return true;
+}
+
+bool FakeFlash::program(uint32_t offset, const void* bytes, uint32_t length) {
+  if (offset + length > image.size()) return false;
+  const uint8_t* data = (const uint8_t*)bytes;
+  if (cutAfter >= 0 && cutAfter-- == 0) {
+    // A prefix programmed
+    length = random() % (length + 1);
+    for (uint32_t i = 0; i < length; i++) {
+      image[offset + i] &= data[i];
+    }
+    throw PowerCut();
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    if ((image[offset + i] & data[i]) != data[i]) violations++;
+    image[offset + i] &= data[i];
+  }
+  return true;
+}
@@ -0,0 +1,312 @@
+/*
+ * VHC Universal Remote - Host HAL
+ * In-memory fakes for every hal.h interface, driven by a virtual clock
+ *
+ * The clock only moves when the firmware reads or waits on it (or a test
+ * advances it), so a run is the same every time. Timers, the pen
+ * interrupt and scheduled events run as interrupts when the clock passes
+ * their due time, one at a time and never inside noInterrupts() or inside
+ * another one.
+ */
+
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <SD.h>
+#include <functional>
+#include <map>
+#include <vector>
+#include "hal.h"
+
+// Thrown by the EEPROM and flash fakes when a planned power cut is reached
+struct PowerCut {};
+
+class FakeClock : public Clock {
+private:
+  struct Timer {
+    bool active;
+    int irq;                  // Mask group
+    uint64_t due;             // ns
+    uint64_t period;          // ns
+    void (*isr)();
+  };
+  
+  uint64_t nowNs;
+  uint32_t readCostNs;
+  bool wallClock;
+  uint64_t wallStartNs;       // Real time and clock time when it was set
+  uint64_t wallStartClockNs;
+  std::vector<Timer> timers;
+  std::multimap<uint64_t, std::function<void()>> events;
+  int disableDepth;
+  bool inInterrupt;
+  std::map<int, int> masks;   // IRQ -> mask depth
+  
+  uint64_t readCost();
+
+public:
+  FakeClock();
+  
+  // Clock interface
+  uint32_t millis() override;
+  void delay(uint32_t ms) override;
+  void sleep() override;      // To the next 1 ms system tick
+  
+  uint32_t micros();
+  uint64_t nanos() const { return nowNs; }
+  
+  // Each clock read costs this much, so busy-waits on the clock end
+  void setReadCost(uint32_t ns) { readCostNs = ns; }
+  
+  // Reads follow real time from here on, for timing host code
+  // (benchmarks); runs are no longer repeatable
+  void setWallClock(bool on);
+  
+  // Moves time forward, running whatever comes due on the way
+  void advance(uint64_t us) { advanceNs(us * 1000); }
+  void advanceNs(uint64_t ns);
+  void runUntil(uint64_t us);
+  
+  // Periodic timer (id for stopTimer) and one-off events; both run as
+  // interrupts, only timers can be masked
+  int startTimer(void (*isr)(), uint32_t periodUs, int irq);
+  void stopTimer(int id);
+  void schedule(uint64_t atUs, std::function<void()> event);
+  
+  // noInterrupts()/interrupts() and per-IRQ masks (SPI transactions)
+  void disableInterrupts();
+  void enableInterrupts();
+  void maskIrq(int irq);
+  void unmaskIrq(int irq);
+  bool isMasked(int irq) const;
+  bool inIsr() const { return inInterrupt; }
+  
+  // Back to time zero with nothing pending
+  void reset();
+};
+
+// ILI9341 model: GRAM in landscape order, the vertical scroll registers
+// (lines run along screen X in rotation 1, as display.cpp uses them) and
+// bus time charged to the clock per window and pixel
+class FakePanel : public Panel {
+private:
+  // Adafruit_SPITFT-style driver: every primitive becomes address
+  // windows and pixel writes into GRAM
+  class Driver : public Adafruit_GFX {
+  private:
+    FakePanel* panel;
+  
+  public:
+    Driver(FakePanel* panel);
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void startWrite(void) override;
+    void endWrite(void) override;
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  };
+  
+  Driver driver;
+  uint16_t* gram;
+  int writeDepth;
+  
+  // Address window and write pointer
+  int16_t winX, winY, winW, winH;
+  uint32_t winPos;
+  
+  // VSCRDEF / VSCRSADD
+  uint16_t topFixed, scrollLines, bottomFixed;
+  uint16_t scrollStart;
+  
+  uint8_t backlight;
+  uint32_t nsPerPixel, nsPerWindow;
+  uint64_t transactionStartNs;
+
+public:
+  // Bus counters since the last resetCounters()
+  uint32_t windows;
+  uint32_t pixels;
+  uint32_t transactions;
+  uint32_t longestTransactionUs;  // Longest time the bus was held
+  uint32_t scrollErrors;  // Scroll start outside the scroll area
+  
+  FakePanel();
+  
+  // Panel interface
+  void begin() override;
+  Adafruit_GFX& gfx() override { return driver; }
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void writePixels(uint16_t* colors, uint32_t length) override;
+  void writeColor(uint16_t color, uint32_t length) override;
+  void setScrollMargins(uint16_t top, uint16_t bottom) override;
+  void scrollTo(uint16_t line) override;
+  void setBacklight(uint8_t brightness) override { backlight = brightness; }
+  
+  // Panel memory, and what the glass shows with scrolling applied
+  const uint16_t* memory() const { return gram; }
+  uint16_t memoryPixel(int16_t x, int16_t y) const;
+  uint16_t visiblePixel(int16_t x, int16_t y) const;
+  int visibleColumn(int16_t x) const;  // Memory column shown at screen column x
+  void readVisible(uint16_t* out) const;
+  bool writePPM(const char* path) const;
+  
+  uint16_t getScrollStart() const { return scrollStart; }
+  uint16_t getScrollLines() const { return scrollLines; }
+  uint8_t getBacklight() const { return backlight; }
+  
+  // Bus time charged to the clock; 0 makes drawing free
+  void setBusTiming(uint32_t pixelNs, uint32_t windowNs);
+  void resetCounters();
+
+private:
+  void window(int16_t x, int16_t y, int16_t w, int16_t h);
+  void put(uint16_t color, uint32_t count, const uint16_t* colors);
+  void charge(uint32_t count);
+  void beginTransaction();
+  void endTransaction();
+};
+
+// XPT2046 model: the sample read() returns is set by the test, directly
+// or from a timed script; the pen interrupt fires when pressure appears
+class FakeTouch : public TouchPanel {
+private:
+  RawTouch current;
+  void (*penIsr)();
+  int sampleTimer;
+  uint32_t reads;
+
+public:
+  FakeTouch();
+  void begin() override {}
+  RawTouch read() override;
+  void attachPenInterrupt(void (*isr)()) override { penIsr = isr; }
+  void startSampling(void (*isr)(), uint32_t periodUs) override;
+  void stopSampling() override;
+  int samplingIrq() override { return IRQ_GPT1; }
+  
+  void set(int16_t x, int16_t y, int16_t z);
+  void release() { set(0, 0, 0); }
+  void setAt(uint64_t atUs, int16_t x, int16_t y, int16_t z);
+  
+  // Pen down at a screen point (default calibration), up again after ms
+  void tapAt(uint64_t atUs, int x, int y, uint32_t holdMs);
+  static int16_t rawX(int x);
+  static int16_t rawY(int y);
+  
+  uint32_t getReads() const { return reads; }
+};
+
+struct IRSent {
+  const char* protocol;
+  uint32_t code;      // Panasonic: the command
+  uint16_t address;   // Panasonic only
+  int bits;
+  bool repeat;        // JVC repeat frame
+  uint32_t time;      // millis()
+};
+
+class FakeIR : public IROutput {
+private:
+  uint32_t frameUs;
+  
+public:
+  std::vector<IRSent> sent;
+  
+  FakeIR() { frameUs = 0; }
+  void begin() override {}
+  void sendNEC(uint32_t code, int bits) override { record("NEC", code, 0, bits, false); }
+  void sendSony(uint32_t code, int bits) override { record("SONY", code, 0, bits, false); }
+  void sendRC5(uint32_t code, int bits) override { record("RC5", code, 0, bits, false); }
+  void sendRC6(uint32_t code, int bits) override { record("RC6", code, 0, bits, false); }
+  void sendPanasonic(uint16_t address, uint32_t command) override { record("PANASONIC", command, address, 48, false); }
+  void sendJVC(uint32_t code, int bits, bool repeat) override { record("JVC", code, 0, bits, repeat); }
+  
+  // Sends block for this long, as IRremote does while it modulates
+  void setFrameTime(uint32_t us) { frameUs = us; }
+
+private:
+  void record(const char* protocol, uint32_t code, uint16_t address, int bits, bool repeat);
+};
+
+// SD card in RAM; a missing card fails begin()
+class FakeStorage : public Storage {
+private:
+  FS files;
+  bool inserted;
+
+public:
+  FakeStorage() { inserted = true; }
+  bool begin() override { return inserted; }
+  FS& fs() override { return files; }
+  
+  void setInserted(bool on) { inserted = on; }
+  void setWriteSpeed(uint32_t kbps);  // Charged to the clock; 0 is free
+  bool addFile(const char* path, const char* contents);
+  bool addFile(const char* path, const uint8_t* bytes, size_t length);
+  // Matching files of a host directory onto the card, and a card
+  // directory's files back out; the number copied, -1 on error
+  int loadDirectory(const char* hostDir, const char* suffix, const char* cardDir = "/");
+  int saveDirectory(const char* cardDir, const char* hostDir);
+  void format() { files.clear(); }
+};
+
+// Teensy 4.1 emulated EEPROM (4284 bytes) with write counts per byte
+class FakeEEPROM : public PersistentMemory {
+private:
+  std::vector<uint8_t> bytes;
+
+public:
+  std::vector<uint32_t> writes;
+  uint32_t totalWrites;
+  int cutAfter;               // Writes left before a PowerCut, -1 for none
+  
+  FakeEEPROM();
+  uint8_t read(int address) override;
+  void update(int address, uint8_t value) override;
+  int length() override { return (int)bytes.size(); }
+  
+  void erase();
+  void resetCounters();
+};
+
+// NOR flash region (FLASH_DB_BYTES of 4 KB sectors)
+class FakeFlash : public FlashRegion {
+private:
+  std::vector<uint8_t> image;
+  uint32_t seed;              // For the part of a cut operation that happened
+
+public:
+  std::vector<uint32_t> erases;  // Per sector
+  uint32_t violations;           // Programs that tried to set a bit
+  int cutAfter;                  // Operations left before a PowerCut, -1 for none
+  
+  FakeFlash();
+  bool begin() override { return true; }
+  uint32_t sectorSize() override { return 4096; }
+  uint32_t sectorCount() override { return FLASH_DB_BYTES / 4096; }
+  const uint8_t* data() override { return image.data(); }
+  bool erase(uint32_t sector) override;
+  bool program(uint32_t offset, const void* bytes, uint32_t length) override;
+  
+  void eraseAll();
+
+private:
+  uint32_t random();
+};
+
+// The instances behind the hal table
+extern FakeClock hostClock;
+extern FakePanel hostPanel;
+extern FakeTouch hostTouch;
+extern FakeIR hostIR;
+extern FakeStorage hostSD;
+extern FakeEEPROM hostEEPROM;
+extern FakeFlash hostFlash;
+
+#endif // HAL_HOST_H
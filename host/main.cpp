@@ -0,0 +1,79 @@
+/*
+ * VHC Universal Remote - Host Runner
+ * Runs the unchanged sketch on the host HAL under the virtual clock
+ *
+ * Usage: vhc_host [--sd DIR] [--ms N] [--tap MS X Y] [--screenshot FILE]
+ *   --sd DIR          Copy DIR's *.csv files onto the fake SD card
+ *   --no-sd           Boot without a card
+ *   --ms N            Virtual time to run for (default 5000)
+ *   --tap MS X Y      Tap screen point X,Y at MS (repeatable)
+ *   --input TEXT      Serial console input, sent once setup() is done
+ *   --screenshot FILE Write the visible screen as a PPM at the end
+ *
+ * Serial output goes to stdout; IR sends are listed at the end.
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal_host.h"
+
+void setup();
+void loop();
+
+static void usage() {
+  fprintf(stderr, "usage: vhc_host [--sd DIR] [--no-sd] [--ms N] [--tap MS X Y] [--input TEXT] [--screenshot FILE]\n");
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  uint32_t runMs = 5000;
+  const char* screenshot = nullptr;
+  const char* input = nullptr;
+  
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--sd") && i + 1 < argc) {
+      int count = hostSD.loadDirectory(argv[++i], ".csv");
+      if (count < 0) {
+        fprintf(stderr, "Cannot read %s\n", argv[i]);
+        return 1;
+      }
+    } else if (!strcmp(argv[i], "--no-sd")) {
+      hostSD.setInserted(false);
+    } else if (!strcmp(argv[i], "--ms") && i + 1 < argc) {
+      runMs = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--tap") && i + 3 < argc) {
+      uint64_t at = strtoull(argv[i + 1], nullptr, 10) * 1000;
+      hostTouch.tapAt(at, atoi(argv[i + 2]), atoi(argv[i + 3]), 80);
+      i += 3;
+    } else if (!strcmp(argv[i], "--input") && i + 1 < argc) {
+      input = argv[++i];
+    } else if (!strcmp(argv[i], "--screenshot") && i + 1 < argc) {
+      screenshot = argv[++i];
+    } else {
+      usage();
+    }
+  }
+  
+  Serial.setEcho(true);
+  setup();
+  if (input) {
+    Serial.inject(input);
+    Serial.inject("\n");
+  }
+  while (hostClock.millis() < runMs) {
+    loop();
+  }
+  fflush(stdout);
+  
+  for (size_t i = 0; i < hostIR.sent.size(); i++) {
+    const IRSent& ir = hostIR.sent[i];
+    printf("IR,%lu,%s,0x%lX,%d\n", (unsigned long)ir.time, ir.protocol, (unsigned long)ir.code, ir.bits);
+  }
+  
+  if (screenshot && !hostPanel.writePPM(screenshot)) {
+    fprintf(stderr, "Cannot write %s\n", screenshot);
+    return 1;
+  }
+  return 0;
+}
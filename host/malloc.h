@@ -0,0 +1,24 @@
+/*
+ * VHC Universal Remote - Host malloc.h
+ * mallinfo() on top of glibc's mallinfo2(), which replaced it
+ */
+
+#ifndef HOST_MALLOC_H
+#define HOST_MALLOC_H
+
+#include_next <malloc.h>
+#include <string.h>
+
+static inline struct mallinfo hostMallinfo() {
+  struct mallinfo2 m = mallinfo2();
+  struct mallinfo info;
+  memset(&info, 0, sizeof(info));
+  info.arena = (int)m.arena;
+  info.uordblks = (int)m.uordblks;
+  info.fordblks = (int)m.fordblks;
+  return info;
+}
+
+#define mallinfo() hostMallinfo()
+
+#endif // HOST_MALLOC_H
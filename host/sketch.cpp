@@ -0,0 +1,23 @@
+/*
+ * VHC Universal Remote - Host Sketch
+ * The .ino compiled as C++, as the Arduino builder would
+ */
+
+// The builder's generated prototypes for functions used before their
+// definition in the sketch
+#include "../config.h"
+#include "../menu.h"
+#include "../touch_input.h"
+#include "../ir_function.h"
+
+void processIRCommands(Action action, const TouchRecord& touch);
+void sendIRFunction(IRFunction function, unsigned long touchTime);
+void irSendTask(uint32_t function);
+void sendingOverlayTask(uint32_t);
+void powerFeedbackTask(uint32_t pressed);
+void requestRedraw(unsigned long touchTime);
+void redrawTask(uint32_t);
+void reportIRResult(bool success);
+void updateDisplay();
+
+#include "../VHC_Universal_Remote.ino"
@@ -0,0 +1,269 @@
+/*
+ * VHC Universal Remote - Host Link Implementation
+ */
+
+#include "host_link.h"
+#include "hal.h"
+#include "menu.h"
+#include "ir_handler.h"
+#include "scheduler.h"
+#include "device_upload.h"
+
+// Global host link instance
+HostLink hostLink;
+
+HostLink::HostLink() {
+  head = 0;
+  count = 0;
+  received = 0;
+  lastByte = 0;
+  txSeq = 0;
+  sent = 0;
+  failed = 0;
+  badFrames = 0;
+}
+
+bool HostLink::feed(uint8_t c, bool lineStart) {
+  uint32_t now = hal.clock->millis();
+  
+  // A frame cut short must not swallow the console input after it
+  if (received > 0 && now - lastByte > PROTO_BYTE_TIMEOUT_MS) {
+    received = 0;
+    badFrames++;
+  }
+  if (received == 0 && !(lineStart && c == PROTO_SYNC)) {
+    return false;
+  }
+  
+  lastByte = now;
+  if ((unsigned)received >= sizeof(frame)) {
+    // Cannot happen with the length checked below; never write outside the buffer
+    received = 0;
+    badFrames++;
+    return true;
+  }
+  frame[received++] = c;
+  
+  if (received == 2 && frame[1] > PROTO_MAX_PAYLOAD) {
+    // Cannot be a frame; nothing sensible to ack
+    received = 0;
+    badFrames++;
+  } else if (received >= PROTO_HEADER_SIZE && received == PROTO_HEADER_SIZE + frame[1] + 2) {
+    handleFrame();
+    received = 0;
+  }
+  return true;
+}
+
+void HostLink::handleFrame() {
+  int length = frame[1];
+  uint8_t seq = frame[2];
+  uint8_t type = frame[3];
+  const uint8_t* payload = frame + PROTO_HEADER_SIZE;
+  
+  if (protoGet16(payload + length) != protoCRC(frame + 1, PROTO_HEADER_SIZE - 1 + length)) {
+    badFrames++;
+    sendAck(seq, PROTO_BAD_FRAME, 0);
+    return;
+  }
+  
+  switch (type) {
+    case PROTO_ENQUEUE:
+      enqueue(seq, payload, length);
+      break;
+      
+    case PROTO_STATUS:
+      sendStatus();
+      break;
+      
+    case PROTO_CLEAR:
+      clear();
+      sendAck(seq, PROTO_OK, 0);
+      break;
+      
+    case PROTO_PING:
+      sendAck(seq, PROTO_OK, 0);
+      break;
+      
+    case PROTO_UPLOAD_BEGIN:
+      sendAck(seq, deviceUpload.begin(payload, length), 0);
+      break;
+      
+    case PROTO_UPLOAD_DATA: {
+      uint8_t result = deviceUpload.write(payload, length);
+      sendAck(seq, result, result == PROTO_OK);
+      break;
+    }
+      
+    case PROTO_UPLOAD_END:
+      // The ack goes first; finish() follows it with UPLOAD_DONE
+      if (!deviceUpload.isReceiving()) {
+        sendAck(seq, PROTO_NO_UPLOAD, 0);
+        break;
+      }
+      sendAck(seq, PROTO_OK, 0);
+      deviceUpload.finish();
+      break;
+      
+    default:
+      sendAck(seq, PROTO_BAD_TYPE, 0);
+      break;
+  }
+}
+
+void HostLink::enqueue(uint8_t seq, const uint8_t* payload, int length) {
+  if (length % PROTO_SEND_SIZE != 0) {
+    badFrames++;
+    sendAck(seq, PROTO_BAD_FRAME, 0);
+    return;
+  }
+  
+  int entries = length / PROTO_SEND_SIZE;
+  int accepted = 0;
+  for (int i = 0; i < entries && count < HOST_QUEUE_SIZE; i++) {
+    const uint8_t* p = payload + i * PROTO_SEND_SIZE;
+    uint32_t deviceHash = protoGet32(p);
+    uint32_t commandHash = protoGet32(p + 4);
+    
+    Job& job = queue[(head + count) % HOST_QUEUE_SIZE];
+    job.deviceHash = deviceHash;
+    job.function = IR_FN_NONE;
+    job.repeatsLeft = p[8] ? p[8] : 1;
+    job.gapMs = protoGet16(p + 9);
+    job.seq = seq;
+    job.index = i;
+    job.result = PROTO_OK;
+    
+    for (int f = 0; f < IR_FN_COUNT; f++) {
+      if (hashName(getFunctionName((IRFunction)f)) == commandHash) {
+        job.function = f;
+        break;
+      }
+    }
+    
+    // Failures are still queued so DONE messages keep queue order
+    int device = findDevice(deviceHash);
+    if (device < 0) {
+      job.result = PROTO_NO_DEVICE;
+    } else if (!menu.findCommand(device, (IRFunction)job.function)) {
+      job.result = PROTO_NO_COMMAND;
+    }
+    
+    count++;
+    accepted++;
+  }
+  
+  sendAck(seq, accepted == entries ? PROTO_OK : PROTO_QUEUE_FULL, accepted);
+  if (accepted > 0 && !scheduler.isPending(sendTask)) {
+    scheduler.post(sendTask, PRIORITY_IR);
+  }
+}
+
+void HostLink::clear() {
+  while (count > 0) {
+    Job& job = queue[head];
+    job.result = PROTO_CLEARED;
+    sendDone(job);
+    head = (head + 1) % HOST_QUEUE_SIZE;
+    count--;
+  }
+}
+
+int HostLink::findDevice(uint32_t deviceHash) {
+  for (int d = 0; d < menu.getDeviceCount(); d++) {
+    if (hashName(menu.getDeviceName(d)) == deviceHash) {
+      return d;
+    }
+  }
+  return -1;
+}
+
+void HostLink::sendTask(uint32_t) {
+  HostLink& link = hostLink;
+  if (link.count == 0) return;
+  
+  // The previous frame's protocol repeats go out first
+  if (irHandler.isBusy()) {
+    scheduler.postDelayed(sendTask, PRIORITY_IR, irHandler.busyFor());
+    return;
+  }
+  
+  Job& job = link.queue[link.head];
+  uint32_t gap = 0;
+  if (job.result == PROTO_OK) {
+    // Where the device is now; the table may have changed since enqueue
+    int device = findDevice(job.deviceHash);
+    IRCommand* cmd = (device >= 0) ? menu.findCommand(device, (IRFunction)job.function) : NULL;
+    if (device < 0) {
+      job.result = PROTO_NO_DEVICE;
+    } else if (!cmd) {
+      job.result = PROTO_NO_COMMAND;
+    } else if (!irHandler.sendCommand(cmd)) {
+      job.result = PROTO_SEND_FAILED;
+    } else {
+      gap = job.gapMs;
+      if (--job.repeatsLeft > 0) {
+        scheduler.postDelayed(sendTask, PRIORITY_IR, gap);
+        return;
+      }
+    }
+  }
+  
+  link.sendDone(job);
+  link.head = (link.head + 1) % HOST_QUEUE_SIZE;
+  link.count--;
+  
+  if (link.count > 0) {
+    scheduler.postDelayed(sendTask, PRIORITY_IR, gap);
+  }
+}
+
+void HostLink::sendAck(uint8_t seq, uint8_t result, uint8_t accepted) {
+  uint8_t payload[PROTO_ACK_SIZE];
+  payload[0] = seq;
+  payload[1] = result;
+  payload[2] = accepted;
+  protoPut16(payload + 3, count);
+  send(PROTO_ACK, payload, sizeof(payload));
+}
+
+void HostLink::sendDone(const Job& job) {
+  if (job.result == PROTO_OK) {
+    sent++;
+  } else {
+    failed++;
+  }
+  
+  uint8_t payload[PROTO_DONE_SIZE];
+  payload[0] = job.seq;
+  payload[1] = job.index;
+  payload[2] = job.result;
+  protoPut32(payload + 3, hal.clock->millis());
+  send(PROTO_DONE, payload, sizeof(payload));
+}
+
+void HostLink::sendStatus() {
+  uint8_t payload[PROTO_STATUS_SIZE];
+  protoPut16(payload, count);
+  protoPut16(payload + 2, HOST_QUEUE_SIZE);
+  protoPut32(payload + 4, sent);
+  protoPut32(payload + 8, failed);
+  send(PROTO_STATUS_REPLY, payload, sizeof(payload));
+}
+
+void HostLink::send(uint8_t type, const uint8_t* payload, int length) {
+  uint8_t out[PROTO_MAX_FRAME];
+  int n = protoFrame(out, txSeq++, type, payload, length);
+  Serial.write(out, n);
+}
+
+void HostLink::printStats() {
+  Serial.print(F("HOST,queued,"));
+  Serial.println(count);
+  Serial.print(F("HOST,sent,"));
+  Serial.println(sent);
+  Serial.print(F("HOST,failed,"));
+  Serial.println(failed);
+  Serial.print(F("HOST,bad_frames,"));
+  Serial.println(badFrames);
+}
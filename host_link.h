@@ -0,0 +1,74 @@
+/*
+ * VHC Universal Remote - Host Link
+ * Batched IR sends from a host over the framed serial protocol
+ */
+
+#ifndef HOST_LINK_H
+#define HOST_LINK_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "remote_protocol.h"
+
+// Frames arrive through the serial console (see remote_protocol.h). An
+// ENQUEUE is acked as soon as it is parsed; its sends are checked against
+// the loaded devices then and queued. A scheduler task sends one
+// frame at a time at IR priority, waits out Sony/JVC repeats and each
+// entry's gap with delayed tasks, and reports every entry with a DONE
+// message, in queue order. Touch sends interleave with a running batch.
+// A job keeps the device's name hash and finds the device again when it
+// is sent, since a reload or flash sync can reorder the table meanwhile.
+class HostLink {
+private:
+  struct Job {
+    uint32_t deviceHash;  // hashName() of the device name
+    uint8_t function;     // IRFunction
+    uint8_t repeatsLeft;
+    uint16_t gapMs;
+    uint8_t seq;          // ENQUEUE frame and entry, for the DONE message
+    uint8_t index;
+    uint8_t result;       // ProtoResult; not PROTO_OK means skip the send
+  };
+  
+  Job queue[HOST_QUEUE_SIZE];
+  uint8_t head;
+  uint8_t count;
+  
+  uint8_t frame[PROTO_MAX_FRAME];
+  int received;
+  uint32_t lastByte;
+  uint8_t txSeq;
+  
+  uint32_t sent;
+  uint32_t failed;
+  uint32_t badFrames;
+  
+public:
+  HostLink();
+  
+  // Offered every serial byte by the console. Takes the bytes of a frame
+  // (one starting at the beginning of a line) and returns true for them.
+  bool feed(uint8_t c, bool lineStart);
+  
+  int getDepth() { return count; }
+  void printStats();
+  
+  // Unsolicited messages (upload results)
+  void send(uint8_t type, const uint8_t* payload, int length);
+  
+private:
+  void handleFrame();
+  void enqueue(uint8_t seq, const uint8_t* payload, int length);
+  void clear();
+  void sendAck(uint8_t seq, uint8_t result, uint8_t accepted);
+  void sendDone(const Job& job);
+  void sendStatus();
+  
+  static int findDevice(uint32_t deviceHash);  // Menu index, -1 if not loaded
+  static void sendTask(uint32_t);
+};
+
+// Global host link instance
+extern HostLink hostLink;
+
+#endif // HOST_LINK_H
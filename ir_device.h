@@ -0,0 +1,27 @@
+/*
+ * VHC Universal Remote - IR Device
+ * Device and command tables, shared by the firmware and host tools
+ */
+
+#ifndef IR_DEVICE_H
+#define IR_DEVICE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "ir_function.h"
+
+// Device structure
+struct IRCommand {
+  char command[16];
+  unsigned long code;
+  char protocol[8];
+};
+
+struct Device {
+  char name[32];
+  IRCommand commands[MAX_COMMANDS];
+  int commandCount;
+  int8_t slots[IR_FN_COUNT];  // Index into commands per IRFunction, -1 if missing
+};
+
+#endif // IR_DEVICE_H
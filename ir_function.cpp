@@ -0,0 +1,50 @@
+/*
+ * VHC Universal Remote - IR Functions Implementation
+ */
+
+#include "ir_function.h"
+
+// Indexed by IRFunction; these are the names used in device files
+constexpr const char* functionNames[IR_FN_COUNT] = {
+  "power", "volUp", "volDown", "chUp", "chDown", "mute", "input",
+  "play", "stop", "pause", "rewind", "forward", "record", "menu", "ok",
+  "0", "1", "2", "3", "4", "5", "6", "7", "8", "9"
+};
+
+// Open-addressed table of function + 1, built by the compiler
+#define FUNCTION_TABLE_SIZE 64
+
+struct FunctionTable {
+  uint8_t slots[FUNCTION_TABLE_SIZE];
+};
+
+constexpr FunctionTable buildFunctionTable() {
+  FunctionTable table = {};
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    uint32_t slot = hashName(functionNames[f]) & (FUNCTION_TABLE_SIZE - 1);
+    while (table.slots[slot]) {
+      slot = (slot + 1) & (FUNCTION_TABLE_SIZE - 1);
+    }
+    table.slots[slot] = f + 1;
+  }
+  return table;
+}
+
+constexpr FunctionTable functionTable = buildFunctionTable();
+
+const char* getFunctionName(IRFunction function) {
+  if (function < 0 || function >= IR_FN_COUNT) return "";
+  return functionNames[function];
+}
+
+IRFunction findFunction(const char* name) {
+  uint32_t slot = hashName(name) & (FUNCTION_TABLE_SIZE - 1);
+  while (functionTable.slots[slot]) {
+    IRFunction function = (IRFunction)(functionTable.slots[slot] - 1);
+    if (strcmp(functionNames[function], name) == 0) {
+      return function;
+    }
+    slot = (slot + 1) & (FUNCTION_TABLE_SIZE - 1);
+  }
+  return IR_FN_NONE;
+}
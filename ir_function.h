@@ -0,0 +1,59 @@
+/*
+ * VHC Universal Remote - IR Functions
+ * Standard remote functions and name lookup
+ */
+
+#ifndef IR_FUNCTION_H
+#define IR_FUNCTION_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Functions a device file can provide. Each device keeps a slot per
+// function, so the UI sends by id with a single index.
+enum IRFunction {
+  IR_FN_POWER,
+  IR_FN_VOL_UP,
+  IR_FN_VOL_DOWN,
+  IR_FN_CH_UP,
+  IR_FN_CH_DOWN,
+  IR_FN_MUTE,
+  IR_FN_INPUT,
+  IR_FN_PLAY,
+  IR_FN_STOP,
+  IR_FN_PAUSE,
+  IR_FN_REWIND,
+  IR_FN_FORWARD,
+  IR_FN_RECORD,
+  IR_FN_MENU,
+  IR_FN_OK,
+  IR_FN_DIGIT_0,
+  IR_FN_DIGIT_1,
+  IR_FN_DIGIT_2,
+  IR_FN_DIGIT_3,
+  IR_FN_DIGIT_4,
+  IR_FN_DIGIT_5,
+  IR_FN_DIGIT_6,
+  IR_FN_DIGIT_7,
+  IR_FN_DIGIT_8,
+  IR_FN_DIGIT_9,
+  IR_FN_COUNT,
+  IR_FN_NONE = IR_FN_COUNT
+};
+
+// FNV-1a hash of a name (function and device names)
+constexpr uint32_t hashName(const char* name) {
+  uint32_t hash = 2166136261u;
+  while (*name) {
+    hash = (hash ^ (uint8_t)*name++) * 16777619u;
+  }
+  return hash;
+}
+
+// Standard name ("power", "volUp", "0", ...)
+const char* getFunctionName(IRFunction function);
+
+// Name to function through a hash table; IR_FN_NONE if unknown
+IRFunction findFunction(const char* name);
+
+#endif // IR_FUNCTION_H
@@ -3,20 +3,30 @@
  */
 
 #include "ir_handler.h"
+#include "profiler.h"
+#include "usage_stats.h"
+#include "scheduler.h"
+#include "event_log.h"
+#include "loop_watchdog.h"
 
 // Global IR handler instance
 IRHandler irHandler;
 
 IRHandler::IRHandler() {
-  irsend = nullptr;
+  irOut = nullptr;
   lastSendTime = 0;
   initialized = false;
+  repeatProtocol = IR_PROTO_UNKNOWN;
+  repeatCode = 0;
+  repeatBits = 0;
+  repeatsLeft = 0;
+  repeatDue = 0;
   lastError[0] = '\0';
 }
 
 void IRHandler::begin() {
-  irsend = new IRsend(IR_LED);
-  irsend->begin();
+  irOut = hal.irOut;
+  irOut->begin();
   initialized = true;
   
   #if DEBUG_SERIAL
@@ -24,82 +34,85 @@ void IRHandler::begin() {
   #endif
 }
 
-bool IRHandler::sendCommand(const char* commandName) {
+bool IRHandler::sendFunction(IRFunction function) {
   if (!initialized) {
     setError("IR not initialized");
     return false;
   }
   
-  IRCommand* cmd = menu.findCommand(commandName);
+  IRCommand* cmd = menu.findCommand(function);
   if (!cmd) {
     setError("Command not found");
     return false;
   }
   
-  return sendCommand(cmd);
+  if (!sendCommand(cmd)) {
+    return false;
+  }
+  
+  // Feeds the main menu ordering
+  usageStats.recordUse(menu.getCurrentDevice()->name);
+  return true;
+}
+
+bool IRHandler::sendCommand(const char* commandName) {
+  // Scripted sends by name go through the function hash table
+  return sendFunction(findFunction(commandName));
 }
 
 bool IRHandler::sendCommand(IRCommand* cmd) {
+  PROFILE_SCOPE(PROF_SEND_COMMAND);
+  WATCHDOG_STAGE(STAGE_IR);
+  
   if (!initialized || !cmd) {
     setError("Invalid command");
     return false;
   }
   
+  bool success = false;
+  int bits;
+  IRProtocol protocol = resolveProtocol(cmd, bits);
+  
   #if DEBUG_IR
-    Serial.print(F("Sending IR: "));
-    Serial.print(cmd->command);
-    Serial.print(F(" Code: 0x"));
-    Serial.print(cmd->code, HEX);
-    Serial.print(F(" Protocol: "));
-    Serial.println(cmd->protocol);
+    LOG_EVENT(LOG_IR_SEND, cmd->command, cmd->code, protocol, bits);
   #endif
   
-  bool success = false;
-  
-  // Send based on protocol (handles both original and IRDB converted protocols)
-  if (strcmp(cmd->protocol, "NEC") == 0 || strcmp(cmd->protocol, "SAMSUNG") == 0) {
-    success = sendNEC(cmd->code);
-  } else if (strcmp(cmd->protocol, "Sony") == 0 || 
-             strcmp(cmd->protocol, "SONY12") == 0 ||
-             strcmp(cmd->protocol, "SONY15") == 0 ||
-             strcmp(cmd->protocol, "SONY20") == 0) {
-    // Determine bit count from protocol name or code value
-    int bits = 12; // default
-    if (strcmp(cmd->protocol, "SONY15") == 0 || cmd->code > 0xFFF) bits = 15;
-    if (strcmp(cmd->protocol, "SONY20") == 0 || cmd->code > 0x7FFF) bits = 20;
-    success = sendSony(cmd->code, bits);
-  } else if (strcmp(cmd->protocol, "RC5") == 0) {
-    success = sendRC5(cmd->code);
-  } else if (strcmp(cmd->protocol, "RC6") == 0) {
-    success = sendRC6(cmd->code);
-  } else if (strcmp(cmd->protocol, "PANASONIC") == 0) {
-    success = sendPanasonic(cmd->code);
-  } else if (strcmp(cmd->protocol, "JVC") == 0) {
-    success = sendJVC(cmd->code);
-  } else {
-    setError("Unknown protocol");
-    return false;
+  switch (protocol) {
+    case IR_PROTO_NEC:       success = sendNEC(cmd->code, bits); break;
+    case IR_PROTO_SONY:      success = sendSony(cmd->code, bits); break;
+    case IR_PROTO_RC5:       success = sendRC5(cmd->code, bits); break;
+    case IR_PROTO_RC6:       success = sendRC6(cmd->code, bits); break;
+    case IR_PROTO_PANASONIC: success = sendPanasonic(cmd->code, bits); break;
+    case IR_PROTO_JVC:       success = sendJVC(cmd->code, bits); break;
+    default:
+      setError("Unknown protocol");
+      return false;
   }
   
   if (success) {
-    lastSendTime = millis();
+    lastSendTime = hal.clock->millis();
   }
   
   return success;
 }
 
+IROutput* IRHandler::setOutput(IROutput* output) {
+  IROutput* previous = irOut;
+  irOut = output;
+  return previous;
+}
+
 bool IRHandler::sendPowerCommand() {
-  return sendCommand("power");
+  return sendFunction(IR_FN_POWER);
 }
 
 bool IRHandler::sendNEC(unsigned long code, int bits) {
   if (!initialized) return false;
   
-  irsend->sendNEC(code, bits);
+  transmitFrame(irOut, IR_PROTO_NEC, code, bits, false);
   
   #if DEBUG_IR
-    Serial.print(F("NEC sent: 0x"));
-    Serial.println(code, HEX);
+    LOG_EVENT(LOG_IR_FRAME, IR_PROTO_NEC, code);
   #endif
   
   return true;
@@ -108,15 +121,13 @@ bool IRHandler::sendNEC(unsigned long code, int bits) {
 bool IRHandler::sendSony(unsigned long code, int bits) {
   if (!initialized) return false;
   
-  // Sony protocol requires sending 3 times
-  for (int i = 0; i < 3; i++) {
-    irsend->sendSony(code, bits);
-    if (i < 2) delay(40); // Small delay between repeats
-  }
+  // Sony protocol requires sending 3 times; the other two frames are
+  // scheduled so input and drawing can run in the gaps
+  transmitFrame(irOut, IR_PROTO_SONY, code, bits, false);
+  scheduleRepeats(IR_PROTO_SONY, code, bits);
   
   #if DEBUG_IR
-    Serial.print(F("Sony sent: 0x"));
-    Serial.println(code, HEX);
+    LOG_EVENT(LOG_IR_FRAME, IR_PROTO_SONY, code);
   #endif
   
   return true;
@@ -125,11 +136,10 @@ bool IRHandler::sendSony(unsigned long code, int bits) {
 bool IRHandler::sendRC5(unsigned long code, int bits) {
   if (!initialized) return false;
   
-  irsend->sendRC5(code, bits);
+  transmitFrame(irOut, IR_PROTO_RC5, code, bits, false);
   
   #if DEBUG_IR
-    Serial.print(F("RC5 sent: 0x"));
-    Serial.println(code, HEX);
+    LOG_EVENT(LOG_IR_FRAME, IR_PROTO_RC5, code);
   #endif
   
   return true;
@@ -138,11 +148,10 @@ bool IRHandler::sendRC5(unsigned long code, int bits) {
 bool IRHandler::sendRC6(unsigned long code, int bits) {
   if (!initialized) return false;
   
-  irsend->sendRC6(code, bits);
+  transmitFrame(irOut, IR_PROTO_RC6, code, bits, false);
   
   #if DEBUG_IR
-    Serial.print(F("RC6 sent: 0x"));
-    Serial.println(code, HEX);
+    LOG_EVENT(LOG_IR_FRAME, IR_PROTO_RC6, code);
   #endif
   
   return true;
@@ -151,18 +160,11 @@ bool IRHandler::sendRC6(unsigned long code, int bits) {
 bool IRHandler::sendPanasonic(unsigned long code, int bits) {
   if (!initialized) return false;
   
-  // Panasonic uses 48-bit codes, IRremote expects address and command separately
-  // For IRDB converted codes, we need to extract them
-  uint16_t address = (code >> 32) & 0xFFFF; // Upper 16 bits
-  uint32_t command = code & 0xFFFFFFFF; // Lower 32 bits
-  
-  irsend->sendPanasonic(address, command);
+  // Address and command are split in transmitFrame
+  transmitFrame(irOut, IR_PROTO_PANASONIC, code, bits, false);
   
   #if DEBUG_IR
-    Serial.print(F("Panasonic sent: addr=0x"));
-    Serial.print(address, HEX);
-    Serial.print(F(" cmd=0x"));
-    Serial.println(command, HEX);
+    LOG_EVENT(LOG_IR_PANASONIC, 0, code);
   #endif
   
   return true;
@@ -172,24 +174,57 @@ bool IRHandler::sendJVC(unsigned long code, int bits) {
   if (!initialized) return false;
   
   // JVC requires sending the code once, then repeating without header
-  irsend->sendJVC(code, bits, false); // First send with header
-  delay(50);
-  irsend->sendJVC(code, bits, true);  // Repeat without header
+  transmitFrame(irOut, IR_PROTO_JVC, code, bits, false); // First send with header
+  scheduleRepeats(IR_PROTO_JVC, code, bits);
   
   #if DEBUG_IR
-    Serial.print(F("JVC sent: 0x"));
-    Serial.println(code, HEX);
+    LOG_EVENT(LOG_IR_FRAME, IR_PROTO_JVC, code);
   #endif
   
   return true;
 }
 
+void IRHandler::scheduleRepeats(IRProtocol protocol, unsigned long code, int bits) {
+  IRRepeatPlan plan = repeatPlan(protocol);
+  repeatProtocol = protocol;
+  repeatCode = code;
+  repeatBits = bits;
+  repeatsLeft = plan.frames;
+  repeatDue = hal.clock->millis() + plan.gapMs;
+  scheduler.postDelayed(repeatTask, PRIORITY_IR, plan.gapMs, plan.gapMs);
+}
+
+void IRHandler::repeatTask(uint32_t interval) {
+  WATCHDOG_STAGE(STAGE_IR);
+  IRHandler& ir = irHandler;
+  if (ir.repeatsLeft <= 0) return;
+  
+  transmitFrame(ir.irOut, ir.repeatProtocol, ir.repeatCode, ir.repeatBits, true);
+  
+  if (--ir.repeatsLeft > 0) {
+    ir.repeatDue = hal.clock->millis() + interval;
+    scheduler.postDelayed(repeatTask, PRIORITY_IR, interval, interval);
+  } else {
+    ir.repeatProtocol = IR_PROTO_UNKNOWN;
+  }
+}
+
+unsigned long IRHandler::busyFor() {
+  if (repeatsLeft <= 0) return 0;
+  
+  // Until the last repeat has gone out (they are evenly spaced)
+  unsigned long interval = repeatPlan(repeatProtocol).gapMs;
+  long untilNext = (long)(repeatDue - hal.clock->millis());
+  if (untilNext < 0) untilNext = 0;
+  return untilNext + (repeatsLeft - 1) * interval + 1;
+}
+
 bool IRHandler::canRepeat() {
-  return (millis() - lastSendTime >= REPEAT_DELAY);
+  return (hal.clock->millis() - lastSendTime >= REPEAT_DELAY);
 }
 
 void IRHandler::resetRepeatTimer() {
-  lastSendTime = millis();
+  lastSendTime = hal.clock->millis();
 }
 
 const char* IRHandler::getLastError() {
@@ -200,8 +235,5 @@ void IRHandler::setError(const char* message) {
   strncpy(lastError, message, 63);
   lastError[63] = '\0';
   
-  #if DEBUG_SERIAL
-    Serial.print(F("IR Error: "));
-    Serial.println(lastError);
-  #endif
+  LOG_EVENT(LOG_IR_ERROR, message);
 }
\ No newline at end of file
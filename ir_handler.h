@@ -7,25 +7,41 @@
 #define IR_HANDLER_H
 
 #include <Arduino.h>
-#include <IRremote.hpp>
 #include "config.h"
+#include "hal.h"
 #include "menu.h"
+#include "histogram.h"
+#include "ir_protocol.h"
 
 class IRHandler {
 private:
-  IRsend* irsend;
+  IROutput* irOut;
   unsigned long lastSendTime;
   bool initialized;
   
+  // Protocol repeats still to send (scheduled, not delayed);
+  // IR_PROTO_UNKNOWN when there are none
+  IRProtocol repeatProtocol;
+  unsigned long repeatCode;
+  int repeatBits;
+  int repeatsLeft;
+  unsigned long repeatDue;
+  
+  Histogram latency;  // Touch to first IR frame
+  
 public:
   IRHandler();
   void begin();
   
   // Send IR commands
+  bool sendFunction(IRFunction function);
   bool sendCommand(const char* commandName);
   bool sendCommand(IRCommand* cmd);
   bool sendPowerCommand();
   
+  // Swap the transmitter (trace replays mute IR); returns the old one
+  IROutput* setOutput(IROutput* output);
+  
   // Protocol-specific sending
   bool sendNEC(unsigned long code, int bits = 32);
   bool sendSony(unsigned long code, int bits = 12);
@@ -34,6 +50,14 @@ public:
   bool sendPanasonic(unsigned long code, int bits = 48);
   bool sendJVC(unsigned long code, int bits = 16);
   
+  // Multi-frame protocols (Sony, JVC) finish in the background
+  bool isBusy() { return repeatsLeft > 0; }
+  unsigned long busyFor();
+  
+  // Touch-to-IR latency
+  void recordLatency(unsigned long ms) { latency.add(ms); }
+  void printLatency() { latency.print("Touch to IR"); }
+  
   // Utility functions
   bool canRepeat(); // Check if enough time has passed for repeat
   void resetRepeatTimer();
@@ -42,6 +66,8 @@ public:
 private:
   char lastError[64];
   void setError(const char* message);
+  void scheduleRepeats(IRProtocol protocol, unsigned long code, int bits);
+  static void repeatTask(uint32_t interval);
 };
 
 // Global IR handler instance
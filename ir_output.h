@@ -0,0 +1,24 @@
+/*
+ * VHC Universal Remote - IR Output
+ * Transmitter interface, shared by the firmware HAL and host tools
+ */
+
+#ifndef IR_OUTPUT_H
+#define IR_OUTPUT_H
+
+#include <stdint.h>
+
+// One call sends one frame. Protocol repeats (Sony's three frames, the
+// headerless JVC repeat) are the caller's job, see ir_protocol.h.
+class IROutput {
+public:
+  virtual void begin() = 0;
+  virtual void sendNEC(uint32_t code, int bits) = 0;
+  virtual void sendSony(uint32_t code, int bits) = 0;
+  virtual void sendRC5(uint32_t code, int bits) = 0;
+  virtual void sendRC6(uint32_t code, int bits) = 0;
+  virtual void sendPanasonic(uint16_t address, uint32_t command) = 0;
+  virtual void sendJVC(uint32_t code, int bits, bool repeat) = 0;
+};
+
+#endif // IR_OUTPUT_H
@@ -0,0 +1,71 @@
+/*
+ * VHC Universal Remote - IR Protocols Implementation
+ */
+
+#include "ir_protocol.h"
+#include <string.h>
+
+IRProtocol resolveProtocol(const IRCommand* cmd, int& bits) {
+  // Handles both original and IRDB converted protocol names
+  const char* protocol = cmd->protocol;
+  
+  if (strcmp(protocol, "NEC") == 0 || strcmp(protocol, "SAMSUNG") == 0) {
+    bits = 32;
+    return IR_PROTO_NEC;
+  }
+  if (strcmp(protocol, "Sony") == 0 ||
+      strcmp(protocol, "SONY12") == 0 ||
+      strcmp(protocol, "SONY15") == 0 ||
+      strcmp(protocol, "SONY20") == 0) {
+    // Determine bit count from protocol name or code value
+    bits = 12;
+    if (strcmp(protocol, "SONY15") == 0 || cmd->code > 0xFFF) bits = 15;
+    if (strcmp(protocol, "SONY20") == 0 || cmd->code > 0x7FFF) bits = 20;
+    return IR_PROTO_SONY;
+  }
+  if (strcmp(protocol, "RC5") == 0) {
+    bits = 13;
+    return IR_PROTO_RC5;
+  }
+  if (strcmp(protocol, "RC6") == 0) {
+    bits = 16;
+    return IR_PROTO_RC6;
+  }
+  if (strcmp(protocol, "PANASONIC") == 0) {
+    bits = 48;
+    return IR_PROTO_PANASONIC;
+  }
+  if (strcmp(protocol, "JVC") == 0) {
+    bits = 16;
+    return IR_PROTO_JVC;
+  }
+  
+  bits = 0;
+  return IR_PROTO_UNKNOWN;
+}
+
+IRRepeatPlan repeatPlan(IRProtocol protocol) {
+  // Sony frames go out three times; JVC follows with one headerless repeat
+  switch (protocol) {
+    case IR_PROTO_SONY: return {2, IR_SONY_REPEAT_MS};
+    case IR_PROTO_JVC:  return {1, IR_JVC_REPEAT_MS};
+    default:            return {0, 0};
+  }
+}
+
+bool transmitFrame(IROutput* out, IRProtocol protocol, uint32_t code, int bits, bool repeat) {
+  switch (protocol) {
+    case IR_PROTO_NEC:  out->sendNEC(code, bits); return true;
+    case IR_PROTO_SONY: out->sendSony(code, bits); return true;
+    case IR_PROTO_RC5:  out->sendRC5(code, bits); return true;
+    case IR_PROTO_RC6:  out->sendRC6(code, bits); return true;
+    case IR_PROTO_JVC:  out->sendJVC(code, bits, repeat); return true;
+    case IR_PROTO_PANASONIC:
+      // Panasonic uses 48-bit codes, IRremote expects address and command
+      // separately; stored codes are 32 bits, so the address half is 0
+      out->sendPanasonic(0, code);
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,40 @@
+/*
+ * VHC Universal Remote - IR Protocols
+ * Protocol resolution and frame sequencing, shared by the firmware and host tools
+ */
+
+#ifndef IR_PROTOCOL_H
+#define IR_PROTOCOL_H
+
+#include <stdint.h>
+#include "config.h"
+#include "ir_device.h"
+#include "ir_output.h"
+
+// Transmit routines an IRCommand's protocol name resolves to
+enum IRProtocol {
+  IR_PROTO_NEC,
+  IR_PROTO_SONY,
+  IR_PROTO_RC5,
+  IR_PROTO_RC6,
+  IR_PROTO_PANASONIC,
+  IR_PROTO_JVC,
+  IR_PROTO_UNKNOWN
+};
+
+// Frames a protocol sends after the first one, each gapMs after the last
+struct IRRepeatPlan {
+  int frames;
+  uint32_t gapMs;
+};
+
+// Protocol and bit count a command is sent with
+IRProtocol resolveProtocol(const IRCommand* cmd, int& bits);
+
+IRRepeatPlan repeatPlan(IRProtocol protocol);
+
+// One frame; repeat picks the repeat form (headerless for JVC). False
+// for IR_PROTO_UNKNOWN.
+bool transmitFrame(IROutput* out, IRProtocol protocol, uint32_t code, int bits, bool repeat);
+
+#endif // IR_PROTOCOL_H
@@ -7,7 +7,9 @@
 #ifndef IRDB_CONVERTER_H
 #define IRDB_CONVERTER_H
 
-#include <Arduino.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 // IRDB Protocol mappings
 enum IRDBProtocol {
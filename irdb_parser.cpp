@@ -0,0 +1,171 @@
+/*
+ * VHC Universal Remote - IRDB Parser Implementation
+ */
+
+#include "irdb_parser.h"
+#include "irdb_converter.h"
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Common IRDB function name mappings
+struct FunctionMap {
+  const char* irdbName;
+  IRFunction function;
+};
+
+const FunctionMap functionMappings[] = {
+  {"POWER", IR_FN_POWER},
+  {"Power", IR_FN_POWER},
+  {"KEY_POWER", IR_FN_POWER},
+  {"VOLUME+", IR_FN_VOL_UP},
+  {"VOLUME_UP", IR_FN_VOL_UP},
+  {"VOL+", IR_FN_VOL_UP},
+  {"KEY_VOLUMEUP", IR_FN_VOL_UP},
+  {"VOLUME-", IR_FN_VOL_DOWN},
+  {"VOLUME_DOWN", IR_FN_VOL_DOWN},
+  {"VOL-", IR_FN_VOL_DOWN},
+  {"KEY_VOLUMEDOWN", IR_FN_VOL_DOWN},
+  {"CHANNEL+", IR_FN_CH_UP},
+  {"CHANNEL_UP", IR_FN_CH_UP},
+  {"CH+", IR_FN_CH_UP},
+  {"KEY_CHANNELUP", IR_FN_CH_UP},
+  {"CHANNEL-", IR_FN_CH_DOWN},
+  {"CHANNEL_DOWN", IR_FN_CH_DOWN},
+  {"CH-", IR_FN_CH_DOWN},
+  {"KEY_CHANNELDOWN", IR_FN_CH_DOWN},
+  {"MUTE", IR_FN_MUTE},
+  {"KEY_MUTE", IR_FN_MUTE},
+  {"INPUT", IR_FN_INPUT},
+  {"SOURCE", IR_FN_INPUT},
+  {"KEY_INPUT", IR_FN_INPUT},
+  {"PLAY", IR_FN_PLAY},
+  {"KEY_PLAY", IR_FN_PLAY},
+  {"STOP", IR_FN_STOP},
+  {"KEY_STOP", IR_FN_STOP},
+  {"PAUSE", IR_FN_PAUSE},
+  {"KEY_PAUSE", IR_FN_PAUSE},
+  {"REWIND", IR_FN_REWIND},
+  {"REW", IR_FN_REWIND},
+  {"KEY_REWIND", IR_FN_REWIND},
+  {"FAST_FORWARD", IR_FN_FORWARD},
+  {"FF", IR_FN_FORWARD},
+  {"KEY_FORWARD", IR_FN_FORWARD},
+  {"RECORD", IR_FN_RECORD},
+  {"REC", IR_FN_RECORD},
+  {"KEY_RECORD", IR_FN_RECORD},
+  {"MENU", IR_FN_MENU},
+  {"KEY_MENU", IR_FN_MENU},
+  {"OK", IR_FN_OK},
+  {"ENTER", IR_FN_OK},
+  {"SELECT", IR_FN_OK},
+  {"KEY_OK", IR_FN_OK},
+  {NULL, IR_FN_NONE}
+};
+
+void IRDBParser::deviceNameFromFile(const char* filename, char* deviceName) {
+  strcpy(deviceName, "Unknown");
+  if (!filename) return;
+  
+  // Remove path if present
+  const char* start = strrchr(filename, '/');
+  if (!start) start = filename;
+  else start++;
+  
+  // Copy name without extension
+  strncpy(deviceName, start, 31);
+  deviceName[31] = '\0';
+  
+  // Remove .csv extension
+  char* ext = strstr(deviceName, ".csv");
+  if (ext) *ext = '\0';
+  
+  // Replace underscores with spaces for display
+  for (char* p = deviceName; *p; p++) {
+    if (*p == '_') *p = ' ';
+  }
+}
+
+void IRDBParser::beginDevice(Device* device, const char* name) {
+  strncpy(device->name, name, 31);
+  device->name[31] = '\0';
+  device->commandCount = 0;
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    device->slots[f] = -1;
+  }
+}
+
+bool IRDBParser::addLine(char* line, Device* device) {
+  // Skip empty lines and comments
+  if (strlen(line) == 0 || line[0] == '#' || line[0] == '/') return false;
+  if (device->commandCount >= MAX_COMMANDS) return false;
+  
+  IRDBFields fields;
+  if (!splitFields(line, fields)) return false;
+  
+  // Map function name to our standard functions
+  IRFunction mapped = mapFunction(fields.functionName);
+  
+  // Only add if we recognize the function; the first code for a
+  // function wins (IRDB files often list aliases)
+  if (mapped == IR_FN_NONE || device->slots[mapped] >= 0) return false;
+  
+  IRCommand* cmd = &device->commands[device->commandCount];
+  
+  // Set command name
+  const char* name = getFunctionName(mapped);
+  size_t nameLength = strnlen(name, sizeof(cmd->command) - 1);
+  memcpy(cmd->command, name, nameLength);
+  cmd->command[nameLength] = '\0';
+  
+  // Convert IRDB codes to hex using converter
+  cmd->code = IRDBConverter::convertToHex(fields.protocol, fields.device, fields.subdevice, fields.function);
+  
+  // Set protocol name
+  const char* protocolName = IRDBConverter::getProtocolName(fields.protocol);
+  size_t protocolLength = strnlen(protocolName, sizeof(cmd->protocol) - 1);
+  memcpy(cmd->protocol, protocolName, protocolLength);
+  cmd->protocol[protocolLength] = '\0';
+  
+  device->slots[mapped] = device->commandCount;
+  device->commandCount++;
+  return true;
+}
+
+bool IRDBParser::splitFields(char* line, IRDBFields& fields) {
+  // Tokenizes the line in place
+  char* functionName = strtok(line, ",");
+  char* protocolStr = strtok(NULL, ",");
+  char* deviceStr = strtok(NULL, ",");
+  char* subdeviceStr = strtok(NULL, ",");
+  char* functionStr = strtok(NULL, ",");
+  
+  if (!functionName || !protocolStr || !deviceStr || !functionStr) {
+    return false;
+  }
+  
+  // Parse numeric values
+  fields.functionName = functionName;
+  fields.protocol = atoi(protocolStr);
+  fields.device = atoi(deviceStr);
+  fields.subdevice = atoi(subdeviceStr);
+  fields.function = atoi(functionStr);
+  return true;
+}
+
+IRFunction IRDBParser::mapFunction(const char* irdbName) {
+  // Check against mapping table
+  for (int i = 0; functionMappings[i].irdbName != NULL; i++) {
+    if (strcasecmp(irdbName, functionMappings[i].irdbName) == 0) {
+      return functionMappings[i].function;
+    }
+  }
+  
+  // Check for numeric buttons
+  if (strlen(irdbName) == 1 && irdbName[0] >= '0' && irdbName[0] <= '9') {
+    return (IRFunction)(IR_FN_DIGIT_0 + (irdbName[0] - '0'));
+  }
+  
+  // Unknown function - skip it
+  return IR_FN_NONE;
+}
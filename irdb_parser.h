@@ -0,0 +1,33 @@
+/*
+ * VHC Universal Remote - IRDB Parser
+ * IRDB CSV lines to device commands, shared by the firmware and host tools
+ */
+
+#ifndef IRDB_PARSER_H
+#define IRDB_PARSER_H
+
+#include "ir_device.h"
+
+// Fields of one IRDB line (the name points into the line)
+struct IRDBFields {
+  char* functionName;
+  int protocol;
+  int device;
+  int subdevice;
+  int function;
+};
+
+// No I/O here: callers read the lines (SDManager from SD, DeviceUpload
+// from the host link, tools/ir_service from disk) and build a device
+// with beginDevice() and one addLine() per line.
+class IRDBParser {
+public:
+  static bool splitFields(char* line, IRDBFields& fields);
+  static IRFunction mapFunction(const char* irdbName);  // Standard function, IR_FN_NONE if unknown
+  
+  static void deviceNameFromFile(const char* filename, char* deviceName);  // 32 bytes
+  static void beginDevice(Device* device, const char* name);
+  static bool addLine(char* line, Device* device);  // True if it added a command
+};
+
+#endif // IRDB_PARSER_H
@@ -0,0 +1,208 @@
+/*
+ * VHC Universal Remote - Key/Value Store Implementation
+ */
+
+#include "kv_store.h"
+#include "hal.h"
+
+// Global key/value store instance
+KVStore kvStore;
+
+#define KV_MAGIC       0x4B56  // "KV"
+#define KV_HEADER_SIZE 4       // Magic, generation
+#define KV_END         0xFF    // Unwritten EEPROM
+
+KVStore::KVStore() {
+  for (int k = 0; k < KV_KEY_COUNT; k++) {
+    values[k].present = false;
+    values[k].length = 0;
+  }
+  activeBank = -1;
+  generation = 0;
+  writeOffset = KV_HEADER_SIZE;
+  recordsWritten = 0;
+  compactions = 0;
+  skippedWrites = 0;
+}
+
+void KVStore::begin() {
+  // The valid bank with the newer generation is active
+  uint16_t gen0, gen1;
+  bool valid0 = readHeader(0, gen0);
+  bool valid1 = readHeader(1, gen1);
+  
+  if (valid0 && valid1) {
+    activeBank = ((int16_t)(gen1 - gen0) > 0) ? 1 : 0;
+  } else if (valid0) {
+    activeBank = 0;
+  } else if (valid1) {
+    activeBank = 1;
+  }
+  
+  if (activeBank < 0) {
+    // First boot: start an empty log in bank 0
+    activeBank = 1;
+    generation = 0;
+    compact();
+  } else {
+    generation = (activeBank == 0) ? gen0 : gen1;
+    replay();
+  }
+  
+  #if DEBUG_SERIAL
+    Serial.print(F("KV store: bank "));
+    Serial.print(activeBank);
+    Serial.print(F(" gen "));
+    Serial.print(generation);
+    Serial.print(F(", "));
+    Serial.print(writeOffset);
+    Serial.print(F("/"));
+    Serial.print(KV_BANK_SIZE);
+    Serial.println(F(" bytes used"));
+  #endif
+}
+
+bool KVStore::get(uint8_t key, void* value, uint8_t length) {
+  if (key == 0 || key >= KV_KEY_COUNT) return false;
+  if (!values[key].present || values[key].length != length) return false;
+  
+  memcpy(value, values[key].data, length);
+  return true;
+}
+
+bool KVStore::set(uint8_t key, const void* value, uint8_t length) {
+  if (key == 0 || key >= KV_KEY_COUNT || length > KV_MAX_VALUE) return false;
+  
+  // Don't wear the EEPROM with a value it already holds
+  Value& v = values[key];
+  if (v.present && v.length == length && memcmp(v.data, value, length) == 0) {
+    skippedWrites++;
+    return true;
+  }
+  
+  v.present = true;
+  v.length = length;
+  memcpy(v.data, value, length);
+  
+  if (!appendRecord(activeBank, writeOffset, key, v.data, length)) {
+    // Bank full: the new value goes over with all the others
+    compact();
+  }
+  return true;
+}
+
+void KVStore::printStats() {
+  Serial.print(F("KV bank "));
+  Serial.print(activeBank);
+  Serial.print(F(" gen "));
+  Serial.print(generation);
+  Serial.print(F(" used "));
+  Serial.print(writeOffset);
+  Serial.print(F("/"));
+  Serial.println(KV_BANK_SIZE);
+  Serial.print(F("Records written "));
+  Serial.print(recordsWritten);
+  Serial.print(F(", unchanged skipped "));
+  Serial.print(skippedWrites);
+  Serial.print(F(", compactions "));
+  Serial.println(compactions);
+}
+
+int KVStore::bankAddress(int bank) {
+  return KV_EEPROM_ADDR + bank * KV_BANK_SIZE;
+}
+
+bool KVStore::readHeader(int bank, uint16_t& gen) {
+  int address = bankAddress(bank);
+  uint16_t magic = hal.memory->read(address) | (hal.memory->read(address + 1) << 8);
+  gen = hal.memory->read(address + 2) | (hal.memory->read(address + 3) << 8);
+  return magic == KV_MAGIC;
+}
+
+void KVStore::replay() {
+  // Later records override earlier ones; stop at unwritten EEPROM or at
+  // the first record that fails its CRC (torn by a power cut)
+  int address = bankAddress(activeBank);
+  int offset = KV_HEADER_SIZE;
+  
+  while (offset + 3 <= KV_BANK_SIZE) {
+    uint8_t key = hal.memory->read(address + offset);
+    uint8_t length = hal.memory->read(address + offset + 1);
+    if (key == KV_END || length > KV_MAX_VALUE || offset + 3 + length > KV_BANK_SIZE) break;
+    
+    uint8_t data[KV_MAX_VALUE];
+    for (int i = 0; i < length; i++) {
+      data[i] = hal.memory->read(address + offset + 2 + i);
+    }
+    uint8_t header[2] = {key, length};
+    uint8_t crc = crc8(crc8(0, header, 2), data, length);
+    if (crc != hal.memory->read(address + offset + 2 + length)) break;
+    
+    if (key > 0 && key < KV_KEY_COUNT) {
+      values[key].present = true;
+      values[key].length = length;
+      memcpy(values[key].data, data, length);
+    }
+    offset += 3 + length;
+  }
+  
+  writeOffset = offset;
+}
+
+bool KVStore::appendRecord(int bank, int& offset, uint8_t key, const uint8_t* data, uint8_t length) {
+  if (offset + 3 + length > KV_BANK_SIZE) return false;
+  
+  int address = bankAddress(bank) + offset;
+  uint8_t header[2] = {key, length};
+  uint8_t crc = crc8(crc8(0, header, 2), data, length);
+  
+  // The bank still holds records from its previous generation: end the
+  // log after this record first, and write the key (which replaces the
+  // old end marker) last, so the record only appears once it is complete
+  if (offset + 3 + length < KV_BANK_SIZE) {
+    hal.memory->update(address + 3 + length, KV_END);
+  }
+  hal.memory->update(address + 1, length);
+  for (int i = 0; i < length; i++) {
+    hal.memory->update(address + 2 + i, data[i]);
+  }
+  hal.memory->update(address + 2 + length, crc);
+  hal.memory->update(address, key);
+  
+  offset += 3 + length;
+  recordsWritten++;
+  return true;
+}
+
+void KVStore::compact() {
+  // Copy the latest values to the other bank, then commit its header
+  int bank = 1 - activeBank;
+  int offset = KV_HEADER_SIZE;
+  hal.memory->update(bankAddress(bank) + offset, KV_END);
+  for (int k = 1; k < KV_KEY_COUNT; k++) {
+    if (values[k].present) {
+      appendRecord(bank, offset, k, values[k].data, values[k].length);
+    }
+  }
+  generation++;
+  int address = bankAddress(bank);
+  hal.memory->update(address + 2, generation & 0xFF);
+  hal.memory->update(address + 3, generation >> 8);
+  hal.memory->update(address, KV_MAGIC & 0xFF);
+  hal.memory->update(address + 1, KV_MAGIC >> 8);
+  
+  activeBank = bank;
+  writeOffset = offset;
+  compactions++;
+}
+
+uint8_t KVStore::crc8(uint8_t crc, const uint8_t* data, int length) {
+  // CRC-8, polynomial 0x07
+  for (int i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
@@ -0,0 +1,69 @@
+/*
+ * VHC Universal Remote - Key/Value Store
+ * Journaled settings storage in EEPROM with CRC and wear leveling
+ */
+
+#ifndef KV_STORE_H
+#define KV_STORE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Keys (one byte each; 0xFF marks unwritten EEPROM)
+enum KVKey {
+  KV_SCREEN = 1,       // Last screen shown
+  KV_DEVICE,           // Name hash of the selected device
+  KV_PAGE,             // Main menu page
+  KV_CALIBRATION,      // Touch calibration (4 x int16)
+  KV_BACKLIGHT,        // Backlight brightness
+  KV_SD_CATALOG,       // SD catalog hash the flash device database matches
+  KV_KEY_COUNT
+};
+
+// Values are appended as records (key, length, data, CRC-8) to the active
+// bank, so repeated saves walk across the bank instead of rewriting the
+// same bytes. When the bank is full the latest values are copied to the
+// other bank, whose header (magic + generation) is written last: a power
+// cut leaves either the old bank or the new one valid, and a torn record
+// at the end of the log fails its CRC and is ignored.
+class KVStore {
+private:
+  struct Value {
+    bool present;
+    uint8_t length;
+    uint8_t data[KV_MAX_VALUE];
+  };
+  
+  Value values[KV_KEY_COUNT];  // Latest value per key
+  int activeBank;
+  uint16_t generation;
+  int writeOffset;             // Next free byte in the active bank
+  
+  // Statistics
+  uint32_t recordsWritten;
+  uint32_t compactions;
+  uint32_t skippedWrites;      // Same value already stored
+  
+public:
+  KVStore();
+  void begin();
+  
+  // False if the key is missing or stored with another length
+  bool get(uint8_t key, void* value, uint8_t length);
+  bool set(uint8_t key, const void* value, uint8_t length);
+  
+  void printStats();
+  
+private:
+  int bankAddress(int bank);
+  bool readHeader(int bank, uint16_t& gen);
+  void replay();
+  bool appendRecord(int bank, int& offset, uint8_t key, const uint8_t* data, uint8_t length);
+  void compact();
+  uint8_t crc8(uint8_t crc, const uint8_t* data, int length);
+};
+
+// Global key/value store instance
+extern KVStore kvStore;
+
+#endif // KV_STORE_H
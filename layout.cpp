@@ -0,0 +1,131 @@
+/*
+ * VHC Universal Remote - Screen Layouts Implementation
+ */
+
+#include "layout.h"
+
+// Screen tables. Earlier widgets win where two overlap, but the checks at
+// the bottom reject overlaps so every drawn button hits its own action.
+
+constexpr Widget MAIN_WIDGETS[] = {
+  POWER_BUTTON,
+  {240, 180, 70, 30, "Next >", ACTION_NEXT_PAGE, WIDGET_PAGED, 0},
+  {240, 220, 70, 20, "Back", ACTION_PREV_PAGE, WIDGET_PAGED, 0},
+  {0, 0, SCREEN_WIDTH - LIST_FIXED_WIDTH, SCREEN_HEIGHT, nullptr, ACTION_DEVICE_STRIP, WIDGET_ZONE, 0}
+};
+
+// Page-relative; the strip is snapped to a page when a row is picked
+constexpr Widget DEVICE_PAGE_WIDGETS[DEVICES_PER_PAGE] = {
+  {20, 90, 200, 30, nullptr, ACTION_SELECT_DEVICE, WIDGET_BUTTON, 0},
+  {20, 125, 200, 30, nullptr, ACTION_SELECT_DEVICE, WIDGET_BUTTON, 1},
+  {20, 160, 200, 30, nullptr, ACTION_SELECT_DEVICE, WIDGET_BUTTON, 2},
+  {20, 195, 200, 30, nullptr, ACTION_SELECT_DEVICE, WIDGET_BUTTON, 3}
+};
+
+constexpr Widget DEVICE_WIDGETS[] = {
+  POWER_BUTTON,
+  {20, 100, 200, 30, "Volume", ACTION_VOLUME, WIDGET_BUTTON, 0},
+  {20, 140, 200, 30, "Channel", ACTION_CHANNEL, WIDGET_BUTTON, 0},
+  {20, 180, 200, 30, "Input", ACTION_INPUT, WIDGET_BUTTON, 0},
+  BACK_BUTTON
+};
+
+constexpr Widget VOLUME_WIDGETS[] = {
+  POWER_BUTTON,
+  {20, 100, 200, 30, "Vol Up", ACTION_VOL_UP, WIDGET_ARROW_UP, 0},
+  {20, 150, 200, 30, "Vol Down", ACTION_VOL_DOWN, WIDGET_ARROW_DOWN, 0},
+  BACK_BUTTON
+};
+
+constexpr Widget CHANNEL_WIDGETS[] = {
+  POWER_BUTTON,
+  {20, 100, 200, 30, "Ch Up", ACTION_CH_UP, WIDGET_ARROW_UP, 0},
+  {20, 150, 200, 30, "Ch Down", ACTION_CH_DOWN, WIDGET_ARROW_DOWN, 0},
+  BACK_BUTTON
+};
+
+#define WIDGET_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+// Grids are built by the compiler and live in flash
+
+constexpr bool overlapsCell(const Widget& w, int col, int row) {
+  return w.x < (col + 1) * LAYOUT_CELL && w.x + w.w > col * LAYOUT_CELL &&
+         w.y < (row + 1) * LAYOUT_CELL && w.y + w.h > row * LAYOUT_CELL;
+}
+
+constexpr LayoutGrid buildGrid(const Widget* widgets, int count) {
+  LayoutGrid grid = {};
+  for (int row = 0; row < LAYOUT_ROWS; row++) {
+    for (int col = 0; col < LAYOUT_COLS; col++) {
+      int found = 0;
+      for (int i = 0; i < count; i++) {
+        if (!overlapsCell(widgets[i], col, row)) continue;
+        if (found == 0) {
+          grid.cells[row][col] = i + 1;
+        } else if (found == 1) {
+          grid.cells[row][col] |= (i + 1) << 4;
+        } else {
+          grid.overflow = true;
+        }
+        found++;
+      }
+    }
+  }
+  return grid;
+}
+
+constexpr bool fitsLayout(const Widget* widgets, int count) {
+  if (count > LAYOUT_MAX_WIDGETS) return false;
+  for (int i = 0; i < count; i++) {
+    const Widget& a = widgets[i];
+    if (a.x < 0 || a.y < 0 || a.w <= 0 || a.h <= 0) return false;
+    if (a.x + a.w > SCREEN_WIDTH || a.y + a.h > SCREEN_HEIGHT) return false;
+    for (int j = 0; j < i; j++) {
+      const Widget& b = widgets[j];
+      if (a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h) return false;
+    }
+  }
+  return true;
+}
+
+#define DEFINE_LAYOUT(grid, table) \
+  constexpr LayoutGrid grid = buildGrid(table, WIDGET_COUNT(table)); \
+  static_assert(fitsLayout(table, WIDGET_COUNT(table)), #table " has overlapping or off-screen widgets"); \
+  static_assert(!grid.overflow, #table " has a grid cell shared by more than two widgets")
+
+DEFINE_LAYOUT(MAIN_GRID, MAIN_WIDGETS);
+DEFINE_LAYOUT(DEVICE_PAGE_GRID, DEVICE_PAGE_WIDGETS);
+DEFINE_LAYOUT(DEVICE_GRID, DEVICE_WIDGETS);
+DEFINE_LAYOUT(VOLUME_GRID, VOLUME_WIDGETS);
+DEFINE_LAYOUT(CHANNEL_GRID, CHANNEL_WIDGETS);
+
+const ScreenLayout layouts[LAYOUT_COUNT] = {
+  {MAIN_WIDGETS, WIDGET_COUNT(MAIN_WIDGETS), &MAIN_GRID},
+  {DEVICE_PAGE_WIDGETS, WIDGET_COUNT(DEVICE_PAGE_WIDGETS), &DEVICE_PAGE_GRID},
+  {DEVICE_WIDGETS, WIDGET_COUNT(DEVICE_WIDGETS), &DEVICE_GRID},
+  {VOLUME_WIDGETS, WIDGET_COUNT(VOLUME_WIDGETS), &VOLUME_GRID},
+  {CHANNEL_WIDGETS, WIDGET_COUNT(CHANNEL_WIDGETS), &CHANNEL_GRID}
+};
+
+const ScreenLayout& getLayout(LayoutId id) {
+  return layouts[id];
+}
+
+const Widget* layoutHitTest(LayoutId id, int x, int y) {
+  if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) {
+    return nullptr;
+  }
+  
+  const ScreenLayout& layout = layouts[id];
+  uint8_t cell = layout.grid->cells[y / LAYOUT_CELL][x / LAYOUT_CELL];
+  
+  // Up to two candidates per cell, checked against their exact bounds
+  while (cell) {
+    const Widget* widget = &layout.widgets[(cell & 0x0F) - 1];
+    if (widget->contains(x, y)) {
+      return widget;
+    }
+    cell >>= 4;
+  }
+  return nullptr;
+}
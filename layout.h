@@ -0,0 +1,87 @@
+/*
+ * VHC Universal Remote - Screen Layouts
+ * Widget tables shared by drawing and touch hit testing
+ */
+
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Coarse hit-test grid: each 16x16 cell lists the (at most two) widgets
+// that overlap it, so a touch needs one lookup and one or two rect checks
+#define LAYOUT_CELL 16
+#define LAYOUT_COLS (SCREEN_WIDTH / LAYOUT_CELL)
+#define LAYOUT_ROWS (SCREEN_HEIGHT / LAYOUT_CELL)
+#define LAYOUT_MAX_WIDGETS 15  // Widget index + 1 must fit in a nibble
+
+// What touching a widget does
+enum Action {
+  ACTION_NONE,
+  ACTION_POWER,
+  ACTION_BACK,          // Return to the previous screen
+  ACTION_NEXT_PAGE,
+  ACTION_PREV_PAGE,
+  ACTION_DEVICE_STRIP,  // Main menu scroll area (drag or tap a row)
+  ACTION_SELECT_DEVICE, // Row on a device page, arg = row
+  ACTION_VOLUME,
+  ACTION_CHANNEL,
+  ACTION_INPUT,
+  ACTION_VOL_UP,
+  ACTION_VOL_DOWN,
+  ACTION_CH_UP,
+  ACTION_CH_DOWN
+};
+
+// How a widget is drawn
+enum WidgetStyle {
+  WIDGET_BUTTON,      // Bordered box with centered label
+  WIDGET_PAGED,       // Button only shown when there is more than one page
+  WIDGET_ARROW_UP,    // Left-aligned label with an up arrow
+  WIDGET_ARROW_DOWN,
+  WIDGET_ZONE         // Touch area only, drawn by someone else
+};
+
+struct Widget {
+  int16_t x, y, w, h;
+  const char* label;  // nullptr when the label is supplied at draw time
+  Action action;
+  WidgetStyle style;
+  int8_t arg;
+  
+  constexpr bool contains(int px, int py) const {
+    return px >= x && px < x + w && py >= y && py < y + h;
+  }
+};
+
+struct LayoutGrid {
+  uint8_t cells[LAYOUT_ROWS][LAYOUT_COLS];  // Low nibble first candidate, high second
+  bool overflow;                            // A cell touched more than two widgets
+};
+
+struct ScreenLayout {
+  const Widget* widgets;
+  uint8_t count;
+  const LayoutGrid* grid;
+};
+
+enum LayoutId {
+  LAYOUT_MAIN,
+  LAYOUT_DEVICE_PAGE,  // One page of the main menu device strip
+  LAYOUT_DEVICE,
+  LAYOUT_VOLUME,
+  LAYOUT_CHANNEL,
+  LAYOUT_COUNT
+};
+
+// Widgets that appear on several screens
+constexpr Widget POWER_BUTTON = {240, 10, 70, 30, "POWER", ACTION_POWER, WIDGET_BUTTON, 0};
+constexpr Widget BACK_BUTTON = {240, 220, 70, 20, "Back", ACTION_BACK, WIDGET_BUTTON, 0};
+
+const ScreenLayout& getLayout(LayoutId id);
+
+// Widget under (x, y) or nullptr; out-of-range points are safe
+const Widget* layoutHitTest(LayoutId id, int x, int y);
+
+#endif // LAYOUT_H
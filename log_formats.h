@@ -0,0 +1,42 @@
+/*
+ * VHC Universal Remote - Log Formats
+ * Format table of the binary event log, shared with tools/log_decode
+ */
+
+#ifndef LOG_FORMATS_H
+#define LOG_FORMATS_H
+
+// One entry per log call site kind: id and printf-style text. Arguments
+// are 32-bit; %s takes a string, at most one per format, copied into the
+// record when it is logged (up to LOG_TEXT_BYTES - 1 characters).
+// Append new formats at the end so older captures still decode.
+#define LOG_FORMATS(X) \
+  X(LOG_STARTED,       "log output started, %u records dropped so far") \
+  X(LOG_IR_SEND,       "IR send %s code=0x%x protocol=%u bits=%u") \
+  X(LOG_IR_FRAME,      "IR frame protocol=%u code=0x%x") \
+  X(LOG_IR_PANASONIC,  "IR frame Panasonic addr=0x%x cmd=0x%x") \
+  X(LOG_IR_ERROR,      "IR error: %s") \
+  X(LOG_TOUCH_SAMPLE,  "touch raw x=%u y=%u z=%u") \
+  X(LOG_TOUCH_EVENT,   "touch %u at (%d,%d) handled after %u ms") \
+  X(LOG_TOUCH_DROPPED, "touch dropped events %u") \
+  X(LOG_LOOP_STALL,    "loop stalled in %s, %u ms so far") \
+  X(LOG_LOOP_STALL_END, "loop stall in %s lasted %u ms")
+
+#define LOG_FORMAT_ID(id, text) id,
+#define LOG_FORMAT_TEXT(id, text) text,
+
+enum LogFormat {
+  LOG_FORMATS(LOG_FORMAT_ID)
+  LOG_FORMAT_COUNT
+};
+
+// Drained stream: per record LOG_SYNC, format (2 bytes), argument count,
+// time in microseconds (4 bytes), then each argument: 4 bytes, or for %s a
+// length byte and that many characters. Little endian. On SD the records
+// follow each other; on Serial, which host tools share with the console,
+// they go out several to a PROTO_LOG frame (remote_protocol.h).
+#define LOG_SYNC       0xA5
+#define LOG_MAX_ARGS   4
+#define LOG_TEXT_BYTES 24
+
+#endif // LOG_FORMATS_H
@@ -0,0 +1,122 @@
+/*
+ * VHC Universal Remote - Loop Watchdog Implementation
+ */
+
+#include "loop_watchdog.h"
+#include "hal.h"
+#include "event_log.h"
+
+// Global loop watchdog instance
+LoopWatchdog loopWatchdog;
+
+static const char* const stageNames[STAGE_COUNT] = {
+  "idle",
+  "loop",
+  "touch",
+  "menu",
+  "ir",
+  "display",
+  "sd",
+  "flash",
+  "console"
+};
+
+LoopWatchdog::LoopWatchdog() {
+  stage = STAGE_IDLE;
+  passStart = 0;
+  stalled = false;
+  stallStage = STAGE_IDLE;
+  budget = WATCHDOG_BUDGET_MS;
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    stalls[i].setBucketMs(WATCHDOG_BUCKET_MS);
+  }
+  reset();
+}
+
+void LoopWatchdog::begin() {
+  passStart = hal.clock->millis();
+  checkTimer.begin(checkISR, WATCHDOG_CHECK_MS * 1000);
+}
+
+void LoopWatchdog::kick() {
+  uint32_t now = hal.clock->millis();
+  uint32_t length = now - passStart;
+  bool wasStalled = stalled;
+  
+  // New pass first: the check interrupt leaves a stalled pass alone,
+  // so it cannot flag the old start time again in between
+  passStart = now;
+  stage = STAGE_LOOP;
+  stalled = false;
+  
+  if (wasStalled) {
+    stalls[stallStage].add(length);
+    if (length > worst) {
+      worst = length;
+      worstStage = stallStage;
+    }
+    LOG_EVENT(LOG_LOOP_STALL_END, stageNames[stallStage], length);
+  }
+}
+
+void LoopWatchdog::checkISR() {
+  LoopWatchdog& w = loopWatchdog;
+  if (w.stalled || w.stage == STAGE_IDLE) return;
+  
+  uint32_t elapsed = hal.clock->millis() - w.passStart;
+  if (elapsed > w.budget) {
+    w.stallStage = w.stage;
+    w.stalled = true;
+    LOG_EVENT(LOG_LOOP_STALL, stageNames[w.stallStage], elapsed);
+  }
+}
+
+void LoopWatchdog::injectStall(LoopStage s, uint32_t ms) {
+  WATCHDOG_STAGE(s);
+  uint32_t start = hal.clock->millis();
+  while (hal.clock->millis() - start < ms) {
+    // Spin; the check interrupt keeps running
+  }
+}
+
+void LoopWatchdog::reset() {
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    stalls[i].reset();
+  }
+  worst = 0;
+  worstStage = STAGE_IDLE;
+}
+
+const char* LoopWatchdog::stageName(uint8_t s) {
+  return (s < STAGE_COUNT) ? stageNames[s] : "?";
+}
+
+int LoopWatchdog::findStage(const char* name) {
+  for (int i = 0; i < STAGE_COUNT; i++) {
+    if (strcmp(name, stageNames[i]) == 0) return i;
+  }
+  return -1;
+}
+
+void LoopWatchdog::printStats() {
+  Serial.print(F("Loop budget "));
+  Serial.print(budget);
+  Serial.print(F(" ms, worst stall "));
+  Serial.print(worst);
+  Serial.print(F(" ms in "));
+  Serial.println(stageName(worstStage));
+  
+  for (int i = STAGE_LOOP; i < STAGE_COUNT; i++) {
+    if (stalls[i].getCount() == 0) continue;
+    stalls[i].print(stageNames[i]);
+  }
+  
+  // A pass that is still stuck has not been counted yet
+  if (stalled) {
+    Serial.print(F("Stalled now in "));
+    Serial.print(stageName(stallStage));
+    Serial.print(F(" for "));
+    Serial.print(hal.clock->millis() - passStart);
+    Serial.println(F(" ms"));
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * VHC Universal Remote - Loop Watchdog
+ * Main loop stall detection with the stage that was running
+ */
+
+#ifndef LOOP_WATCHDOG_H
+#define LOOP_WATCHDOG_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "histogram.h"
+
+// What the main loop is doing; markers nest, the innermost one counts
+enum LoopStage {
+  STAGE_IDLE,       // Asleep between passes, never a stall
+  STAGE_LOOP,       // Unmarked loop code
+  STAGE_TOUCH,
+  STAGE_MENU,
+  STAGE_IR,
+  STAGE_DISPLAY,
+  STAGE_SD,
+  STAGE_FLASH,
+  STAGE_CONSOLE,
+  STAGE_COUNT
+};
+
+// kick() at the top of loop() starts a pass. A timer interrupt checks
+// every WATCHDOG_CHECK_MS whether the pass has run longer than the
+// budget; if so it notes the innermost active stage (and logs it to the
+// event log, so a hang that never ends still leaves a record). When the
+// loop comes round again the whole pass length goes into that stage's
+// stall histogram. Nothing resets the board; this is for finding out
+// where the time went.
+class LoopWatchdog {
+private:
+  IntervalTimer checkTimer;
+  volatile uint8_t stage;
+  volatile uint32_t passStart;   // millis() at kick()
+  volatile bool stalled;         // Budget crossed in this pass
+  volatile uint8_t stallStage;
+  uint32_t budget;
+  Histogram stalls[STAGE_COUNT]; // Pass length of each stall
+  uint32_t worst;
+  uint8_t worstStage;
+  
+public:
+  LoopWatchdog();
+  void begin();
+  
+  // Start of a loop pass; records the previous pass if it stalled
+  void kick();
+  
+  // Stage markers (see WATCHDOG_STAGE); enter returns the stage to restore
+  uint8_t enter(LoopStage s) {
+    uint8_t previous = stage;
+    stage = s;
+    return previous;
+  }
+  void leave(uint8_t previous) { stage = previous; }
+  
+  void setBudget(uint32_t ms) { budget = ms; }
+  uint32_t getBudget() { return budget; }
+  
+  // Busy-waits ms inside the given stage, to check the detection
+  void injectStall(LoopStage s, uint32_t ms);
+  
+  void reset();
+  void printStats();
+  static const char* stageName(uint8_t s);
+  static int findStage(const char* name);  // -1 if unknown
+  
+private:
+  static void checkISR();
+};
+
+// Global loop watchdog instance
+extern LoopWatchdog loopWatchdog;
+
+class StageScope {
+private:
+  uint8_t previous;
+  
+public:
+  StageScope(LoopStage s) : previous(loopWatchdog.enter(s)) {}
+  ~StageScope() { loopWatchdog.leave(previous); }
+};
+
+#define WATCHDOG_CONCAT2(a, b) a##b
+#define WATCHDOG_CONCAT(a, b) WATCHDOG_CONCAT2(a, b)
+#define WATCHDOG_STAGE(s) StageScope WATCHDOG_CONCAT(stageScope, __LINE__)(s)
+
+#endif // LOOP_WATCHDOG_H
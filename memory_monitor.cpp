@@ -0,0 +1,90 @@
+/*
+ * VHC Universal Remote - Memory Monitor Implementation
+ */
+
+#include "memory_monitor.h"
+#include <malloc.h>
+#include "menu.h"
+
+// Global memory monitor instance
+MemoryMonitor memoryMonitor;
+
+#define STACK_PATTERN 0xA5A5A5A5UL
+
+#if defined(__IMXRT1062__)
+  // Teensy 4 linker symbols
+  extern unsigned long _ebss;
+  extern unsigned long _estack;
+  extern unsigned long _heap_end;
+  extern "C" char* __brkval;
+  #define STACK_BOTTOM ((uint32_t*)&_ebss)
+  #define STACK_TOP    ((uint32_t*)&_estack)
+#endif
+
+MemoryMonitor::MemoryMonitor() {
+}
+
+void MemoryMonitor::begin() {
+  #if defined(STACK_BOTTOM)
+    // Paint from the end of .bss up to just below the live frames
+    uint32_t marker;
+    uint32_t* limit = (uint32_t*)((uint32_t)&marker - STACK_PAINT_MARGIN);
+    for (uint32_t* p = STACK_BOTTOM; p < limit; p++) {
+      *p = STACK_PATTERN;
+    }
+  #endif
+}
+
+uint32_t MemoryMonitor::stackSize() {
+  #if defined(STACK_BOTTOM)
+    return (uint32_t)STACK_TOP - (uint32_t)STACK_BOTTOM;
+  #else
+    return 0;
+  #endif
+}
+
+uint32_t MemoryMonitor::stackHighWater() {
+  #if defined(STACK_BOTTOM)
+    uint32_t* p = STACK_BOTTOM;
+    while (p < STACK_TOP && *p == STACK_PATTERN) {
+      p++;
+    }
+    return (uint32_t)STACK_TOP - (uint32_t)p;
+  #else
+    return 0;
+  #endif
+}
+
+uint32_t MemoryMonitor::heapFree() {
+  #if defined(STACK_BOTTOM)
+    char* top = __brkval ? __brkval : (char*)&_heap_end;
+    return (uint32_t)&_heap_end - (uint32_t)top;
+  #else
+    return 0;
+  #endif
+}
+
+void MemoryMonitor::printReport() {
+  uint32_t size = stackSize();
+  uint32_t used = stackHighWater();
+  
+  Serial.print(F("MEM,stack_size,"));
+  Serial.println(size);
+  Serial.print(F("MEM,stack_high_water,"));
+  Serial.println(used);
+  Serial.print(F("MEM,stack_headroom,"));
+  Serial.println(size - used);
+  
+  Serial.print(F("MEM,heap_used,"));
+  Serial.println(mallinfo().uordblks);
+  Serial.print(F("MEM,heap_free,"));
+  Serial.println(heapFree());
+  
+  // Each extra device slot costs this much stack headroom
+  Serial.print(F("MEM,device_bytes,"));
+  Serial.println((uint32_t)sizeof(Device));
+  Serial.print(F("MEM,device_table,"));
+  Serial.println((uint32_t)(sizeof(Device) * MAX_DEVICES));
+  Serial.print(F("MEM,devices_in_headroom,"));
+  Serial.println((size - used) / (uint32_t)sizeof(Device));
+}
@@ -0,0 +1,33 @@
+/*
+ * VHC Universal Remote - Memory Monitor
+ * Stack high-water mark and RAM headroom at runtime
+ */
+
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// The stack grows down through DTCM towards the end of .bss. begin()
+// fills the free part with a pattern; the deepest word that no longer
+// holds it is the high-water mark. On Teensy 4.1 the heap is in OCRAM
+// (RAM2), so growing static data (e.g. MAX_DEVICES, which sizes the
+// device table inside Menu) comes straight out of the stack's room.
+// tools/memory_report gives the static breakdown per module.
+class MemoryMonitor {
+public:
+  MemoryMonitor();
+  void begin();  // Call first thing in setup()
+  
+  uint32_t stackSize();      // _ebss to the top of the stack
+  uint32_t stackHighWater(); // Most stack ever used
+  uint32_t heapFree();       // OCRAM not yet claimed by the heap
+  
+  void printReport();
+};
+
+// Global memory monitor instance
+extern MemoryMonitor memoryMonitor;
+
+#endif // MEMORY_MONITOR_H
@@ -3,7 +3,16 @@
  */
 
 #include "menu.h"
-#include "sd_manager.h"
+#include "ascii_art.h"
+#include "device_store.h"
+#include "device_bundle.h"
+#include "device_list.h"
+#include "screen_cache.h"
+#include "usage_stats.h"
+#include "kv_store.h"
+#include "hal.h"
+#include "loop_watchdog.h"
+#include "scheduler.h"
 
 // Global menu instance
 Menu menu;
@@ -15,10 +24,9 @@ Menu::Menu() {
   selectedDevice = 0;
   mainMenuPage = 0;
   screenTimer = 0;
-  touchTimer = 0;
-  touchActive = false;
   lastTouchX = 0;
   lastTouchY = 0;
+  stateChangedAt = 0;
   refreshNeeded = true;
   errorMessage[0] = '\0';
 }
@@ -32,6 +40,11 @@ void Menu::setScreen(Screen screen) {
   currentScreen = screen;
   refreshNeeded = true;
   resetTimer();
+  
+  if (screen == SCREEN_MAIN) {
+    usageStats.startTrip();
+  }
+  saveState();
 }
 
 void Menu::returnToPrevious() {
@@ -39,29 +52,165 @@ void Menu::returnToPrevious() {
   currentScreen = previousScreen;
   previousScreen = temp;
   refreshNeeded = true;
+  
+  if (currentScreen == SCREEN_MAIN) {
+    usageStats.startTrip();
+  }
+  saveState();
 }
 
 bool Menu::isTimeToAdvance() {
-  return (currentScreen == SCREEN_SPLASH && millis() - screenTimer > SPLASH_DURATION);
+  #if FAST_BOOT
+    const unsigned long duration = SPLASH_FAST_DURATION;
+  #else
+    const unsigned long duration = SPLASH_DURATION;
+  #endif
+  return (currentScreen == SCREEN_SPLASH && hal.clock->millis() - screenTimer >= duration);
 }
 
 int Menu::loadDevices() {
-  // Use the SD manager to load devices
-  deviceCount = sdManager.loadDevices(devices, MAX_DEVICES);
+  // From flash, or SD while flash has none (-1 without a card)
+  deviceCount = deviceStore.loadDevices(devices, MAX_DEVICES);
+  bool noCard = deviceCount < 0;
+  if (noCard) deviceCount = 0;
   
-  if (deviceCount < 0) {
-    setError(ERROR_NO_SD);
-    return -1;
-  }
+  // Devices compiled into the firmware work with or without a card
+  mergeBundledDevices();
+  
+  // Cached screens show device names from the old table
+  screenCache.clear();
   
   if (deviceCount == 0) {
-    setError(ERROR_NO_DEVICES);
+    setError(noCard ? ERROR_NO_SD : ERROR_NO_DEVICES);
     return -1;
   }
   
+  #if USAGE_SORT_MENU
+    // Most used devices on the first page
+    usageStats.sortDevices(devices, deviceCount);
+  #endif
+  
   return deviceCount;
 }
 
+void Menu::mergeBundledDevices() {
+  // Already converted, so this is a copy out of flash. A card file with
+  // the same name is the editable copy and wins.
+  for (int i = 0; i < BUNDLED_DEVICE_COUNT && deviceCount < MAX_DEVICES; i++) {
+    if (findDevice(BUNDLED_DEVICES[i].name) < 0) {
+      devices[deviceCount++] = BUNDLED_DEVICES[i];
+    }
+  }
+}
+
+int Menu::findDevice(const char* name) {
+  for (int i = 0; i < deviceCount; i++) {
+    if (strcmp(devices[i].name, name) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int Menu::addDevice(const Device& device) {
+  int index = findDevice(device.name);
+  if (index < 0) {
+    if (deviceCount >= MAX_DEVICES) return -1;
+    index = deviceCount++;
+  }
+  devices[index] = device;
+  
+  // Cached screens show the old table
+  screenCache.clear();
+  
+  // The first device ends the "no devices" error
+  if (currentScreen == SCREEN_ERROR) {
+    setScreen(SCREEN_MAIN);
+  }
+  refreshNeeded = true;
+  return index;
+}
+
+bool Menu::restoreState() {
+  // Resume the last screen; the device is matched by name since the
+  // table may have been reordered or edited since it was saved
+  uint8_t screen;
+  uint8_t page;
+  uint32_t deviceHash;
+  if (!kvStore.get(KV_SCREEN, &screen, sizeof(screen))) return false;
+  if (screen < SCREEN_MAIN || screen > SCREEN_CHANNEL) return false;
+  
+  if (kvStore.get(KV_PAGE, &page, sizeof(page))) {
+    setPage(page);
+  }
+  
+  if (screen != SCREEN_MAIN) {
+    int found = -1;
+    if (kvStore.get(KV_DEVICE, &deviceHash, sizeof(deviceHash))) {
+      for (int i = 0; i < deviceCount; i++) {
+        if (hashName(devices[i].name) == deviceHash) {
+          found = i;
+          break;
+        }
+      }
+    }
+    if (found < 0) return false;
+    selectDevice(found);
+  }
+  
+  // Rebuild the way back: volume/channel return to the device menu
+  currentScreen = (screen == SCREEN_MAIN) ? SCREEN_SPLASH : SCREEN_MAIN;
+  if (screen == SCREEN_VOLUME || screen == SCREEN_CHANNEL) {
+    currentScreen = SCREEN_DEVICE;
+  }
+  setScreen((Screen)screen);
+  
+  #if DEBUG_SERIAL
+    Serial.print(F("Resumed screen "));
+    Serial.print(screen);
+    Serial.print(F(" device "));
+    Serial.print(selectedDevice);
+    Serial.print(F(" page "));
+    Serial.println(mainMenuPage);
+  #endif
+  
+  return true;
+}
+
+void Menu::saveState() {
+  // Browsing screens and pages would otherwise append a record per tap;
+  // the state is written once it has been left alone STATE_SAVE_DELAY_MS
+  stateChangedAt = hal.clock->millis();
+  if (!scheduler.isPending(saveStateTask)) {
+    scheduler.postDelayed(saveStateTask, PRIORITY_BACKGROUND, STATE_SAVE_DELAY_MS);
+  }
+}
+
+void Menu::saveStateTask(uint32_t) {
+  unsigned long quiet = hal.clock->millis() - menu.stateChangedAt;
+  if (quiet < STATE_SAVE_DELAY_MS) {
+    scheduler.postDelayed(saveStateTask, PRIORITY_BACKGROUND, STATE_SAVE_DELAY_MS - quiet);
+    return;
+  }
+  menu.writeState();
+}
+
+void Menu::writeState() {
+  // Unchanged values are not rewritten, see KVStore::set()
+  if (currentScreen < SCREEN_MAIN || currentScreen > SCREEN_CHANNEL) return;
+  
+  uint8_t screen = currentScreen;
+  uint8_t page = mainMenuPage;
+  kvStore.set(KV_SCREEN, &screen, sizeof(screen));
+  kvStore.set(KV_PAGE, &page, sizeof(page));
+  
+  Device* dev = getCurrentDevice();
+  if (dev && currentScreen != SCREEN_MAIN) {
+    uint32_t deviceHash = hashName(dev->name);
+    kvStore.set(KV_DEVICE, &deviceHash, sizeof(deviceHash));
+  }
+}
+
 Device* Menu::getDevice(int index) {
   if (index >= 0 && index < deviceCount) {
     return &devices[index];
@@ -79,17 +228,23 @@ const char* Menu::getDeviceName(int index) {
 }
 
 void Menu::nextPage() {
+  // The device strip scrolls to the page and reports back through setPage()
   int totalPages = getTotalPages();
   if (mainMenuPage < totalPages - 1) {
-    mainMenuPage++;
-    refreshNeeded = true;
+    deviceList.scrollToPage(mainMenuPage + 1);
   }
 }
 
 void Menu::previousPage() {
   if (mainMenuPage > 0) {
-    mainMenuPage--;
-    refreshNeeded = true;
+    deviceList.scrollToPage(mainMenuPage - 1);
+  }
+}
+
+void Menu::setPage(int page) {
+  if (page >= 0 && page < getTotalPages()) {
+    mainMenuPage = page;
+    saveState();
   }
 }
 
@@ -103,146 +258,102 @@ int Menu::getTotalPages() {
   return (deviceCount + DEVICES_PER_PAGE - 1) / DEVICES_PER_PAGE;
 }
 
-TouchEvent Menu::processTouchInput(int x, int y, bool touched) {
-  TouchEvent event = TOUCH_NONE;
+Action Menu::handleTouch(const TouchRecord& touch) {
+  WATCHDOG_STAGE(STAGE_MENU);
   
-  if (touched && !touchActive) {
-    // New touch
-    touchActive = true;
-    touchTimer = millis();
-    lastTouchX = x;
-    lastTouchY = y;
-    event = TOUCH_TAP;
-  } else if (touched && touchActive) {
-    // Continuing touch
-    if (millis() - touchTimer > REPEAT_DELAY) {
-      event = TOUCH_HOLD;
-    }
-  } else if (!touched && touchActive) {
-    // Touch released
-    touchActive = false;
-    event = TOUCH_RELEASE;
+  if (touch.type == TOUCH_NONE) return ACTION_NONE;
+  if (touch.type == TOUCH_TAP) {
+    lastTouchX = touch.x;
+    lastTouchY = touch.y;
+    usageStats.noteTap();
   }
   
-  return event;
-}
-
-void Menu::handleTouch(int x, int y, TouchEvent event) {
-  if (event == TOUCH_NONE) return;
+  // A drag on the device strip keeps the touch even if it crosses a button
+  if (currentScreen == SCREEN_MAIN && deviceList.isDragging()) {
+    handleStripTouch(touch);
+    return ACTION_DEVICE_STRIP;
+  }
   
-  // Handle power button from any screen
-  if (currentScreen != SCREEN_SPLASH && isInZone(x, y, 240, 10, 70, 30)) {
-    handlePowerButton(event);
-    return;
+  LayoutId layoutId;
+  if (!getLayoutId(layoutId)) return ACTION_NONE;
+  
+  const Widget* widget = layoutHitTest(layoutId, touch.x, touch.y);
+  if (!widget) return ACTION_NONE;
+  
+  // Navigation happens here; IR actions are sent by the main sketch
+  if (touch.type == TOUCH_TAP) {
+    switch (widget->action) {
+      case ACTION_DEVICE_STRIP:
+        deviceList.press(touch.x, touch.time);
+        break;
+      case ACTION_NEXT_PAGE:
+        nextPage();
+        break;
+      case ACTION_PREV_PAGE:
+        previousPage();
+        break;
+      case ACTION_VOLUME:
+        setScreen(SCREEN_VOLUME);
+        break;
+      case ACTION_CHANNEL:
+        setScreen(SCREEN_CHANNEL);
+        break;
+      case ACTION_BACK:
+        returnToPrevious();
+        break;
+      default:
+        break;
+    }
   }
   
-  // Route to appropriate handler
+  return widget->action;
+}
+
+bool Menu::getLayoutId(LayoutId& id) {
   switch (currentScreen) {
     case SCREEN_MAIN:
-      handleMainMenuTouch(x, y, event);
-      break;
+      id = LAYOUT_MAIN;
+      return true;
     case SCREEN_DEVICE:
-      handleDeviceMenuTouch(x, y, event);
-      break;
+      id = LAYOUT_DEVICE;
+      return true;
     case SCREEN_VOLUME:
-      handleVolumeMenuTouch(x, y, event);
-      break;
+      id = LAYOUT_VOLUME;
+      return true;
     case SCREEN_CHANNEL:
-      handleChannelMenuTouch(x, y, event);
-      break;
+      id = LAYOUT_CHANNEL;
+      return true;
+    default:
+      // Splash and error screens have no buttons
+      return false;
   }
 }
 
-bool Menu::isInZone(int x, int y, int zoneX, int zoneY, int zoneW, int zoneH) {
-  return (x >= zoneX && x < zoneX + zoneW && y >= zoneY && y < zoneY + zoneH);
-}
-
-void Menu::handleMainMenuTouch(int x, int y, TouchEvent event) {
-  if (event != TOUCH_TAP) return;
-  
-  // Check device buttons
-  int startIdx = mainMenuPage * DEVICES_PER_PAGE;
-  for (int i = 0; i < DEVICES_PER_PAGE && (startIdx + i) < deviceCount; i++) {
-    if (isInZone(x, y, 20, 60 + (i * 40), 200, 30)) {
-      selectDevice(startIdx + i);
+void Menu::handleStripTouch(const TouchRecord& touch) {
+  // Once the device strip owns a touch it gets every event until release
+  if (touch.type == TOUCH_DRAG || touch.type == TOUCH_HOLD) {
+    deviceList.drag(touch.x, touch.time);
+  } else if (touch.type == TOUCH_RELEASE && deviceList.release(touch.time)) {
+    // Tap without dragging: pick the device row under the press point
+    const Widget* row = layoutHitTest(LAYOUT_DEVICE_PAGE, lastTouchX, lastTouchY);
+    int index = mainMenuPage * DEVICES_PER_PAGE + (row ? row->arg : 0);
+    if (row && index < deviceCount) {
+      selectDevice(index);
       setScreen(SCREEN_DEVICE);
-      return;
     }
   }
-  
-  // Check next button
-  if (isInZone(x, y, 220, 60, 80, 30) && mainMenuPage < getTotalPages() - 1) {
-    nextPage();
-  }
-}
-
-void Menu::handleDeviceMenuTouch(int x, int y, TouchEvent event) {
-  if (event != TOUCH_TAP) return;
-  
-  // Volume button
-  if (isInZone(x, y, 20, 60, 120, 30)) {
-    setScreen(SCREEN_VOLUME);
-  }
-  // Channel button
-  else if (isInZone(x, y, 20, 100, 120, 30)) {
-    setScreen(SCREEN_CHANNEL);
-  }
-  // Input button
-  else if (isInZone(x, y, 20, 140, 120, 30)) {
-    // This will trigger IR send in main code
-    refreshNeeded = true;
-  }
-  // Back button
-  else if (isInZone(x, y, 240, 220, 70, 20)) {
-    returnToPrevious();
-  }
 }
 
-void Menu::handleVolumeMenuTouch(int x, int y, TouchEvent event) {
-  if (event == TOUCH_TAP || event == TOUCH_HOLD) {
-    // Volume up
-    if (isInZone(x, y, 20, 60, 120, 30)) {
-      // This will trigger IR send in main code
-      refreshNeeded = true;
-    }
-    // Volume down
-    else if (isInZone(x, y, 20, 100, 120, 30)) {
-      // This will trigger IR send in main code
-      refreshNeeded = true;
-    }
-  }
-  
-  // Back button (tap only)
-  if (event == TOUCH_TAP && isInZone(x, y, 240, 220, 70, 20)) {
-    returnToPrevious();
-  }
+IRCommand* Menu::findCommand(IRFunction function) {
+  return findCommand(selectedDevice, function);
 }
 
-void Menu::handleChannelMenuTouch(int x, int y, TouchEvent event) {
-  if (event == TOUCH_TAP || event == TOUCH_HOLD) {
-    // Channel up
-    if (isInZone(x, y, 20, 60, 120, 30)) {
-      // This will trigger IR send in main code
-      refreshNeeded = true;
-    }
-    // Channel down
-    else if (isInZone(x, y, 20, 100, 120, 30)) {
-      // This will trigger IR send in main code
-      refreshNeeded = true;
-    }
-  }
+IRCommand* Menu::findCommand(int deviceIndex, IRFunction function) {
+  Device* dev = getDevice(deviceIndex);
+  if (!dev || function < 0 || function >= IR_FN_COUNT) return nullptr;
   
-  // Back button (tap only)
-  if (event == TOUCH_TAP && isInZone(x, y, 240, 220, 70, 20)) {
-    returnToPrevious();
-  }
-}
-
-void Menu::handlePowerButton(TouchEvent event) {
-  if (event == TOUCH_TAP) {
-    // This will trigger IR send in main code
-    refreshNeeded = true;
-  }
+  int slot = dev->slots[function];
+  return (slot >= 0) ? &dev->commands[slot] : nullptr;
 }
 
 IRCommand* Menu::findCommand(const char* commandName) {
@@ -250,15 +361,7 @@ IRCommand* Menu::findCommand(const char* commandName) {
 }
 
 IRCommand* Menu::findCommand(int deviceIndex, const char* commandName) {
-  Device* dev = getDevice(deviceIndex);
-  if (!dev) return nullptr;
-  
-  for (int i = 0; i < dev->commandCount; i++) {
-    if (strcmp(dev->commands[i].command, commandName) == 0) {
-      return &dev->commands[i];
-    }
-  }
-  return nullptr;
+  return findCommand(deviceIndex, findFunction(commandName));
 }
 
 bool Menu::needsRefresh() {
@@ -268,13 +371,28 @@ bool Menu::needsRefresh() {
 }
 
 void Menu::resetTimer() {
-  screenTimer = millis();
+  screenTimer = hal.clock->millis();
 }
 
 const char* Menu::getErrorMessage() {
   return errorMessage;
 }
 
+uint32_t Menu::getScreenKey() {
+  switch (currentScreen) {
+    case SCREEN_MAIN:
+      return SCREEN_CACHE_KEY(SCREEN_MAIN, mainMenuPage);
+    case SCREEN_DEVICE:
+      return SCREEN_CACHE_KEY(SCREEN_DEVICE, selectedDevice);
+    case SCREEN_VOLUME:
+    case SCREEN_CHANNEL:
+      return SCREEN_CACHE_KEY(currentScreen, 0);
+    default:
+      // Splash and error screens are not cached
+      return 0;
+  }
+}
+
 void Menu::setError(const char* message) {
   strncpy(errorMessage, message, 63);
   errorMessage[63] = '\0';
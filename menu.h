@@ -8,6 +8,10 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "layout.h"
+#include "touch_input.h"
+#include "ir_function.h"
+#include "ir_device.h"
 
 // Menu states
 enum Screen {
@@ -19,27 +23,6 @@ enum Screen {
   SCREEN_ERROR
 };
 
-// Touch event types
-enum TouchEvent {
-  TOUCH_NONE,
-  TOUCH_TAP,
-  TOUCH_HOLD,
-  TOUCH_RELEASE
-};
-
-// Device structure
-struct IRCommand {
-  char command[16];
-  unsigned long code;
-  char protocol[8];
-};
-
-struct Device {
-  char name[32];
-  IRCommand commands[MAX_COMMANDS];
-  int commandCount;
-};
-
 class Menu {
 private:
   Screen currentScreen;
@@ -49,10 +32,9 @@ private:
   int selectedDevice;
   int mainMenuPage;
   unsigned long screenTimer;
-  unsigned long touchTimer;
-  bool touchActive;
-  int lastTouchX;
+  int lastTouchX;   // Where the current touch started
   int lastTouchY;
+  unsigned long stateChangedAt;  // Last change saveState() was told of
   
 public:
   Menu();
@@ -63,9 +45,11 @@ public:
   void setScreen(Screen screen);
   void returnToPrevious();
   bool isTimeToAdvance(); // For splash screen
+  bool restoreState();    // Resume the saved screen once devices are loaded
   
   // Device management
-  int loadDevices(); // Returns count, -1 on error
+  int loadDevices(); // Stored devices (flash or SD) plus bundled ones; count, -1 on error
+  int addDevice(const Device& device); // Live insert (replaces a same-named one); index, -1 if full
   Device* getDevice(int index);
   Device* getCurrentDevice();
   const char* getDeviceName(int index);
@@ -76,14 +60,15 @@ public:
   void previousPage();
   void selectDevice(int index);
   int getCurrentPage() { return mainMenuPage; }
+  void setPage(int page);
   int getTotalPages();
   
   // Touch handling
-  TouchEvent processTouchInput(int x, int y, bool touched);
-  void handleTouch(int x, int y, TouchEvent event);
-  bool isInZone(int x, int y, int zoneX, int zoneY, int zoneW, int zoneH);
+  Action handleTouch(const TouchRecord& touch); // Hit-tests once, returns the action touched
   
-  // Command lookup
+  // Command lookup (by function id, or by name for scripted use)
+  IRCommand* findCommand(IRFunction function);
+  IRCommand* findCommand(int deviceIndex, IRFunction function);
   IRCommand* findCommand(const char* commandName);
   IRCommand* findCommand(int deviceIndex, const char* commandName);
   
@@ -91,15 +76,20 @@ public:
   bool needsRefresh();
   void resetTimer();
   const char* getErrorMessage();
+  uint32_t getScreenKey(); // Screen plus the state it shows, 0 if not cacheable
   void setError(const char* message);
   
 private:
-  // Touch zones for different screens
-  void handleMainMenuTouch(int x, int y, TouchEvent event);
-  void handleDeviceMenuTouch(int x, int y, TouchEvent event);
-  void handleVolumeMenuTouch(int x, int y, TouchEvent event);
-  void handleChannelMenuTouch(int x, int y, TouchEvent event);
-  void handlePowerButton(TouchEvent event);
+  // Touch handling helpers
+  bool getLayoutId(LayoutId& id);
+  void handleStripTouch(const TouchRecord& touch);
+  void saveState();   // Deferred until the state settles
+  void writeState();
+  static void saveStateTask(uint32_t);
+  
+  // Device table helpers
+  int findDevice(const char* name);  // Index, -1 if not loaded
+  void mergeBundledDevices();
   
   // CSV parsing helper
   bool parseCSVLine(char* line, Device* device);
@@ -0,0 +1,381 @@
+/*
+ * VHC Universal Remote - Micro Benchmarks Implementation
+ */
+
+#include "micro_bench.h"
+#include <malloc.h>
+#include "hal.h"
+#include "sd_manager.h"
+#include "irdb_converter.h"
+#include "irdb_parser.h"
+#include "ir_handler.h"
+#include "menu.h"
+
+// Global micro benchmark instance
+MicroBench microBench;
+
+#define MICRO_BASELINE_FILE "/bench/micro.csv"
+#define CORPUS_BYTES (MICRO_BENCH_LINES * 40)
+
+// Names as they appear in IRDB files: mapped ones, aliases, digits and
+// buttons the remote has no use for
+static const char* const corpusNames[] = {
+  "POWER", "Power", "KEY_POWER", "VOLUME+", "VOL+", "KEY_VOLUMEDOWN",
+  "CHANNEL_UP", "CH-", "MUTE", "INPUT", "SOURCE", "PLAY", "PAUSE",
+  "FAST_FORWARD", "REW", "MENU", "OK", "SELECT", "0", "5", "9",
+  "GUIDE", "INFO", "EXIT", "SLEEP", "KEY_SUBTITLE", "ASPECT", "PIP_SWAP"
+};
+static const int corpusNameCount = sizeof(corpusNames) / sizeof(corpusNames[0]);
+
+static const char* const protocolNames[] = {
+  "nec1", "nec2", "rc5", "rc6", "samsung", "sony12",
+  "sony15", "sony20", "panasonic", "jvc", "sharp", "denon"
+};
+static const int protocolCount = sizeof(protocolNames) / sizeof(protocolNames[0]);
+
+// Generated corpus (large, not speed critical)
+DMAMEM static char corpus[CORPUS_BYTES];
+static int corpusLength;
+static const char* lines[MICRO_BENCH_LINES];  // Newline terminated, inside corpus
+static uint8_t lineLengths[MICRO_BENCH_LINES];
+static IRCommand commands[MICRO_BENCH_LINES];
+
+// Lookup tables at sizes a device cannot have (MAX_COMMANDS), built by
+// the benchmark: the standard functions spread through each table and
+// the rest buttons nothing maps
+static const int lookupSizes[] = {10, 50, 200};
+static const int lookupSizeCount = sizeof(lookupSizes) / sizeof(lookupSizes[0]);
+#define LOOKUP_MAX_COMMANDS 200
+
+struct LookupTable {
+  IRCommand* commands;
+  int count;
+  int16_t slots[IR_FN_COUNT];
+};
+
+DMAMEM static IRCommand lookupCommands[lookupSizeCount][LOOKUP_MAX_COMMANDS];
+static LookupTable lookupTables[lookupSizeCount];
+
+// Results the compiler cannot see through
+static volatile uint32_t sink;
+
+// Stream over the corpus, so line reading runs without the SD card
+class CorpusStream : public Stream {
+private:
+  int position;
+  
+public:
+  CorpusStream() { position = 0; }
+  int available() override { return corpusLength - position; }
+  int read() override { return (position < corpusLength) ? corpus[position++] : -1; }
+  int peek() override { return (position < corpusLength) ? corpus[position] : -1; }
+  size_t write(uint8_t) override { return 0; }
+};
+
+// Benchmark bodies run one batch and return the operations done
+typedef uint32_t (*BenchBody)(int arg);
+
+static uint32_t benchReadLine(int) {
+  CorpusStream in;
+  char line[64];
+  uint32_t count = 0;
+  while (in.available()) {
+    sink += SDManager::readLine(in, line, sizeof(line));
+    count++;
+  }
+  return count;
+}
+
+static uint32_t benchSplitFields(int) {
+  // Includes the copy that strtok's in-place splitting needs
+  char line[64];
+  IRDBFields fields;
+  for (int i = 0; i < MICRO_BENCH_LINES; i++) {
+    memcpy(line, lines[i], lineLengths[i]);
+    line[lineLengths[i]] = '\0';
+    sink += IRDBParser::splitFields(line, fields);
+  }
+  return MICRO_BENCH_LINES;
+}
+
+static uint32_t benchMapFunction(int) {
+  for (int i = 0; i < corpusNameCount; i++) {
+    sink += IRDBParser::mapFunction(corpusNames[i]);
+  }
+  return corpusNameCount;
+}
+
+static uint32_t benchConvert(int protocol) {
+  for (int i = 0; i < MICRO_BENCH_LINES; i++) {
+    sink += IRDBConverter::convertToHex(protocol, i & 0xFF, (i & 1) ? -1 : i >> 1, i & 0x7F);
+  }
+  return MICRO_BENCH_LINES;
+}
+
+static uint32_t benchFindCommand(int) {
+  uint32_t count = 0;
+  for (int d = 0; d < menu.getDeviceCount(); d++) {
+    for (int f = 0; f < IR_FN_COUNT; f++) {
+      sink += (menu.findCommand(d, (IRFunction)f) != nullptr);
+      count++;
+    }
+  }
+  return count;
+}
+
+static uint32_t benchFindByName(int) {
+  uint32_t count = 0;
+  for (int d = 0; d < menu.getDeviceCount(); d++) {
+    for (int f = 0; f < IR_FN_COUNT; f++) {
+      sink += (menu.findCommand(d, getFunctionName((IRFunction)f)) != nullptr);
+      count++;
+    }
+  }
+  return count;
+}
+
+static uint32_t benchLookupScan(int table) {
+  // By name, comparing each command in turn (before the slot tables)
+  const LookupTable& t = lookupTables[table];
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    const char* name = getFunctionName((IRFunction)f);
+    for (int i = 0; i < t.count; i++) {
+      if (strcmp(t.commands[i].command, name) == 0) {
+        sink += i;
+        break;
+      }
+    }
+  }
+  return IR_FN_COUNT;
+}
+
+static uint32_t benchLookupSlot(int table) {
+  const LookupTable& t = lookupTables[table];
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    sink += t.slots[f];
+  }
+  return IR_FN_COUNT;
+}
+
+static uint32_t benchLookupName(int table) {
+  // By name through the function hash table, then the slot
+  const LookupTable& t = lookupTables[table];
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    IRFunction function = findFunction(getFunctionName((IRFunction)f));
+    sink += (function < IR_FN_COUNT) ? t.slots[function] : -1;
+  }
+  return IR_FN_COUNT;
+}
+
+static uint32_t benchResolveProtocol(int) {
+  int bits;
+  for (int i = 0; i < MICRO_BENCH_LINES; i++) {
+    sink += resolveProtocol(&commands[i], bits) + bits;
+  }
+  return MICRO_BENCH_LINES;
+}
+
+MicroBench::MicroBench() {
+}
+
+bool MicroBench::run(bool saveBaseline) {
+  generateCorpus();
+  buildLookupTables();
+  bool passed = true;
+  
+  File baseline;
+  if (saveBaseline) {
+    hal.storage->fs().mkdir("/bench");
+    hal.storage->fs().remove(MICRO_BASELINE_FILE);
+    baseline = hal.storage->fs().open(MICRO_BASELINE_FILE, FILE_WRITE);
+    if (!baseline) {
+      Serial.println(F("BENCH,error,cannot write " MICRO_BASELINE_FILE));
+      return false;
+    }
+  }
+  
+  // Fixed benchmarks first, then conversion per protocol
+  struct Bench {
+    const char* name;
+    BenchBody body;
+    int arg;
+  };
+  static const Bench fixed[] = {
+    {"read_line",        benchReadLine, 0},
+    {"split_fields",     benchSplitFields, 0},
+    {"map_function",     benchMapFunction, 0},
+    {"find_command",     benchFindCommand, 0},
+    {"find_by_name",     benchFindByName, 0},
+    {"resolve_protocol", benchResolveProtocol, 0}
+  };
+  const int fixedCount = sizeof(fixed) / sizeof(fixed[0]);
+  
+  // Then lookups by table size, three ways
+  static const Bench lookups[] = {
+    {"lookup_scan", benchLookupScan, 0},
+    {"lookup_slot", benchLookupSlot, 0},
+    {"lookup_name", benchLookupName, 0}
+  };
+  const int lookupCount = sizeof(lookups) / sizeof(lookups[0]) * lookupSizeCount;
+  
+  Serial.println(F("BENCH,name,ns_per_op,ops,heap_bytes,baseline_ns,status"));
+  for (int i = 0; i < fixedCount + lookupCount + protocolCount; i++) {
+    Bench bench;
+    char name[24];
+    if (i < fixedCount) {
+      bench = fixed[i];
+    } else if (i < fixedCount + lookupCount) {
+      int table = (i - fixedCount) % lookupSizeCount;
+      bench = lookups[(i - fixedCount) / lookupSizeCount];
+      snprintf(name, sizeof(name), "%s_%d", bench.name, lookupSizes[table]);
+      bench.name = name;
+      bench.arg = table;
+    } else {
+      int protocol = i - fixedCount - lookupCount;
+      snprintf(name, sizeof(name), "convert_%s", protocolNames[protocol]);
+      bench.name = name;
+      bench.body = benchConvert;
+      bench.arg = protocol;
+    }
+    
+    // Repeat whole batches until the run is long enough to time
+    int heapBefore = mallinfo().uordblks;
+    uint32_t ops = 0;
+    uint32_t start = micros();
+    uint32_t elapsed = 0;
+    do {
+      uint32_t done = bench.body(bench.arg);
+      if (done == 0) break;
+      ops += done;
+      elapsed = micros() - start;
+    } while (elapsed < MICRO_BENCH_MIN_US);
+    int heapBytes = mallinfo().uordblks - heapBefore;
+    
+    uint32_t nsPerOp = ops ? (uint32_t)((uint64_t)elapsed * 1000 / ops) : 0;
+    uint32_t base = 0;
+    const char* status = "ok";
+    
+    if (ops == 0) {
+      status = "no-data";  // Command lookups need devices loaded
+    } else if (saveBaseline) {
+      baseline.print(bench.name);
+      baseline.print(',');
+      baseline.println(nsPerOp);
+      status = "saved";
+    } else if (!readBaseline(bench.name, base)) {
+      status = "no-baseline";
+    } else if (nsPerOp > base + 1 &&  // ns/op are truncated; 1 ns is rounding
+               (uint64_t)nsPerOp * 100 > (uint64_t)base * (100 + MICRO_BENCH_REGRESSION_PCT)) {
+      status = "REGRESSION";
+      passed = false;
+    }
+    if (heapBytes != 0) {
+      // Nothing on these paths should allocate
+      status = "ALLOCATES";
+      passed = false;
+    }
+    
+    Serial.print(F("BENCH,"));
+    Serial.print(bench.name);
+    Serial.print(',');
+    Serial.print(nsPerOp);
+    Serial.print(',');
+    Serial.print(ops);
+    Serial.print(',');
+    Serial.print(heapBytes);
+    Serial.print(',');
+    Serial.print(base);
+    Serial.print(',');
+    Serial.println(status);
+  }
+  
+  if (saveBaseline) {
+    baseline.close();
+  }
+  return passed;
+}
+
+void MicroBench::generateCorpus() {
+  // Same corpus every run (fixed xorshift seed), so results compare
+  uint32_t seed = 0x2545F491;
+  corpusLength = 0;
+  
+  for (int i = 0; i < MICRO_BENCH_LINES; i++) {
+    uint32_t r[4];
+    for (int k = 0; k < 4; k++) {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+      r[k] = seed;
+    }
+    
+    int protocol = r[0] % protocolCount;
+    int device = r[1] & 0xFF;
+    int subdevice = (r[1] & 0x100) ? -1 : (r[1] >> 9) & 0xFF;
+    int function = r[2] & 0x7F;
+    const char* name = corpusNames[r[3] % corpusNameCount];
+    
+    char* line = &corpus[corpusLength];
+    int length = snprintf(line, CORPUS_BYTES - corpusLength - 1, "%s,%d,%d,%d,%d",
+                          name, protocol, device, subdevice, function);
+    lines[i] = line;
+    lineLengths[i] = length;
+    corpusLength += length;
+    corpus[corpusLength++] = '\n';
+    
+    // The send path sees what loadIRDBFile would have stored
+    IRCommand& cmd = commands[i];
+    size_t nameLength = strnlen(name, sizeof(cmd.command) - 1);
+    memcpy(cmd.command, name, nameLength);
+    cmd.command[nameLength] = '\0';
+    cmd.code = IRDBConverter::convertToHex(protocol, device, subdevice, function);
+    const char* protocolName = IRDBConverter::getProtocolName(protocol);
+    size_t protocolLength = strnlen(protocolName, sizeof(cmd.protocol) - 1);
+    memcpy(cmd.protocol, protocolName, protocolLength);
+    cmd.protocol[protocolLength] = '\0';
+  }
+}
+
+void MicroBench::buildLookupTables() {
+  for (int t = 0; t < lookupSizeCount; t++) {
+    LookupTable& table = lookupTables[t];
+    table.commands = lookupCommands[t];
+    table.count = lookupSizes[t];
+    for (int f = 0; f < IR_FN_COUNT; f++) {
+      table.slots[f] = -1;
+    }
+    
+    for (int i = 0; i < table.count; i++) {
+      snprintf(table.commands[i].command, sizeof(table.commands[i].command), "KEY_%03d", i);
+      table.commands[i].code = i;
+      strcpy(table.commands[i].protocol, "NEC");
+    }
+    // Function f at an even spread; tables smaller than the function
+    // list hold the first ones only
+    int functions = (table.count < IR_FN_COUNT) ? table.count : IR_FN_COUNT;
+    for (int f = 0; f < functions; f++) {
+      int index = f * table.count / functions;
+      strcpy(table.commands[index].command, getFunctionName((IRFunction)f));
+      table.slots[f] = index;
+    }
+  }
+}
+
+bool MicroBench::readBaseline(const char* name, uint32_t& nsPerOp) {
+  File file = hal.storage->fs().open(MICRO_BASELINE_FILE);
+  if (!file) return false;
+  
+  char line[48];
+  bool found = false;
+  while (file.available() && !found) {
+    SDManager::readLine(file, line, sizeof(line));
+    char* field = strtok(line, ",");
+    char* value = strtok(NULL, ",");
+    if (field && value && strcmp(field, name) == 0) {
+      nsPerOp = strtoul(value, NULL, 10);
+      found = true;
+    }
+  }
+  file.close();
+  return found;
+}
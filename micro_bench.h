@@ -0,0 +1,37 @@
+/*
+ * VHC Universal Remote - Micro Benchmarks
+ * ns/op of the IRDB load and IR send hot paths
+ */
+
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Times each step of loading an IRDB file - line reading, field
+// splitting, function name mapping, code conversion per protocol - over
+// a generated corpus held in RAM (no SD access), plus command lookup and
+// protocol resolution on the send path. Lookups are also timed in tables
+// of 10, 50 and 200 commands, by scan, slot and name hash. Each benchmark
+// repeats for at least MICRO_BENCH_MIN_US and reports ns/op and the heap
+// bytes it left allocated. "save" stores ns/op as the baseline; later
+// runs flag benchmarks that got slower by more than
+// MICRO_BENCH_REGRESSION_PCT.
+class MicroBench {
+public:
+  MicroBench();
+  
+  // Run all benchmarks; returns false on a regression or an allocation
+  bool run(bool saveBaseline);
+  
+private:
+  void generateCorpus();
+  void buildLookupTables();
+  bool readBaseline(const char* name, uint32_t& nsPerOp);
+};
+
+// Global micro benchmark instance
+extern MicroBench microBench;
+
+#endif // MICRO_BENCH_H
@@ -0,0 +1,177 @@
+/*
+ * VHC Universal Remote - Overlay Compositor Implementation
+ */
+
+#include "overlay.h"
+#include "display.h"
+#include "hal.h"
+#include "loop_watchdog.h"
+
+// Display instance lives in the main sketch
+extern Display display;
+
+// Global overlay manager instance
+OverlayManager overlays;
+
+// Save-under pixels for the whole stack, kept out of the fast DTCM
+DMAMEM static uint16_t saveBuffer[OVERLAY_SAVE_PIXELS];
+
+// Toast geometry: stacked upward from the bottom of the screen
+#define TOAST_X      10
+#define TOAST_W      (SCREEN_WIDTH - 20)
+#define TOAST_H      25
+#define TOAST_BOTTOM (SCREEN_HEIGHT - 30)
+#define TOAST_STEP   28
+
+OverlayManager::OverlayManager() {
+  count = 0;
+  saveUsed = 0;
+}
+
+bool OverlayManager::show(OverlayId id, const char* text, unsigned long duration) {
+  int index = find(id);
+  if (index >= 0) {
+    Overlay* existing = &stack[index];
+    if (strncmp(existing->text, text, sizeof(existing->text) - 1) == 0) {
+      // Same content: just extend it
+      existing->shownAt = hal.clock->millis();
+      existing->duration = duration;
+      return true;
+    }
+    remove(index);
+  }
+  
+  if (count >= OVERLAY_MAX) {
+    return false;
+  }
+  
+  // Lowest free slot: one removed from the middle leaves a gap, and the
+  // ones above it stay where they are
+  bool taken[OVERLAY_MAX] = {};
+  for (int i = 0; i < count; i++) {
+    taken[(TOAST_BOTTOM - stack[i].y) / TOAST_STEP] = true;
+  }
+  int slot = 0;
+  while (taken[slot]) {
+    slot++;
+  }
+  
+  Overlay* overlay = &stack[count];
+  overlay->id = id;
+  overlay->x = TOAST_X;
+  overlay->y = TOAST_BOTTOM - slot * TOAST_STEP;
+  overlay->w = TOAST_W;
+  overlay->h = TOAST_H;
+  strncpy(overlay->text, text, sizeof(overlay->text) - 1);
+  overlay->text[sizeof(overlay->text) - 1] = '\0';
+  overlay->shownAt = hal.clock->millis();
+  overlay->duration = duration;
+  
+  uint32_t pixels = (uint32_t)overlay->w * overlay->h;
+  if (overlay->y < 0 || saveUsed + pixels > OVERLAY_SAVE_PIXELS) {
+    return false;
+  }
+  overlay->saveOffset = saveUsed;
+  saveUsed += pixels;
+  count++;
+  
+  capture(overlay);
+  draw(overlay);
+  return true;
+}
+
+void OverlayManager::hide(OverlayId id) {
+  int index = find(id);
+  if (index >= 0) {
+    remove(index);
+  }
+}
+
+bool OverlayManager::isShown(OverlayId id) {
+  return find(id) >= 0;
+}
+
+void OverlayManager::update() {
+  WATCHDOG_STAGE(STAGE_DISPLAY);
+  
+  if (count == 0) return;
+  
+  unsigned long now = hal.clock->millis();
+  for (int i = count - 1; i >= 0; i--) {
+    Overlay* overlay = &stack[i];
+    if (overlay->duration > 0 && now - overlay->shownAt >= overlay->duration) {
+      remove(i);
+    }
+  }
+}
+
+void OverlayManager::recomposite() {
+  for (int i = 0; i < count; i++) {
+    capture(&stack[i]);
+    draw(&stack[i]);
+  }
+}
+
+void OverlayManager::dismissAll() {
+  for (int i = count - 1; i >= 0; i--) {
+    restore(&stack[i]);
+  }
+  count = 0;
+  saveUsed = 0;
+}
+
+int OverlayManager::find(OverlayId id) {
+  for (int i = 0; i < count; i++) {
+    if (stack[i].id == id) return i;
+  }
+  return -1;
+}
+
+void OverlayManager::capture(Overlay* overlay) {
+  display.getShadow()->readRect(overlay->x, overlay->y, overlay->w, overlay->h,
+                                saveBuffer + overlay->saveOffset);
+}
+
+void OverlayManager::restore(Overlay* overlay) {
+  display.getShadow()->pushPixels(overlay->x, overlay->y, overlay->w, overlay->h,
+                                  saveBuffer + overlay->saveOffset, overlay->w);
+}
+
+void OverlayManager::draw(Overlay* overlay) {
+  uint16_t fill = COLOR_BUTTON;
+  uint16_t text = COLOR_BUTTON_TEXT;
+  if (overlay->id == OVERLAY_SENDING) {
+    // Low-key indicator for something that happens on every press
+    fill = COLOR_BACKGROUND;
+    text = COLOR_TEXT;
+  } else if (overlay->id == OVERLAY_SD_WARNING) {
+    fill = COLOR_DISABLED;
+  }
+  display.drawMessageBox(overlay->x, overlay->y, overlay->w, overlay->h, overlay->text, fill, text);
+}
+
+void OverlayManager::remove(int index) {
+  // Peel off everything above, restore this one, then put the rest back
+  for (int i = count - 1; i >= index; i--) {
+    restore(&stack[i]);
+  }
+  
+  uint32_t freed = (uint32_t)stack[index].w * stack[index].h;
+  uint32_t from = stack[index].saveOffset + freed;
+  if (from < saveUsed) {
+    memmove(saveBuffer + stack[index].saveOffset, saveBuffer + from,
+            (saveUsed - from) * sizeof(uint16_t));
+  }
+  saveUsed -= freed;
+  
+  for (int i = index; i < count - 1; i++) {
+    stack[i] = stack[i + 1];
+    stack[i].saveOffset -= freed;
+  }
+  count--;
+  
+  for (int i = index; i < count; i++) {
+    capture(&stack[i]);
+    draw(&stack[i]);
+  }
+}
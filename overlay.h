@@ -0,0 +1,71 @@
+/*
+ * VHC Universal Remote - Overlay Compositor
+ * Toasts and popups drawn over a screen with save-under and timed restore
+ */
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Overlay kinds (one of each may be shown at a time)
+enum OverlayId {
+  OVERLAY_MESSAGE,     // Display::showMessage toast
+  OVERLAY_SENDING,     // IR transmission in progress
+  OVERLAY_SD_WARNING,  // SD card problems
+  OVERLAY_ERROR        // Failed actions
+};
+
+// Overlays stack bottom-up above the screen. Before one is drawn, the pixels
+// under it are copied from the shadow framebuffer into a save-under buffer;
+// when it expires (checked from update(), never blocking) exactly that
+// rectangle is written back. Removing an overlay from the middle of the
+// stack peels off the ones above it first and re-composites them after;
+// the gap it leaves is where the next one goes.
+class OverlayManager {
+private:
+  struct Overlay {
+    OverlayId id;
+    int16_t x, y, w, h;
+    char text[40];
+    unsigned long shownAt;
+    unsigned long duration;   // 0 = until hide()
+    uint32_t saveOffset;      // Pixels in the save-under buffer
+  };
+  
+  Overlay stack[OVERLAY_MAX];
+  int count;
+  uint32_t saveUsed;
+  
+public:
+  OverlayManager();
+  
+  // Show (or replace) an overlay; duration 0 keeps it until hide()
+  bool show(OverlayId id, const char* text, unsigned long duration);
+  void hide(OverlayId id);
+  bool isShown(OverlayId id);
+  
+  // Expire timed overlays; call every loop pass
+  void update();
+  
+  // The screen under the overlays was redrawn: capture and draw them again
+  void recomposite();
+  
+  // Restore everything under the overlays and drop them
+  void dismissAll();
+  
+  int getCount() { return count; }
+  
+private:
+  int find(OverlayId id);
+  void capture(Overlay* overlay);
+  void restore(Overlay* overlay);
+  void draw(Overlay* overlay);
+  void remove(int index);
+};
+
+// Global overlay manager instance
+extern OverlayManager overlays;
+
+#endif // OVERLAY_H
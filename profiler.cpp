@@ -0,0 +1,71 @@
+/*
+ * VHC Universal Remote - Profiler Implementation
+ */
+
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+// Global profiler instance
+Profiler profiler;
+
+const char* const profileZoneNames[PROF_ZONE_COUNT] = {
+  "load_irdb",
+  "send_command",
+  "draw_main",
+  "draw_device",
+  "draw_volume",
+  "draw_channel",
+  "touch_point"
+};
+
+#if defined(ARM_DWT_CYCCNT)
+  #define PROFILER_TICKS_PER_US (F_CPU_ACTUAL / 1000000)
+#else
+  #define PROFILER_TICKS_PER_US 1000
+#endif
+
+Profiler::Profiler() {
+  reset();
+}
+
+void Profiler::begin() {
+  #if defined(ARM_DWT_CYCCNT)
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+  #endif
+}
+
+void Profiler::reset() {
+  for (int i = 0; i < PROF_ZONE_COUNT; i++) {
+    zones[i].count = 0;
+    zones[i].total = 0;
+    zones[i].min = 0xFFFFFFFF;
+    zones[i].max = 0;
+  }
+}
+
+void Profiler::print() {
+  uint32_t perUs = PROFILER_TICKS_PER_US;
+  
+  Serial.println(F("PROF,zone,count,total_us,mean_us,min_us,max_us"));
+  for (int i = 0; i < PROF_ZONE_COUNT; i++) {
+    const ProfileStats& z = zones[i];
+    uint32_t total = z.total / perUs;
+    
+    Serial.print(F("PROF,"));
+    Serial.print(profileZoneNames[i]);
+    Serial.print(',');
+    Serial.print(z.count);
+    Serial.print(',');
+    Serial.print(total);
+    Serial.print(',');
+    Serial.print(z.count ? total / z.count : 0);
+    Serial.print(',');
+    Serial.print(z.count ? z.min / perUs : 0);
+    Serial.print(',');
+    Serial.println(z.max / perUs);
+  }
+}
+
+#endif // PROFILER_ENABLED
@@ -0,0 +1,94 @@
+/*
+ * VHC Universal Remote - Profiler
+ * Scoped cycle counting of hot paths into a fixed zone table
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Profiled zones; add the name to profileZoneNames too
+enum ProfileZone {
+  PROF_LOAD_IRDB,       // SDManager::loadIRDBFile
+  PROF_SEND_COMMAND,    // IRHandler::sendCommand
+  PROF_DRAW_MAIN,       // Display::drawMainMenu
+  PROF_DRAW_DEVICE,     // Display::drawDeviceMenu
+  PROF_DRAW_VOLUME,     // Display::drawVolumeMenu
+  PROF_DRAW_CHANNEL,    // Display::drawChannelMenu
+  PROF_TOUCH_POINT,     // TouchInput::getTouchPoint
+  PROF_ZONE_COUNT
+};
+
+#if PROFILER_ENABLED
+
+#if defined(ARM_DWT_CYCCNT)
+  // Core clock cycles (DWT), wraps after ~7 s at 600 MHz
+  static inline uint32_t profilerTicks() { return ARM_DWT_CYCCNT; }
+#else
+  // Host builds: nanoseconds of a steady clock
+  #include <chrono>
+  static inline uint32_t profilerTicks() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+struct ProfileStats {
+  uint32_t count;
+  uint64_t total;
+  uint32_t min;
+  uint32_t max;
+};
+
+// record() only updates the zone's counters: no allocation, no output.
+// Zones are recorded from the main loop only.
+class Profiler {
+private:
+  ProfileStats zones[PROF_ZONE_COUNT];
+  
+public:
+  Profiler();
+  void begin();  // Starts the cycle counter
+  
+  void record(ProfileZone zone, uint32_t ticks) {
+    ProfileStats& z = zones[zone];
+    z.count++;
+    z.total += ticks;
+    if (ticks < z.min) z.min = ticks;
+    if (ticks > z.max) z.max = ticks;
+  }
+  
+  void reset();
+  void print();  // PROF CSV, times in microseconds
+};
+
+class ProfileScope {
+private:
+  ProfileZone zone;
+  uint32_t start;
+  
+public:
+  ProfileScope(ProfileZone zone) : zone(zone), start(profilerTicks()) {}
+  ~ProfileScope();
+};
+
+// Global profiler instance
+extern Profiler profiler;
+
+inline ProfileScope::~ProfileScope() {
+  profiler.record(zone, profilerTicks() - start);
+}
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(zone) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
+
+#else
+
+#define PROFILE_SCOPE(zone) do {} while (0)
+
+#endif // PROFILER_ENABLED
+
+#endif // PROFILER_H
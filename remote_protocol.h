@@ -0,0 +1,159 @@
+/*
+ * VHC Universal Remote - Remote Protocol
+ * Framed binary serial protocol for batched IR sends, shared with tools/remote_link
+ */
+
+#ifndef REMOTE_PROTOCOL_H
+#define REMOTE_PROTOCOL_H
+
+#include <stdint.h>
+
+// Frame layout (multi-byte fields little endian):
+//   0     PROTO_SYNC
+//   1     payload length (0..PROTO_MAX_PAYLOAD)
+//   2     sequence number (sender's own counter)
+//   3     message type
+//   4..   payload
+//   last  CRC-16/CCITT of bytes 1 up to the end of the payload (2 bytes)
+// Frames share the USB serial port with the text console: the console
+// hands a line that starts with PROTO_SYNC to the frame parser, and host
+// tools skip console text between frames. The binary event log goes out
+// in PROTO_LOG frames, so its bytes are never mistaken for a frame.
+#define PROTO_SYNC         0xA7
+#define PROTO_HEADER_SIZE  4
+#define PROTO_MAX_PAYLOAD  200
+#define PROTO_MAX_FRAME    (PROTO_HEADER_SIZE + PROTO_MAX_PAYLOAD + 2)
+
+enum ProtoType {
+  // Host to remote
+  PROTO_ENQUEUE = 0x01,   // ProtoSend entries; acked, then one DONE per entry
+  PROTO_STATUS  = 0x02,   // Queue depth and counters (STATUS_REPLY)
+  PROTO_CLEAR   = 0x03,   // Drop queued sends
+  PROTO_PING    = 0x04,   // Acked straight away, for latency
+  PROTO_UPLOAD_BEGIN = 0x05,  // u32 file size, then the file name (no .csv); resend on PROTO_BUSY
+  PROTO_UPLOAD_DATA  = 0x06,  // Next bytes of the file; resend on PROTO_BUSY
+  PROTO_UPLOAD_END   = 0x07,  // Acked, then UPLOAD_DONE and later UPLOAD_SAVED
+  
+  // Remote to host
+  PROTO_ACK          = 0x81,  // ProtoAck: frame received (or why not)
+  PROTO_DONE         = 0x82,  // ProtoDone: a queued send finished
+  PROTO_STATUS_REPLY = 0x83,  // ProtoStatus
+  PROTO_UPLOAD_DONE  = 0x84,  // ProtoUploadDone: device parsed and usable
+  PROTO_UPLOAD_SAVED = 0x85,  // ProtoUploadSaved: file written to SD
+  PROTO_LOG          = 0x86   // Event log records (log_formats.h), own sequence
+};
+
+enum ProtoResult {
+  PROTO_OK,
+  PROTO_QUEUE_FULL,       // Ack: only 'accepted' entries were queued
+  PROTO_BAD_FRAME,        // Ack: CRC or length mismatch, nothing done
+  PROTO_BAD_TYPE,         // Ack: unknown message type
+  PROTO_NO_DEVICE,        // Done: no loaded device has that name hash
+  PROTO_NO_COMMAND,       // Done: the device lacks that function
+  PROTO_SEND_FAILED,      // Done: the IR handler reported an error
+  PROTO_CLEARED,          // Done: dropped by PROTO_CLEAR
+  PROTO_BUSY,             // Ack: upload buffer full, or the last upload still saving; send again
+  PROTO_NO_UPLOAD,        // Ack: upload data or end without a begin
+  PROTO_BAD_SIZE,         // Upload: byte count differs from the announced size
+  PROTO_NO_COMMANDS,      // Upload: no line mapped to a standard function
+  PROTO_TABLE_FULL,       // Upload: MAX_DEVICES already loaded
+  PROTO_SD_FAILED         // Upload: could not write the file (device still usable)
+};
+
+// One send in an ENQUEUE payload. Device and command are FNV-1a hashes
+// of the device name and the standard function name ("power", "volUp",
+// "0", ...), see hashName() in ir_function.h. The command goes out
+// 'repeat' times with 'gapMs' after each frame, including the last.
+#define PROTO_SEND_SIZE  11
+struct ProtoSend {
+  uint32_t device;
+  uint32_t command;
+  uint8_t repeat;
+  uint16_t gapMs;
+};
+
+#define PROTO_ACK_SIZE  5
+struct ProtoAck {
+  uint8_t seq;            // Host frame being acknowledged
+  uint8_t result;         // ProtoResult
+  uint8_t accepted;       // ENQUEUE entries queued
+  uint16_t depth;         // Queue depth after this frame
+};
+
+#define PROTO_DONE_SIZE  7
+struct ProtoDone {
+  uint8_t seq;            // ENQUEUE frame the send came in
+  uint8_t index;          // Entry within that frame
+  uint8_t result;         // ProtoResult
+  uint32_t time;          // Remote millis() when it finished
+};
+
+#define PROTO_STATUS_SIZE  12
+struct ProtoStatus {
+  uint16_t depth;
+  uint16_t capacity;
+  uint32_t sent;          // Entries finished since boot
+  uint32_t failed;
+};
+
+// Upload timings are from the UPLOAD_BEGIN frame, in milliseconds
+#define PROTO_UPLOAD_DONE_SIZE  14
+struct ProtoUploadDone {
+  uint8_t result;
+  uint8_t commands;       // Commands the device ended up with
+  uint32_t bytes;
+  uint32_t elapsedMs;     // Until UPLOAD_END arrived
+  uint32_t usableMs;      // Until the device was in the table
+};
+
+#define PROTO_UPLOAD_SAVED_SIZE  5
+struct ProtoUploadSaved {
+  uint8_t result;
+  uint32_t savedMs;       // Until the file was renamed into place
+};
+
+static inline uint16_t protoCRC(const uint8_t* data, int length) {
+  uint16_t crc = 0xFFFF;
+  for (int i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static inline void protoPut16(uint8_t* p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static inline void protoPut32(uint8_t* p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static inline uint16_t protoGet16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t protoGet32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Builds a frame in out (PROTO_MAX_FRAME bytes); returns its length
+static inline int protoFrame(uint8_t* out, uint8_t seq, uint8_t type, const uint8_t* payload, int length) {
+  out[0] = PROTO_SYNC;
+  out[1] = length;
+  out[2] = seq;
+  out[3] = type;
+  for (int i = 0; i < length; i++) {
+    out[PROTO_HEADER_SIZE + i] = payload[i];
+  }
+  protoPut16(out + PROTO_HEADER_SIZE + length, protoCRC(out + 1, PROTO_HEADER_SIZE - 1 + length));
+  return PROTO_HEADER_SIZE + length + 2;
+}
+
+#endif // REMOTE_PROTOCOL_H
@@ -0,0 +1,230 @@
+/*
+ * VHC Universal Remote - Render Benchmark Implementation
+ */
+
+#include "render_bench.h"
+#include "hal.h"
+#include "display.h"
+
+// Display instance lives in the main sketch
+extern Display display;
+
+// Global render benchmark instance
+RenderBench renderBench;
+
+#define RENDER_BASELINE_FILE "/bench/render.csv"
+
+// Scenario names double as golden file names (/bench/<name>.ppm)
+const char* const renderScenarios[] = {
+  "splash",
+  "main_1p",
+  "main_3p",
+  "main_5p",
+  "device",
+  "volume",
+  "channel",
+  "error"
+};
+const int renderScenarioCount = sizeof(renderScenarios) / sizeof(renderScenarios[0]);
+
+RenderBench::RenderBench() {
+}
+
+bool RenderBench::run(bool saveBaseline) {
+  ShadowGFX* shadow = display.getShadow();
+  bool passed = true;
+  
+  File baseline;
+  if (saveBaseline) {
+    hal.storage->fs().mkdir("/bench");
+    hal.storage->fs().remove(RENDER_BASELINE_FILE);
+    baseline = hal.storage->fs().open(RENDER_BASELINE_FILE, FILE_WRITE);
+    if (!baseline) {
+      Serial.println(F("RENDER,error,cannot write " RENDER_BASELINE_FILE));
+      return false;
+    }
+  }
+  
+  Serial.println(F("RENDER,screen,us,transactions,windows,pixels,status"));
+  for (int i = 0; i < renderScenarioCount; i++) {
+    const char* name = renderScenarios[i];
+    
+    shadow->resetCost();
+    unsigned long start = micros();
+    renderScenario(i);
+    unsigned long elapsed = micros() - start;
+    RenderCost cost = shadow->getCost();
+    
+    char golden[32];
+    snprintf(golden, 32, "/bench/%s.ppm", name);
+    const char* status = "ok";
+    
+    if (saveBaseline) {
+      baseline.print(name);
+      baseline.print(',');
+      baseline.print(cost.transactions);
+      baseline.print(',');
+      baseline.print(cost.windows);
+      baseline.print(',');
+      baseline.println(cost.pixels);
+      
+      hal.storage->fs().remove(golden);
+      File ppm = hal.storage->fs().open(golden, FILE_WRITE);
+      if (ppm) {
+        writePPM(ppm);
+        ppm.close();
+        status = "saved";
+      } else {
+        status = "save-failed";
+        passed = false;
+      }
+    } else {
+      uint32_t base[3];
+      if (!readBaseline(name, base)) {
+        status = "no-baseline";
+      } else {
+        uint32_t counts[3] = {cost.transactions, cost.windows, cost.pixels};
+        for (int c = 0; c < 3; c++) {
+          if (counts[c] * 100 > base[c] * (100 + RENDER_REGRESSION_PCT)) {
+            status = "REGRESSION";
+            passed = false;
+          }
+        }
+        long differing = compareGolden(golden);
+        if (differing > 0) {
+          status = "GOLDEN-MISMATCH";
+          passed = false;
+        }
+      }
+    }
+    
+    Serial.print(F("RENDER,"));
+    Serial.print(name);
+    Serial.print(',');
+    Serial.print(elapsed);
+    Serial.print(',');
+    Serial.print(cost.transactions);
+    Serial.print(',');
+    Serial.print(cost.windows);
+    Serial.print(',');
+    Serial.print(cost.pixels);
+    Serial.print(',');
+    Serial.println(status);
+  }
+  
+  if (saveBaseline) {
+    baseline.close();
+  }
+  return passed;
+}
+
+void RenderBench::writePPM(Print& out) {
+  const uint16_t* pixels = display.getShadow()->getBuffer();
+  uint8_t row[SCREEN_WIDTH * 3];
+  
+  out.print(F("P6\n"));
+  out.print(SCREEN_WIDTH);
+  out.print(' ');
+  out.print(SCREEN_HEIGHT);
+  out.print(F("\n255\n"));
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      toRGB(pixels[y * SCREEN_WIDTH + x], &row[x * 3]);
+    }
+    out.write(row, sizeof(row));
+  }
+}
+
+void RenderBench::renderScenario(int index) {
+  const char* names[DEVICES_PER_PAGE] = {"Samsung TV", "Sony VCR", "LG Soundbar", "Generic DVD"};
+  
+  switch (index) {
+    case 0:
+      display.drawSplashScreen();
+      break;
+    case 1:
+    case 2:
+    case 3:
+      {
+        const int pageCounts[] = {1, 3, 5};
+        display.drawMainMenu(0, pageCounts[index - 1]);
+        display.drawDevicePage(display.getShadow(), 0, names, DEVICES_PER_PAGE);
+      }
+      break;
+    case 4:
+      display.drawDeviceMenu(names[0]);
+      break;
+    case 5:
+      display.drawVolumeMenu();
+      break;
+    case 6:
+      display.drawChannelMenu();
+      break;
+    case 7:
+      display.drawErrorScreen(ERROR_NO_SD);
+      break;
+  }
+}
+
+bool RenderBench::readBaseline(const char* name, uint32_t counts[3]) {
+  File file = hal.storage->fs().open(RENDER_BASELINE_FILE);
+  if (!file) return false;
+  
+  char line[64];
+  bool found = false;
+  while (file.available() && !found) {
+    int i = 0;
+    while (file.available() && i < 63) {
+      char c = file.read();
+      if (c == '\n') break;
+      if (c != '\r') line[i++] = c;
+    }
+    line[i] = '\0';
+    
+    char* field = strtok(line, ",");
+    if (field && strcmp(field, name) == 0) {
+      for (int c = 0; c < 3; c++) {
+        field = strtok(NULL, ",");
+        counts[c] = field ? strtoul(field, NULL, 10) : 0;
+      }
+      found = true;
+    }
+  }
+  file.close();
+  return found;
+}
+
+long RenderBench::compareGolden(const char* path) {
+  // Returns the number of differing pixels, -1 if there is no golden
+  File file = hal.storage->fs().open(path);
+  if (!file) return -1;
+  
+  // Skip the three header lines
+  for (int lines = 0; lines < 3 && file.available(); ) {
+    if (file.read() == '\n') lines++;
+  }
+  
+  const uint16_t* pixels = display.getShadow()->getBuffer();
+  uint8_t row[SCREEN_WIDTH * 3];
+  uint8_t rgb[3];
+  long differing = 0;
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    if (file.read(row, sizeof(row)) != (int)sizeof(row)) {
+      differing += (long)(SCREEN_HEIGHT - y) * SCREEN_WIDTH;
+      break;
+    }
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      toRGB(pixels[y * SCREEN_WIDTH + x], rgb);
+      if (memcmp(rgb, &row[x * 3], 3) != 0) differing++;
+    }
+  }
+  file.close();
+  return differing;
+}
+
+void RenderBench::toRGB(uint16_t color, uint8_t* rgb) {
+  // RGB565 to RGB888
+  rgb[0] = ((color >> 11) & 0x1F) * 255 / 31;
+  rgb[1] = ((color >> 5) & 0x3F) * 255 / 63;
+  rgb[2] = (color & 0x1F) * 255 / 31;
+}
@@ -0,0 +1,37 @@
+/*
+ * VHC Universal Remote - Render Benchmark
+ * Per-screen pixel cost, PPM capture and golden image checks
+ */
+
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Renders every screen (splash, main at several page counts, device,
+// volume, channel, error) with fixed sample data and reports the SPI cost
+// counted by ShadowGFX. "save" stores the counts and a PPM of each screen
+// on the SD card as the baseline; later runs flag screens whose cost grew
+// by more than RENDER_REGRESSION_PCT or whose pixels differ from the golden.
+class RenderBench {
+public:
+  RenderBench();
+  
+  // Run all screens; returns false if any regression or mismatch was found
+  bool run(bool saveBaseline);
+  
+  // Write the current screen as a binary PPM (P6)
+  void writePPM(Print& out);
+  
+private:
+  void renderScenario(int index);
+  bool readBaseline(const char* name, uint32_t counts[3]);
+  long compareGolden(const char* path);
+  void toRGB(uint16_t color, uint8_t* rgb);
+};
+
+// Global render benchmark instance
+extern RenderBench renderBench;
+
+#endif // RENDER_BENCH_H
@@ -0,0 +1,56 @@
+/*
+ * VHC Universal Remote - Ring Buffer
+ * Lock-free single-producer/single-consumer queue for ISR to loop hand-off
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <Arduino.h>
+
+// One interrupt handler pushes, the main loop pops. Each side only writes
+// its own index, so no locking is needed on the single-core Teensy.
+// SIZE must be a power of two; one slot is kept free to tell full from empty.
+template <typename T, uint16_t SIZE>
+class RingBuffer {
+  static_assert((SIZE & (SIZE - 1)) == 0, "RingBuffer SIZE must be a power of two");
+  
+private:
+  T items[SIZE];
+  volatile uint16_t head;  // Written by the producer
+  volatile uint16_t tail;  // Written by the consumer
+  
+public:
+  RingBuffer() {
+    head = 0;
+    tail = 0;
+  }
+  
+  // Producer side; returns false (and drops the item) when full
+  bool push(const T& item) {
+    uint16_t next = (head + 1) & (SIZE - 1);
+    if (next == tail) return false;
+    items[head] = item;
+    // Item must be stored before the consumer can see the new head
+    __asm__ volatile("" ::: "memory");
+    head = next;
+    return true;
+  }
+  
+  // Consumer side; returns false when empty
+  bool pop(T& item) {
+    if (tail == head) return false;
+    item = items[tail];
+    __asm__ volatile("" ::: "memory");
+    tail = (tail + 1) & (SIZE - 1);
+    return true;
+  }
+  
+  bool isEmpty() const { return tail == head; }
+  uint16_t count() const { return (head - tail) & (SIZE - 1); }
+  
+  // Consumer side: drop everything queued so far
+  void clear() { tail = head; }
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,203 @@
+/*
+ * VHC Universal Remote - Scheduler Implementation
+ */
+
+#include "scheduler.h"
+#include "hal.h"
+#include "loop_watchdog.h"
+
+// Global scheduler instance
+Scheduler scheduler;
+
+Scheduler::Scheduler() {
+  for (int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    tasks[i].used = false;
+    tasks[i].next = -1;
+  }
+  for (int i = 0; i < SCHEDULER_WHEEL_SLOTS; i++) {
+    wheel[i] = -1;
+  }
+  for (int p = 0; p < PRIORITY_COUNT; p++) {
+    readyHead[p] = -1;
+    readyTail[p] = -1;
+    runs[p] = 0;
+  }
+  wheelTime = 0;
+  timerCount = 0;
+  current = -1;
+  lateRuns = 0;
+  rejected = 0;
+}
+
+bool Scheduler::post(TaskFunction function, TaskPriority priority, uint32_t arg, uint32_t stamp) {
+  int index = allocate(function, priority, arg, stamp);
+  if (index < 0) return false;
+  
+  tasks[index].due = hal.clock->millis();
+  makeReady(index);
+  return true;
+}
+
+bool Scheduler::postDelayed(TaskFunction function, TaskPriority priority, uint32_t delayMs, uint32_t arg, uint32_t stamp) {
+  if (delayMs == 0) {
+    return post(function, priority, arg, stamp);
+  }
+  
+  int index = allocate(function, priority, arg, stamp);
+  if (index < 0) return false;
+  
+  // Bring the wheel up to date first so the new deadline lies ahead of it
+  advance(hal.clock->millis());
+  
+  Task& task = tasks[index];
+  task.due = hal.clock->millis() + delayMs;
+  int slot = task.due % SCHEDULER_WHEEL_SLOTS;
+  task.next = wheel[slot];
+  wheel[slot] = index;
+  timerCount++;
+  return true;
+}
+
+bool Scheduler::isPending(TaskFunction function) {
+  for (int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    if (tasks[i].used && tasks[i].function == function && i != current) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Scheduler::runReady() {
+  advance(hal.clock->millis());
+  
+  while (hasReady()) {
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+      int index = readyHead[p];
+      if (index < 0) continue;
+      
+      // Pop before running; the task may post more work
+      readyHead[p] = tasks[index].next;
+      if (readyHead[p] < 0) readyTail[p] = -1;
+      
+      Task task = tasks[index];
+      if ((int32_t)(hal.clock->millis() - task.due) > 1) {
+        lateRuns++;
+      }
+      runs[p]++;
+      
+      current = index;
+      task.function(task.arg);
+      current = -1;
+      tasks[index].used = false;
+      
+      // Timers may have come due while the task ran
+      advance(hal.clock->millis());
+      break;
+    }
+  }
+}
+
+void Scheduler::sleep() {
+  // Any interrupt wakes the core: the 1 ms system tick (which also
+  // serves the timer wheel), touch sampling, USB serial
+  if (!hasReady()) {
+    WATCHDOG_STAGE(STAGE_IDLE);
+    hal.clock->sleep();
+  }
+}
+
+uint32_t Scheduler::currentStamp() {
+  return (current >= 0) ? tasks[current].stamp : hal.clock->millis();
+}
+
+void Scheduler::printStats() {
+  const char* names[PRIORITY_COUNT] = {"ir", "input", "display", "background"};
+  Serial.print(F("Tasks run:"));
+  for (int p = 0; p < PRIORITY_COUNT; p++) {
+    Serial.print(' ');
+    Serial.print(names[p]);
+    Serial.print('=');
+    Serial.print(runs[p]);
+  }
+  Serial.println();
+  Serial.print(F("Late: "));
+  Serial.print(lateRuns);
+  Serial.print(F(" Rejected: "));
+  Serial.print(rejected);
+  Serial.print(F(" Timers: "));
+  Serial.println(timerCount);
+}
+
+int Scheduler::allocate(TaskFunction function, TaskPriority priority, uint32_t arg, uint32_t stamp) {
+  for (int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    if (!tasks[i].used) {
+      Task& task = tasks[i];
+      task.used = true;
+      task.function = function;
+      task.priority = priority;
+      task.arg = arg;
+      task.stamp = stamp ? stamp : hal.clock->millis();
+      task.next = -1;
+      return i;
+    }
+  }
+  
+  rejected++;
+  #if DEBUG_SERIAL
+    Serial.println(F("Scheduler: task pool full"));
+  #endif
+  return -1;
+}
+
+void Scheduler::makeReady(int index) {
+  // FIFO per priority keeps deadline order within a priority
+  Task& task = tasks[index];
+  task.next = -1;
+  if (readyTail[task.priority] >= 0) {
+    tasks[readyTail[task.priority]].next = index;
+  } else {
+    readyHead[task.priority] = index;
+  }
+  readyTail[task.priority] = index;
+}
+
+void Scheduler::advance(uint32_t now) {
+  if (timerCount == 0) {
+    wheelTime = now;
+    return;
+  }
+  
+  // Visit every slot passed since the last call; after a long stall one
+  // full turn covers all of them
+  uint32_t elapsed = now - wheelTime;
+  if (elapsed > SCHEDULER_WHEEL_SLOTS) {
+    elapsed = SCHEDULER_WHEEL_SLOTS;
+  }
+  for (uint32_t i = 1; i <= elapsed; i++) {
+    expireSlot((now - elapsed + i) % SCHEDULER_WHEEL_SLOTS, now);
+  }
+  wheelTime = now;
+}
+
+void Scheduler::expireSlot(int slot, uint32_t now) {
+  int8_t* link = &wheel[slot];
+  while (*link >= 0) {
+    int index = *link;
+    Task& task = tasks[index];
+    if ((int32_t)(now - task.due) >= 0) {
+      *link = task.next;
+      timerCount--;
+      makeReady(index);
+    } else {
+      // Due on a later lap
+      link = &task.next;
+    }
+  }
+}
+
+bool Scheduler::hasReady() {
+  for (int p = 0; p < PRIORITY_COUNT; p++) {
+    if (readyHead[p] >= 0) return true;
+  }
+  return false;
+}
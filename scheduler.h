@@ -0,0 +1,82 @@
+/*
+ * VHC Universal Remote - Scheduler
+ * Cooperative tasks with priorities and a timer wheel
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Lower value runs first. IR emission outranks everything so a touch's
+// first IR frame always goes out before the redraw it causes.
+enum TaskPriority {
+  PRIORITY_IR,
+  PRIORITY_INPUT,
+  PRIORITY_DISPLAY,
+  PRIORITY_BACKGROUND,
+  PRIORITY_COUNT
+};
+
+typedef void (*TaskFunction)(uint32_t arg);
+
+// Tasks run to completion from loop(); anything that used to delay()
+// posts a delayed continuation instead. Delayed tasks wait in a 1 ms
+// timer wheel (longer delays take several laps) and become ready at
+// their deadline. Between passes the CPU sleeps until an interrupt.
+class Scheduler {
+private:
+  struct Task {
+    TaskFunction function;
+    uint32_t arg;
+    uint32_t stamp;     // When the work was requested
+    uint32_t due;       // Deadline (millis)
+    uint8_t priority;
+    int8_t next;        // Next task in the same ready list or wheel slot
+    bool used;
+  };
+  
+  Task tasks[SCHEDULER_MAX_TASKS];
+  int8_t wheel[SCHEDULER_WHEEL_SLOTS];
+  int8_t readyHead[PRIORITY_COUNT];
+  int8_t readyTail[PRIORITY_COUNT];
+  uint32_t wheelTime;   // Last millisecond the wheel was advanced to
+  int timerCount;
+  int current;          // Task running now, -1 outside tasks
+  
+  // Statistics
+  uint32_t runs[PRIORITY_COUNT];
+  uint32_t lateRuns;    // Ran more than 1 ms after the deadline
+  uint32_t rejected;    // Pool full
+  
+public:
+  Scheduler();
+  
+  // Queue a task; stamp defaults to now and is handed back through
+  // currentStamp() for latency measurements
+  bool post(TaskFunction function, TaskPriority priority, uint32_t arg = 0, uint32_t stamp = 0);
+  bool postDelayed(TaskFunction function, TaskPriority priority, uint32_t delayMs, uint32_t arg = 0, uint32_t stamp = 0);
+  bool isPending(TaskFunction function);
+  
+  // Run ready tasks, highest priority first, until none are left
+  void runReady();
+  
+  // Sleep until the next interrupt (touch, timer tick, USB) if idle
+  void sleep();
+  
+  uint32_t currentStamp();
+  void printStats();
+  
+private:
+  int allocate(TaskFunction function, TaskPriority priority, uint32_t arg, uint32_t stamp);
+  void makeReady(int index);
+  void advance(uint32_t now);
+  void expireSlot(int slot, uint32_t now);
+  bool hasReady();
+};
+
+// Global scheduler instance
+extern Scheduler scheduler;
+
+#endif // SCHEDULER_H
@@ -0,0 +1,276 @@
+/*
+ * VHC Universal Remote - Screen Snapshot Cache Implementation
+ */
+
+#include "screen_cache.h"
+
+// Global screen cache instance
+ScreenCache screenCache;
+
+#define TOKEN_LENGTH_BITS 5
+#define TOKEN_LENGTH_MASK 0x1F
+#define TOKEN_LONG_RUN    0x1F  // Length field value meaning "varint follows"
+
+ScreenCache::ScreenCache() {
+  shadow = nullptr;
+  poolUsed = 0;
+  useCounter = 0;
+  hits = 0;
+  misses = 0;
+  savedMicros = 0;
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    entries[i].used = false;
+  }
+}
+
+void ScreenCache::begin(ShadowGFX* shadow) {
+  this->shadow = shadow;
+  clear();
+}
+
+bool ScreenCache::restore(uint32_t key) {
+  Entry* entry = shadow ? find(key) : nullptr;
+  if (!entry) {
+    misses++;
+    return false;
+  }
+  
+  unsigned long start = micros();
+  
+  shadow->beginWindow(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  const uint8_t* p = pool + entry->offset;
+  const uint8_t* end = p + entry->size;
+  while (p < end) {
+    uint8_t token = *p++;
+    uint32_t length = (token & TOKEN_LENGTH_MASK) + 1;
+    if ((token & TOKEN_LENGTH_MASK) == TOKEN_LONG_RUN) {
+      // Varint continuation, 7 bits per byte
+      uint32_t extra = 0;
+      int shift = 0;
+      uint8_t b;
+      do {
+        b = *p++;
+        extra |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      length = extra + TOKEN_LONG_RUN + 1;
+    }
+    shadow->writeRun(entry->palette[token >> TOKEN_LENGTH_BITS], length);
+  }
+  shadow->endWindow();
+  
+  unsigned long elapsed = micros() - start;
+  entry->lastUsed = ++useCounter;
+  hits++;
+  if (entry->drawMicros > elapsed) {
+    savedMicros += entry->drawMicros - elapsed;
+  }
+  
+  #if DEBUG_SERIAL
+    Serial.print(F("Screen cache hit: "));
+    Serial.print(elapsed);
+    Serial.print(F(" us vs "));
+    Serial.print(entry->drawMicros);
+    Serial.println(F(" us redraw"));
+    printStats();
+  #endif
+  
+  return true;
+}
+
+void ScreenCache::store(uint32_t key, uint32_t drawMicros) {
+  if (!shadow) return;
+  
+  Entry* existing = find(key);
+  if (existing) {
+    evict(existing);
+  }
+  
+  // Pick a free slot, evicting the least recently used one if needed
+  Entry* slot = nullptr;
+  Entry* oldest = nullptr;
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    if (!entries[i].used) {
+      slot = &entries[i];
+      break;
+    }
+    if (!oldest || entries[i].lastUsed < oldest->lastUsed) {
+      oldest = &entries[i];
+    }
+  }
+  if (!slot) {
+    evict(oldest);
+    slot = oldest;
+  }
+  
+  // Screens with more colors than the palette holds are not cached
+  if (!buildPalette(slot)) {
+    return;
+  }
+  
+  uint32_t size = encode(slot, nullptr);
+  if (size > SCREEN_CACHE_BYTES) {
+    #if DEBUG_SERIAL
+      Serial.print(F("Screen cache: snapshot too large ("));
+      Serial.print(size);
+      Serial.println(F(" bytes)"));
+    #endif
+    return;
+  }
+  
+  // Make room within the byte budget. Evicted entries only give their
+  // bytes back in compact(), so count what the live ones hold
+  uint32_t live = 0;
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    if (entries[i].used) live += entries[i].size;
+  }
+  while (live + size > SCREEN_CACHE_BYTES) {
+    Entry* victim = nullptr;
+    for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+      if (entries[i].used && (!victim || entries[i].lastUsed < victim->lastUsed)) {
+        victim = &entries[i];
+      }
+    }
+    if (!victim) break;
+    evict(victim);
+    live -= victim->size;
+  }
+  compact();
+  
+  slot->used = true;
+  slot->key = key;
+  slot->offset = poolUsed;
+  slot->size = encode(slot, pool + poolUsed);
+  slot->drawMicros = drawMicros;
+  slot->lastUsed = ++useCounter;
+  poolUsed += slot->size;
+}
+
+void ScreenCache::invalidate(uint32_t key) {
+  Entry* entry = find(key);
+  if (entry) {
+    evict(entry);
+  }
+}
+
+void ScreenCache::invalidateScreen(uint8_t screen) {
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    if (entries[i].used && (entries[i].key >> 24) == screen) {
+      evict(&entries[i]);
+    }
+  }
+}
+
+void ScreenCache::clear() {
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    entries[i].used = false;
+  }
+  poolUsed = 0;
+}
+
+void ScreenCache::printStats() {
+  unsigned long lookups = hits + misses;
+  Serial.print(F("Screen cache: "));
+  Serial.print(hits);
+  Serial.print(F("/"));
+  Serial.print(lookups);
+  Serial.print(F(" hits ("));
+  Serial.print(lookups ? (hits * 100) / lookups : 0);
+  Serial.print(F("%), "));
+  Serial.print(savedMicros / 1000.0, 1);
+  Serial.print(F(" ms redraw saved, "));
+  Serial.print(poolUsed);
+  Serial.print(F("/"));
+  Serial.print(SCREEN_CACHE_BYTES);
+  Serial.println(F(" bytes used"));
+}
+
+ScreenCache::Entry* ScreenCache::find(uint32_t key) {
+  for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+    if (entries[i].used && entries[i].key == key) {
+      return &entries[i];
+    }
+  }
+  return nullptr;
+}
+
+void ScreenCache::evict(Entry* entry) {
+  entry->used = false;
+}
+
+void ScreenCache::compact() {
+  // Slide live entries down so free space is one block at the end
+  uint32_t next = 0;
+  for (;;) {
+    Entry* lowest = nullptr;
+    for (int i = 0; i < SCREEN_CACHE_ENTRIES; i++) {
+      if (entries[i].used && entries[i].offset >= next &&
+          (!lowest || entries[i].offset < lowest->offset)) {
+        lowest = &entries[i];
+      }
+    }
+    if (!lowest) break;
+    if (lowest->offset != next) {
+      memmove(pool + next, pool + lowest->offset, lowest->size);
+      lowest->offset = next;
+    }
+    next += lowest->size;
+  }
+  poolUsed = next;
+}
+
+bool ScreenCache::buildPalette(Entry* entry) {
+  const uint16_t* pixels = shadow->getBuffer();
+  uint32_t total = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+  
+  entry->paletteSize = 0;
+  uint16_t last = pixels[0] ^ 0xFFFF;
+  for (uint32_t i = 0; i < total; i++) {
+    if (pixels[i] == last) continue;
+    last = pixels[i];
+    if (paletteIndex(entry, last) < entry->paletteSize) continue;
+    if (entry->paletteSize == SCREEN_CACHE_COLORS) return false;
+    entry->palette[entry->paletteSize++] = last;
+  }
+  return true;
+}
+
+uint32_t ScreenCache::encode(Entry* entry, uint8_t* out) {
+  // Returns the encoded size; only writes when out is not null
+  const uint16_t* pixels = shadow->getBuffer();
+  uint32_t total = (uint32_t)SCREEN_WIDTH * SCREEN_HEIGHT;
+  uint32_t size = 0;
+  
+  uint32_t i = 0;
+  while (i < total) {
+    uint16_t color = pixels[i];
+    uint32_t run = 1;
+    while (i + run < total && pixels[i + run] == color) run++;
+    i += run;
+    
+    uint8_t index = paletteIndex(entry, color) << TOKEN_LENGTH_BITS;
+    if (run <= TOKEN_LONG_RUN) {
+      if (out) out[size] = index | (run - 1);
+      size++;
+    } else {
+      if (out) out[size] = index | TOKEN_LONG_RUN;
+      size++;
+      uint32_t extra = run - TOKEN_LONG_RUN - 1;
+      do {
+        uint8_t b = extra & 0x7F;
+        extra >>= 7;
+        if (extra) b |= 0x80;
+        if (out) out[size] = b;
+        size++;
+      } while (extra);
+    }
+  }
+  return size;
+}
+
+uint8_t ScreenCache::paletteIndex(Entry* entry, uint16_t color) {
+  for (uint8_t i = 0; i < entry->paletteSize; i++) {
+    if (entry->palette[i] == color) return i;
+  }
+  return entry->paletteSize;
+}
@@ -0,0 +1,81 @@
+/*
+ * VHC Universal Remote - Screen Snapshot Cache
+ * Compressed framebuffer snapshots of recently shown screens
+ */
+
+#ifndef SCREEN_CACHE_H
+#define SCREEN_CACHE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "shadow_gfx.h"
+
+// Snapshots are taken from the shadow framebuffer right after a screen is
+// drawn and streamed back to the panel in one address window when the same
+// screen (same key) is shown again. Keys encode the screen and whatever
+// state it depends on, so a state change simply misses the cache.
+//
+// Encoding: up to SCREEN_CACHE_COLORS palette colors per snapshot, then one
+// token byte per run: top 3 bits palette index, low 5 bits length - 1. A
+// length field of 31 means a varint with (length - 32) follows.
+class ScreenCache {
+private:
+  struct Entry {
+    bool used;
+    uint32_t key;
+    uint32_t offset;        // Start of the token stream in pool
+    uint32_t size;
+    uint32_t drawMicros;    // Cost of the full redraw this entry replaces
+    uint32_t lastUsed;
+    uint8_t paletteSize;
+    uint16_t palette[SCREEN_CACHE_COLORS];
+  };
+  
+  ShadowGFX* shadow;
+  Entry entries[SCREEN_CACHE_ENTRIES];
+  uint8_t pool[SCREEN_CACHE_BYTES];
+  uint32_t poolUsed;
+  uint32_t useCounter;
+  
+  // Statistics
+  unsigned long hits;
+  unsigned long misses;
+  unsigned long savedMicros;
+  
+public:
+  ScreenCache();
+  void begin(ShadowGFX* shadow);
+  
+  // Stream a cached screen to the panel; false on a miss
+  bool restore(uint32_t key);
+  
+  // Snapshot the screen just drawn (drawMicros = time the draw took)
+  void store(uint32_t key, uint32_t drawMicros);
+  
+  // Drop entries whose state changed
+  void invalidate(uint32_t key);
+  void invalidateScreen(uint8_t screen);
+  void clear();
+  
+  // Statistics
+  unsigned long getHits() { return hits; }
+  unsigned long getMisses() { return misses; }
+  unsigned long getSavedMicros() { return savedMicros; }
+  void printStats();
+  
+private:
+  Entry* find(uint32_t key);
+  void evict(Entry* entry);
+  void compact();
+  bool buildPalette(Entry* entry);
+  uint32_t encode(Entry* entry, uint8_t* out);
+  uint8_t paletteIndex(Entry* entry, uint16_t color);
+};
+
+// Screen keys: screen id in the top byte, screen state below
+#define SCREEN_CACHE_KEY(screen, state) (((uint32_t)(screen) << 24) | ((uint32_t)(state) & 0xFFFFFF))
+
+// Global screen cache instance
+extern ScreenCache screenCache;
+
+#endif // SCREEN_CACHE_H
@@ -9,6 +9,7 @@
 #include <Arduino.h>
 #include <SD.h>
 #include "config.h"
+#include "menu.h"
 
 class SDManager {
 private:
@@ -17,23 +18,34 @@ private:
   // Load a single IRDB file into a device
   bool loadIRDBFile(File& file, Device* device);
   
-  // Map IRDB function names to our standard names
-  const char* mapFunctionName(const char* irdbName);
-  
 public:
   SDManager();
   
+  // One line of a file (the parsing itself is in IRDBParser)
+  static int readLine(Stream& in, char* line, int size);
+  
   // Initialize SD card
   bool begin();
+  bool isReady() { return initialized; }
   
   // Load all CSV files from SD card as devices
   int loadDevices(Device* devices, int maxDevices);
   
+  // Every CSV file in turn, without a table; count, -1 on error
+  int forEachDevice(void (*callback)(const Device& device));
+  
+  // One device by name, opening its file directly
+  bool loadDevice(const char* deviceName, Device* device);
+  
   // Check if device file exists
   bool deviceExists(const char* deviceName);
   
   // Get number of CSV files on card
   int getFileCount();
+  
+  // Names and sizes of the CSV files in one hash, without reading them;
+  // changes when a file is added, removed or edited. 0 without a card
+  uint32_t getCatalogHash();
 };
 
 // Global SD manager instance
@@ -0,0 +1,306 @@
+/*
+ * VHC Universal Remote - Serial Console Implementation
+ */
+
+#include "serial_console.h"
+#include "render_bench.h"
+#include "screen_cache.h"
+#include "usage_stats.h"
+#include "scheduler.h"
+#include "ir_handler.h"
+#include "kv_store.h"
+#include "boot_timeline.h"
+#include "micro_bench.h"
+#include "touch_trace.h"
+#include "profiler.h"
+#include "memory_monitor.h"
+#include "event_log.h"
+#include "loop_watchdog.h"
+#include "host_link.h"
+#include "device_upload.h"
+#include "device_store.h"
+#include "display.h"
+
+// Display instance lives in the main sketch
+extern Display display;
+
+// Global serial console instance
+SerialConsole serialConsole;
+
+// Command handlers return true if they drew over the current screen
+typedef bool (*ConsoleHandler)(const char* args);
+
+struct ConsoleCommand {
+  const char* name;
+  const char* help;
+  ConsoleHandler handler;
+};
+
+static bool cmdHelp(const char* args);
+
+static bool cmdPPM(const char*) {
+  renderBench.writePPM(Serial);
+  return false;
+}
+
+static bool cmdRender(const char* args) {
+  bool save = (strcmp(args, "save") == 0);
+  bool passed = renderBench.run(save);
+  Serial.println(passed ? F("RENDER,result,pass") : F("RENDER,result,FAIL"));
+  return true;
+}
+
+static bool cmdBench(const char* args) {
+  bool save = (strcmp(args, "save") == 0);
+  bool passed = microBench.run(save);
+  Serial.println(passed ? F("BENCH,result,pass") : F("BENCH,result,FAIL"));
+  return false;
+}
+
+static bool cmdTrace(const char* args) {
+  // trace rec [name] | trace play <name> | trace stop | trace report
+  char verb[8];
+  int i = 0;
+  while (*args && *args != ' ' && i < 7) verb[i++] = *args++;
+  verb[i] = '\0';
+  while (*args == ' ') args++;
+  
+  bool ok = true;
+  if (strcmp(verb, "rec") == 0) {
+    ok = touchTrace.startRecording(args);
+  } else if (strcmp(verb, "play") == 0) {
+    ok = touchTrace.startReplay(args);
+  } else if (strcmp(verb, "stop") == 0) {
+    touchTrace.stop();
+  } else if (strcmp(verb, "report") == 0) {
+    touchTrace.printReport();
+  } else {
+    Serial.println(F("Usage: trace rec [name] | play <name> | stop | report"));
+  }
+  if (!ok) {
+    Serial.println(F("TRACE,error,cannot open trace file"));
+  }
+  return false;
+}
+
+static bool cmdProf(const char* args) {
+  #if PROFILER_ENABLED
+    profiler.print();
+    if (strcmp(args, "reset") == 0) {
+      profiler.reset();
+    }
+  #else
+    Serial.println(F("Profiler disabled (PROFILER_ENABLED 0)"));
+  #endif
+  return false;
+}
+
+static bool cmdMem(const char*) {
+  memoryMonitor.printReport();
+  return false;
+}
+
+static bool cmdLog(const char* args) {
+  // log [serial|sd|off|bench]
+  bool ok = true;
+  if (strcmp(args, "serial") == 0) {
+    ok = eventLog.setOutput(LOG_OUTPUT_SERIAL);
+  } else if (strcmp(args, "sd") == 0) {
+    ok = eventLog.setOutput(LOG_OUTPUT_SD);
+  } else if (strcmp(args, "off") == 0) {
+    eventLog.setOutput(LOG_OUTPUT_OFF);
+  } else if (strcmp(args, "bench") == 0) {
+    eventLog.benchmark();
+  } else if (*args) {
+    Serial.println(F("Usage: log [serial|sd|off|bench]"));
+  }
+  if (!ok) {
+    Serial.println(F("LOG,error,cannot open log file"));
+  }
+  eventLog.printStats();
+  return false;
+}
+
+static bool cmdStall(const char* args) {
+  // stall [reset | budget <ms> | inject <ms> [stage]]
+  char verb[8];
+  int i = 0;
+  while (*args && *args != ' ' && i < 7) verb[i++] = *args++;
+  verb[i] = '\0';
+  while (*args == ' ') args++;
+  
+  if (strcmp(verb, "reset") == 0) {
+    loopWatchdog.reset();
+  } else if (strcmp(verb, "budget") == 0 && *args) {
+    loopWatchdog.setBudget(atoi(args));
+  } else if (strcmp(verb, "inject") == 0 && *args) {
+    uint32_t ms = atoi(args);
+    const char* name = strchr(args, ' ');
+    int stage = name ? LoopWatchdog::findStage(name + 1) : STAGE_CONSOLE;
+    if (stage <= STAGE_IDLE) {
+      Serial.println(F("Unknown stage"));
+      return false;
+    }
+    loopWatchdog.injectStall((LoopStage)stage, ms);
+    // Counted when the loop comes round again
+    Serial.println(F("Stall injected, run 'stall' for the histogram"));
+    return false;
+  } else if (*verb) {
+    Serial.println(F("Usage: stall [reset | budget <ms> | inject <ms> [stage]]"));
+  }
+  loopWatchdog.printStats();
+  return false;
+}
+
+static bool cmdHost(const char*) {
+  hostLink.printStats();
+  deviceUpload.printStats();
+  return false;
+}
+
+static bool cmdCache(const char*) {
+  screenCache.printStats();
+  return false;
+}
+
+static bool cmdUsage(const char*) {
+  usageStats.printStats();
+  return false;
+}
+
+static bool cmdSched(const char*) {
+  scheduler.printStats();
+  irHandler.printLatency();
+  return false;
+}
+
+static bool cmdKV(const char*) {
+  kvStore.printStats();
+  return false;
+}
+
+static bool cmdBacklight(const char* args) {
+  uint8_t brightness = 255;
+  if (*args) {
+    brightness = constrain(atoi(args), 0, 255);
+    display.setBacklight(brightness);
+    kvStore.set(KV_BACKLIGHT, &brightness, sizeof(brightness));
+  } else {
+    kvStore.get(KV_BACKLIGHT, &brightness, sizeof(brightness));
+  }
+  Serial.print(F("Backlight "));
+  Serial.println(brightness);
+  return false;
+}
+
+static bool cmdFlashDB(const char* args) {
+  // flashdb | flashdb sync | flashdb bench
+  if (strcmp(args, "sync") == 0) {
+    int synced = deviceStore.sync();
+    if (synced < 0) {
+      Serial.println(F("FLASHDB,error,no card or flash database"));
+    } else {
+      // The menu keeps its table until the next load
+      Serial.print(F("FLASHDB,synced,"));
+      Serial.println(synced);
+    }
+  } else if (strcmp(args, "bench") == 0) {
+    deviceStore.benchmark();
+  } else if (args[0] == '\0') {
+    deviceStore.printStats();
+  } else {
+    Serial.println(F("Usage: flashdb [sync | bench]"));
+  }
+  return false;
+}
+
+static bool cmdBoot(const char* args) {
+  if (strcmp(args, "save") == 0) {
+    Serial.println(bootTimeline.saveBaseline() ? F("BOOT,baseline,saved") : F("BOOT,baseline,save-failed"));
+  }
+  bool passed = bootTimeline.print();
+  Serial.println(passed ? F("BOOT,result,pass") : F("BOOT,result,FAIL"));
+  return false;
+}
+
+const ConsoleCommand consoleCommands[] = {
+  {"help",   "list commands", cmdHelp},
+  {"ppm",    "dump the current screen as binary PPM", cmdPPM},
+  {"render", "[save] render all screens, compare (or save) baselines", cmdRender},
+  {"bench",  "[save] load/send micro benchmarks, compare (or save) baseline", cmdBench},
+  {"trace",  "rec [name] | play <name> | stop | report: touch traces", cmdTrace},
+  {"prof",   "[reset] profiled zone times, then clear them", cmdProf},
+  {"mem",    "stack high-water mark and heap headroom", cmdMem},
+  {"log",    "[serial|sd|off|bench] binary event log output and counters", cmdLog},
+  {"stall",  "[reset | budget <ms> | inject <ms> [stage]] loop stalls per stage", cmdStall},
+  {"host",   "host link queue, frame counters and last device upload", cmdHost},
+  {"cache",  "screen cache statistics", cmdCache},
+  {"usage",  "device usage ranking and taps to first IR", cmdUsage},
+  {"sched",  "scheduler counters and touch-to-IR latency", cmdSched},
+  {"boot",   "[save] boot phase timeline, compare (or save) baseline", cmdBoot},
+  {"kv",     "key/value store bank, fill and write counters", cmdKV},
+  {"flashdb", "[sync | bench] flash device database: counters, refill from SD, timing", cmdFlashDB},
+  {"backlight", "[0-255] show or set (and save) the backlight", cmdBacklight},
+  {NULL, NULL, NULL}
+};
+
+static bool cmdHelp(const char*) {
+  for (int i = 0; consoleCommands[i].name != NULL; i++) {
+    Serial.print(consoleCommands[i].name);
+    Serial.print(F(" - "));
+    Serial.println(consoleCommands[i].help);
+  }
+  return false;
+}
+
+SerialConsole::SerialConsole() {
+  length = 0;
+  line[0] = '\0';
+}
+
+bool SerialConsole::update() {
+  WATCHDOG_STAGE(STAGE_CONSOLE);
+  
+  bool redraw = false;
+  
+  while (Serial.available()) {
+    char c = Serial.read();
+    
+    // Binary frames from a host tool (see remote_protocol.h)
+    if (hostLink.feed(c, length == 0)) {
+      continue;
+    }
+    
+    if (c == '\r' || c == '\n') {
+      if (length > 0) {
+        line[length] = '\0';
+        redraw |= execute(line);
+        length = 0;
+      }
+    } else if (length < (int)sizeof(line) - 1) {
+      line[length++] = c;
+    }
+  }
+  
+  return redraw;
+}
+
+bool SerialConsole::execute(char* command) {
+  // Split "name args"
+  char* args = strchr(command, ' ');
+  if (args) {
+    *args++ = '\0';
+  } else {
+    args = command + strlen(command);
+  }
+  
+  for (int i = 0; consoleCommands[i].name != NULL; i++) {
+    if (strcmp(command, consoleCommands[i].name) == 0) {
+      return consoleCommands[i].handler(args);
+    }
+  }
+  
+  Serial.print(F("Unknown command: "));
+  Serial.println(command);
+  return false;
+}
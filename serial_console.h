@@ -0,0 +1,31 @@
+/*
+ * VHC Universal Remote - Serial Console
+ * Line-based debug commands over USB serial
+ */
+
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class SerialConsole {
+private:
+  char line[64];
+  int length;
+  
+public:
+  SerialConsole();
+  
+  // Read pending serial input and run complete commands. Returns true when
+  // a command drew over the screen and the caller should redraw it.
+  bool update();
+  
+private:
+  bool execute(char* command);
+};
+
+// Global serial console instance
+extern SerialConsole serialConsole;
+
+#endif // SERIAL_CONSOLE_H
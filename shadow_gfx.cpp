@@ -0,0 +1,205 @@
+/*
+ * VHC Universal Remote - Shadow Framebuffer Implementation
+ */
+
+#include "shadow_gfx.h"
+
+ShadowGFX::ShadowGFX(Panel* panel, uint16_t* buffer)
+  : Adafruit_GFX(SCREEN_WIDTH, SCREEN_HEIGHT) {
+  this->panel = panel;
+  this->buffer = buffer;
+  winX = winY = winW = winH = 0;
+  winPos = 0;
+  bandStart = 0;
+  writeDepth = 0;
+  resetCost();
+}
+
+void ShadowGFX::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  panel->gfx().drawPixel(x, y, color);
+  countWindow(x, y, 1, 1);
+  fillBuffer(x, y, 1, 1, color);
+}
+
+void ShadowGFX::startWrite(void) {
+  panel->gfx().startWrite();
+  if (writeDepth++ == 0) cost.transactions++;
+}
+
+void ShadowGFX::endWrite(void) {
+  panel->gfx().endWrite();
+  if (writeDepth > 0) writeDepth--;
+}
+
+void ShadowGFX::writePixel(int16_t x, int16_t y, uint16_t color) {
+  panel->gfx().writePixel(x, y, color);
+  countWindow(x, y, 1, 1);
+  fillBuffer(x, y, 1, 1, color);
+}
+
+void ShadowGFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  panel->gfx().writeFillRect(x, y, w, h, color);
+  countWindow(x, y, w, h);
+  fillBuffer(x, y, w, h, color);
+}
+
+void ShadowGFX::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  panel->gfx().writeFastVLine(x, y, h, color);
+  countWindow(x, y, 1, h);
+  fillBuffer(x, y, 1, h, color);
+}
+
+void ShadowGFX::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  panel->gfx().writeFastHLine(x, y, w, color);
+  countWindow(x, y, w, 1);
+  fillBuffer(x, y, w, 1, color);
+}
+
+void ShadowGFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // Large fills go out in bands, a transaction each, so the touch sampler
+  // gets the bus in between
+  int16_t rows = (w > 0 && w < DISPLAY_BAND_PIXELS) ? DISPLAY_BAND_PIXELS / w : 1;
+  for (int16_t top = y; top < y + h; top += rows) {
+    int16_t bandH = min(rows, (int16_t)(y + h - top));
+    panel->gfx().fillRect(x, top, w, bandH, color);
+    countWindow(x, top, w, bandH);
+  }
+  fillBuffer(x, y, w, h, color);
+}
+
+void ShadowGFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  panel->gfx().drawFastVLine(x, y, h, color);
+  countWindow(x, y, 1, h);
+  fillBuffer(x, y, 1, h, color);
+}
+
+void ShadowGFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  panel->gfx().drawFastHLine(x, y, w, color);
+  countWindow(x, y, w, 1);
+  fillBuffer(x, y, w, 1, color);
+}
+
+void ShadowGFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, color);
+}
+
+void ShadowGFX::pushPixels(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels, int16_t stride) {
+  if (w <= 0 || h <= 0) return;
+  
+  int16_t bandRows = w < DISPLAY_BAND_PIXELS ? DISPLAY_BAND_PIXELS / w : 1;
+  startWrite();
+  panel->setAddrWindow(x, y, w, h);
+  countWindow(x, y, w, h);
+  for (int16_t row = 0; row < h; row++) {
+    if (row > 0 && row % bandRows == 0) {
+      // Let the touch sampler have the bus between bands
+      endWrite();
+      startWrite();
+      panel->setAddrWindow(x, y + row, w, h - row);
+      cost.windows++;
+    }
+    const uint16_t* src = pixels + (uint32_t)row * stride;
+    // writePixels takes a non-const pointer but only reads from it
+    panel->writePixels((uint16_t*)src, w);
+    if (y + row >= 0 && y + row < SCREEN_HEIGHT) {
+      for (int16_t col = 0; col < w; col++) {
+        if (x + col >= 0 && x + col < SCREEN_WIDTH) {
+          buffer[(uint32_t)(y + row) * SCREEN_WIDTH + x + col] = src[col];
+        }
+      }
+    }
+  }
+  endWrite();
+}
+
+void ShadowGFX::beginWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  winX = x;
+  winY = y;
+  winW = w;
+  winH = h;
+  winPos = 0;
+  bandStart = 0;
+  startWrite();
+  panel->setAddrWindow(x, y, w, h);
+  cost.windows++;
+}
+
+void ShadowGFX::writeRun(uint16_t color, uint32_t length) {
+  // Row by row, wrapping across window rows like the panel does, and
+  // mirrored as it goes
+  uint32_t total = (uint32_t)winW * winH;
+  while (length > 0 && winPos < total) {
+    int16_t row = winPos / winW;
+    int16_t col = winPos % winW;
+    if (col == 0 && winPos - bandStart >= DISPLAY_BAND_PIXELS) {
+      // Let the touch sampler have the bus, then carry on in a window
+      // over the rows left
+      endWrite();
+      startWrite();
+      panel->setAddrWindow(winX, winY + row, winW, winH - row);
+      cost.windows++;
+      bandStart = winPos;
+    }
+    uint32_t span = winW - col;
+    if (span > length) span = length;
+    panel->writeColor(color, span);
+    cost.pixels += span;
+    fillBuffer(winX + col, winY + row, span, 1, color);
+    winPos += span;
+    length -= span;
+  }
+}
+
+void ShadowGFX::endWindow() {
+  endWrite();
+}
+
+uint16_t ShadowGFX::getPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return 0;
+  return buffer[(uint32_t)y * SCREEN_WIDTH + x];
+}
+
+void ShadowGFX::readRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* out) const {
+  for (int16_t row = 0; row < h; row++) {
+    for (int16_t col = 0; col < w; col++) {
+      *out++ = getPixel(x + col, y + row);
+    }
+  }
+}
+
+void ShadowGFX::fillBuffer(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // Clip to the screen
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+  if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+  if (w <= 0 || h <= 0) return;
+  
+  for (int16_t row = y; row < y + h; row++) {
+    uint16_t* p = buffer + (uint32_t)row * SCREEN_WIDTH + x;
+    for (int16_t i = 0; i < w; i++) {
+      *p++ = color;
+    }
+  }
+}
+
+
+void ShadowGFX::resetCost() {
+  cost.transactions = 0;
+  cost.windows = 0;
+  cost.pixels = 0;
+}
+
+void ShadowGFX::countWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  // Calls made outside startWrite/endWrite are a transaction of their own
+  if (writeDepth == 0) cost.transactions++;
+  cost.windows++;
+  
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
+  if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+  if (w > 0 && h > 0) {
+    cost.pixels += (uint32_t)w * h;
+  }
+}
\ No newline at end of file
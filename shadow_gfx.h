@@ -0,0 +1,75 @@
+/*
+ * VHC Universal Remote - Shadow Framebuffer
+ * Mirrors every panel write into a RAM copy of the screen
+ */
+
+#ifndef SHADOW_GFX_H
+#define SHADOW_GFX_H
+
+#include <Adafruit_GFX.h>
+#include "config.h"
+#include "hal.h"
+
+// Drawing target that forwards each primitive to the panel unchanged and
+// also records the result in a 16-bit framebuffer. The panel cannot be read
+// back quickly, so snapshots and save-unders read pixels from here instead.
+// The buffer is in panel memory order: while the main menu strip is
+// scrolled, scroll-area columns are stored where the panel holds them.
+// Bus cost of the drawing since the last resetCost(), counted the way
+// Adafruit_SPITFT issues it
+struct RenderCost {
+  uint32_t transactions;  // startWrite/endWrite pairs
+  uint32_t windows;       // setAddrWindow calls
+  uint32_t pixels;        // Pixels clocked out
+};
+
+class ShadowGFX : public Adafruit_GFX {
+private:
+  Panel* panel;
+  uint16_t* buffer;
+  RenderCost cost;
+  int writeDepth;
+  
+  // Streaming window state (writeRun)
+  int16_t winX, winY, winW, winH;
+  uint32_t winPos;
+  uint32_t bandStart;  // winPos where the current transaction began
+  
+public:
+  ShadowGFX(Panel* panel, uint16_t* buffer);
+  
+  // Adafruit_GFX overrides: same call on the panel, mirrored into RAM
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void startWrite(void) override;
+  void endWrite(void) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  
+  // Block transfers (one address window each, reopened every
+  // DISPLAY_BAND_PIXELS at a row boundary)
+  void pushPixels(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels, int16_t stride);
+  void beginWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+  void writeRun(uint16_t color, uint32_t length);
+  void endWindow();
+  
+  // Read back from the RAM copy
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  void readRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t* out) const;
+  const uint16_t* getBuffer() const { return buffer; }
+  
+  // Pixel-cost counters
+  const RenderCost& getCost() const { return cost; }
+  void resetCost();
+  
+private:
+  void fillBuffer(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void countWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+};
+
+#endif // SHADOW_GFX_H
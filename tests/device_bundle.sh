@@ -0,0 +1,31 @@
+#!/bin/sh
+# VHC Universal Remote - Device Bundle Test
+# device_bundle_gen over the CSVs device_bundle.h lists, compared with the
+# committed header, then device_bundle_check against the same CSVs
+# Usage: device_bundle.sh <build dir> <source dir>
+
+BUILD=$1
+SOURCE=$2
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+# Relative paths, as the header's Sources line records them
+cd "$SOURCE" || exit 1
+CSVS=$(sed -n 's/^ \* Sources: //p' device_bundle.h)
+[ "$CSVS" = "none" ] && CSVS=""
+case "$CSVS" in
+  *examples/*) ;;
+  *) echo "device_bundle.h is not built from examples/: $CSVS"; exit 1 ;;
+esac
+
+"$BUILD/device_bundle_gen" "$OUT/device_bundle.h" $CSVS || exit 1
+diff -u device_bundle.h "$OUT/device_bundle.h" || { echo "device_bundle.h is stale, regenerate it"; exit 1; }
+"$BUILD/device_bundle_check" $CSVS || exit 1
+
+# The header goes first; a CSV in its place is refused, not overwritten
+cp examples/Sony_TV.csv "$OUT/Sony_TV.csv"
+if "$BUILD/device_bundle_gen" "$OUT/Sony_TV.csv" examples/Sony_TV.csv 2>/dev/null; then
+  echo "device_bundle_gen wrote over a CSV"
+  exit 1
+fi
+cmp -s examples/Sony_TV.csv "$OUT/Sony_TV.csv" || { echo "CSV changed"; exit 1; }
@@ -0,0 +1,74 @@
+/*
+ * VHC Universal Remote - Host Test Helpers
+ * Checks and sketch drivers shared by the host tests
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "hal_host.h"
+#include "menu.h"
+
+void setup();
+void loop();
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      testFailures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long long _a = (long long)(a), _b = (long long)(b); \
+    if (_a != _b) { \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+      testFailures++; \
+    } \
+  } while (0)
+
+static inline int testResult(const char* name) {
+  if (testFailures) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, testFailures);
+    return 1;
+  }
+  printf("%s: OK\n", name);
+  return 0;
+}
+
+// Sketch loop until the virtual clock reaches ms
+static inline void runUntil(uint32_t ms) {
+  while (hostClock.millis() < ms) {
+    loop();
+  }
+}
+
+static inline void runFor(uint32_t ms) {
+  runUntil(hostClock.millis() + ms);
+}
+
+// Example devices on the card, setup(), then loop() past the splash
+// until the first screen has finished drawing
+static inline bool bootToMain() {
+  hostSD.loadDirectory(VHC_SOURCE_DIR "/examples", ".csv");
+  setup();
+  uint32_t limit = hostClock.millis() + 10000;
+  while (menu.getCurrentScreen() == SCREEN_SPLASH && hostClock.millis() < limit) {
+    loop();
+  }
+  runFor(1000);
+  return menu.getCurrentScreen() != SCREEN_SPLASH;
+}
+
+// Tap at a screen point and let the sketch handle it
+static inline void tap(int x, int y, uint32_t holdMs = 80) {
+  uint64_t now = hostClock.nanos() / 1000;
+  hostTouch.tapAt(now + 1000, x, y, holdMs);
+  runFor(holdMs + 100);
+}
+
+#endif // HOST_TEST_H
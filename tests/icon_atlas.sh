@@ -0,0 +1,13 @@
+#!/bin/sh
+# VHC Universal Remote - Icon Atlas Test
+# icon_atlas_gen over the current ui_icons.h, compared with the committed
+# ui_icon_atlas.h
+# Usage: icon_atlas.sh <build dir> <source dir>
+
+BUILD=$1
+SOURCE=$2
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+"$BUILD/icon_atlas_gen" "$OUT/ui_icon_atlas.h" || exit 1
+diff -u "$SOURCE/ui_icon_atlas.h" "$OUT/ui_icon_atlas.h" || { echo "ui_icon_atlas.h is stale, regenerate it"; exit 1; }
@@ -0,0 +1,30 @@
+#!/bin/sh
+# VHC Universal Remote - IR Service Test
+# ir_loadgen against ir_service with two file emitters: every request
+# answered OK, and every one of them on an emitter's output
+# Usage: ir_service.sh <build dir> <source dir>
+
+BUILD=$1
+SOURCE=$2
+DIR=$(mktemp -d)
+SOCKET="$DIR/ir.sock"
+
+"$BUILD/ir_service" --socket "$SOCKET" --irdb "$SOURCE/examples" \
+  --emitter ir0=file:"$DIR/ir0.txt" --emitter ir1=file:"$DIR/ir1.txt" > "$DIR/service.txt" 2>&1 &
+SERVICE=$!
+trap 'kill $SERVICE; rm -rf "$DIR"' EXIT
+
+for i in 1 2 3 4 5 6 7 8 9 10; do
+  [ -S "$SOCKET" ] && break
+  sleep 0.2
+done
+[ -S "$SOCKET" ] || { cat "$DIR/service.txt"; echo "ir_service did not start"; exit 1; }
+
+# 1 + 4 clients, 20 requests each; exits 1 on any error reply
+"$BUILD/ir_loadgen" --socket "$SOCKET" --device "Sony TV" --function volUp \
+  --emitters ir0,ir1 --clients 1,4 --requests 20 || exit 1
+
+# The service flushes each batch before it replies
+FRAMES=$(cat "$DIR/ir0.txt" "$DIR/ir1.txt" | wc -l)
+echo "$FRAMES frames on the emitters"
+[ "$FRAMES" -ge 100 ] || { echo "expected at least 100 frames"; exit 1; }
@@ -0,0 +1,24 @@
+#!/bin/sh
+# VHC Universal Remote - Log Decode Test
+# log_decode over the Serial output test_event_log captures: console text
+# skipped, no PROTO_LOG frame missing, and the test's records as text
+# Usage: log_decode.sh <build dir>
+
+BUILD=$1
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+"$BUILD/tests/test_event_log" "$DIR/serial.bin" > /dev/null || exit 1
+"$BUILD/log_decode" --relative "$DIR/serial.bin" > "$DIR/log.txt" 2> "$DIR/summary.txt" || exit 1
+cat "$DIR/summary.txt"
+grep -q 'missing' "$DIR/summary.txt" && exit 1
+
+expect() {
+  grep -q "$1" "$DIR/log.txt" || { echo "not decoded: $1"; exit 1; }
+}
+expect '  IR send volUp code=0x490 protocol=2 bits=12$'
+expect '  IR error: a message longer than a$'
+expect '  touch raw x=0 y=0 z=0$'
+expect '  touch raw x=59 y=118 z=177$'
+SAMPLES=$(grep -c '  touch raw ' "$DIR/log.txt")
+[ "$SAMPLES" -eq 60 ] || { echo "$SAMPLES touch samples decoded, expected 60"; exit 1; }
@@ -0,0 +1,29 @@
+#!/bin/sh
+# VHC Universal Remote - Host Link Test
+# remote_upload and remote_bench against remote_sim over a pty
+# Usage: remote_sim_link.sh <build dir> <source dir>
+
+BUILD=$1
+SOURCE=$2
+OUT=$(mktemp)
+DIR=$(mktemp -d)
+
+"$BUILD/remote_sim" --devices TV --sd-kbps 50 > "$OUT" 2>&1 &
+SIM=$!
+trap 'kill $SIM; rm -rf "$OUT" "$DIR"' EXIT
+
+for i in 1 2 3 4 5 6 7 8 9 10; do
+  [ -s "$OUT" ] && break
+  sleep 0.2
+done
+PTY=$(head -n 1 "$OUT")
+[ -e "$PTY" ] || { echo "remote_sim did not start"; exit 1; }
+
+# A new device through the firmware's upload path, saved to the card
+cp "$SOURCE/examples/Sony_TV.csv" "$DIR/Uploaded_TV.csv"
+"$BUILD/remote_upload" "$PTY" "$DIR/Uploaded_TV.csv" | tee "$DIR/upload.txt" || exit 1
+grep -q '10 commands' "$DIR/upload.txt" || exit 1
+
+# Sends to the generated device and to the uploaded one
+"$BUILD/remote_bench" "$PTY" --device TV --command volUp --count 20 --pings 10 || exit 1
+"$BUILD/remote_bench" "$PTY" --device "Uploaded TV" --command power --count 4 --pings 0 || exit 1
@@ -0,0 +1,21 @@
+/*
+ * VHC Universal Remote - Boot Test
+ * The sketch boots on the host HAL, shows the main menu and sends IR
+ */
+
+#include "host_test.h"
+
+int main() {
+  CHECK(bootToMain());
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_MAIN);
+  CHECK(hostPanel.pixels > 0);
+  CHECK(Serial.getOutput().find("Setup complete!") != std::string::npos);
+  
+  // First device in the strip, then its POWER button
+  tap(120, 105);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_DEVICE);
+  tap(275, 25);
+  runFor(500);
+  CHECK(!hostIR.sent.empty());
+  return testResult("test_boot");
+}
@@ -0,0 +1,166 @@
+/*
+ * VHC Universal Remote - Device List Test
+ * The hardware-scrolled device strip against the scroll register model:
+ * after every loop pass of a drag, a flick and the Next/Back buttons, what
+ * the glass shows through the scroll registers is exactly the strip drawn
+ * in one piece at the same offset, the scroll start never leaves the
+ * scroll area, and each scroll step rasterizes only the columns it
+ * brings into view
+ */
+
+#include <fstream>
+#include <sstream>
+#include "host_test.h"
+#include "display.h"
+#include "device_list.h"
+
+extern Display display;
+
+static const int EXTRA_DEVICES = 9;  // With the examples, three pages
+static const int SCROLL_WIDTH = SCREEN_WIDTH - LIST_FIXED_WIDTH;
+
+static GFXcanvas16* strip;
+static int offset;  // Strip column at the left edge, followed pass to pass
+static uint32_t passes;
+static uint32_t mismatches;
+static unsigned long lastSteps;    // DeviceList counters at the last pass
+static unsigned long lastColumns;
+static uint32_t steps;
+
+// The whole strip, each page drawn once with no bands
+static void drawStrip() {
+  int pages = menu.getTotalPages();
+  strip = new GFXcanvas16(pages * SCROLL_WIDTH, SCREEN_HEIGHT);
+  strip->setTextWrap(false);
+  strip->fillScreen(COLOR_BACKGROUND);
+  for (int page = 0; page < pages; page++) {
+    const char* names[DEVICES_PER_PAGE];
+    int count = 0;
+    for (int i = page * DEVICES_PER_PAGE; i < menu.getDeviceCount() && count < DEVICES_PER_PAGE; i++) {
+      names[count++] = menu.getDeviceName(i);
+    }
+    display.drawDevicePage(strip, page * SCROLL_WIDTH, names, count);
+  }
+}
+
+// Follow the offset from the scroll start (it moves less than the scroll
+// area per pass) and compare the scroll area with the strip there
+static void checkScreen() {
+  int start = hostPanel.getScrollStart();
+  int step = ((start - offset % SCROLL_WIDTH) % SCROLL_WIDTH + SCROLL_WIDTH) % SCROLL_WIDTH;
+  if (step > SCROLL_WIDTH / 2) step -= SCROLL_WIDTH;
+  offset += step;
+  passes++;
+
+  // Rasterized: just the columns scrolled in, by however many steps the
+  // pass took (drag samples can queue up). The counters restart with
+  // each press and page scroll.
+  unsigned long stepCount = deviceList.getScrollSteps();
+  unsigned long columns = deviceList.getColumnsRasterized();
+  if (stepCount < lastSteps || columns < lastColumns) {
+    lastSteps = 0;
+    lastColumns = 0;
+  }
+  CHECK_EQ(stepCount > lastSteps, step != 0);
+  CHECK_EQ(columns - lastColumns, (unsigned long)abs(step));
+  steps += stepCount - lastSteps;
+  lastSteps = stepCount;
+  lastColumns = columns;
+
+  CHECK(offset >= 0 && offset + SCROLL_WIDTH <= strip->width());
+  if (offset < 0 || offset + SCROLL_WIDTH > strip->width()) return;
+
+  const uint16_t* expected = strip->getBuffer();
+  for (int x = 0; x < SCROLL_WIDTH; x++) {
+    CHECK_EQ(hostPanel.visibleColumn(x), (x + offset) % SCROLL_WIDTH);
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+      if (hostPanel.visiblePixel(x, y) != expected[y * strip->width() + offset + x]) {
+        mismatches++;
+      }
+    }
+  }
+}
+
+static void runChecked(uint32_t ms) {
+  uint32_t end = hostClock.millis() + ms;
+  while (hostClock.millis() < end) {
+    loop();
+    checkScreen();
+  }
+}
+
+static void testDrag() {
+  // Finger from right to left across most of the strip, slowly enough to
+  // snap rather than flick when lifted
+  uint64_t now = hostClock.nanos() / 1000 + 1000;
+  int y = FakeTouch::rawY(60);
+  for (int i = 0; i <= 20; i++) {
+    hostTouch.setAt(now + i * 30000, FakeTouch::rawX(200 - i * 8), y, 1000);
+  }
+  hostTouch.setAt(now + 20 * 30000 + 200000, FakeTouch::rawX(40), y, 1000);
+  hostTouch.setAt(now + 20 * 30000 + 210000, 0, 0, 0);
+  runChecked(20 * 30 + 1500);
+  CHECK_EQ(menu.getCurrentPage(), 1);
+  CHECK_EQ(offset, SCROLL_WIDTH);
+}
+
+static void testFlick() {
+  // Fast back to the right: momentum past page 1, then settles on page 0
+  uint64_t now = hostClock.nanos() / 1000 + 1000;
+  int y = FakeTouch::rawY(60);
+  for (int i = 0; i <= 5; i++) {
+    hostTouch.setAt(now + i * 10000, FakeTouch::rawX(40 + i * 25), y, 1000);
+  }
+  hostTouch.setAt(now + 5 * 10000 + 5000, 0, 0, 0);
+  runChecked(2000);
+  CHECK_EQ(menu.getCurrentPage(), 0);
+  CHECK_EQ(offset, 0);
+}
+
+static void testButtons() {
+  // Next twice to the last page, then Back, each an animated scroll
+  hostTouch.tapAt(hostClock.nanos() / 1000 + 1000, 275, 195, 80);
+  runChecked(1000);
+  hostTouch.tapAt(hostClock.nanos() / 1000 + 1000, 275, 195, 80);
+  runChecked(1000);
+  CHECK_EQ(menu.getCurrentPage(), 2);
+  CHECK_EQ(offset, 2 * SCROLL_WIDTH);
+
+  hostTouch.tapAt(hostClock.nanos() / 1000 + 1000, 275, 230, 80);
+  runChecked(1000);
+  CHECK_EQ(menu.getCurrentPage(), 1);
+  CHECK_EQ(offset, SCROLL_WIDTH);
+}
+
+int main() {
+  std::ifstream example(VHC_SOURCE_DIR "/examples/Sony_TV.csv");
+  std::stringstream codes;
+  codes << example.rdbuf();
+  for (int i = 0; i < EXTRA_DEVICES; i++) {
+    char path[32];
+    snprintf(path, sizeof(path), "/Living_Room_TV_%d.csv", i + 1);
+    CHECK(hostSD.addFile(path, codes.str().c_str()));
+  }
+  CHECK(bootToMain());
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_MAIN);
+  CHECK_EQ(menu.getTotalPages(), 3);
+  CHECK_EQ(menu.getCurrentPage(), 0);
+
+  drawStrip();
+  offset = 0;
+  lastSteps = deviceList.getScrollSteps();
+  lastColumns = deviceList.getColumnsRasterized();
+  hostPanel.resetCounters();
+  checkScreen();
+
+  testDrag();
+  testFlick();
+  testButtons();
+
+  CHECK(passes > 1000);
+  CHECK(steps > 50);
+  CHECK_EQ(mismatches, 0);
+  CHECK_EQ(hostPanel.scrollErrors, 0);
+
+  return testResult("test_device_list");
+}
@@ -0,0 +1,128 @@
+/*
+ * VHC Universal Remote - Device Store Test
+ * Boot loads follow the card when its files change and list the devices
+ * in the card's order, from SD or from flash, and a sync with more
+ * devices than flash indexes keeps the ones it could not list
+ */
+
+#include "host_test.h"
+#include "device_store.h"
+#include "flash_db.h"
+#include "irdb_parser.h"
+#include "kv_store.h"
+#include "sd_manager.h"
+
+static Device devices[MAX_DEVICES];
+
+static const char* POWER_ONLY = "POWER,5,1,-1,21\n";
+static const char* POWER_AND_VOLUME = "POWER,5,1,-1,21\nVOLUME+,5,1,-1,18\n";
+
+static int load() {
+  return deviceStore.loadDevices(devices, MAX_DEVICES);
+}
+
+// The table matches the card listing, name for name
+static void checkCardOrder(int count) {
+  static Device listed[MAX_DEVICES];
+  CHECK_EQ(sdManager.loadDevices(listed, MAX_DEVICES), count);
+  for (int i = 0; i < count; i++) {
+    if (strcmp(devices[i].name, listed[i].name) != 0) {
+      fprintf(stderr, "device %d: %s, card lists %s\n", i, devices[i].name, listed[i].name);
+      testFailures++;
+    }
+  }
+}
+
+static int commandsOf(const char* name, int count) {
+  for (int i = 0; i < count; i++) {
+    if (strcmp(devices[i].name, name) == 0) return devices[i].commandCount;
+  }
+  return -1;
+}
+
+int main() {
+  hostSD.addFile("/Alpha.csv", POWER_ONLY);
+  hostSD.addFile("/Bravo.csv", POWER_ONLY);
+  kvStore.begin();
+  CHECK(sdManager.begin());
+  deviceStore.begin();
+  CHECK(flashDB.isReady());
+  
+  // First boot fills flash from the card
+  CHECK_EQ(load(), 2);
+  CHECK_EQ(flashDB.getCount(), 2);
+  
+  // Unchanged card: flash only, no SD parsing
+  uint32_t stores = flashDB.getStats().stores;
+  CHECK_EQ(load(), 2);
+  CHECK_EQ(flashDB.getStats().stores, stores);
+  
+  // A new file shows up at the next boot
+  hostSD.addFile("/Charlie.csv", POWER_ONLY);
+  CHECK_EQ(load(), 3);
+  CHECK_EQ(commandsOf("Charlie", 3), 1);
+  
+  // So does an edited one, and a removed one goes from flash too
+  hostSD.fs().remove("/Alpha.csv");
+  hostSD.addFile("/Bravo.csv", POWER_AND_VOLUME);
+  int count = load();
+  CHECK_EQ(count, 2);
+  CHECK_EQ(commandsOf("Alpha", count), -1);
+  CHECK_EQ(commandsOf("Bravo", count), 2);
+  CHECK_EQ(flashDB.getCount(), 2);
+  
+  // Without a card, flash is all there is
+  hostSD.setInserted(false);
+  sdManager = SDManager();
+  CHECK(!sdManager.begin());
+  CHECK_EQ(load(), 2);
+  hostSD.setInserted(true);
+  CHECK(sdManager.begin());
+  
+  // Boots from flash list the devices as the card does, not by name
+  // hash, after a sync as well as after the first fill
+  hostSD.format();
+  char path[32];
+  for (int i = 0; i < 12; i++) {
+    snprintf(path, sizeof(path), "/Room%02d TV.csv", i);
+    hostSD.addFile(path, i % 2 ? POWER_ONLY : POWER_AND_VOLUME);
+  }
+  hostSD.addFile("/Bravo.csv", POWER_AND_VOLUME);
+  hostSD.addFile("/Charlie.csv", POWER_ONLY);
+  stores = flashDB.getStats().stores;
+  CHECK_EQ(load(), 14);
+  CHECK(flashDB.getStats().stores > stores);
+  checkCardOrder(14);
+  stores = flashDB.getStats().stores;
+  CHECK_EQ(load(), 14);
+  CHECK_EQ(flashDB.getStats().stores, stores);
+  checkCardOrder(14);
+  
+  // A new file takes its place in the listing; an upload with no card
+  // position goes after the rest
+  hostSD.addFile("/Attic.csv", POWER_ONLY);
+  CHECK_EQ(load(), 15);
+  checkCardOrder(15);
+  Device upload;
+  IRDBParser::beginDevice(&upload, "Uploaded");
+  deviceStore.store(upload);
+  CHECK_EQ(flashDB.loadDevices(devices, MAX_DEVICES), 16);
+  CHECK(strcmp(devices[15].name, "Uploaded") == 0);
+  
+  // More devices on the card than flash indexes, with ones already in
+  // flash listed last: those must survive the sync
+  hostSD.format();
+  for (int i = 0; i < FLASH_DB_MAX_DEVICES + 4; i++) {
+    snprintf(path, sizeof(path), "/Filler%02d.csv", i);
+    hostSD.addFile(path, POWER_ONLY);
+  }
+  hostSD.addFile("/Bravo.csv", POWER_AND_VOLUME);
+  hostSD.addFile("/Charlie.csv", POWER_ONLY);
+  CHECK(deviceStore.sync() > FLASH_DB_MAX_DEVICES);
+  Device device;
+  CHECK(flashDB.find("Bravo", &device));
+  CHECK(flashDB.find("Charlie", &device));
+  CHECK_EQ(flashDB.getCount(), FLASH_DB_MAX_DEVICES);
+  
+  return testResult("test_device_store");
+}
@@ -0,0 +1,87 @@
+/*
+ * VHC Universal Remote - Device Upload Test
+ * A second upload begun while the first is still being written to SD is
+ * refused with PROTO_BUSY; the first file is saved and reported, and the
+ * second goes through once it has been
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "host_test.h"
+#include "device_upload.h"
+#include "remote_protocol.h"
+
+static std::string csv;
+
+// UPLOAD_SAVED results in the captured output, in order
+static std::string savedResults() {
+  std::string results;
+  const std::string& out = Serial.getOutput();
+  const uint8_t* p = (const uint8_t*)out.data();
+  for (size_t i = 0; i + PROTO_HEADER_SIZE + 2 <= out.size(); i++) {
+    if (p[i] != PROTO_SYNC) continue;
+    int length = p[i + 1];
+    if (i + PROTO_HEADER_SIZE + length + 2 > out.size() ||
+        protoGet16(p + i + PROTO_HEADER_SIZE + length) != protoCRC(p + i + 1, PROTO_HEADER_SIZE - 1 + length)) {
+      continue;
+    }
+    if (p[i + 3] == PROTO_UPLOAD_SAVED) {
+      results += (char)('0' + p[i + PROTO_HEADER_SIZE]);
+    }
+    i += PROTO_HEADER_SIZE + length + 1;
+  }
+  return results;
+}
+
+static uint8_t begin(const char* name) {
+  uint8_t payload[PROTO_MAX_PAYLOAD];
+  protoPut32(payload, csv.size());
+  memcpy(payload + 4, name, strlen(name));
+  return deviceUpload.begin(payload, 4 + strlen(name));
+}
+
+// The whole file, then the end; UPLOAD_DONE is sent, the save is not done
+static void upload(const char* name) {
+  CHECK_EQ(begin(name), PROTO_OK);
+  for (size_t offset = 0; offset < csv.size(); offset += PROTO_MAX_PAYLOAD) {
+    int chunk = std::min(csv.size() - offset, (size_t)PROTO_MAX_PAYLOAD);
+    CHECK_EQ(deviceUpload.write((const uint8_t*)csv.data() + offset, chunk), PROTO_OK);
+  }
+  CHECK_EQ(deviceUpload.finish(), PROTO_OK);
+}
+
+int main() {
+  std::ifstream example(VHC_SOURCE_DIR "/examples/Sony_TV.csv");
+  std::stringstream codes;
+  codes << example.rdbuf();
+  csv = codes.str();
+  CHECK(csv.size() < UPLOAD_BUFFER_BYTES);
+
+  CHECK(bootToMain());
+  runFor(500);
+  Serial.clearOutput();
+
+  // Nothing runs the write task in between
+  upload("First_TV");
+  CHECK_EQ(begin("Second_TV"), PROTO_BUSY);
+  CHECK(savedResults().empty());
+
+  runFor(2000);
+  CHECK(savedResults() == "0");
+  CHECK(hal.storage->fs().exists("/First_TV.csv"));
+  bool loaded = false;
+  for (int i = 0; i < menu.getDeviceCount(); i++) {
+    loaded = loaded || strcmp(menu.getDeviceName(i), "First TV") == 0;
+  }
+  CHECK(loaded);
+
+  upload("Second_TV");
+  runFor(2000);
+  CHECK(savedResults() == "00");
+  CHECK(hal.storage->fs().exists("/First_TV.csv"));
+  CHECK(hal.storage->fs().exists("/Second_TV.csv"));
+
+  return testResult("test_device_upload");
+}
@@ -0,0 +1,143 @@
+/*
+ * VHC Universal Remote - Event Log Test
+ * Records drained to Serial: a string argument is the one the caller
+ * passed even after its buffer changed, and every record arrives, in
+ * order, inside PROTO_LOG frames with consecutive sequence numbers and
+ * nothing binary between them. With a path argument the captured output
+ * is also written there, for log_decode.sh to decode
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "host_test.h"
+#include "event_log.h"
+
+static const int SAMPLES = 60;  // Several frames' worth
+
+struct Record {
+  uint16_t format;
+  std::vector<uint32_t> args;
+  std::string text;
+};
+
+// Frames out of the captured output; bytes between them must be text
+static std::vector<uint8_t> unframe(const std::string& out, int& frames, int& seqErrors, int& binaryOutside) {
+  std::vector<uint8_t> payload;
+  const uint8_t* p = (const uint8_t*)out.data();
+  size_t size = out.size();
+  int lastSeq = -1;
+  frames = 0;
+  seqErrors = 0;
+  binaryOutside = 0;
+
+  size_t i = 0;
+  while (i < size) {
+    if (p[i] != PROTO_SYNC) {
+      if (p[i] >= 0x80) binaryOutside++;
+      i++;
+      continue;
+    }
+    int length = (i + 1 < size) ? p[i + 1] : 0;
+    size_t total = PROTO_HEADER_SIZE + length + 2;
+    if (i + total > size || length > PROTO_MAX_PAYLOAD ||
+        protoGet16(p + i + PROTO_HEADER_SIZE + length) != protoCRC(p + i + 1, PROTO_HEADER_SIZE - 1 + length)) {
+      binaryOutside++;
+      i++;
+      continue;
+    }
+    if (p[i + 3] == PROTO_LOG) {
+      if (lastSeq >= 0 && p[i + 2] != (uint8_t)(lastSeq + 1)) seqErrors++;
+      lastSeq = p[i + 2];
+      payload.insert(payload.end(), p + i + PROTO_HEADER_SIZE, p + i + PROTO_HEADER_SIZE + length);
+      frames++;
+    }
+    i += total;
+  }
+  return payload;
+}
+
+// Records as log_formats.h lays them out; %s arguments by format
+static std::vector<Record> parse(const std::vector<uint8_t>& data) {
+  std::vector<Record> records;
+  size_t i = 0;
+  while (i + 8 <= data.size()) {
+    CHECK_EQ(data[i], LOG_SYNC);
+    if (data[i] != LOG_SYNC) break;
+    Record r;
+    r.format = data[i + 1] | (data[i + 2] << 8);
+    int argCount = data[i + 3];
+    i += 8;
+    for (int a = 0; a < argCount && i < data.size(); a++) {
+      bool text = (r.format == LOG_IR_SEND && a == 0) || r.format == LOG_IR_ERROR ||
+                  ((r.format == LOG_LOOP_STALL || r.format == LOG_LOOP_STALL_END) && a == 0);
+      if (text) {
+        int length = data[i++];
+        r.text.assign((const char*)&data[i], length);
+        r.args.push_back(0);
+        i += length;
+      } else {
+        r.args.push_back(protoGet32(&data[i]));
+        i += 4;
+      }
+    }
+    records.push_back(r);
+  }
+  CHECK_EQ(i, data.size());
+  return records;
+}
+
+int main(int argc, char** argv) {
+  CHECK(bootToMain());
+  CHECK(eventLog.setOutput(LOG_OUTPUT_SERIAL));
+  runFor(100);
+  Serial.clearOutput();
+
+  // The name's buffer is reused before the drain gets to the record
+  char name[16] = "volUp";
+  logEvent(LOG_IR_SEND, name, 0x490, 2, 12);
+  strcpy(name, "garbage");
+  const char* longError = "a message longer than a record holds";
+  logEvent(LOG_IR_ERROR, longError);
+  for (int i = 0; i < SAMPLES; i++) {
+    logEvent(LOG_TOUCH_SAMPLE, i, 2 * i, 3 * i);
+  }
+  Serial.print(F("console text between frames\n"));
+  runFor(5 * LOG_DRAIN_MS);
+
+  int frames, seqErrors, binaryOutside;
+  std::vector<uint8_t> payload = unframe(Serial.getOutput(), frames, seqErrors, binaryOutside);
+  CHECK(frames > 1);
+  CHECK_EQ(seqErrors, 0);
+  CHECK_EQ(binaryOutside, 0);
+  CHECK(Serial.getOutput().find("console text between frames") != std::string::npos);
+  if (argc > 1) {
+    std::ofstream capture(argv[1], std::ios::binary);
+    capture << Serial.getOutput();
+    CHECK(capture.good());
+  }
+
+  // Ours, in order, among whatever else the sketch logged
+  std::vector<Record> records = parse(payload);
+  int send = -1, error = -1, samples = 0;
+  for (size_t i = 0; i < records.size(); i++) {
+    const Record& r = records[i];
+    if (r.format == LOG_IR_SEND) {
+      send = i;
+      CHECK(r.text == "volUp");
+      CHECK_EQ(r.args.size(), 4);
+      if (r.args.size() == 4) CHECK_EQ(r.args[1], 0x490);
+    } else if (r.format == LOG_IR_ERROR) {
+      error = i;
+      CHECK(r.text == std::string(longError, LOG_TEXT_BYTES - 1));
+    } else if (r.format == LOG_TOUCH_SAMPLE) {
+      CHECK(r.args.size() == 3 && r.args[0] == (uint32_t)samples && r.args[2] == 3u * samples);
+      samples++;
+    }
+  }
+  CHECK(send >= 0);
+  CHECK(error > send);
+  CHECK_EQ(samples, SAMPLES);
+
+  return testResult("test_event_log");
+}
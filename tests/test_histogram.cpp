@@ -0,0 +1,65 @@
+/*
+ * VHC Universal Remote - Histogram Test
+ * Percentiles against the exact ones of the same samples: never below
+ * them, within one bucket above, exact with 1 ms buckets, and never past
+ * the largest sample
+ */
+
+#include <algorithm>
+#include <vector>
+#include "host_test.h"
+#include "histogram.h"
+
+// Smallest sample that pct percent of them are at or below
+static uint32_t exactPercentile(std::vector<uint32_t> samples, int pct) {
+  std::sort(samples.begin(), samples.end());
+  size_t rank = (samples.size() * pct + 99) / 100;
+  return samples[rank > 0 ? rank - 1 : 0];
+}
+
+static void checkPercentiles(uint16_t bucketMs, const std::vector<uint32_t>& samples) {
+  Histogram histogram;
+  histogram.setBucketMs(bucketMs);
+  for (uint32_t ms : samples) {
+    histogram.add(ms);
+  }
+  for (int pct = 1; pct <= 100; pct++) {
+    uint32_t exact = exactPercentile(samples, pct);
+    uint32_t reported = histogram.percentile(pct);
+    if (reported < exact || reported >= exact + bucketMs || reported > histogram.getMax()) {
+      fprintf(stderr, "%u ms buckets: p%d reported %u, exact %u\n", bucketMs, pct, reported, exact);
+      testFailures++;
+    }
+  }
+}
+
+int main() {
+  std::vector<uint32_t> ramp;
+  for (uint32_t ms = 0; ms < 100; ms++) {
+    ramp.push_back(ms);
+  }
+  checkPercentiles(1, ramp);
+  checkPercentiles(10, ramp);
+
+  // Loop times as the watchdog sees them: mostly short, a tail of stalls
+  std::vector<uint32_t> loops(95, 12);
+  loops.insert(loops.end(), 5, 47);
+  checkPercentiles(WATCHDOG_BUCKET_MS, loops);
+
+  Histogram watchdog;
+  watchdog.setBucketMs(WATCHDOG_BUCKET_MS);
+  for (uint32_t ms : loops) {
+    watchdog.add(ms);
+  }
+  CHECK_EQ(watchdog.percentile(50), 19u);  // Top of the 10-19 ms bucket
+  CHECK_EQ(watchdog.percentile(99), 47u);  // The largest, not 49
+
+  // Past the last bucket only the maximum is known
+  Histogram overflow;
+  overflow.add(5);
+  overflow.add(HISTOGRAM_BUCKETS + 500);
+  CHECK_EQ(overflow.percentile(50), 5u);
+  CHECK_EQ(overflow.percentile(99), (uint32_t)HISTOGRAM_BUCKETS + 500);
+
+  return testResult("test_histogram");
+}
@@ -0,0 +1,86 @@
+/*
+ * VHC Universal Remote - Host Link Test
+ * An ENQUEUE parsed while the device table is in one order and sent
+ * after a reload has reordered it: the frame that goes out is the named
+ * device's, not whatever now sits at its old index
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "host_test.h"
+#include "host_link.h"
+#include "usage_stats.h"
+
+// Same commands, but the two devices' POWER codes differ
+static void addDevices() {
+  std::ifstream example(VHC_SOURCE_DIR "/examples/Sony_TV.csv");
+  std::stringstream codes;
+  codes << example.rdbuf();
+  std::string alpha = codes.str();
+  std::string bravo = alpha;
+  size_t power = bravo.find("POWER,5,1,-1,21");
+  CHECK(power != std::string::npos);
+  bravo.replace(power, 15, "POWER,5,1,-1,47");
+  CHECK(hostSD.addFile("/Alpha_TV.csv", alpha.c_str()));
+  CHECK(hostSD.addFile("/Bravo_TV.csv", bravo.c_str()));
+}
+
+static int deviceIndex(const char* prefix) {
+  for (int i = 0; i < menu.getDeviceCount(); i++) {
+    if (strncmp(menu.getDeviceName(i), prefix, strlen(prefix)) == 0) return i;
+  }
+  return -1;
+}
+
+// One ENQUEUE frame with a single send, fed as the console would
+static void enqueue(const char* deviceName, IRFunction function) {
+  uint8_t entry[PROTO_SEND_SIZE];
+  protoPut32(entry, hashName(deviceName));
+  protoPut32(entry + 4, hashName(getFunctionName(function)));
+  entry[8] = 1;
+  protoPut16(entry + 9, 0);
+  uint8_t frame[PROTO_MAX_FRAME];
+  int n = protoFrame(frame, 1, PROTO_ENQUEUE, entry, sizeof(entry));
+  for (int i = 0; i < n; i++) {
+    CHECK(hostLink.feed(frame[i], i == 0));
+  }
+}
+
+int main() {
+  addDevices();
+  CHECK(bootToMain());
+  runFor(500);
+
+  int alpha = deviceIndex("Alpha");
+  int bravo = deviceIndex("Bravo");
+  CHECK(alpha >= 0 && bravo >= 0);
+  if (alpha < 0 || bravo < 0) return testResult("test_host_link");
+  std::string bravoName = menu.getDeviceName(bravo);
+  unsigned long bravoCode = menu.findCommand(bravo, IR_FN_POWER)->code;
+  CHECK(bravoCode != menu.findCommand(alpha, IR_FN_POWER)->code);
+
+  // Queued, not yet sent: the send task waits for the scheduler
+  size_t sent = hostIR.sent.size();
+  enqueue(bravoName.c_str(), IR_FN_POWER);
+  CHECK_EQ(hostLink.getDepth(), 1);
+
+  // Bravo used far more, then the table reloads in use order
+  for (int i = 0; i < 20; i++) {
+    usageStats.recordUse(bravoName.c_str());
+  }
+  CHECK(menu.loadDevices() > 0);
+  if (USAGE_SORT_MENU) {
+    CHECK(deviceIndex("Bravo") != bravo);
+  }
+
+  runFor(500);
+  CHECK_EQ(hostLink.getDepth(), 0);
+  // Sony goes out as several frames, all Bravo's
+  CHECK(hostIR.sent.size() > sent);
+  for (size_t i = sent; i < hostIR.sent.size(); i++) {
+    CHECK_EQ(hostIR.sent[i].code, bravoCode);
+  }
+
+  return testResult("test_host_link");
+}
@@ -0,0 +1,151 @@
+/*
+ * VHC Universal Remote - Layout Test
+ * Every widget of every screen's layout, drawn through drawLayout and
+ * tapped at its centre and its four corners through the touch sampler:
+ * the border is where the table says, and Menu::handleTouch returns that
+ * widget's own action (a device row also opens its own device)
+ */
+
+#include <fstream>
+#include <sstream>
+#include "host_test.h"
+#include "display.h"
+#include "device_list.h"
+#include "touch_input.h"
+
+extern Display display;
+
+static const int EXTRA_DEVICES = 9;  // Several pages, so the paged buttons show
+
+struct ScreenCase {
+  Screen screen;
+  LayoutId layout;
+  const char* name;
+};
+
+static const ScreenCase SCREENS[] = {
+  {SCREEN_MAIN, LAYOUT_MAIN, "main"},
+  {SCREEN_DEVICE, LAYOUT_DEVICE, "device"},
+  {SCREEN_VOLUME, LAYOUT_VOLUME, "volume"},
+  {SCREEN_CHANNEL, LAYOUT_CHANNEL, "channel"}
+};
+
+// Centre, then the corners, all inside the widget
+static void widgetPoints(const Widget& w, int xs[5], int ys[5]) {
+  xs[0] = w.x + w.w / 2;      ys[0] = w.y + w.h / 2;
+  xs[1] = w.x;                ys[1] = w.y;
+  xs[2] = w.x + w.w - 1;      ys[2] = w.y;
+  xs[3] = w.x;                ys[3] = w.y + w.h - 1;
+  xs[4] = w.x + w.w - 1;      ys[4] = w.y + w.h - 1;
+}
+
+// Pen down at (x, y) with the sketch loop stopped; every event goes to
+// handleTouch as loop() would pass it. The action of the TAP
+static Action tapAction(int x, int y) {
+  touchInput.flushEvents();
+  hostTouch.tapAt(hostClock.nanos() / 1000 + 1000, x, y, 50);
+
+  Action action = ACTION_NONE;
+  int taps = 0;
+  for (int t = 0; t < 150; t++) {
+    hostClock.advance(1000);
+    TouchRecord event;
+    while (touchInput.getEvent(event)) {
+      Action result = menu.handleTouch(event);
+      if (event.type == TOUCH_TAP) {
+        CHECK_EQ(event.x, x);
+        CHECK_EQ(event.y, y);
+        action = result;
+        taps++;
+      }
+    }
+  }
+  CHECK_EQ(taps, 1);
+  return action;
+}
+
+static void showScreen(Screen screen) {
+  if (menu.getCurrentScreen() != screen) {
+    menu.setScreen(screen);
+  }
+  runFor(500);
+}
+
+static void testScreen(const ScreenCase& c) {
+  showScreen(c.screen);
+
+  // The layout alone, paged buttons included
+  display.clear();
+  display.drawLayout(c.layout, true);
+
+  const ScreenLayout& layout = getLayout(c.layout);
+  for (int i = 0; i < layout.count; i++) {
+    const Widget& widget = layout.widgets[i];
+    int xs[5], ys[5];
+    widgetPoints(widget, xs, ys);
+
+    bool drawn = widget.label && widget.style != WIDGET_ZONE;
+    for (int p = 1; p < 5 && drawn; p++) {
+      CHECK_EQ(hostPanel.visiblePixel(xs[p], ys[p]), COLOR_TEXT);
+    }
+
+    for (int p = 0; p < 5; p++) {
+      Action action = tapAction(xs[p], ys[p]);
+      if (action != widget.action) {
+        fprintf(stderr, "%s widget %d at (%d, %d): action %d, expected %d\n",
+                c.name, i, xs[p], ys[p], action, widget.action);
+        testFailures++;
+      }
+      // Navigation undone; redrawn by the next showScreen()
+      if (menu.getCurrentScreen() != c.screen) {
+        menu.setScreen(c.screen);
+      }
+    }
+  }
+}
+
+static void testDeviceRows() {
+  // Rows of the first page, on a strip at rest
+  showScreen(SCREEN_MAIN);
+  menu.setPage(0);
+  deviceList.scrollToPage(0);
+  runFor(1000);
+  CHECK(deviceList.isSettled());
+
+  const ScreenLayout& rows = getLayout(LAYOUT_DEVICE_PAGE);
+  for (int i = 0; i < rows.count; i++) {
+    const Widget& row = rows.widgets[i];
+    int xs[5], ys[5];
+    widgetPoints(row, xs, ys);
+
+    for (int p = 1; p < 5; p++) {
+      CHECK_EQ(hostPanel.visiblePixel(xs[p], ys[p]), COLOR_TEXT);
+    }
+    for (int p = 0; p < 5; p++) {
+      CHECK_EQ(tapAction(xs[p], ys[p]), ACTION_DEVICE_STRIP);
+      CHECK_EQ(menu.getCurrentScreen(), SCREEN_DEVICE);
+      CHECK(menu.getCurrentDevice() == menu.getDevice(row.arg));
+      showScreen(SCREEN_MAIN);
+    }
+  }
+}
+
+int main() {
+  std::ifstream example(VHC_SOURCE_DIR "/examples/Sony_TV.csv");
+  std::stringstream codes;
+  codes << example.rdbuf();
+  for (int i = 0; i < EXTRA_DEVICES; i++) {
+    char path[32];
+    snprintf(path, sizeof(path), "/Living_Room_TV_%d.csv", i + 1);
+    CHECK(hostSD.addFile(path, codes.str().c_str()));
+  }
+  CHECK(bootToMain());
+  CHECK(menu.getTotalPages() > 1);
+
+  testDeviceRows();
+  for (const ScreenCase& c : SCREENS) {
+    testScreen(c);
+  }
+
+  return testResult("test_layout");
+}
@@ -0,0 +1,117 @@
+/*
+ * VHC Universal Remote - Loop Watchdog Test
+ * Stalls injected through the serial "stall" command under the virtual
+ * clock: each one over the budget lands in its own stage's histogram with
+ * its length, passes under the budget are not counted, and a stall is
+ * caught by the check interrupt while it is still going on
+ */
+
+#include <string>
+#include "host_test.h"
+#include "loop_watchdog.h"
+
+// Console command, then loop() until it has answered
+static void command(const char* text) {
+  Serial.inject(text);
+  Serial.inject("\n");
+  runFor(50);
+}
+
+struct StageStalls {
+  uint32_t count;
+  uint32_t max;
+};
+
+// The histogram line "<stage>: n=N ... max=M ms" of the last 'stall'
+static StageStalls stallsIn(const char* stage) {
+  StageStalls stalls = {0, 0};
+  const std::string& out = Serial.getOutput();
+  std::string label = std::string("\n") + stage + ": n=";
+  size_t at = out.rfind(label);
+  if (at == std::string::npos) return stalls;
+  stalls.count = strtoul(out.c_str() + at + label.size(), nullptr, 10);
+  size_t max = out.find("max=", at);
+  if (max != std::string::npos) {
+    stalls.max = strtoul(out.c_str() + max + 4, nullptr, 10);
+  }
+  return stalls;
+}
+
+// Allowance for the rest of the pass the stall was injected into
+static const uint32_t PASS_SLACK_MS = 20;
+
+static void checkStall(const char* stage, uint32_t count, uint32_t ms) {
+  StageStalls stalls = stallsIn(stage);
+  CHECK_EQ(stalls.count, count);
+  CHECK(stalls.max >= ms);
+  CHECK(stalls.max <= ms + PASS_SLACK_MS);
+}
+
+static void testAttribution() {
+  command("stall reset");
+  command("stall budget 100");
+
+  // Under the budget: not a stall
+  command("stall inject 60 sd");
+  // Over it, in three stages; the display one twice
+  command("stall inject 250 sd");
+  command("stall inject 150 display");
+  command("stall inject 180 display");
+  command("stall inject 400 ir");
+
+  Serial.clearOutput();
+  command("stall");
+  checkStall("sd", 1, 250);
+  checkStall("display", 2, 180);
+  checkStall("ir", 1, 400);
+  CHECK_EQ(stallsIn("touch").count, 0);
+  CHECK_EQ(stallsIn("menu").count, 0);
+  CHECK(Serial.getOutput().find(" ms in ir") != std::string::npos);
+  CHECK(Serial.getOutput().find("Stalled now") == std::string::npos);
+}
+
+static void testBudget() {
+  // The same stall is fine once the budget allows it
+  command("stall reset");
+  command("stall budget 300");
+  command("stall inject 250 sd");
+  Serial.clearOutput();
+  command("stall");
+  CHECK_EQ(stallsIn("sd").count, 0);
+
+  command("stall budget 100");
+  command("stall inject 250 sd");
+  Serial.clearOutput();
+  command("stall");
+  checkStall("sd", 1, 250);
+}
+
+static void testDetectedDuringStall() {
+  // A hang that has not ended yet: the check interrupt has already seen
+  // it, before the loop comes round to count it
+  command("stall reset");
+  std::string during;
+  uint64_t atUs = (uint64_t)(hostClock.millis() + 200) * 1000;
+  hostClock.schedule(atUs, [&during]() {
+    Serial.clearOutput();
+    loopWatchdog.printStats();
+    during = Serial.getOutput();
+  });
+  command("stall inject 300 flash");
+
+  CHECK(during.find("Stalled now in flash") != std::string::npos);
+  CHECK(during.find("flash: n=") == std::string::npos);
+  Serial.clearOutput();
+  command("stall");
+  checkStall("flash", 1, 300);
+}
+
+int main() {
+  CHECK(bootToMain());
+  runFor(1000);
+
+  testAttribution();
+  testBudget();
+  testDetectedDuringStall();
+  return testResult("test_loop_watchdog");
+}
@@ -0,0 +1,172 @@
+/*
+ * VHC Universal Remote - Overlay Test
+ * Toasts over the volume screen, alone and stacked four high, expiring
+ * in and out of stack order and hidden from the middle: each one leaves
+ * exactly the pixels that were under it, on the glass and in the shadow
+ * framebuffer, one shown after a middle one went fills its gap instead
+ * of covering another, and one shown across a screen change leaves the
+ * new screen
+ */
+
+#include <vector>
+#include "host_test.h"
+#include "display.h"
+#include "overlay.h"
+
+extern Display display;
+
+typedef std::vector<uint16_t> Pixels;
+
+// Toast rectangles, from overlay.cpp: stacked upward from the bottom
+static const int TOAST_X = 10;
+static const int TOAST_W = SCREEN_WIDTH - 20;
+static const int TOAST_H = 25;
+static const int TOAST_BOTTOM = SCREEN_HEIGHT - 30;
+static const int TOAST_STEP = 28;
+
+static Pixels grab() {
+  Pixels screen(SCREEN_WIDTH * SCREEN_HEIGHT);
+  hostPanel.readVisible(screen.data());
+  return screen;
+}
+
+// Differing pixels, in the whole screen or in toast slot (0 = bottom)
+static int differing(const Pixels& a, const Pixels& b, int slot = -1) {
+  int top = 0, bottom = SCREEN_HEIGHT;
+  int left = 0, right = SCREEN_WIDTH;
+  if (slot >= 0) {
+    top = TOAST_BOTTOM - slot * TOAST_STEP;
+    bottom = top + TOAST_H;
+    left = TOAST_X;
+    right = TOAST_X + TOAST_W;
+  }
+  int count = 0;
+  for (int y = top; y < bottom; y++) {
+    for (int x = left; x < right; x++) {
+      if (a[y * SCREEN_WIDTH + x] != b[y * SCREEN_WIDTH + x]) count++;
+    }
+  }
+  return count;
+}
+
+// Shadow framebuffer and panel memory agree (no scroll area here)
+static void checkShadow() {
+  const uint16_t* shadow = display.getShadow()->getBuffer();
+  const uint16_t* gram = hostPanel.memory();
+  CHECK(memcmp(shadow, gram, SCREEN_WIDTH * SCREEN_HEIGHT * sizeof(uint16_t)) == 0);
+}
+
+static void testSingle(const Pixels& clean) {
+  CHECK(overlays.show(OVERLAY_MESSAGE, "Saved", 500));
+  CHECK(differing(grab(), clean, 0) > 0);
+  CHECK_EQ(differing(grab(), clean) - differing(grab(), clean, 0), 0);
+
+  runFor(400);
+  CHECK_EQ(overlays.getCount(), 1);
+  runFor(200);
+  CHECK_EQ(overlays.getCount(), 0);
+  CHECK_EQ(differing(grab(), clean), 0);
+  checkShadow();
+}
+
+static void testStacked(const Pixels& clean) {
+  // Bottom to top; the bottom one expires first, under the others
+  CHECK(overlays.show(OVERLAY_SENDING, "Sending...", 300));
+  CHECK(overlays.show(OVERLAY_SD_WARNING, "SD card removed", 0));
+  CHECK(overlays.show(OVERLAY_ERROR, "Send failed", 1000));
+  CHECK(overlays.show(OVERLAY_MESSAGE, "Saved", 700));
+  CHECK_EQ(overlays.getCount(), OVERLAY_MAX);
+  Pixels stacked = grab();
+  for (int slot = 0; slot < OVERLAY_MAX; slot++) {
+    CHECK(differing(stacked, clean, slot) > 0);
+  }
+
+  runFor(400);
+  CHECK(!overlays.isShown(OVERLAY_SENDING));
+  Pixels now = grab();
+  CHECK_EQ(differing(now, clean, 0), 0);
+  for (int slot = 1; slot < OVERLAY_MAX; slot++) {
+    CHECK_EQ(differing(now, stacked, slot), 0);
+  }
+
+  // Out of the middle: the ones above are put back as they were
+  overlays.hide(OVERLAY_SD_WARNING);
+  now = grab();
+  CHECK_EQ(differing(now, clean, 1), 0);
+  CHECK_EQ(differing(now, stacked, 2), 0);
+  CHECK_EQ(differing(now, stacked, 3), 0);
+
+  // The top one before the one under it
+  runFor(400);
+  CHECK(!overlays.isShown(OVERLAY_MESSAGE));
+  CHECK(overlays.isShown(OVERLAY_ERROR));
+  CHECK_EQ(differing(grab(), clean, 3), 0);
+  runFor(400);
+  CHECK_EQ(overlays.getCount(), 0);
+  CHECK_EQ(differing(grab(), clean), 0);
+  checkShadow();
+}
+
+static void testShowAfterMiddleRemove(const Pixels& clean) {
+  // Three up, the bottom one hidden: the next goes in its slot, not on
+  // top of the third
+  CHECK(overlays.show(OVERLAY_SENDING, "Sending...", 0));
+  CHECK(overlays.show(OVERLAY_SD_WARNING, "SD card removed", 0));
+  CHECK(overlays.show(OVERLAY_ERROR, "Send failed", 0));
+  Pixels stacked = grab();
+  overlays.hide(OVERLAY_SENDING);
+  CHECK_EQ(differing(grab(), clean, 0), 0);
+
+  CHECK(overlays.show(OVERLAY_MESSAGE, "Saved", 0));
+  Pixels now = grab();
+  CHECK(differing(now, clean, 0) > 0);
+  CHECK_EQ(differing(now, stacked, 1), 0);
+  CHECK_EQ(differing(now, stacked, 2), 0);
+  CHECK_EQ(differing(now, clean, 3), 0);
+  int outside = differing(now, clean);
+  for (int slot = 0; slot < 3; slot++) {
+    outside -= differing(now, clean, slot);
+  }
+  CHECK_EQ(outside, 0);
+
+  // Each one gives back exactly what it covered
+  overlays.hide(OVERLAY_SD_WARNING);
+  CHECK_EQ(differing(grab(), clean, 1), 0);
+  overlays.hide(OVERLAY_MESSAGE);
+  CHECK_EQ(differing(grab(), clean, 0), 0);
+  overlays.hide(OVERLAY_ERROR);
+  CHECK_EQ(overlays.getCount(), 0);
+  CHECK_EQ(differing(grab(), clean), 0);
+  checkShadow();
+}
+
+static void testScreenChange(const Pixels& device) {
+  // Still up when the screen underneath is replaced
+  CHECK(overlays.show(OVERLAY_ERROR, "Send failed", 1500));
+  tap(275, 230);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_DEVICE);
+  runFor(1500);
+  CHECK_EQ(overlays.getCount(), 0);
+  CHECK_EQ(differing(grab(), device), 0);
+  checkShadow();
+}
+
+int main() {
+  CHECK(bootToMain());
+  tap(120, 105);
+  runFor(500);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_DEVICE);
+  Pixels device = grab();
+  tap(120, 115);
+  runFor(500);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+  Pixels volume = grab();
+  checkShadow();
+
+  testSingle(volume);
+  testStacked(volume);
+  testShowAfterMiddleRemove(volume);
+  testScreenChange(device);
+
+  return testResult("test_overlay");
+}
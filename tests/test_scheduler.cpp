@@ -0,0 +1,123 @@
+/*
+ * VHC Universal Remote - Scheduler Test
+ * Deadlines and latency under the virtual clock: priority order, delayed
+ * tasks on time across wheel laps, an IR task that comes due during a long
+ * redraw runs before the redraws queued behind it, and a tap's first IR
+ * frame goes out within a sample period or two of the touch
+ */
+
+#include <vector>
+#include "host_test.h"
+#include "scheduler.h"
+
+struct Run {
+  uint32_t id;
+  uint32_t time;
+};
+
+static std::vector<Run> runs;
+
+static void recordTask(uint32_t id) {
+  Run run = {id, hostClock.millis()};
+  runs.push_back(run);
+}
+
+static void longTask(uint32_t id) {
+  recordTask(id);
+  hostClock.advance(30000);
+}
+
+// runReady()/sleep() as loop() does, for ms
+static void idleFor(uint32_t ms) {
+  uint32_t end = hostClock.millis() + ms;
+  while (hostClock.millis() < end) {
+    scheduler.runReady();
+    scheduler.sleep();
+  }
+}
+
+static void testPriorities() {
+  runs.clear();
+  scheduler.post(recordTask, PRIORITY_BACKGROUND, 1);
+  scheduler.post(recordTask, PRIORITY_DISPLAY, 2);
+  scheduler.post(recordTask, PRIORITY_IR, 3);
+  scheduler.post(recordTask, PRIORITY_INPUT, 4);
+  scheduler.post(recordTask, PRIORITY_IR, 5);
+  scheduler.runReady();
+
+  const uint32_t order[] = {3, 5, 4, 2, 1};
+  CHECK_EQ(runs.size(), 5);
+  for (size_t i = 0; i < runs.size() && i < 5; i++) {
+    CHECK_EQ(runs[i].id, order[i]);
+  }
+}
+
+static void testDeadlines() {
+  // Within the wheel, its last slot, and several laps around it
+  const uint32_t delays[] = {1, 5, 30, SCHEDULER_WHEEL_SLOTS - 1, SCHEDULER_WHEEL_SLOTS,
+                             SCHEDULER_WHEEL_SLOTS + 1, 200, 1000};
+  const int count = sizeof(delays) / sizeof(delays[0]);
+
+  runs.clear();
+  uint32_t start = hostClock.millis();
+  for (int i = 0; i < count; i++) {
+    scheduler.postDelayed(recordTask, PRIORITY_DISPLAY, delays[i], delays[i]);
+  }
+  idleFor(1100);
+
+  CHECK_EQ(runs.size(), count);
+  for (size_t i = 0; i < runs.size(); i++) {
+    uint32_t waited = runs[i].time - start;
+    CHECK(waited >= runs[i].id);
+    CHECK(waited <= runs[i].id + 1);
+  }
+}
+
+static void testLatencyUnderLoad() {
+  // A 30 ms redraw with two more queued behind it; an IR task comes due
+  // 10 ms into the first and must not wait for the other two
+  runs.clear();
+  uint32_t start = hostClock.millis();
+  scheduler.post(longTask, PRIORITY_DISPLAY, 1);
+  scheduler.post(longTask, PRIORITY_DISPLAY, 2);
+  scheduler.post(longTask, PRIORITY_DISPLAY, 3);
+  scheduler.postDelayed(recordTask, PRIORITY_IR, 10, 10);
+  idleFor(200);
+
+  CHECK_EQ(runs.size(), 4);
+  if (runs.size() == 4) {
+    CHECK_EQ(runs[0].id, 1);
+    CHECK_EQ(runs[1].id, 10);
+    CHECK_EQ(runs[1].time - start, 30);
+    CHECK_EQ(runs[2].id, 2);
+    CHECK_EQ(runs[3].id, 3);
+  }
+}
+
+static void testTouchToIR() {
+  // The sketch itself: tap Vol Up on the volume screen
+  CHECK(bootToMain());
+  tap(120, 105);
+  tap(120, 115);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+  runFor(500);
+
+  size_t sent = hostIR.sent.size();
+  uint32_t pressMs = hostClock.millis() + 1;
+  tap(120, 115);
+  CHECK(hostIR.sent.size() > sent);
+  if (hostIR.sent.size() > sent) {
+    // Pen interrupt, one sample period to the first sample, then the
+    // IR task ahead of anything else the tap queued
+    uint32_t latency = hostIR.sent[sent].time - pressMs;
+    CHECK(latency <= 2 * TOUCH_SAMPLE_US / 1000);
+  }
+}
+
+int main() {
+  testPriorities();
+  testDeadlines();
+  testLatencyUnderLoad();
+  testTouchToIR();
+  return testResult("test_scheduler");
+}
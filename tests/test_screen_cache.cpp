@@ -0,0 +1,69 @@
+/*
+ * VHC Universal Remote - Screen Cache Test
+ * Going over the byte budget evicts only the least recently used snapshot
+ */
+
+#include "host_test.h"
+#include "screen_cache.h"
+
+static uint16_t frame[SCREEN_WIDTH * SCREEN_HEIGHT];
+static ShadowGFX shadow(&hostPanel, frame);
+static ScreenCache cache;
+
+// About 9 KB encoded: 28 rows of single-pixel runs, one color per screen
+#define BUSY_ROWS 28
+
+static uint16_t screenColor(int screen) {
+  return 0x0841 * (screen + 1);
+}
+
+static void drawScreen(int screen) {
+  shadow.fillScreen(0);
+  for (int y = 0; y < BUSY_ROWS; y++) {
+    for (int x = (y & 1); x < SCREEN_WIDTH; x += 2) {
+      shadow.drawPixel(x, y, screenColor(screen));
+    }
+  }
+}
+
+static bool showsScreen(int screen) {
+  for (int y = 0; y < SCREEN_HEIGHT; y++) {
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      bool lit = y < BUSY_ROWS && ((x + y) & 1) == 0;
+      uint16_t expected = lit ? screenColor(screen) : 0;
+      if (hostPanel.memoryPixel(x, y) != expected || shadow.getPixel(x, y) != expected) return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  hostPanel.begin();
+  hostPanel.setBusTiming(0, 0);
+  cache.begin(&shadow);
+  
+  // Three fit; the fourth needs the space of one of them
+  for (int screen = 0; screen < 4; screen++) {
+    drawScreen(screen);
+    cache.store(SCREEN_CACHE_KEY(screen, 0), 1000);
+  }
+  
+  CHECK(!cache.restore(SCREEN_CACHE_KEY(0, 0)));
+  for (int screen = 1; screen < 4; screen++) {
+    shadow.fillScreen(0xFFFF);
+    CHECK(cache.restore(SCREEN_CACHE_KEY(screen, 0)));
+    CHECK(showsScreen(screen));
+  }
+  
+  // Screen 1 is now the least recently used
+  drawScreen(4);
+  cache.store(SCREEN_CACHE_KEY(4, 0), 1000);
+  CHECK(!cache.restore(SCREEN_CACHE_KEY(1, 0)));
+  CHECK(cache.restore(SCREEN_CACHE_KEY(2, 0)));
+  CHECK(showsScreen(2));
+  CHECK(cache.restore(SCREEN_CACHE_KEY(3, 0)));
+  CHECK(cache.restore(SCREEN_CACHE_KEY(4, 0)));
+  CHECK(showsScreen(4));
+  
+  return testResult("test_screen_cache");
+}
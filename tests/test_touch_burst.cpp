@@ -0,0 +1,81 @@
+/*
+ * VHC Universal Remote - Touch Burst Test
+ * A burst of taps, each pressed while the redraw or Sony send the ones
+ * before it started is still running: every tap is still handled, on the
+ * screen it was meant for, and the IR commands go out in tap order
+ */
+
+#include <vector>
+#include "host_test.h"
+
+struct BurstTap {
+  int x, y;
+  IRFunction function;  // Command it sends, IR_FN_COUNT for navigation
+};
+
+// Navigation taps redraw the whole screen; the commands only reach the
+// right screen if none of the taps before them was lost
+static const BurstTap BURST[] = {
+  {120, 105, IR_FN_COUNT},     // First device row
+  {120, 115, IR_FN_COUNT},     // Volume
+  {120, 115, IR_FN_VOL_UP},    // Vol Up
+  {120, 115, IR_FN_VOL_UP},
+  {120, 165, IR_FN_VOL_DOWN},  // Vol Down
+  {275, 230, IR_FN_COUNT},     // Back
+  {120, 155, IR_FN_COUNT},     // Channel
+  {120, 115, IR_FN_CH_UP},     // Ch Up
+  {120, 165, IR_FN_CH_DOWN},   // Ch Down
+  {275, 25, IR_FN_POWER}       // POWER
+};
+static const int BURST_COUNT = sizeof(BURST) / sizeof(BURST[0]);
+static const uint32_t TAP_HOLD_MS = 60;
+static const uint32_t TAP_GAP_MS = 40;
+static const int SONY_FRAMES = 3;
+
+int main() {
+  CHECK(bootToMain());
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_MAIN);
+
+  // The whole burst is scheduled up front; the sketch runs through it
+  uint64_t startUs = hostClock.nanos() / 1000 + 1000;
+  for (int i = 0; i < BURST_COUNT; i++) {
+    hostTouch.tapAt(startUs + (uint64_t)i * (TAP_HOLD_MS + TAP_GAP_MS) * 1000, BURST[i].x, BURST[i].y, TAP_HOLD_MS);
+  }
+  size_t sentBefore = hostIR.sent.size();
+  hostPanel.resetCounters();
+  uint32_t burstEnd = (uint32_t)(startUs / 1000) + BURST_COUNT * (TAP_HOLD_MS + TAP_GAP_MS);
+  uint32_t longestPass = 0;
+  while (hostClock.millis() < burstEnd + 2000) {
+    uint32_t passStart = hostClock.millis();
+    loop();
+    if (hostClock.millis() - passStart > longestPass) {
+      longestPass = hostClock.millis() - passStart;
+    }
+  }
+
+  // The sketch really was busy for longer than a tap...
+  CHECK(longestPass > TAP_HOLD_MS + TAP_GAP_MS);
+  // ...but the touch sampler never waited the length of one for the bus
+  CHECK(hostPanel.longestTransactionUs < TAP_GAP_MS * 1000 / 4);
+
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_CHANNEL);
+
+  // Every command, in tap order (the example device is a Sony TV)
+  std::vector<uint32_t> expected;
+  for (int i = 0; i < BURST_COUNT; i++) {
+    if (BURST[i].function == IR_FN_COUNT) continue;
+    IRCommand* command = menu.findCommand(BURST[i].function);
+    CHECK(command != nullptr);
+    if (!command) continue;
+    CHECK(strncmp(command->protocol, "SONY", 4) == 0);
+    for (int frame = 0; frame < SONY_FRAMES; frame++) {
+      expected.push_back(command->code);
+    }
+  }
+  CHECK_EQ(hostIR.sent.size() - sentBefore, expected.size());
+  for (size_t i = 0; i < expected.size() && sentBefore + i < hostIR.sent.size(); i++) {
+    CHECK_EQ(hostIR.sent[sentBefore + i].code, expected[i]);
+  }
+
+  return testResult("test_touch_burst");
+}
@@ -0,0 +1,143 @@
+/*
+ * VHC Universal Remote - Touch Input Test
+ * A noisy press through the sampler: one TAP where it was pressed, holds
+ * but no drags from the jitter, a bounded latency, the same events when
+ * the recorded samples are replayed, and display transactions holding
+ * off the sampler but not the PIT timers (the loop watchdog's)
+ */
+
+#include <vector>
+#include <SPI.h>
+#include "host_test.h"
+#include "touch_input.h"
+
+static const int PRESS_X = 120;
+static const int PRESS_Y = 105;
+static const uint32_t PRESS_MS = 600;
+
+static uint32_t noiseState = 12345;
+
+// Uniform in -amp..amp, the same sequence every run
+static int noise(int amp) {
+  noiseState = noiseState * 1103515245 + 12345;
+  return (int)((noiseState >> 16) % (2 * amp + 1)) - amp;
+}
+
+// Pen down at a screen point for ms, the reading changing every 1 ms by
+// up to 20 raw units (under 2 px), with a 400-unit spike every 50 ms
+static void noisyPress(uint64_t atUs, int x, int y, uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t++) {
+    int dx = noise(20);
+    int dy = noise(20);
+    if (t % 50 == 25) {
+      dx += 400;
+      dy -= 400;
+    }
+    hostTouch.setAt(atUs + t * 1000, FakeTouch::rawX(x) + dx, FakeTouch::rawY(y) + dy, 900 + noise(100));
+  }
+  hostTouch.setAt(atUs + (uint64_t)ms * 1000, 0, 0, 0);
+}
+
+static std::vector<TouchRecord> drainEvents() {
+  std::vector<TouchRecord> out;
+  TouchRecord event;
+  while (touchInput.getEvent(event)) {
+    out.push_back(event);
+  }
+  return out;
+}
+
+static volatile uint32_t pitTicks = 0;
+
+static void pitTick() {
+  pitTicks++;
+}
+
+int main() {
+  CHECK(bootToMain());
+  touchInput.flushEvents();
+
+  // Live: the sampler reads the noisy pen, the sketch loop not running
+  touchInput.setRecording(true);
+  uint32_t downMs = hostClock.millis() + 10;
+  noisyPress((uint64_t)downMs * 1000, PRESS_X, PRESS_Y, PRESS_MS);
+  std::vector<TouchRecord> live;
+  std::vector<TouchSample> trace;
+  for (uint32_t t = 0; t < PRESS_MS + 100; t++) {
+    hostClock.advance(1000);
+    std::vector<TouchRecord> batch = drainEvents();
+    live.insert(live.end(), batch.begin(), batch.end());
+    TouchSample sample;
+    while (touchInput.getSample(sample)) {
+      trace.push_back(sample);
+    }
+  }
+  touchInput.setRecording(false);
+
+  CHECK(live.size() >= 3);
+  if (live.size() >= 3) {
+    const TouchRecord& tapEvent = live.front();
+    CHECK_EQ(tapEvent.type, TOUCH_TAP);
+    CHECK(abs(tapEvent.x - PRESS_X) <= 3);
+    CHECK(abs(tapEvent.y - PRESS_Y) <= 3);
+    // First sample one period after the pen interrupt
+    CHECK(tapEvent.time - downMs <= TOUCH_SAMPLE_US / 1000 + 1);
+
+    int holds = 0;
+    for (size_t i = 1; i + 1 < live.size(); i++) {
+      CHECK_EQ(live[i].type, TOUCH_HOLD);
+      CHECK(abs(live[i].x - tapEvent.x) < LIST_DRAG_START / 2);
+      CHECK(abs(live[i].y - tapEvent.y) < LIST_DRAG_START / 2);
+      CHECK_EQ(live[i].time - tapEvent.time, (uint32_t)(i * REPEAT_DELAY));
+      holds++;
+    }
+    CHECK_EQ(holds, (PRESS_MS - (tapEvent.time - downMs)) / REPEAT_DELAY);
+
+    const TouchRecord& releaseEvent = live.back();
+    CHECK_EQ(releaseEvent.type, TOUCH_RELEASE);
+    CHECK(releaseEvent.time - (downMs + PRESS_MS) <= TOUCH_RELEASE_COUNT * TOUCH_SAMPLE_US / 1000);
+  }
+
+  // Replay: the recorded samples give the same events
+  CHECK(trace.size() > PRESS_MS / (TOUCH_SAMPLE_US / 1000));
+  touchInput.setReplay(true);
+  std::vector<TouchRecord> replayed;
+  for (size_t i = 0; i < trace.size(); i++) {
+    RawTouch raw = {(int16_t)trace[i].x, (int16_t)trace[i].y, (int16_t)trace[i].z};
+    touchInput.injectSample(raw, trace[i].time);
+    std::vector<TouchRecord> batch = drainEvents();
+    replayed.insert(replayed.end(), batch.begin(), batch.end());
+  }
+  touchInput.setReplay(false);
+  CHECK_EQ(replayed.size(), live.size());
+  for (size_t i = 0; i < live.size() && i < replayed.size(); i++) {
+    CHECK_EQ(replayed[i].type, live[i].type);
+    CHECK_EQ(replayed[i].x, live[i].x);
+    CHECK_EQ(replayed[i].y, live[i].y);
+    CHECK_EQ(replayed[i].time, live[i].time);
+  }
+
+  // A display transaction holds off the sampler but not PIT timers
+  IntervalTimer pit;
+  pit.begin(pitTick, 1000);
+  uint64_t pressUs = hostClock.nanos() / 1000 + 1000;
+  hostTouch.tapAt(pressUs, PRESS_X, PRESS_Y, 300);
+  hostClock.advance(20000);
+  CHECK(touchInput.isTouched());
+
+  uint32_t reads = hostTouch.getReads();
+  uint32_t ticks = pitTicks;
+  hostPanel.gfx().startWrite();
+  CHECK(hostClock.isMasked(IRQ_GPT1));
+  CHECK(!hostClock.isMasked(IRQ_PIT));
+  hostClock.advance(100000);
+  CHECK_EQ(hostTouch.getReads(), reads);
+  CHECK(pitTicks - ticks >= 99);
+  hostPanel.gfx().endWrite();
+
+  hostClock.advance(20000);
+  CHECK(hostTouch.getReads() > reads);
+  pit.end();
+
+  return testResult("test_touch_input");
+}
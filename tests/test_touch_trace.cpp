@@ -0,0 +1,100 @@
+/*
+ * VHC Universal Remote - Touch Trace Test
+ * Records a walk through the menus with the serial "trace" command, then
+ * replays it twice from the same screen: each replay lists the IR sends
+ * the live run made, in order, ends on the same screen, and both replays
+ * print exactly the same send times and latencies
+ */
+
+#include <string>
+#include <vector>
+#include "host_test.h"
+#include "ir_function.h"
+
+// Console command, then loop() until it has answered
+static void command(const char* text) {
+  Serial.inject(text);
+  Serial.inject("\n");
+  runFor(50);
+}
+
+// The TRACE,ir lines of a replay
+static std::vector<std::string> replay(const char* name) {
+  Serial.clearOutput();
+  std::string play = std::string("trace play ") + name;
+  command(play.c_str());
+  uint32_t limit = hostClock.millis() + 20000;
+  while (Serial.getOutput().find("TRACE,replay,done") == std::string::npos && hostClock.millis() < limit) {
+    loop();
+  }
+  CHECK(hostClock.millis() < limit);
+
+  std::vector<std::string> sends;
+  const std::string& out = Serial.getOutput();
+  for (size_t at = out.find("TRACE,ir,"); at != std::string::npos; at = out.find("TRACE,ir,", at + 1)) {
+    sends.push_back(out.substr(at, out.find('\n', at) - at));
+  }
+  return sends;
+}
+
+// Function name field of a TRACE,ir,<ms>,<function>,<latency> line
+static std::string functionOf(const std::string& line) {
+  size_t start = line.find(',', strlen("TRACE,ir,")) + 1;
+  return line.substr(start, line.find(',', start) - start);
+}
+
+int main() {
+  CHECK(bootToMain());
+  tap(120, 105);
+  tap(120, 115);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+  runFor(500);
+
+  // Live: a loop through the device's screens that ends where it began,
+  // on Volume with Device behind it (Back swaps the two)
+  command("trace rec walk");
+  size_t sentBefore = hostIR.sent.size();
+  tap(120, 115);       // Vol Up
+  tap(120, 115, 700);  // Vol Up, held for repeats
+  tap(120, 165);       // Vol Down
+  tap(275, 230);       // Back to Device
+  tap(120, 155);       // Channel
+  tap(120, 115);       // Ch Up
+  tap(275, 230);       // Back to Device
+  tap(120, 115);       // Volume
+  runFor(500);
+  command("trace stop");
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+
+  // The live sends, from the frames: Sony sends three of each
+  std::vector<std::string> live;
+  const IRFunction functions[] = {IR_FN_VOL_UP, IR_FN_VOL_DOWN, IR_FN_CH_UP};
+  CHECK_EQ((hostIR.sent.size() - sentBefore) % 3, 0);
+  for (size_t i = sentBefore; i < hostIR.sent.size(); i += 3) {
+    for (IRFunction function : functions) {
+      IRCommand* cmd = menu.findCommand(function);
+      if (cmd && cmd->code == hostIR.sent[i].code) {
+        live.push_back(getFunctionName(function));
+      }
+    }
+  }
+  CHECK(live.size() >= 5);
+
+  // Replays start where the recording did
+  size_t sentLive = hostIR.sent.size();
+  std::vector<std::string> first = replay("walk");
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+  std::vector<std::string> second = replay("walk");
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_VOLUME);
+
+  // Muted: nothing reached the LED
+  CHECK_EQ(hostIR.sent.size(), sentLive);
+
+  CHECK_EQ(first.size(), live.size());
+  for (size_t i = 0; i < first.size() && i < live.size(); i++) {
+    CHECK(functionOf(first[i]) == live[i]);
+  }
+  CHECK(first == second);
+
+  return testResult("test_touch_trace");
+}
@@ -0,0 +1,152 @@
+/*
+ * VHC Universal Remote - Usage Trips Test
+ * The usage trace (tests/usage_trace.csv) replayed as taps through the
+ * touch sampler: for each use, Next/Back to the device's page, its row,
+ * then the button. Played once to build the usage scores, then again
+ * after the device table is reloaded as at the next boot, each pass
+ * measuring the average taps from the main menu to the first IR send.
+ * Built twice, with USAGE_SORT_MENU as configured and with it 0;
+ * usage_trips.sh compares the two
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "host_test.h"
+#include "device_list.h"
+#include "usage_stats.h"
+
+// Card order: the devices used most come late, as they often do
+static const char* const CARD[] = {
+  "Attic_TV", "Basement_Projector", "Bedroom_TV", "Den_Soundbar",
+  "Garage_Radio", "Guest_Room_TV", "Kids_Room_TV", "Kitchen_TV",
+  "Office_Monitor", "Patio_Speaker", "Living_Room_TV", "Living_Room_Soundbar"
+};
+
+struct Use {
+  std::string device;
+  IRFunction function;
+};
+
+static std::vector<Use> readTrace(const char* path) {
+  std::vector<Use> uses;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    size_t comma = line.find(',');
+    CHECK(comma != std::string::npos);
+    if (comma == std::string::npos) continue;
+    Use use = {line.substr(0, comma), findFunction(line.substr(comma + 1).c_str())};
+    CHECK(use.function == IR_FN_POWER || use.function == IR_FN_INPUT);
+    uses.push_back(use);
+  }
+  return uses;
+}
+
+// Centre of the widget for an action (or a device row) in a layout
+static void tapWidget(LayoutId id, Action action, int arg = 0) {
+  const ScreenLayout& layout = getLayout(id);
+  for (int i = 0; i < layout.count; i++) {
+    const Widget& w = layout.widgets[i];
+    if (w.action == action && w.arg == arg) {
+      tap(w.x + w.w / 2, w.y + w.h / 2);
+      return;
+    }
+  }
+  CHECK(!"no widget for the action");
+}
+
+static void settle() {
+  uint32_t limit = hostClock.millis() + 2000;
+  while (!deviceList.isSettled() && hostClock.millis() < limit) {
+    loop();
+  }
+  runFor(100);
+}
+
+static int deviceIndex(const std::string& name) {
+  for (int i = 0; i < menu.getDeviceCount(); i++) {
+    if (name == menu.getDeviceName(i)) return i;
+  }
+  return -1;
+}
+
+// One use, as someone looking at the screen would do it
+static void replayUse(const Use& use) {
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_MAIN);
+  int index = deviceIndex(use.device);
+  CHECK(index >= 0);
+  if (index < 0) return;
+
+  int page = index / DEVICES_PER_PAGE;
+  while (menu.getCurrentPage() < page) {
+    tapWidget(LAYOUT_MAIN, ACTION_NEXT_PAGE);
+    settle();
+  }
+  while (menu.getCurrentPage() > page) {
+    tapWidget(LAYOUT_MAIN, ACTION_PREV_PAGE);
+    settle();
+  }
+  tapWidget(LAYOUT_DEVICE_PAGE, ACTION_SELECT_DEVICE, index % DEVICES_PER_PAGE);
+  runFor(300);
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_DEVICE);
+  CHECK(use.device == menu.getCurrentDevice()->name);
+
+  size_t sent = hostIR.sent.size();
+  tapWidget(LAYOUT_DEVICE, use.function == IR_FN_POWER ? ACTION_POWER : ACTION_INPUT);
+  runFor(500);
+  CHECK(hostIR.sent.size() > sent);
+
+  tapWidget(LAYOUT_DEVICE, ACTION_BACK);
+  settle();
+}
+
+// Average taps to the first IR send over one pass of the trace
+static float replayTrace(const std::vector<Use>& uses) {
+  unsigned long trips = usageStats.getTrips();
+  unsigned long taps = usageStats.getTripTaps();
+  for (const Use& use : uses) {
+    replayUse(use);
+  }
+  trips = usageStats.getTrips() - trips;
+  taps = usageStats.getTripTaps() - taps;
+  CHECK_EQ(trips, uses.size());
+  return trips ? (float)taps / trips : 0;
+}
+
+int main() {
+  std::ifstream example(VHC_SOURCE_DIR "/examples/Sony_TV.csv");
+  std::stringstream codes;
+  codes << example.rdbuf();
+  for (const char* name : CARD) {
+    std::string path = std::string("/") + name + ".csv";
+    CHECK(hostSD.addFile(path.c_str(), codes.str().c_str()));
+  }
+  std::vector<Use> uses = readTrace(VHC_SOURCE_DIR "/tests/usage_trace.csv");
+  CHECK(uses.size() > 20);
+
+  CHECK(bootToMain());
+  CHECK_EQ(menu.getCurrentScreen(), SCREEN_MAIN);
+  float first = replayTrace(uses);
+
+  // Next boot: the table loads again (and is sorted, if enabled)
+  CHECK(menu.loadDevices() > 0);
+  menu.setPage(0);
+  menu.setScreen(SCREEN_MAIN);
+  runFor(1000);
+  float after = replayTrace(uses);
+
+  printf("USAGE_SORT_MENU %d: %zu uses, taps to first IR %.2f first pass, %.2f after reload\n",
+         USAGE_SORT_MENU, uses.size(), first, after);
+  printf("taps_to_first_ir %.2f\n", after);
+
+  // Card order is the same both times; the sort puts the used ones first
+  if (USAGE_SORT_MENU) {
+    CHECK(after < first);
+  } else {
+    CHECK(after == first);
+  }
+  return testResult("test_usage_trips");
+}
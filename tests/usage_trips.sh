@@ -0,0 +1,18 @@
+#!/bin/sh
+# VHC Universal Remote - Usage Trips Test
+# The usage trace with the main menu in card order, then sorted by use:
+# prints both averages of taps to the first IR send; sorting must need fewer
+# Usage: usage_trips.sh <tests build dir>
+
+BUILD=$1
+
+OFF=$("$BUILD/test_usage_trips_unsorted") || { echo "$OFF"; exit 1; }
+ON=$("$BUILD/test_usage_trips") || { echo "$ON"; exit 1; }
+echo "$OFF"
+echo "$ON"
+
+OFF_TAPS=$(echo "$OFF" | sed -n 's/^taps_to_first_ir //p')
+ON_TAPS=$(echo "$ON" | sed -n 's/^taps_to_first_ir //p')
+[ -n "$OFF_TAPS" ] && [ -n "$ON_TAPS" ] || { echo "no taps_to_first_ir line"; exit 1; }
+echo "Taps to first IR: $OFF_TAPS in card order, $ON_TAPS sorted by use"
+awk -v off="$OFF_TAPS" -v on="$ON_TAPS" 'BEGIN { exit !(on < off) }' || { echo "sorting did not reduce taps"; exit 1; }
@@ -0,0 +1,42 @@
+/*
+ * VHC Universal Remote - Device Bundle Sources Implementation
+ */
+
+#include "bundle_source.h"
+#include <stdio.h>
+#include "irdb_parser.h"
+
+static int readLine(FILE* in, char* line, int size) {
+  // SDManager::readLine with fgetc for Stream::read
+  int i = 0;
+  int c;
+  while (i < size - 1 && (c = fgetc(in)) != EOF) {
+    if (c == '\n' || c == '\r') {
+      if (i > 0) break;
+      continue;
+    }
+    line[i++] = c;
+  }
+  line[i] = '\0';
+  return i;
+}
+
+bool loadBundleSource(const char* path, Device* device) {
+  FILE* in = fopen(path, "rb");
+  if (!in) return false;
+  
+  char deviceName[32];
+  IRDBParser::deviceNameFromFile(path, deviceName);
+  IRDBParser::beginDevice(device, deviceName);
+  
+  char line[256];
+  while (device->commandCount < MAX_COMMANDS) {
+    int c = fgetc(in);
+    if (c == EOF) break;
+    ungetc(c, in);
+    readLine(in, line, sizeof(line));
+    IRDBParser::addLine(line, device);
+  }
+  fclose(in);
+  return device->commandCount > 0;
+}
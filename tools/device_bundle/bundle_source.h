@@ -0,0 +1,16 @@
+/*
+ * VHC Universal Remote - Device Bundle Sources
+ * IRDB CSV loading for the bundle tools, the same way the remote reads SD
+ */
+
+#ifndef BUNDLE_SOURCE_H
+#define BUNDLE_SOURCE_H
+
+#include "ir_device.h"
+
+// SDManager::loadIRDBFile on a host file: SDManager::readLine's line
+// splitting (blank lines skipped, long lines split at 255 characters),
+// then IRDBParser. False if the file cannot be read or has no commands.
+bool loadBundleSource(const char* path, Device* device);
+
+#endif // BUNDLE_SOURCE_H
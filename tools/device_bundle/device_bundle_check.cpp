@@ -0,0 +1,82 @@
+/*
+ * VHC Universal Remote - Device Bundle Check
+ * Checks the compiled-in device tables against their CSVs.
+ *
+ * Builds against device_bundle.h as the firmware does and compares every
+ * bundled device, field by field, with what SDManager loads from the
+ * CSVs given (bundle_source.h runs the same line reader and parser).
+ * Fails if the header is stale: a CSV or the IRDB conversion changed
+ * without regenerating it, or the list of CSVs differs.
+ *
+ * Built by the host build and run by ctest (tests/device_bundle.sh), from
+ * the repository root:
+ *   cmake -S . -B build && cmake --build build --target device_bundle_check
+ *   ./build/device_bundle_check examples/Sony_TV.csv   (the Sources line of device_bundle.h)
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "bundle_source.h"
+#include "device_bundle.h"
+
+static int failures = 0;
+
+static void fail(const char* device, const char* what) {
+  printf("MISMATCH %s: %s\n", device, what);
+  failures++;
+}
+
+static void compare(const Device& bundled, const Device& loaded) {
+  const char* name = loaded.name;
+  if (strcmp(bundled.name, loaded.name) != 0) {
+    fail(name, "name");
+    return;
+  }
+  if (bundled.commandCount != loaded.commandCount) {
+    fail(name, "command count");
+    return;
+  }
+  for (int c = 0; c < loaded.commandCount; c++) {
+    const IRCommand& a = bundled.commands[c];
+    const IRCommand& b = loaded.commands[c];
+    if (strcmp(a.command, b.command) != 0 || a.code != b.code || strcmp(a.protocol, b.protocol) != 0) {
+      char what[64];
+      snprintf(what, sizeof(what), "command %d (%s)", c, b.command);
+      fail(name, what);
+    }
+  }
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    if (bundled.slots[f] != loaded.slots[f]) {
+      char what[64];
+      snprintf(what, sizeof(what), "slot of %s", getFunctionName((IRFunction)f));
+      fail(name, what);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  int sources = argc - 1;
+  if (sources != BUNDLED_DEVICE_COUNT) {
+    printf("MISMATCH: %d CSVs given, %d devices bundled\n", sources, BUNDLED_DEVICE_COUNT);
+    return 1;
+  }
+  
+  for (int i = 0; i < sources; i++) {
+    Device loaded;
+    if (!loadBundleSource(argv[i + 1], &loaded)) {
+      printf("MISMATCH %s: unreadable or no known commands\n", argv[i + 1]);
+      failures++;
+      continue;
+    }
+    int before = failures;
+    compare(BUNDLED_DEVICES[i], loaded);
+    printf("%-20s %2d commands %s\n", loaded.name, loaded.commandCount, failures == before ? "ok" : "differ");
+  }
+  
+  if (failures) {
+    printf("%d mismatches, regenerate with device_bundle_gen\n", failures);
+    return 1;
+  }
+  printf("Bundle matches its %d CSVs\n", sources);
+  return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * VHC Universal Remote - Device Bundle Generator
+ * Converts a chosen set of IRDB CSVs into device_bundle.h, the devices
+ * compiled into the firmware.
+ *
+ * Each CSV goes through the remote's own parser (bundle_source.h), so a
+ * bundled device is exactly what SDManager would load from the same
+ * file, and is written out as a constexpr Device table in flash. The
+ * remote copies it at boot without parsing anything and with or without
+ * a card; an SD file with the same device name replaces it.
+ * Regenerate after editing a bundled CSV or the IRDB conversion, then
+ * run device_bundle_check.
+ *
+ * Built by the host build; run from the repository root (the paths go
+ * into the header's Sources line):
+ *   cmake -S . -B build && cmake --build build --target device_bundle_gen
+ *   ./build/device_bundle_gen device_bundle.h examples/Sony_TV.csv   (no CSVs: empty bundle)
+ * The header comes first; a .csv there is refused rather than overwritten.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <vector>
+#include "bundle_source.h"
+
+static bool isCSV(const char* path) {
+  size_t length = strlen(path);
+  return length >= 4 && strcasecmp(path + length - 4, ".csv") == 0;
+}
+
+static void writeDevice(FILE* out, const Device& device) {
+  fprintf(out, "  {\"%s\", {\n", device.name);
+  for (int c = 0; c < device.commandCount; c++) {
+    const IRCommand& cmd = device.commands[c];
+    fprintf(out, "    {\"%s\", 0x%08lXUL, \"%s\"},\n", cmd.command, cmd.code, cmd.protocol);
+  }
+  fprintf(out, "  }, %d, {", device.commandCount);
+  for (int f = 0; f < IR_FN_COUNT; f++) {
+    fprintf(out, f ? ", %d" : "%d", device.slots[f]);
+  }
+  fprintf(out, "}},\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "Usage: %s OUT.h [CSV...]\n", argv[0]);
+    return 1;
+  }
+  if (isCSV(argv[1])) {
+    fprintf(stderr, "%s: not overwriting a CSV; the header to write comes first (%s OUT.h [CSV...])\n",
+            argv[1], argv[0]);
+    return 1;
+  }
+  
+  std::vector<Device> devices;
+  std::vector<const char*> sources;
+  for (int i = 2; i < argc; i++) {
+    Device device;
+    if (!loadBundleSource(argv[i], &device)) {
+      fprintf(stderr, "%s: unreadable or no known commands\n", argv[i]);
+      return 1;
+    }
+    for (const Device& other : devices) {
+      if (strcmp(other.name, device.name) == 0) {
+        fprintf(stderr, "%s: device \"%s\" is already bundled\n", argv[i], device.name);
+        return 1;
+      }
+    }
+    devices.push_back(device);
+    sources.push_back(argv[i]);
+  }
+  if (devices.size() > MAX_DEVICES) {
+    fprintf(stderr, "%zu devices, the table holds %d (MAX_DEVICES)\n", devices.size(), MAX_DEVICES);
+    return 1;
+  }
+  
+  FILE* out = fopen(argv[1], "w");
+  if (!out) {
+    perror(argv[1]);
+    return 1;
+  }
+  
+  fprintf(out, "/*\n");
+  fprintf(out, " * VHC Universal Remote - Device Bundle\n");
+  fprintf(out, " * Devices compiled into the firmware, already converted from IRDB CSVs\n");
+  fprintf(out, " *\n");
+  fprintf(out, " * GENERATED by tools/device_bundle/device_bundle_gen.cpp - do not edit by hand.\n");
+  fprintf(out, " * Sources:");
+  for (const char* source : sources) {
+    fprintf(out, " %s", source);
+  }
+  fprintf(out, sources.empty() ? " none\n" : "\n");
+  fprintf(out, " * Merged with the SD card devices by Menu::loadDevices().\n");
+  fprintf(out, " */\n\n");
+  fprintf(out, "#ifndef DEVICE_BUNDLE_H\n#define DEVICE_BUNDLE_H\n\n");
+  fprintf(out, "#ifdef ARDUINO\n#include <Arduino.h>\n#elif !defined(PROGMEM)\n#define PROGMEM  // Host builds\n#endif\n");
+  fprintf(out, "#include \"ir_device.h\"\n\n");
+  
+  fprintf(out, "// Table layout the bundle was generated for\n");
+  fprintf(out, "static_assert(MAX_COMMANDS == %d && IR_FN_COUNT == %d, \"Regenerate device_bundle.h\");\n\n",
+          MAX_COMMANDS, (int)IR_FN_COUNT);
+  
+  fprintf(out, "constexpr int BUNDLED_DEVICE_COUNT = %zu;\n\n", devices.size());
+  fprintf(out, "// name, {command, code, protocol}..., commandCount, slots per IRFunction\n");
+  if (devices.empty()) {
+    fprintf(out, "constexpr Device BUNDLED_DEVICES[1] PROGMEM = {};\n\n");
+  } else {
+    fprintf(out, "constexpr Device BUNDLED_DEVICES[] PROGMEM = {\n");
+    for (const Device& device : devices) {
+      writeDevice(out, device);
+    }
+    fprintf(out, "};\n\n");
+  }
+  fprintf(out, "#endif // DEVICE_BUNDLE_H\n");
+  fclose(out);
+  
+  printf("%zu devices written to %s\n", devices.size(), argv[1]);
+  return 0;
+}
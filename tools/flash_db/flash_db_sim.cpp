@@ -0,0 +1,344 @@
+/*
+ * VHC Universal Remote - Flash Database Simulator
+ * Wear and power cut check of flash_db.cpp against a file-backed flash image.
+ *
+ * Runs the firmware's FlashDB on a stand-in FlashRegion that behaves as
+ * NOR flash: erase sets a sector to 0xFF, programming only clears bits
+ * (setting one is reported as a violation). Random stores, identical
+ * re-stores and removes go to the database and to a model of what it
+ * should hold. With --cuts, power fails during a random program or
+ * erase: the operation is left half done (a prefix of the bytes
+ * programmed, a random part of the sector erased), the database is
+ * rebuilt from the image as at boot, and every device must match the
+ * model, the interrupted one in its old or new state. With --cold, some
+ * devices are stored once up front and never touched again, as most
+ * devices on a remote are: the ring comes round to their sectors with
+ * them still live, so reclaiming has to relocate them (the run fails if
+ * none were).
+ * Reports erase counts per sector and the write amplification (records
+ * written, relocations included, per record the caller wrote).
+ *
+ * Built by the host build from the repository root:
+ *   cmake -S . -B build && cmake --build build --target flash_db_sim
+ *   ./build/flash_db_sim --ops 200000 --cuts --cold 20
+ * Options:
+ *   --image PATH    flash image to start from and save to (none: blank)
+ *   --sectors N     4 KB sectors in the region (FLASH_DB_BYTES / 4096)
+ *   --names N       device names in use (40)
+ *   --cold N        of those, stored once and then left alone (0)
+ *   --ops N         operations to run (100000)
+ *   --cuts          cut the power at random points
+ *   --seed N        random seed (1)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "flash_db.h"
+#include "irdb_parser.h"
+
+#define SECTOR_BYTES 4096
+
+struct PowerCut {};
+
+static std::mt19937 rng(1);
+
+static uint32_t randomBelow(uint32_t n) {
+  return rng() % n;
+}
+
+class FileFlash : public FlashRegion {
+private:
+  uint32_t sectors;
+
+public:
+  std::vector<uint8_t> image;
+  std::vector<uint32_t> erases;     // Per sector
+  uint64_t programmed;
+  uint32_t violations;
+  int cutAfter;                     // Operations left before the cut, -1 for none
+  
+  FileFlash(uint32_t sectorCount) {
+    sectors = sectorCount;
+    image.assign(sectors * SECTOR_BYTES, 0xFF);
+    erases.assign(sectors, 0);
+    programmed = 0;
+    violations = 0;
+    cutAfter = -1;
+  }
+  
+  bool begin() { return true; }
+  uint32_t sectorSize() { return SECTOR_BYTES; }
+  uint32_t sectorCount() { return sectors; }
+  const uint8_t* data() { return image.data(); }
+  
+  bool erase(uint32_t sector) {
+    uint8_t* start = &image[sector * SECTOR_BYTES];
+    if (cutAfter >= 0 && cutAfter-- == 0) {
+      for (int i = 0; i < SECTOR_BYTES; i++) {
+        if (randomBelow(2)) start[i] = 0xFF;
+      }
+      throw PowerCut();
+    }
+    memset(start, 0xFF, SECTOR_BYTES);
+    erases[sector]++;
+    return true;
+  }
+  
+  bool program(uint32_t offset, const void* bytes, uint32_t length) {
+    const uint8_t* data = (const uint8_t*)bytes;
+    if (cutAfter >= 0 && cutAfter-- == 0) {
+      length = randomBelow(length + 1);
+      for (uint32_t i = 0; i < length; i++) {
+        image[offset + i] &= data[i];
+      }
+      throw PowerCut();
+    }
+    for (uint32_t i = 0; i < length; i++) {
+      if ((image[offset + i] & data[i]) != data[i]) violations++;
+      image[offset + i] &= data[i];
+    }
+    programmed += length;
+    return true;
+  }
+  
+  bool load(const char* path) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return false;
+    std::vector<uint8_t> bytes(image.size() + sectors * 4);
+    size_t got = fread(bytes.data(), 1, bytes.size(), in);
+    fclose(in);
+    if (got != bytes.size()) return false;
+    memcpy(image.data(), bytes.data(), image.size());
+    memcpy(erases.data(), bytes.data() + image.size(), sectors * 4);
+    return true;
+  }
+  
+  bool save(const char* path) {
+    // The image, then the erase counts so far
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = fwrite(image.data(), 1, image.size(), out) == image.size() &&
+              fwrite(erases.data(), 4, sectors, out) == sectors;
+    return fclose(out) == 0 && ok;
+  }
+};
+
+static const char* const protocols[] = {"NEC1", "SONY12", "RC5", "NECx2"};
+
+static Device randomDevice(const std::string& name) {
+  Device device;
+  IRDBParser::beginDevice(&device, name.c_str());
+  for (int f = 0; f < IR_FN_COUNT && device.commandCount < MAX_COMMANDS; f++) {
+    if (randomBelow(3)) continue;
+    IRCommand* cmd = &device.commands[device.commandCount];
+    strncpy(cmd->command, getFunctionName((IRFunction)f), sizeof(cmd->command) - 1);
+    cmd->command[sizeof(cmd->command) - 1] = '\0';
+    cmd->code = rng();
+    strcpy(cmd->protocol, protocols[randomBelow(4)]);
+    device.slots[f] = device.commandCount++;
+  }
+  return device;
+}
+
+static bool sameDevice(const Device& a, const Device& b) {
+  if (strcmp(a.name, b.name) != 0 || a.commandCount != b.commandCount) return false;
+  for (int c = 0; c < a.commandCount; c++) {
+    const IRCommand& x = a.commands[c];
+    const IRCommand& y = b.commands[c];
+    if (strcmp(x.command, y.command) != 0 || x.code != y.code || strcmp(x.protocol, y.protocol) != 0) return false;
+  }
+  return memcmp(a.slots, b.slots, sizeof(a.slots)) == 0;
+}
+
+// Device name -> what the database should hold
+typedef std::map<std::string, Device> Model;
+
+static int failures = 0;
+
+static void fail(const std::string& name, const char* what) {
+  if (failures++ < 20) printf("FAIL %s: %s\n", name.c_str(), what);
+}
+
+static void checkAll(FlashDB& db, const Model& model) {
+  if (db.getCount() != (int)model.size()) fail("-", "device count");
+  for (auto& entry : model) {
+    Device found;
+    if (!db.find(entry.first.c_str(), &found)) fail(entry.first, "missing");
+    else if (!sameDevice(found, entry.second)) fail(entry.first, "wrong contents");
+  }
+}
+
+int main(int argc, char** argv) {
+  const char* imagePath = NULL;
+  uint32_t sectors = FLASH_DB_BYTES / SECTOR_BYTES;
+  int names = 40;
+  int cold = 0;
+  long ops = 100000;
+  bool cuts = false;
+  
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--image") == 0 && i + 1 < argc) imagePath = argv[++i];
+    else if (strcmp(argv[i], "--sectors") == 0 && i + 1 < argc) sectors = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--names") == 0 && i + 1 < argc) names = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--cold") == 0 && i + 1 < argc) cold = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) ops = atol(argv[++i]);
+    else if (strcmp(argv[i], "--cuts") == 0) cuts = true;
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) rng.seed(atoi(argv[++i]));
+    else {
+      fprintf(stderr, "Usage: %s [--image PATH] [--sectors N] [--names N] [--cold N] [--ops N] [--cuts] [--seed N]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (names > FLASH_DB_MAX_DEVICES) names = FLASH_DB_MAX_DEVICES;
+  if (cold < 0 || cold >= names) {
+    fprintf(stderr, "--cold must leave some of the %d names in use\n", names);
+    return 1;
+  }
+  
+  FileFlash flash(sectors);
+  if (imagePath && flash.load(imagePath)) printf("Image %s loaded\n", imagePath);
+  
+  FlashDB* db = new FlashDB();
+  if (!db->begin(&flash)) {
+    printf("Region of %u sectors rejected\n", sectors);
+    return 1;
+  }
+  
+  // An existing image is the starting state
+  Model model;
+  std::vector<Device> loaded(FLASH_DB_MAX_DEVICES);
+  int loadedCount = db->loadDevices(loaded.data(), loaded.size());
+  for (int i = 0; i < loadedCount; i++) {
+    model[loaded[i].name] = loaded[i];
+  }
+  
+  long stores = 0, removes = 0, identical = 0, full = 0, powerCuts = 0;
+  uint64_t written = 0, relocated = 0;
+  auto reboot = [&]() {
+    FlashDBStats s = db->getStats();
+    written += s.stores;
+    relocated += s.relocated;
+    delete db;
+    db = new FlashDB();
+    
+    // Recovery at boot can be cut off as well
+    while (true) {
+      try {
+        if (!db->begin(&flash)) fail("-", "begin after reboot");
+        break;
+      } catch (const PowerCut&) {
+        powerCuts++;
+        flash.cutAfter = -1;
+      }
+    }
+  };
+  
+  // Cold devices go in once, before any power cut
+  bool blank = model.empty();
+  for (int i = 0; i < cold; i++) {
+    std::string name = "Device " + std::to_string(i);
+    Device device = randomDevice(name);
+    if (db->store(device)) {
+      model[name] = device;
+      stores++;
+    } else {
+      full++;
+    }
+  }
+  
+  for (long op = 0; op < ops; op++) {
+    if (cuts && flash.cutAfter < 0 && randomBelow(20) == 0) {
+      flash.cutAfter = randomBelow(8);
+    }
+    
+    std::string name = "Device " + std::to_string(cold + randomBelow(names - cold));
+    auto current = model.find(name);
+    bool existed = current != model.end();
+    Device before = existed ? current->second : Device();
+    Device after;
+    bool removing = existed && randomBelow(4) == 0;
+    if (!removing) {
+      after = (existed && randomBelow(4) == 0) ? before : randomDevice(name);
+    }
+    
+    try {
+      if (removing) {
+        if (!db->remove(name.c_str())) fail(name, "remove failed");
+        model.erase(name);
+        removes++;
+      } else if (db->store(after)) {
+        if (existed && sameDevice(before, after)) identical++;
+        model[name] = after;
+        stores++;
+      } else {
+        full++;
+      }
+    } catch (const PowerCut&) {
+      powerCuts++;
+      flash.cutAfter = -1;
+      reboot();
+      
+      // The interrupted device may be in either state
+      Device found;
+      bool present = db->find(name.c_str(), &found);
+      if (present && !removing && sameDevice(found, after)) model[name] = after;
+      else if (present && existed && sameDevice(found, before)) model[name] = before;
+      else if (!present && (removing || !existed)) model.erase(name);
+      else fail(name, "neither old nor new after a power cut");
+      checkAll(*db, model);
+      continue;
+    }
+    
+    if (op % 1000 == 999) {
+      reboot();
+      checkAll(*db, model);
+    }
+  }
+  flash.cutAfter = -1;
+  reboot();
+  checkAll(*db, model);
+  
+  uint32_t minErases = flash.erases[0], maxErases = 0;
+  uint64_t totalErases = 0;
+  for (uint32_t e : flash.erases) {
+    if (e < minErases) minErases = e;
+    if (e > maxErases) maxErases = e;
+    totalErases += e;
+  }
+  long requested = stores + removes - identical;
+  
+  printf("%ld ops: %ld stores (%ld identical), %ld removes, %ld refused full, %ld power cuts\n",
+         ops, stores, identical, removes, full, powerCuts);
+  printf("%d devices, %u of %u bytes live\n", db->getCount(), db->getStats().liveBytes, db->getStats().capacity);
+  printf("Erases per sector: min %u mean %.1f max %u (%u sectors)\n",
+         minErases, (double)totalErases / sectors, maxErases, sectors);
+  printf("Records written %llu, relocated %llu, write amplification %.2f\n",
+         (unsigned long long)written, (unsigned long long)relocated,
+         requested > 0 ? (double)(written + relocated) / requested : 0.0);
+  printf("Bytes programmed %llu, NOR violations %u\n", (unsigned long long)flash.programmed, flash.violations);
+  if (flash.violations) failures++;
+  if (cold > 0 && relocated == 0) fail("-", "cold devices were never relocated");
+  
+  // Stored first on a blank image, so listed first, in store order,
+  // relocated or not
+  loadedCount = db->loadDevices(loaded.data(), loaded.size());
+  for (int i = 0; blank && i < cold && i < loadedCount; i++) {
+    std::string name = "Device " + std::to_string(i);
+    if (name != loaded[i].name) fail(name, "out of order after relocation");
+  }
+  
+  if (imagePath && !flash.save(imagePath)) perror(imagePath);
+  delete db;
+  
+  if (failures) {
+    printf("%d failures\n", failures);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
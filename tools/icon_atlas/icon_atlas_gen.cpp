@@ -0,0 +1,295 @@
+/*
+ * VHC Universal Remote - Icon Atlas Generator
+ * Rasterizes every UIIcons::draw*Icon at each atlas size and writes the
+ * run-length encoded 1-bit atlas (ui_icon_atlas.h).
+ *
+ * ui_icons.h stays the source of truth: this tool runs the real drawing code
+ * on the host build's Adafruit_GFX (host/), so regenerate after editing an
+ * icon; the icon_atlas test fails while the committed atlas is stale.
+ *
+ * Built by the host build (cmake --build build --target icon_atlas_gen):
+ *   build/icon_atlas_gen ui_icon_atlas.h     (write the atlas header)
+ *   build/icon_atlas_gen --bench             (per-icon draw cost table)
+ *
+ * RLE format: each icon is scanned row by row and stored as byte-sized runs
+ * that alternate background/foreground, starting with background. A run
+ * longer than 255 is split with a zero-length run of the other color.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <Adafruit_ILI9341.h>
+#include "ui_icons.h"
+
+// Bus cost of one drawing sequence, counted as Adafruit_SPITFT issues it
+struct GFXCost {
+  unsigned long transactions; // startWrite/endWrite pairs
+  unsigned long windows;      // setAddrWindow calls
+  unsigned long pixels;       // pixels clocked out
+};
+
+// Canvas that takes the panel driver's write path: lines and rects are one
+// address window each, nested calls share the outer transaction
+class AtlasCanvas : public GFXcanvas16 {
+private:
+  int writeDepth;
+  GFXCost cost;
+
+public:
+  AtlasCanvas(int16_t w, int16_t h) : GFXcanvas16(w, h) {
+    writeDepth = 0;
+    memset(&cost, 0, sizeof(cost));
+  }
+  
+  const GFXCost& getCost() const { return cost; }
+  // Anything not drawn in COLOR_BACKGROUND is foreground
+  bool isSet(int16_t x, int16_t y) const { return getPixel(x, y) != COLOR_BACKGROUND; }
+  
+  void startWrite() override {
+    if (writeDepth++ == 0) cost.transactions++;
+  }
+  void endWrite() override {
+    if (writeDepth > 0) writeDepth--;
+  }
+  void writePixel(int16_t x, int16_t y, uint16_t color) override {
+    cost.windows++;
+    cost.pixels++;
+    GFXcanvas16::drawPixel(x, y, color);
+  }
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    if (w <= 0 || h <= 0) return;
+    cost.windows++;
+    cost.pixels += (unsigned long)w * h;
+    for (int16_t j = y; j < y + h; j++) {
+      for (int16_t i = x; i < x + w; i++) GFXcanvas16::drawPixel(i, j, color);
+    }
+  }
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    writeFillRect(x, y, w, 1, color);
+  }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    writeFillRect(x, y, 1, h, color);
+  }
+  
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    startWrite();
+    writePixel(x, y, color);
+    endWrite();
+  }
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    endWrite();
+  }
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override {
+    startWrite();
+    writeFastVLine(x, y, h, color);
+    endWrite();
+  }
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+    startWrite();
+    writeFillRect(x, y, w, h, color);
+    endWrite();
+  }
+};
+
+typedef void (*IconDrawFn)(Adafruit_GFX* gfx, int x, int y, int size, uint16_t color);
+
+struct IconSource {
+  const char* name;
+  IconDrawFn draw;
+};
+
+// Order defines the IconId enum in the generated header
+const IconSource icons[] = {
+  {"POWER",        UIIcons::drawPowerIcon},
+  {"VOLUME_UP",    UIIcons::drawVolumeUpIcon},
+  {"VOLUME_DOWN",  UIIcons::drawVolumeDownIcon},
+  {"CHANNEL_UP",   UIIcons::drawChannelUpIcon},
+  {"CHANNEL_DOWN", UIIcons::drawChannelDownIcon},
+  {"INPUT",        UIIcons::drawInputIcon},
+  {"MENU",         UIIcons::drawMenuIcon},
+  {"BACK",         UIIcons::drawBackIcon},
+  {"OK",           UIIcons::drawOKIcon},
+  {"MUTE",         UIIcons::drawMuteIcon},
+  {"SETTINGS",     UIIcons::drawSettingsIcon},
+  {"PLAY",         UIIcons::drawPlayIcon},
+  {"PAUSE",        UIIcons::drawPauseIcon},
+  {"STOP",         UIIcons::drawStopIcon},
+  {"TV",           UIIcons::drawTVIcon},
+  {"AUDIO",        UIIcons::drawAudioIcon},
+  {"DISC",         UIIcons::drawDiscIcon}
+};
+const int iconCount = sizeof(icons) / sizeof(icons[0]);
+
+// Atlas sizes (the size argument passed to the draw functions)
+const int atlasSizes[] = {16, 24, 32};
+const int sizeCount = sizeof(atlasSizes) / sizeof(atlasSizes[0]);
+
+struct AtlasEntry {
+  unsigned offset;
+  unsigned length;
+  int width;
+  int height;
+  GFXCost drawCost; // Cost of the original primitive drawing
+  unsigned runs;    // Non-empty runs (one writeColor each when blitted)
+};
+
+// Icons reach x + size / y + size inclusive, so each cell is size + 1 square
+static int cellSize(int size) {
+  return size + 1;
+}
+
+static AtlasEntry rasterize(const IconSource& icon, int size, std::vector<unsigned char>& rle) {
+  int cell = cellSize(size);
+  AtlasCanvas canvas(cell, cell);
+  icon.draw(&canvas, 0, 0, size, COLOR_TEXT);
+
+  AtlasEntry entry;
+  entry.offset = rle.size();
+  entry.width = cell;
+  entry.height = cell;
+  entry.drawCost = canvas.getCost();
+  entry.runs = 0;
+
+  bool current = false; // Runs start with background
+  unsigned run = 0;
+  for (int y = 0; y < cell; y++) {
+    for (int x = 0; x < cell; x++) {
+      bool on = canvas.isSet(x, y);
+      if (on != current) {
+        rle.push_back(run);
+        if (run > 0) entry.runs++;
+        current = on;
+        run = 0;
+      }
+      if (run == 255) {
+        // Split long runs with an empty run of the other color
+        rle.push_back(255);
+        rle.push_back(0);
+        entry.runs++;
+        run = 0;
+      }
+      run++;
+    }
+  }
+  rle.push_back(run);
+  if (run > 0) entry.runs++;
+
+  entry.length = rle.size() - entry.offset;
+  return entry;
+}
+
+static void writeHeader(FILE* out, const std::vector<unsigned char>& rle,
+                        AtlasEntry entries[][sizeCount]) {
+  fprintf(out, "/*\n");
+  fprintf(out, " * VHC Universal Remote - UI Icon Atlas\n");
+  fprintf(out, " * Run-length encoded 1-bit icons rasterized from ui_icons.h\n");
+  fprintf(out, " *\n");
+  fprintf(out, " * GENERATED by tools/icon_atlas/icon_atlas_gen.cpp - do not edit by hand.\n");
+  fprintf(out, " * Each entry blits in one address window, one color run per byte.\n");
+  fprintf(out, " */\n\n");
+  fprintf(out, "#ifndef UI_ICON_ATLAS_H\n#define UI_ICON_ATLAS_H\n\n");
+  fprintf(out, "#include <Arduino.h>\n\n");
+
+  fprintf(out, "enum IconId {\n");
+  for (int i = 0; i < iconCount; i++) {
+    fprintf(out, "  ICON_%s,\n", icons[i].name);
+  }
+  fprintf(out, "  ICON_COUNT\n};\n\n");
+
+  fprintf(out, "enum IconSize {\n");
+  for (int s = 0; s < sizeCount; s++) {
+    fprintf(out, "  ICON_SIZE_%d,\n", atlasSizes[s]);
+  }
+  fprintf(out, "  ICON_SIZE_COUNT\n};\n\n");
+
+  fprintf(out, "struct IconAtlasEntry {\n");
+  fprintf(out, "  uint16_t offset; // First run in ICON_ATLAS_RLE\n");
+  fprintf(out, "  uint16_t length; // Number of run bytes\n");
+  fprintf(out, "  uint8_t width;\n");
+  fprintf(out, "  uint8_t height;\n");
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "// Runs alternate background/foreground, starting with background\n");
+  fprintf(out, "const uint8_t ICON_ATLAS_RLE[%u] PROGMEM = {", (unsigned)rle.size());
+  for (size_t i = 0; i < rle.size(); i++) {
+    if (i % 16 == 0) fprintf(out, "\n  ");
+    fprintf(out, "%u%s", rle[i], (i + 1 < rle.size()) ? ", " : "");
+  }
+  fprintf(out, "\n};\n\n");
+
+  fprintf(out, "const IconAtlasEntry ICON_ATLAS[ICON_COUNT][ICON_SIZE_COUNT] PROGMEM = {\n");
+  for (int i = 0; i < iconCount; i++) {
+    fprintf(out, "  {");
+    for (int s = 0; s < sizeCount; s++) {
+      const AtlasEntry& e = entries[i][s];
+      fprintf(out, "{%u, %u, %d, %d}%s", e.offset, e.length, e.width, e.height,
+              (s + 1 < sizeCount) ? ", " : "");
+    }
+    fprintf(out, "}%s // %s\n", (i + 1 < iconCount) ? "," : "", icons[i].name);
+  }
+  fprintf(out, "};\n\n");
+
+  fprintf(out, "#endif // UI_ICON_ATLAS_H\n");
+}
+
+static void printBenchmark(AtlasEntry entries[][sizeCount]) {
+  printf("%-13s %4s | %12s %8s %7s | %12s %8s %7s %5s\n",
+         "icon", "size", "draw: trans", "windows", "pixels",
+         "blit: trans", "windows", "pixels", "runs");
+  unsigned long totalDrawWindows = 0, totalBlitWindows = 0;
+  unsigned long totalDrawTrans = 0, totalBlitTrans = 0;
+  for (int i = 0; i < iconCount; i++) {
+    for (int s = 0; s < sizeCount; s++) {
+      const AtlasEntry& e = entries[i][s];
+      printf("%-13s %4d | %12lu %8lu %7lu | %12d %8d %7d %5u\n",
+             icons[i].name, atlasSizes[s],
+             e.drawCost.transactions, e.drawCost.windows, e.drawCost.pixels,
+             1, 1, e.width * e.height, e.runs);
+      totalDrawTrans += e.drawCost.transactions;
+      totalDrawWindows += e.drawCost.windows;
+      totalBlitTrans += 1;
+      totalBlitWindows += 1;
+    }
+  }
+  printf("\ntotal transactions: draw %lu, blit %lu\n", totalDrawTrans, totalBlitTrans);
+  printf("total address windows: draw %lu, blit %lu\n", totalDrawWindows, totalBlitWindows);
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <ui_icon_atlas.h> | --bench\n", argv[0]);
+    return 1;
+  }
+
+  std::vector<unsigned char> rle;
+  AtlasEntry entries[iconCount][sizeCount];
+  for (int i = 0; i < iconCount; i++) {
+    for (int s = 0; s < sizeCount; s++) {
+      entries[i][s] = rasterize(icons[i], atlasSizes[s], rle);
+    }
+  }
+
+  if (rle.size() > 0xFFFF) {
+    fprintf(stderr, "atlas too large for 16-bit offsets (%u bytes)\n", (unsigned)rle.size());
+    return 1;
+  }
+
+  if (strcmp(argv[1], "--bench") == 0) {
+    printBenchmark(entries);
+    return 0;
+  }
+
+  FILE* out = fopen(argv[1], "w");
+  if (!out) {
+    perror(argv[1]);
+    return 1;
+  }
+  writeHeader(out, rle, entries);
+  fclose(out);
+
+  printf("Wrote %d icons x %d sizes, %u bytes of runs\n", iconCount, sizeCount, (unsigned)rle.size());
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * VHC Universal Remote - IR Service Backends Implementation
+ */
+
+#include "backends.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/lirc.h>
+#include <chrono>
+#include <thread>
+
+TextBackend::TextBackend(FILE* out, int frameMs) {
+  this->out = out;
+  this->frameMs = frameMs;
+}
+
+void TextBackend::frame(const char* protocol, uint32_t code, int bits, const char* note) {
+  fprintf(out, "%s 0x%08X %d%s\n", protocol, code, bits, note);
+  if (frameMs > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(frameMs));
+  }
+}
+
+void TextBackend::sendNEC(uint32_t code, int bits) { frame("NEC", code, bits, ""); }
+void TextBackend::sendSony(uint32_t code, int bits) { frame("SONY", code, bits, ""); }
+void TextBackend::sendRC5(uint32_t code, int bits) { frame("RC5", code, bits, ""); }
+void TextBackend::sendRC6(uint32_t code, int bits) { frame("RC6", code, bits, ""); }
+
+void TextBackend::sendPanasonic(uint16_t address, uint32_t command) {
+  char note[16];
+  snprintf(note, sizeof(note), " addr=0x%04X", address);
+  frame("PANASONIC", command, 48, note);
+}
+
+void TextBackend::sendJVC(uint32_t code, int bits, bool repeat) {
+  frame("JVC", code, bits, repeat ? " repeat" : "");
+}
+
+LircBackend::LircBackend(int fd) {
+  this->fd = fd;
+}
+
+void LircBackend::carrier(int hz) {
+  // Not every transmitter can change it; those keep their default
+  uint32_t value = hz;
+  ioctl(fd, LIRC_SET_SEND_CARRIER, &value);
+}
+
+void LircBackend::mark(int us) {
+  // Even entries are marks; runs of the same kind merge
+  if (pulses.size() % 2 == 1) {
+    pulses.back() += us;
+  } else {
+    pulses.push_back(us);
+  }
+}
+
+void LircBackend::space(int us) {
+  if (pulses.empty()) return;
+  if (pulses.size() % 2 == 0) {
+    pulses.back() += us;
+  } else {
+    pulses.push_back(us);
+  }
+}
+
+void LircBackend::bits(uint32_t data, int count, int oneMark, int oneSpace, int zeroMark, int zeroSpace) {
+  for (uint32_t mask = 1UL << (count - 1); mask; mask >>= 1) {
+    if (data & mask) {
+      mark(oneMark);
+      space(oneSpace);
+    } else {
+      mark(zeroMark);
+      space(zeroSpace);
+    }
+  }
+}
+
+void LircBackend::send() {
+  // LIRC wants an odd count: it starts and ends with a mark
+  if (pulses.size() % 2 == 0 && !pulses.empty()) {
+    pulses.pop_back();
+  }
+  std::vector<unsigned int> data(pulses.begin(), pulses.end());
+  ssize_t n = write(fd, data.data(), data.size() * sizeof(unsigned int));
+  if (n < 0) {
+    fprintf(stderr, "lirc write: %s\n", strerror(errno));
+  }
+  pulses.clear();
+}
+
+void LircBackend::sendNEC(uint32_t code, int bits) {
+  carrier(38000);
+  mark(9000);
+  space(4500);
+  this->bits(code, bits, 560, 1690, 560, 560);
+  mark(560);
+  send();
+}
+
+void LircBackend::sendSony(uint32_t code, int bits) {
+  carrier(40000);
+  mark(2400);
+  space(600);
+  this->bits(code, bits, 1200, 600, 600, 600);
+  send();
+}
+
+void LircBackend::sendRC5(uint32_t code, int bits) {
+  // Manchester coded after two start bits, 889 us half bits
+  const int t = 889;
+  carrier(36000);
+  mark(t);
+  space(t);
+  mark(t);
+  for (uint32_t mask = 1UL << (bits - 1); mask; mask >>= 1) {
+    if (code & mask) {
+      space(t);
+      mark(t);
+    } else {
+      mark(t);
+      space(t);
+    }
+  }
+  send();
+}
+
+void LircBackend::sendRC6(uint32_t code, int bits) {
+  // Leader, start bit, then Manchester with a double width trailer bit
+  const int t = 444;
+  carrier(36000);
+  mark(2666);
+  space(889);
+  mark(t);
+  space(t);
+  int i = 1;
+  for (uint32_t mask = 1UL << (bits - 1); mask; mask >>= 1, i++) {
+    int width = (i == 4) ? t * 2 : t;
+    if (code & mask) {
+      mark(width);
+      space(width);
+    } else {
+      space(width);
+      mark(width);
+    }
+  }
+  send();
+}
+
+void LircBackend::sendPanasonic(uint16_t address, uint32_t command) {
+  carrier(35000);
+  mark(3502);
+  space(1750);
+  bits(address, 16, 502, 1244, 502, 400);
+  bits(command, 32, 502, 1244, 502, 400);
+  mark(502);
+  send();
+}
+
+void LircBackend::sendJVC(uint32_t code, int bits, bool repeat) {
+  carrier(38000);
+  if (!repeat) {
+    mark(8400);
+    space(4200);
+  }
+  this->bits(code, bits, 600, 1600, 600, 550);
+  mark(600);
+  send();
+}
+
+Backend* openBackend(const char* spec, int frameMs) {
+  if (strncmp(spec, "file:", 5) == 0) {
+    const char* path = spec + 5;
+    FILE* out = strcmp(path, "-") == 0 ? stdout : fopen(path, "a");
+    if (!out) {
+      fprintf(stderr, "%s: %s\n", path, strerror(errno));
+      return NULL;
+    }
+    return new TextBackend(out, frameMs);
+  }
+  
+  if (strncmp(spec, "lirc:", 5) == 0) {
+    const char* path = spec + 5;
+    int fd = open(path, O_WRONLY);
+    if (fd < 0) {
+      fprintf(stderr, "%s: %s\n", path, strerror(errno));
+      return NULL;
+    }
+    uint32_t mode = LIRC_MODE_PULSE;
+    if (ioctl(fd, LIRC_SET_SEND_MODE, &mode) < 0) {
+      fprintf(stderr, "%s: not a LIRC transmitter\n", path);
+      close(fd);
+      return NULL;
+    }
+    return new LircBackend(fd);
+  }
+  
+  fprintf(stderr, "Unknown backend %s (file:PATH or lirc:DEVICE)\n", spec);
+  return NULL;
+}
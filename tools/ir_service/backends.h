@@ -0,0 +1,70 @@
+/*
+ * VHC Universal Remote - IR Service Backends
+ * Transmitters for the Linux IR service (IROutput, as in the firmware HAL)
+ */
+
+#ifndef IR_SERVICE_BACKENDS_H
+#define IR_SERVICE_BACKENDS_H
+
+#include <stdio.h>
+#include <vector>
+#include "ir_output.h"
+
+// The emitter worker calls flush() once per batch of frames
+class Backend : public IROutput {
+public:
+  virtual ~Backend() {}
+  virtual void flush() {}
+};
+
+// One text line per frame ("NEC 0x20DF10EF 32") to a file or pty, for
+// tests and lab logs. Each frame sleeps frameMs to stand in for the
+// time it spends on air.
+class TextBackend : public Backend {
+private:
+  FILE* out;
+  int frameMs;
+  void frame(const char* protocol, uint32_t code, int bits, const char* note);
+
+public:
+  TextBackend(FILE* out, int frameMs);
+  void begin() override {}
+  void sendNEC(uint32_t code, int bits) override;
+  void sendSony(uint32_t code, int bits) override;
+  void sendRC5(uint32_t code, int bits) override;
+  void sendRC6(uint32_t code, int bits) override;
+  void sendPanasonic(uint16_t address, uint32_t command) override;
+  void sendJVC(uint32_t code, int bits, bool repeat) override;
+  void flush() override { fflush(out); }
+};
+
+// Pulse/space timings written to a LIRC transmitter (/dev/lirc0, which
+// is what most USB IR blasters show up as). Encodings follow the
+// IRremote library the firmware sends with, MSB first. The write
+// blocks until the frame is on air.
+class LircBackend : public Backend {
+private:
+  int fd;
+  std::vector<int> pulses;  // Microseconds, mark first, alternating
+  void carrier(int hz);
+  void mark(int us);
+  void space(int us);
+  void bits(uint32_t data, int count, int oneMark, int oneSpace, int zeroMark, int zeroSpace);
+  void send();
+
+public:
+  explicit LircBackend(int fd);
+  void begin() override {}
+  void sendNEC(uint32_t code, int bits) override;
+  void sendSony(uint32_t code, int bits) override;
+  void sendRC5(uint32_t code, int bits) override;
+  void sendRC6(uint32_t code, int bits) override;
+  void sendPanasonic(uint16_t address, uint32_t command) override;
+  void sendJVC(uint32_t code, int bits, bool repeat) override;
+};
+
+// "file:PATH" (or "file:-" for stdout) or "lirc:DEVICE"; NULL with a
+// message on stderr if it cannot be opened
+Backend* openBackend(const char* spec, int frameMs);
+
+#endif // IR_SERVICE_BACKENDS_H
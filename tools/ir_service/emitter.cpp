@@ -0,0 +1,100 @@
+/*
+ * VHC Universal Remote - IR Service Emitter Implementation
+ */
+
+#include "emitter.h"
+#include <vector>
+#include "ir_protocol.h"
+
+Emitter::Emitter(const std::string& name, Backend* backend) {
+  this->name = name;
+  this->backend = backend;
+  stats = EmitterStats();
+  stopping = false;
+  backend->begin();
+  worker = std::thread(&Emitter::run, this);
+}
+
+Emitter::~Emitter() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  worker.join();
+}
+
+void Emitter::send(SendRequest* request) {
+  std::unique_lock<std::mutex> guard(lock);
+  request->queued = ServiceClock::now();
+  request->done = false;
+  queue.push_back(request);
+  stats.queued = queue.size();
+  if (stats.queued > stats.maxQueued) {
+    stats.maxQueued = stats.queued;
+  }
+  wake.notify_one();
+  finished.wait(guard, [request] { return request->done; });
+}
+
+EmitterStats Emitter::getStats() {
+  std::lock_guard<std::mutex> guard(lock);
+  return stats;
+}
+
+int Emitter::transmit(SendRequest* request) {
+  int bits;
+  IRProtocol protocol = resolveProtocol(&request->command, bits);
+  uint32_t code = request->command.code;
+  
+  request->started = ServiceClock::now();
+  if (!transmitFrame(backend, protocol, code, bits, false)) {
+    request->finished = request->started;
+    return 0;
+  }
+  
+  // The repeats are part of the command: nothing else may go out between them
+  IRRepeatPlan plan = repeatPlan(protocol);
+  for (int i = 0; i < plan.frames; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(plan.gapMs));
+    transmitFrame(backend, protocol, code, bits, true);
+  }
+  request->finished = ServiceClock::now();
+  return 1 + plan.frames;
+}
+
+void Emitter::run() {
+  std::vector<SendRequest*> batch;
+  std::unique_lock<std::mutex> guard(lock);
+  while (true) {
+    wake.wait(guard, [this] { return stopping || !queue.empty(); });
+    if (queue.empty()) break;
+    
+    // Everything that queued up while the last batch was on air
+    batch.assign(queue.begin(), queue.end());
+    queue.clear();
+    stats.queued = 0;
+    guard.unlock();
+    
+    int frames = 0;
+    for (SendRequest* request : batch) {
+      int sent = transmit(request);
+      request->ok = sent > 0;
+      frames += sent;
+    }
+    backend->flush();
+    
+    guard.lock();
+    for (SendRequest* request : batch) {
+      if (request->ok) {
+        stats.sent++;
+      } else {
+        stats.failed++;
+      }
+      request->done = true;
+    }
+    stats.batches++;
+    stats.frames += frames;
+    finished.notify_all();
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * VHC Universal Remote - IR Service Emitter
+ * Per-transmitter request queue with a worker thread
+ */
+
+#ifndef IR_SERVICE_EMITTER_H
+#define IR_SERVICE_EMITTER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ir_device.h"
+#include "backends.h"
+
+typedef std::chrono::steady_clock ServiceClock;
+
+// One send, owned by the client thread that waits on it
+struct SendRequest {
+  IRCommand command;
+  ServiceClock::time_point queued;
+  ServiceClock::time_point started;  // First frame handed to the backend
+  ServiceClock::time_point finished; // Last repeat sent
+  bool ok;
+  bool done;
+};
+
+struct EmitterStats {
+  uint64_t sent;
+  uint64_t failed;
+  uint64_t batches;
+  uint64_t frames;
+  size_t queued;
+  size_t maxQueued;
+};
+
+// Frames on one transmitter never overlap, so everything for it goes
+// through a single worker: it takes all waiting requests as one batch,
+// sends them in arrival order (repeats included, as IRHandler does) and
+// flushes the backend once per batch. Clients on other emitters are
+// not held up.
+class Emitter {
+private:
+  std::string name;
+  Backend* backend;
+  std::mutex lock;
+  std::condition_variable wake;      // Worker: requests waiting
+  std::condition_variable finished;  // Clients: a batch is done
+  std::deque<SendRequest*> queue;
+  EmitterStats stats;
+  bool stopping;
+  std::thread worker;
+  
+  void run();
+  int transmit(SendRequest* request);  // Frames sent, 0 if the protocol is unknown
+  
+public:
+  Emitter(const std::string& name, Backend* backend);
+  ~Emitter();
+  
+  const std::string& getName() { return name; }
+  
+  // Queues the request and blocks until it has been sent
+  void send(SendRequest* request);
+  
+  EmitterStats getStats();
+};
+
+#endif // IR_SERVICE_EMITTER_H
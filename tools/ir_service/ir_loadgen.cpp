@@ -0,0 +1,188 @@
+/*
+ * VHC Universal Remote - IR Service Load Generator
+ * Throughput and queueing latency of ir_service at rising client counts.
+ *
+ * For each client count, that many threads each open a connection and
+ * send --requests SEND requests back to back, spread round robin over
+ * the --emitters. Reports requests per second, client round trip
+ * percentiles and the queueing time the service measured (request
+ * queued to its first frame on air). Exits 1 if any request failed.
+ *
+ * Built by the host build (cmake --build build --target ir_loadgen);
+ * run with ir_service running:
+ *   build/ir_loadgen --device "Samsung TV" --emitters ir0,ir1 --clients 1,2,4,8,16,32
+ * Options:
+ *   --socket PATH     service socket (/tmp/vhc_ir.sock)
+ *   --device NAME     device to send to (required)
+ *   --function NAME   standard function name (volUp)
+ *   --emitters A,B    emitter names (ir0)
+ *   --clients LIST    client counts to run (1,2,4,8,16,32)
+ *   --requests N      requests per client per run (50)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* socketPath = "/tmp/vhc_ir.sock";
+static const char* deviceName = NULL;
+static const char* functionName = "volUp";
+static std::vector<std::string> emitterNames;
+static int requests = 50;
+
+struct RunResult {
+  std::vector<long> roundTripUs;
+  std::vector<long> queueUs;
+  int errors;
+  std::string firstError;
+};
+
+static std::vector<std::string> splitList(const char* text) {
+  std::vector<std::string> items;
+  std::string item;
+  for (const char* p = text; ; p++) {
+    if (*p == ',' || *p == '\0') {
+      if (!item.empty()) items.push_back(item);
+      item.clear();
+      if (*p == '\0') break;
+    } else {
+      item += *p;
+    }
+  }
+  return items;
+}
+
+static int connectService() {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+  if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static bool readLine(int fd, std::string& line) {
+  // Replies are one line and requests wait for them, so no read-ahead
+  line.clear();
+  char c;
+  while (read(fd, &c, 1) == 1) {
+    if (c == '\n') return true;
+    line += c;
+  }
+  return false;
+}
+
+static void client(int id, RunResult* result, std::mutex* resultLock) {
+  std::vector<long> roundTrips;
+  std::vector<long> queueTimes;
+  int errors = 0;
+  std::string firstError;
+  
+  int fd = connectService();
+  if (fd < 0) {
+    errors = requests;
+    firstError = "cannot connect";
+  }
+  const std::string& emitter = emitterNames[id % emitterNames.size()];
+  std::string request = "SEND " + emitter + " " + functionName + " " + deviceName + "\n";
+  
+  for (int i = 0; fd >= 0 && i < requests; i++) {
+    Clock::time_point start = Clock::now();
+    std::string reply;
+    if (write(fd, request.data(), request.size()) != (ssize_t)request.size() || !readLine(fd, reply)) {
+      errors += requests - i;
+      if (firstError.empty()) firstError = "connection closed";
+      break;
+    }
+    long queueUs, totalUs;
+    if (sscanf(reply.c_str(), "OK %ld %ld", &queueUs, &totalUs) != 2) {
+      errors++;
+      if (firstError.empty()) firstError = reply;
+      continue;
+    }
+    roundTrips.push_back(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    queueTimes.push_back(queueUs);
+  }
+  if (fd >= 0) close(fd);
+  
+  std::lock_guard<std::mutex> guard(*resultLock);
+  result->roundTripUs.insert(result->roundTripUs.end(), roundTrips.begin(), roundTrips.end());
+  result->queueUs.insert(result->queueUs.end(), queueTimes.begin(), queueTimes.end());
+  result->errors += errors;
+  if (result->firstError.empty()) result->firstError = firstError;
+}
+
+static int usage(const char* program) {
+  fprintf(stderr, "Usage: %s --device NAME [--socket PATH] [--function NAME] [--emitters A,B] [--clients 1,2,4] [--requests N]\n", program);
+  return 1;
+}
+
+static double percentileMs(std::vector<long>& values, int pct) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  size_t index = (values.size() * pct + 99) / 100;
+  if (index > 0) index--;
+  return values[index] / 1000.0;
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> clientCounts = splitList("1,2,4,8,16,32");
+  emitterNames.push_back("ir0");
+  
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) socketPath = argv[++i];
+    else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) deviceName = argv[++i];
+    else if (strcmp(argv[i], "--function") == 0 && i + 1 < argc) functionName = argv[++i];
+    else if (strcmp(argv[i], "--emitters") == 0 && i + 1 < argc) emitterNames = splitList(argv[++i]);
+    else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) clientCounts = splitList(argv[++i]);
+    else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) requests = atoi(argv[++i]);
+    else return usage(argv[0]);
+  }
+  if (!deviceName || emitterNames.empty()) return usage(argv[0]);
+  
+  int failed = 0;
+  printf("%s %s on %zu emitter(s), %d requests per client\n", deviceName, functionName, emitterNames.size(), requests);
+  printf("clients    req/s   rtt p50    p95    p99 ms   queue p50    p95    p99 ms  errors\n");
+  for (const std::string& count : clientCounts) {
+    int clients = atoi(count.c_str());
+    if (clients <= 0) continue;
+    
+    RunResult result = {};
+    std::mutex resultLock;
+    std::vector<std::thread> threads;
+    Clock::time_point start = Clock::now();
+    for (int c = 0; c < clients; c++) {
+      threads.emplace_back(client, c, &result, &resultLock);
+    }
+    for (std::thread& t : threads) {
+      t.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    printf("%7d %8.1f %9.2f %6.2f %6.2f %12.2f %6.2f %6.2f %7d\n",
+           clients, result.roundTripUs.size() / seconds,
+           percentileMs(result.roundTripUs, 50), percentileMs(result.roundTripUs, 95), percentileMs(result.roundTripUs, 99),
+           percentileMs(result.queueUs, 50), percentileMs(result.queueUs, 95), percentileMs(result.queueUs, 99),
+           result.errors);
+    failed += result.errors;
+    if (!result.firstError.empty()) {
+      printf("        first error: %s\n", result.firstError.c_str());
+    }
+    fflush(stdout);
+  }
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * VHC Universal Remote - IR Service
+ * Headless Linux daemon sending IRDB device commands for lab automation.
+ *
+ * Loads every .csv in --irdb with the firmware's IRDBParser, so devices
+ * get the same commands they get on the remote, and sends through the
+ * firmware's protocol code (ir_protocol.h) to one or more emitters. Any
+ * number of clients connect to a Unix socket; each gets a thread, and
+ * each emitter a queue and a worker (emitter.h) that batches what waits
+ * and keeps frames from overlapping.
+ *
+ * Requests are text lines, one reply line each:
+ *   SEND <emitter> <function> <device name>
+ *     -> OK <queue_us> <total_us>  (waiting for the emitter, and overall)
+ *     -> ERR <reason>
+ *   LIST   -> DEVICE <commands> <name> per device, then END
+ *   STATS  -> EMITTER <name> sent=.. failed=.. batches=.. frames=.. queued=.. max=.., then END
+ *   QUIT
+ * Function names are the standard ones ("power", "volUp", "0", ...).
+ *
+ * Built by the host build (cmake --build build --target ir_service):
+ *   build/ir_service --irdb /path/to/csvs --emitter rack1=lirc:/dev/lirc0 --emitter test=file:-
+ * Options:
+ *   --socket PATH       listening socket (/tmp/vhc_ir.sock)
+ *   --irdb DIR          directory of IRDB CSV files (.)
+ *   --emitter NAME=SPEC emitter with a backend, repeatable (ir0=file:/dev/null):
+ *                       file:PATH writes one line per frame (file:- is stdout),
+ *                       lirc:DEVICE sends pulses to a LIRC transmitter
+ *   --frame-ms N        air time file backends simulate per frame (0)
+ */
+
+#include <dirent.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "irdb_parser.h"
+#include "emitter.h"
+
+static std::vector<Device> devices;
+static std::unordered_map<uint32_t, size_t> deviceIndex;  // hashName(name)
+static std::map<std::string, Emitter*> emitters;
+static const char* socketPath = "/tmp/vhc_ir.sock";
+
+static bool loadFile(const char* path, Device* device) {
+  FILE* in = fopen(path, "r");
+  if (!in) return false;
+  
+  char deviceName[32];
+  IRDBParser::deviceNameFromFile(path, deviceName);
+  IRDBParser::beginDevice(device, deviceName);
+  
+  // Same line handling as SDManager::readLine
+  char line[256];
+  while (device->commandCount < MAX_COMMANDS && fgets(line, sizeof(line), in)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    IRDBParser::addLine(line, device);
+  }
+  fclose(in);
+  return device->commandCount > 0;
+}
+
+static int loadDevices(const char* dir) {
+  DIR* d = opendir(dir);
+  if (!d) {
+    perror(dir);
+    return -1;
+  }
+  dirent* entry;
+  while ((entry = readdir(d))) {
+    if (!strstr(entry->d_name, ".csv")) continue;
+    std::string path = std::string(dir) + "/" + entry->d_name;
+    Device device;
+    if (!loadFile(path.c_str(), &device)) continue;
+    
+    uint32_t hash = hashName(device.name);
+    if (deviceIndex.count(hash)) {
+      fprintf(stderr, "%s: device \"%s\" already loaded, skipped\n", path.c_str(), device.name);
+      continue;
+    }
+    deviceIndex[hash] = devices.size();
+    devices.push_back(device);
+  }
+  closedir(d);
+  return devices.size();
+}
+
+static std::string handleSend(char* args) {
+  // <emitter> <function> <device name, may contain spaces>
+  char* emitterName = strtok(args, " ");
+  char* functionName = strtok(NULL, " ");
+  char* deviceName = strtok(NULL, "");
+  if (!emitterName || !functionName || !deviceName) return "ERR usage: SEND <emitter> <function> <device>";
+  
+  auto emitter = emitters.find(emitterName);
+  if (emitter == emitters.end()) return "ERR no emitter";
+  auto index = deviceIndex.find(hashName(deviceName));
+  if (index == deviceIndex.end()) return "ERR no device";
+  IRFunction function = findFunction(functionName);
+  if (function == IR_FN_NONE) return "ERR no function";
+  const Device& device = devices[index->second];
+  int slot = device.slots[function];
+  if (slot < 0) return "ERR no command";
+  
+  SendRequest request;
+  request.command = device.commands[slot];
+  emitter->second->send(&request);
+  if (!request.ok) return "ERR unknown protocol";
+  
+  auto us = [&](ServiceClock::time_point t) {
+    return (long)std::chrono::duration_cast<std::chrono::microseconds>(t - request.queued).count();
+  };
+  char reply[48];
+  snprintf(reply, sizeof(reply), "OK %ld %ld", us(request.started), us(request.finished));
+  return reply;
+}
+
+static std::string handleRequest(char* line) {
+  char* args = strchr(line, ' ');
+  if (args) *args++ = '\0';
+  
+  if (strcmp(line, "SEND") == 0) {
+    return handleSend(args ? args : (char*)"");
+  }
+  
+  if (strcmp(line, "LIST") == 0) {
+    std::string reply;
+    for (const Device& device : devices) {
+      reply += "DEVICE " + std::to_string(device.commandCount) + " " + device.name + "\n";
+    }
+    return reply + "END";
+  }
+  
+  if (strcmp(line, "STATS") == 0) {
+    std::string reply;
+    for (auto& entry : emitters) {
+      EmitterStats s = entry.second->getStats();
+      char text[160];
+      snprintf(text, sizeof(text), "EMITTER %s sent=%llu failed=%llu batches=%llu frames=%llu queued=%zu max=%zu\n",
+               entry.first.c_str(), (unsigned long long)s.sent, (unsigned long long)s.failed,
+               (unsigned long long)s.batches, (unsigned long long)s.frames, s.queued, s.maxQueued);
+      reply += text;
+    }
+    return reply + "END";
+  }
+  
+  return "ERR unknown request";
+}
+
+static void serveClient(int fd) {
+  FILE* in = fdopen(fd, "r");
+  char line[256];
+  while (fgets(line, sizeof(line), in)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0') continue;
+    if (strcmp(line, "QUIT") == 0) break;
+    
+    std::string reply = handleRequest(line) + "\n";
+    if (write(fd, reply.data(), reply.size()) != (ssize_t)reply.size()) break;
+  }
+  fclose(in);
+}
+
+static void stop(int) {
+  unlink(socketPath);
+  _exit(0);
+}
+
+int main(int argc, char** argv) {
+  const char* irdbDir = ".";
+  std::vector<std::string> emitterSpecs;
+  int frameMs = 0;
+  
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) socketPath = argv[++i];
+    else if (strcmp(argv[i], "--irdb") == 0 && i + 1 < argc) irdbDir = argv[++i];
+    else if (strcmp(argv[i], "--emitter") == 0 && i + 1 < argc) emitterSpecs.push_back(argv[++i]);
+    else if (strcmp(argv[i], "--frame-ms") == 0 && i + 1 < argc) frameMs = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "Usage: %s [--socket PATH] [--irdb DIR] [--emitter NAME=SPEC]... [--frame-ms N]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (emitterSpecs.empty()) emitterSpecs.push_back("ir0=file:/dev/null");
+  
+  if (loadDevices(irdbDir) < 0) return 1;
+  printf("%zu devices from %s\n", devices.size(), irdbDir);
+  
+  for (const std::string& spec : emitterSpecs) {
+    size_t split = spec.find('=');
+    if (split == std::string::npos) {
+      fprintf(stderr, "Emitter %s: expected NAME=SPEC\n", spec.c_str());
+      return 1;
+    }
+    std::string name = spec.substr(0, split);
+    Backend* backend = openBackend(spec.c_str() + split + 1, frameMs);
+    if (!backend || emitters.count(name)) {
+      if (backend) fprintf(stderr, "Emitter %s given twice\n", name.c_str());
+      return 1;
+    }
+    emitters[name] = new Emitter(name, backend);
+    printf("Emitter %s: %s\n", name.c_str(), spec.c_str() + split + 1);
+  }
+  
+  int server = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socketPath, sizeof(addr.sun_path) - 1);
+  unlink(socketPath);
+  if (bind(server, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(server, 64) < 0) {
+    perror(socketPath);
+    return 1;
+  }
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, stop);
+  signal(SIGTERM, stop);
+  printf("Listening on %s\n", socketPath);
+  fflush(stdout);
+  
+  while (true) {
+    int client = accept(server, NULL, NULL);
+    if (client < 0) continue;
+    std::thread(serveClient, client).detach();
+  }
+}
@@ -0,0 +1,261 @@
+/*
+ * VHC Universal Remote - Log Decoder
+ * Expands the binary event log back into text lines.
+ *
+ * Reads the stream the firmware drains to Serial ("log serial") or to
+ * /log/events.bin on the SD card ("log sd") and prints one line per
+ * record: time in microseconds, then the formatted text. The format
+ * table is log_formats.h from the sketch, so rebuild this tool when a
+ * format is added. On Serial the records come in PROTO_LOG frames
+ * (remote_protocol.h), which are unpacked; other frames are dropped, and
+ * a gap in the frames' sequence numbers is counted as frames missing.
+ * Bytes that do not start a valid record (console text mixed into a
+ * serial capture) are skipped until the next sync byte.
+ *
+ * Built by the host build (cmake --build build --target log_decode):
+ *   build/log_decode events.bin
+ *   cat /dev/ttyACM0 | build/log_decode      (live, after "log serial")
+ * Options:
+ *   --relative   times relative to the first record, in milliseconds
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "log_formats.h"
+#include "remote_protocol.h"
+
+static const char* const formatText[LOG_FORMAT_COUNT] = {
+  LOG_FORMATS(LOG_FORMAT_TEXT)
+};
+
+struct Conversion {
+  std::string spec;   // "%08x" etc.
+  char type;          // Conversion letter
+};
+
+// Splits a format into literal text and conversions, in order
+static void parseFormat(const char* text, std::vector<std::string>& literals, std::vector<Conversion>& conversions) {
+  std::string literal;
+  for (const char* p = text; *p; p++) {
+    if (*p != '%') {
+      literal += *p;
+      continue;
+    }
+    if (p[1] == '%') {
+      literal += '%';
+      p++;
+      continue;
+    }
+    Conversion c;
+    c.spec = "%";
+    p++;
+    while (*p && strchr("-+ #0123456789.l", *p)) {
+      if (*p != 'l') c.spec += *p;
+      p++;
+    }
+    if (!*p) break;
+    c.type = *p;
+    c.spec += *p;
+    literals.push_back(literal);
+    conversions.push_back(c);
+    literal.clear();
+  }
+  literals.push_back(literal);
+}
+
+class Reader {
+private:
+  FILE* in;
+  std::vector<uint8_t> pending;  // Bytes pushed back after a failed record
+  std::deque<uint8_t> unframed;  // Frame payload, or bytes that were no frame
+  int lastSeq;
+  
+  int next() {
+    if (!unframed.empty()) {
+      int c = unframed.front();
+      unframed.pop_front();
+      return c;
+    }
+    return fgetc(in);
+  }
+  
+  // After a PROTO_SYNC byte: queues a log frame's payload, drops any
+  // other frame, or puts the bytes back if they are not a frame
+  void unframe() {
+    std::vector<uint8_t> frame(1, PROTO_SYNC);
+    int c;
+    while (frame.size() < PROTO_HEADER_SIZE && (c = fgetc(in)) != EOF) {
+      frame.push_back((uint8_t)c);
+    }
+    size_t total = (frame.size() > 1 && frame[1] <= PROTO_MAX_PAYLOAD) ? PROTO_HEADER_SIZE + frame[1] + 2 : 0;
+    while (total && frame.size() < total && (c = fgetc(in)) != EOF) {
+      frame.push_back((uint8_t)c);
+    }
+    
+    int length = frame.size() > 1 ? frame[1] : 0;
+    if (!total || frame.size() < total ||
+        protoGet16(&frame[PROTO_HEADER_SIZE + length]) != protoCRC(&frame[1], PROTO_HEADER_SIZE - 1 + length)) {
+      unframed.insert(unframed.begin(), frame.begin(), frame.end());
+      return;
+    }
+    if (frame[3] != PROTO_LOG) return;
+    
+    if (lastSeq >= 0) {
+      framesMissing += (uint8_t)(frame[2] - lastSeq - 1);
+    }
+    lastSeq = frame[2];
+    unframed.insert(unframed.end(), frame.begin() + PROTO_HEADER_SIZE, frame.begin() + PROTO_HEADER_SIZE + length);
+  }
+  
+public:
+  long framesMissing;
+  
+  Reader(FILE* in) : in(in), lastSeq(-1), framesMissing(0) {}
+  
+  int get() {
+    if (!pending.empty()) {
+      int c = pending.back();
+      pending.pop_back();
+      return c;
+    }
+    // Frames only come from the port, never from inside another frame
+    while (unframed.empty()) {
+      int c = fgetc(in);
+      if (c != PROTO_SYNC) return c;
+      unframe();
+    }
+    return next();
+  }
+  
+  // Puts bytes back so they are read again, first one first
+  void unget(const std::vector<uint8_t>& bytes) {
+    for (size_t i = bytes.size(); i > 0; i--) {
+      pending.push_back(bytes[i - 1]);
+    }
+  }
+};
+
+// Reads one record after the sync byte. Returns false (with the bytes
+// consumed in 'raw') if it is not a valid record.
+static bool readRecord(Reader& reader, std::vector<uint8_t>& raw, std::string& line, uint32_t& time) {
+  auto next = [&](int& c) {
+    c = reader.get();
+    if (c == EOF) return false;
+    raw.push_back((uint8_t)c);
+    return true;
+  };
+  auto next32 = [&](uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+      int c;
+      if (!next(c)) return false;
+      value |= (uint32_t)c << (8 * i);
+    }
+    return true;
+  };
+  
+  int lo, hi, argCount;
+  if (!next(lo) || !next(hi) || !next(argCount)) return false;
+  int format = lo | (hi << 8);
+  if (format >= LOG_FORMAT_COUNT || argCount > LOG_MAX_ARGS) return false;
+  if (!next32(time)) return false;
+  
+  std::vector<std::string> literals;
+  std::vector<Conversion> conversions;
+  parseFormat(formatText[format], literals, conversions);
+  if ((int)conversions.size() != argCount) return false;
+  
+  line = literals[0];
+  for (int i = 0; i < argCount; i++) {
+    char text[300];
+    const Conversion& c = conversions[i];
+    if (c.type == 's') {
+      int len;
+      if (!next(len)) return false;
+      std::string s;
+      for (int k = 0; k < len; k++) {
+        int ch;
+        if (!next(ch)) return false;
+        s += (char)ch;
+      }
+      snprintf(text, sizeof(text), c.spec.c_str(), s.c_str());
+    } else {
+      uint32_t value;
+      if (!next32(value)) return false;
+      if (c.type == 'd' || c.type == 'i') {
+        snprintf(text, sizeof(text), c.spec.c_str(), (int32_t)value);
+      } else if (c.type == 'c') {
+        snprintf(text, sizeof(text), c.spec.c_str(), (int)value);
+      } else {
+        snprintf(text, sizeof(text), c.spec.c_str(), value);
+      }
+    }
+    line += text;
+    line += literals[i + 1];
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  bool relative = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--relative") == 0) {
+      relative = true;
+    } else {
+      path = argv[i];
+    }
+  }
+  
+  FILE* in = path ? fopen(path, "rb") : stdin;
+  if (!in) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  
+  Reader reader(in);
+  bool haveFirst = false;
+  uint32_t first = 0;
+  long records = 0;
+  long skipped = 0;
+  int c;
+  while ((c = reader.get()) != EOF) {
+    if (c != LOG_SYNC) {
+      skipped++;
+      continue;
+    }
+    
+    std::vector<uint8_t> raw;
+    std::string line;
+    uint32_t time;
+    if (!readRecord(reader, raw, line, time)) {
+      // Not a record: look for the next sync byte inside what was read
+      reader.unget(raw);
+      skipped++;
+      continue;
+    }
+    
+    if (!haveFirst) {
+      first = time;
+      haveFirst = true;
+    }
+    if (relative) {
+      printf("%10.3f  %s\n", (uint32_t)(time - first) / 1000.0, line.c_str());
+    } else {
+      printf("%10u  %s\n", time, line.c_str());
+    }
+    records++;
+  }
+  
+  fprintf(stderr, "%ld records, %ld bytes skipped", records, skipped);
+  if (reader.framesMissing) {
+    fprintf(stderr, ", %ld log frames missing", reader.framesMissing);
+  }
+  fprintf(stderr, "\n");
+  if (path) fclose(in);
+  return 0;
+}
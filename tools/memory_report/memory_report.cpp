@@ -0,0 +1,190 @@
+/*
+ * VHC Universal Remote - Memory Report
+ * Breaks the firmware's static memory down by module and region and
+ * checks it against a budget.
+ *
+ * Reads symbol sizes from nm (with -l for source locations, so symbols
+ * can be charged to the module that defines them) and sorts them into
+ * the Teensy 4.1 regions by address:
+ *   ITCM   0x00000000  code run from RAM1 (FASTRUN, the default for code)
+ *   DTCM   0x20000000  data, bss and the stack (RAM1)
+ *   OCRAM  0x20200000  DMAMEM buffers and the heap (RAM2)
+ *   FLASH  0x60000000  PROGMEM/FLASHMEM code and constants
+ * ITCM and DTCM share the 512 KB of RAM1 (ITCM in 32 KB blocks); what
+ * DTCM leaves over is stack. Exits with status 1 when a region is over
+ * budget, so a build script can fail on it.
+ *
+ * Built by the host build (cmake --build build --target memory_report):
+ *   arm-none-eabi-nm -S -l -C <build>/VHC_Universal_Remote.ino.elf | build/memory_report
+ * Budgets in KB (defaults in parentheses):
+ *   --ram1 N (512)  --dtcm N (448)  --ocram N (480)  --flash N (7936)
+ *   --top N         also list the N largest symbols (0)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+enum Region {
+  REGION_ITCM,
+  REGION_DTCM,
+  REGION_OCRAM,
+  REGION_FLASH,
+  REGION_COUNT
+};
+
+const char* const regionNames[REGION_COUNT] = {"itcm", "dtcm", "ocram", "flash"};
+
+struct Symbol {
+  std::string name;
+  std::string module;
+  Region region;
+  unsigned long size;
+};
+
+static bool regionOf(unsigned long address, Region& region) {
+  if (address < 0x00080000UL) region = REGION_ITCM;
+  else if (address >= 0x20000000UL && address < 0x20080000UL) region = REGION_DTCM;
+  else if (address >= 0x20200000UL && address < 0x20280000UL) region = REGION_OCRAM;
+  else if (address >= 0x60000000UL && address < 0x61000000UL) region = REGION_FLASH;
+  else return false;
+  return true;
+}
+
+static std::string moduleOf(const char* location) {
+  // "path/to/menu.cpp:42" -> "menu"; library sources keep their file name
+  if (!location || !*location) return "(no source)";
+  std::string path(location);
+  size_t colon = path.rfind(':');
+  if (colon != std::string::npos) path = path.substr(0, colon);
+  size_t slash = path.find_last_of("/\\");
+  if (slash != std::string::npos) path = path.substr(slash + 1);
+  size_t dot = path.rfind('.');
+  if (dot != std::string::npos) path = path.substr(0, dot);
+  return path;
+}
+
+static unsigned long roundUp(unsigned long bytes, unsigned long block) {
+  return (bytes + block - 1) / block * block;
+}
+
+int main(int argc, char** argv) {
+  unsigned long budgetRam1 = 512, budgetDtcm = 448, budgetOcram = 480, budgetFlash = 7936;
+  int top = 0;
+  
+  for (int i = 1; i + 1 < argc; i += 2) {
+    unsigned long value = strtoul(argv[i + 1], NULL, 10);
+    if (strcmp(argv[i], "--ram1") == 0) budgetRam1 = value;
+    else if (strcmp(argv[i], "--dtcm") == 0) budgetDtcm = value;
+    else if (strcmp(argv[i], "--ocram") == 0) budgetOcram = value;
+    else if (strcmp(argv[i], "--flash") == 0) budgetFlash = value;
+    else if (strcmp(argv[i], "--top") == 0) top = (int)value;
+    else {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  
+  // nm -S: "address size type name[\tfile:line]"
+  std::vector<Symbol> symbols;
+  char line[1024];
+  while (fgets(line, sizeof(line), stdin)) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char* location = strchr(line, '\t');
+    if (location) *location++ = '\0';
+    
+    char* fields[4];
+    char* rest = line;
+    int count = 0;
+    while (count < 3) {
+      fields[count] = strtok(count == 0 ? rest : NULL, " ");
+      if (!fields[count]) break;
+      count++;
+    }
+    if (count < 3) continue;  // No size: not an object
+    fields[3] = strtok(NULL, "");
+    if (!fields[3]) continue;
+    
+    Symbol symbol;
+    Region region;
+    if (!regionOf(strtoul(fields[0], NULL, 16), region)) continue;
+    symbol.size = strtoul(fields[1], NULL, 16);
+    symbol.region = region;
+    symbol.name = fields[3];
+    symbol.module = moduleOf(location);
+    symbols.push_back(symbol);
+  }
+  
+  if (symbols.empty()) {
+    fprintf(stderr, "No sized symbols on stdin (expected arm-none-eabi-nm -S -l -C output)\n");
+    return 2;
+  }
+  
+  // Per module and region
+  std::map<std::string, std::vector<unsigned long> > modules;
+  unsigned long totals[REGION_COUNT] = {0, 0, 0, 0};
+  for (size_t i = 0; i < symbols.size(); i++) {
+    std::vector<unsigned long>& sizes = modules[symbols[i].module];
+    sizes.resize(REGION_COUNT, 0);
+    sizes[symbols[i].region] += symbols[i].size;
+    totals[symbols[i].region] += symbols[i].size;
+  }
+  
+  std::vector<std::pair<unsigned long, std::string> > order;
+  for (std::map<std::string, std::vector<unsigned long> >::iterator it = modules.begin(); it != modules.end(); ++it) {
+    unsigned long ram = it->second[REGION_ITCM] + it->second[REGION_DTCM] + it->second[REGION_OCRAM];
+    order.push_back(std::make_pair(ram, it->first));
+  }
+  std::sort(order.rbegin(), order.rend());
+  
+  printf("%-24s %10s %10s %10s %10s\n", "module", "itcm", "dtcm", "ocram", "flash");
+  for (size_t i = 0; i < order.size(); i++) {
+    std::vector<unsigned long>& sizes = modules[order[i].second];
+    printf("%-24s %10lu %10lu %10lu %10lu\n", order[i].second.c_str(),
+           sizes[REGION_ITCM], sizes[REGION_DTCM], sizes[REGION_OCRAM], sizes[REGION_FLASH]);
+  }
+  printf("%-24s %10lu %10lu %10lu %10lu\n", "total",
+         totals[REGION_ITCM], totals[REGION_DTCM], totals[REGION_OCRAM], totals[REGION_FLASH]);
+  
+  if (top > 0) {
+    std::vector<Symbol> sorted(symbols);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Symbol& a, const Symbol& b) { return a.size > b.size; });
+    printf("\n%-10s %-6s %-20s %s\n", "bytes", "region", "module", "symbol");
+    for (int i = 0; i < top && i < (int)sorted.size(); i++) {
+      printf("%-10lu %-6s %-20s %s\n", sorted[i].size, regionNames[sorted[i].region],
+             sorted[i].module.c_str(), sorted[i].name.c_str());
+    }
+  }
+  
+  // RAM1 holds ITCM in whole 32 KB blocks plus DTCM; the rest is stack
+  unsigned long ram1 = roundUp(totals[REGION_ITCM], 32768) + totals[REGION_DTCM];
+  struct Check {
+    const char* name;
+    unsigned long used;
+    unsigned long budget;
+  } checks[] = {
+    {"ram1",  ram1, budgetRam1 * 1024},
+    {"dtcm",  totals[REGION_DTCM], budgetDtcm * 1024},
+    {"ocram", totals[REGION_OCRAM], budgetOcram * 1024},
+    {"flash", totals[REGION_FLASH], budgetFlash * 1024}
+  };
+  
+  bool over = false;
+  printf("\n");
+  for (size_t i = 0; i < sizeof(checks) / sizeof(checks[0]); i++) {
+    bool fits = checks[i].used <= checks[i].budget;
+    printf("%-6s %8lu / %8lu bytes  %s\n", checks[i].name, checks[i].used, checks[i].budget,
+           fits ? "ok" : "OVER BUDGET");
+    if (!fits) over = true;
+  }
+  if (ram1 <= 512 * 1024) {
+    printf("stack  %8lu bytes left in RAM1\n", 512 * 1024 - ram1);
+  }
+  
+  return over ? 1 : 0;
+}
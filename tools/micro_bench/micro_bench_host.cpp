@@ -0,0 +1,79 @@
+/*
+ * VHC Universal Remote - Host Micro Benchmarks
+ * Runs the firmware's micro benchmarks (micro_bench.cpp) on the host
+ * build, without a remote.
+ *
+ * The benchmark bodies are the unchanged firmware code over the same
+ * generated IRDB corpus; only the clock differs: once booted, the host
+ * clock follows real time, so ns/op are this machine's, not the
+ * Teensy's. A baseline is only comparable with one saved on the same
+ * machine. Exits non-zero if a benchmark allocated or, with --baseline,
+ * got slower by more than MICRO_BENCH_REGRESSION_PCT.
+ *
+ * Built by the host build from the repository root:
+ *   cmake -S . -B build && cmake --build build --target micro_bench
+ *   ./build/micro_bench --devices examples --save /tmp/bench
+ *   ./build/micro_bench --devices examples --baseline /tmp/bench
+ * Options:
+ *   --devices DIR   IRDB files (*.csv) to load, for the command lookups
+ *   --baseline DIR  compare with DIR/micro.csv
+ *   --save DIR      write this run's ns/op to DIR/micro.csv
+ */
+
+#include <Arduino.h>
+#include "hal_host.h"
+#include "menu.h"
+#include "micro_bench.h"
+
+void setup();
+void loop();
+
+int main(int argc, char** argv) {
+  const char* devicesDir = nullptr;
+  const char* baselineDir = nullptr;
+  const char* saveDir = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--devices") == 0 && i + 1 < argc) {
+      devicesDir = argv[++i];
+    } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baselineDir = argv[++i];
+    } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+      saveDir = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--devices DIR] [--baseline DIR] [--save DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (devicesDir && hostSD.loadDirectory(devicesDir, ".csv") < 1) {
+    fprintf(stderr, "No IRDB files in %s\n", devicesDir);
+    return 1;
+  }
+  if (baselineDir && hostSD.loadDirectory(baselineDir, ".csv", "/bench") < 1) {
+    fprintf(stderr, "No baseline in %s\n", baselineDir);
+    return 1;
+  }
+
+  // Boot past the splash for the device table, its output discarded
+  setup();
+  uint32_t limit = hostClock.millis() + 10000;
+  while (menu.getCurrentScreen() == SCREEN_SPLASH && hostClock.millis() < limit) {
+    loop();
+  }
+  Serial.clearOutput();
+  Serial.setEcho(true);
+  hostClock.setWallClock(true);
+
+  bool passed = microBench.run(saveDir != nullptr);
+  if (saveDir) {
+    // Only the benchmark's own file; boot wrote its timeline there too
+    hal.storage->fs().remove("/bench/boot.csv");
+    if (hostSD.saveDirectory("/bench", saveDir) < 0) {
+      fprintf(stderr, "Cannot save to %s\n", saveDir);
+      return 1;
+    }
+    printf("Saved to %s\n", saveDir);
+  }
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+/*
+ * VHC Universal Remote - Remote Benchmark
+ * Sustained IR commands per second and ack latency over the serial link.
+ *
+ * First times round trips of PROTO_PING frames, then streams --count
+ * sends of one device command in ENQUEUE frames of --batch entries,
+ * keeping the remote's queue topped up without overflowing it. Reports
+ * ack latency percentiles, the completion rate and any failed sends.
+ * Works against the remote itself or against remote_sim.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=c++11 -O2 -I. tools/remote_link/remote_bench.cpp tools/remote_link/remote_link.cpp -o remote_bench
+ *   ./remote_bench /dev/ttyACM0 --device TV --command volUp --count 500
+ * Options:
+ *   --device NAME   device name as on the SD card (required)
+ *   --command NAME  standard function name (volUp)
+ *   --count N       sends in the stream (200)
+ *   --batch N       sends per ENQUEUE frame, at most 18 (8)
+ *   --gap MS        gap after each send (0)
+ *   --pings N       round trips timed before the stream (100)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "remote_link.h"
+
+#define REPLY_TIMEOUT_MS 2000
+
+static double nowMs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void printLatency(const char* label, std::vector<double>& samples) {
+  if (samples.empty()) {
+    printf("%s: no samples\n", label);
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto pct = [&](int p) { return samples[std::min(samples.size() - 1, samples.size() * p / 100)]; };
+  printf("%s: n=%zu p50=%.2f p90=%.2f p99=%.2f max=%.2f ms\n",
+         label, samples.size(), pct(50), pct(90), pct(99), samples.back());
+}
+
+int main(int argc, char** argv) {
+  const char* port = nullptr;
+  const char* device = nullptr;
+  const char* command = "volUp";
+  int count = 200;
+  int batch = 8;
+  int gap = 0;
+  int pings = 100;
+  
+  bool usage = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) device = argv[++i];
+    else if (strcmp(argv[i], "--command") == 0 && i + 1 < argc) command = argv[++i];
+    else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) batch = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--gap") == 0 && i + 1 < argc) gap = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--pings") == 0 && i + 1 < argc) pings = atoi(argv[++i]);
+    else if (argv[i][0] != '-') port = argv[i];
+    else usage = true;
+  }
+  int maxBatch = PROTO_MAX_PAYLOAD / PROTO_SEND_SIZE;
+  if (usage || !port || !device || batch < 1 || batch > maxBatch) {
+    fprintf(stderr, "usage: %s <port> --device NAME [--command NAME] [--count N] [--batch 1-%d] [--gap MS] [--pings N]\n",
+            argv[0], maxBatch);
+    return 2;
+  }
+  
+  RemoteLink link;
+  if (!link.open(port)) {
+    perror(port);
+    return 1;
+  }
+  RemoteMessage message;
+  
+  // Queue capacity, and a clean start
+  link.clear();
+  int capacity = 0;
+  link.status();
+  double deadline = nowMs() + REPLY_TIMEOUT_MS;
+  while (!capacity && nowMs() < deadline && link.receive(message, REPLY_TIMEOUT_MS)) {
+    if (message.type == PROTO_STATUS_REPLY) {
+      capacity = RemoteLink::parseStatus(message).capacity;
+    }
+  }
+  if (!capacity) {
+    fprintf(stderr, "no status reply from %s\n", port);
+    return 1;
+  }
+  
+  // Round trips
+  std::vector<double> pingMs;
+  for (int i = 0; i < pings; i++) {
+    double start = nowMs();
+    int seq = link.ping();
+    while (link.receive(message, REPLY_TIMEOUT_MS)) {
+      if (message.type == PROTO_ACK && RemoteLink::parseAck(message).seq == seq) {
+        pingMs.push_back(nowMs() - start);
+        break;
+      }
+    }
+  }
+  printLatency("ping round trip", pingMs);
+  
+  // Stream, keeping at most 'capacity' sends outstanding
+  ProtoSend send;
+  send.device = nameHash(device);
+  send.command = nameHash(command);
+  send.repeat = 1;
+  send.gapMs = gap;
+  
+  struct Pending {
+    double sentAt;
+    int entries;
+  };
+  std::map<int, Pending> ackPending;  // By frame seq
+  std::vector<double> ackMs;
+  std::map<int, int> results;
+  int queued = 0;
+  int finished = 0;
+  int outstanding = 0;
+  double firstDone = 0;
+  double lastDone = 0;
+  double start = nowMs();
+  
+  while (finished < count) {
+    int room = capacity - outstanding;
+    int n = std::min(std::min(batch, count - queued), room);
+    if (n > 0 && ackPending.empty()) {
+      std::vector<ProtoSend> sends(n, send);
+      ackPending[link.enqueue(sends)] = {nowMs(), n};
+      outstanding += n;
+      queued += n;
+    }
+    
+    if (!link.receive(message, REPLY_TIMEOUT_MS)) {
+      fprintf(stderr, "timed out with %d of %d finished\n", finished, count);
+      break;
+    }
+    if (message.type == PROTO_ACK) {
+      ProtoAck ack = RemoteLink::parseAck(message);
+      auto it = ackPending.find(ack.seq);
+      if (it != ackPending.end()) {
+        ackMs.push_back(nowMs() - it->second.sentAt);
+        // Entries the remote had no room for go out again later
+        int rejected = it->second.entries - ack.accepted;
+        outstanding -= rejected;
+        queued -= rejected;
+        ackPending.erase(it);
+      }
+    } else if (message.type == PROTO_DONE) {
+      ProtoDone done = RemoteLink::parseDone(message);
+      results[done.result]++;
+      finished++;
+      outstanding--;
+      lastDone = nowMs();
+      if (!firstDone) firstDone = lastDone;
+    }
+  }
+  
+  printLatency("enqueue ack", ackMs);
+  double seconds = (lastDone - start) / 1000.0;
+  printf("finished %d sends in %.2f s: %.1f commands/s\n", finished, seconds, seconds > 0 ? finished / seconds : 0.0);
+  if (finished > 1 && lastDone > firstDone) {
+    printf("steady state: %.1f commands/s\n", (finished - 1) / ((lastDone - firstDone) / 1000.0));
+  }
+  for (auto& r : results) {
+    if (r.first != PROTO_OK) {
+      printf("result %d: %d sends\n", r.first, r.second);
+    }
+  }
+  return results[PROTO_OK] == count ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/*
+ * VHC Universal Remote - Remote Link Client Implementation
+ */
+
+#include "remote_link.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <time.h>
+#include <string.h>
+#include <algorithm>
+
+uint32_t nameHash(const char* name) {
+  uint32_t hash = 2166136261u;
+  while (*name) {
+    hash = (hash ^ (uint8_t)*name++) * 16777619u;
+  }
+  return hash;
+}
+
+static long nowMs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000L + ts.tv_nsec / 1000000;
+}
+
+RemoteLink::RemoteLink() {
+  fd = -1;
+  txSeq = 0;
+}
+
+RemoteLink::~RemoteLink() {
+  close();
+}
+
+bool RemoteLink::open(const char* path) {
+  close();
+  fd = ::open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) return false;
+  
+  // Raw bytes; the baud rate does not matter for USB serial
+  termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetspeed(&tio, B115200);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  input.clear();
+  return true;
+}
+
+void RemoteLink::close() {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+int RemoteLink::sendFrame(uint8_t type, const uint8_t* payload, int length) {
+  uint8_t frame[PROTO_MAX_FRAME + 1];
+  
+  // A newline first so the frame starts a console line
+  frame[0] = '\n';
+  uint8_t seq = txSeq++;
+  int n = protoFrame(frame + 1, seq, type, payload, length) + 1;
+  
+  for (int done = 0; done < n; ) {
+    ssize_t w = ::write(fd, frame + done, n - done);
+    if (w <= 0) return -1;
+    done += w;
+  }
+  return seq;
+}
+
+int RemoteLink::enqueue(const std::vector<ProtoSend>& sends) {
+  uint8_t payload[PROTO_MAX_PAYLOAD];
+  int n = 0;
+  for (const ProtoSend& s : sends) {
+    if (n + PROTO_SEND_SIZE > PROTO_MAX_PAYLOAD) break;
+    protoPut32(payload + n, s.device);
+    protoPut32(payload + n + 4, s.command);
+    payload[n + 8] = s.repeat;
+    protoPut16(payload + n + 9, s.gapMs);
+    n += PROTO_SEND_SIZE;
+  }
+  return sendFrame(PROTO_ENQUEUE, payload, n);
+}
+
+int RemoteLink::status() {
+  return sendFrame(PROTO_STATUS, nullptr, 0);
+}
+
+int RemoteLink::clear() {
+  return sendFrame(PROTO_CLEAR, nullptr, 0);
+}
+
+int RemoteLink::ping() {
+  return sendFrame(PROTO_PING, nullptr, 0);
+}
+
+int RemoteLink::uploadBegin(const char* name, uint32_t size) {
+  uint8_t payload[PROTO_MAX_PAYLOAD];
+  int nameLength = std::min((int)strlen(name), PROTO_MAX_PAYLOAD - 4);
+  protoPut32(payload, size);
+  memcpy(payload + 4, name, nameLength);
+  return sendFrame(PROTO_UPLOAD_BEGIN, payload, 4 + nameLength);
+}
+
+int RemoteLink::uploadData(const uint8_t* data, int length) {
+  return sendFrame(PROTO_UPLOAD_DATA, data, std::min(length, PROTO_MAX_PAYLOAD));
+}
+
+int RemoteLink::uploadEnd() {
+  return sendFrame(PROTO_UPLOAD_END, nullptr, 0);
+}
+
+bool RemoteLink::takeFrame(RemoteMessage& message) {
+  while (!input.empty()) {
+    // Skip to the next sync byte
+    size_t start = 0;
+    while (start < input.size() && input[start] != PROTO_SYNC) start++;
+    input.erase(input.begin(), input.begin() + start);
+    if (input.size() < 2) return false;
+    
+    int length = input[1];
+    if (length > PROTO_MAX_PAYLOAD) {
+      input.erase(input.begin());
+      continue;
+    }
+    size_t total = PROTO_HEADER_SIZE + length + 2;
+    if (input.size() < total) return false;
+    
+    if (protoGet16(&input[PROTO_HEADER_SIZE + length]) != protoCRC(&input[1], PROTO_HEADER_SIZE - 1 + length)) {
+      // Sync byte inside other output; look again one byte on
+      input.erase(input.begin());
+      continue;
+    }
+    
+    if (input[3] == PROTO_LOG) {
+      // Event log output (log serial) is for tools/log_decode
+      input.erase(input.begin(), input.begin() + total);
+      continue;
+    }
+    
+    message.seq = input[2];
+    message.type = input[3];
+    message.payload.assign(input.begin() + PROTO_HEADER_SIZE, input.begin() + PROTO_HEADER_SIZE + length);
+    input.erase(input.begin(), input.begin() + total);
+    return true;
+  }
+  return false;
+}
+
+bool RemoteLink::receive(RemoteMessage& message, int timeoutMs) {
+  long deadline = nowMs() + timeoutMs;
+  while (true) {
+    if (takeFrame(message)) return true;
+    
+    long left = deadline - nowMs();
+    if (left < 0) return false;
+    pollfd p = {fd, POLLIN, 0};
+    if (poll(&p, 1, (int)left) <= 0) return false;
+    
+    uint8_t buf[512];
+    ssize_t n = ::read(fd, buf, sizeof(buf));
+    if (n <= 0) return false;
+    input.insert(input.end(), buf, buf + n);
+  }
+}
+
+ProtoAck RemoteLink::parseAck(const RemoteMessage& message) {
+  ProtoAck ack = {};
+  if (message.payload.size() >= PROTO_ACK_SIZE) {
+    const uint8_t* p = message.payload.data();
+    ack.seq = p[0];
+    ack.result = p[1];
+    ack.accepted = p[2];
+    ack.depth = protoGet16(p + 3);
+  }
+  return ack;
+}
+
+ProtoDone RemoteLink::parseDone(const RemoteMessage& message) {
+  ProtoDone done = {};
+  if (message.payload.size() >= PROTO_DONE_SIZE) {
+    const uint8_t* p = message.payload.data();
+    done.seq = p[0];
+    done.index = p[1];
+    done.result = p[2];
+    done.time = protoGet32(p + 3);
+  }
+  return done;
+}
+
+ProtoStatus RemoteLink::parseStatus(const RemoteMessage& message) {
+  ProtoStatus status = {};
+  if (message.payload.size() >= PROTO_STATUS_SIZE) {
+    const uint8_t* p = message.payload.data();
+    status.depth = protoGet16(p);
+    status.capacity = protoGet16(p + 2);
+    status.sent = protoGet32(p + 4);
+    status.failed = protoGet32(p + 8);
+  }
+  return status;
+}
+
+ProtoUploadDone RemoteLink::parseUploadDone(const RemoteMessage& message) {
+  ProtoUploadDone done = {};
+  if (message.payload.size() >= PROTO_UPLOAD_DONE_SIZE) {
+    const uint8_t* p = message.payload.data();
+    done.result = p[0];
+    done.commands = p[1];
+    done.bytes = protoGet32(p + 2);
+    done.elapsedMs = protoGet32(p + 6);
+    done.usableMs = protoGet32(p + 10);
+  }
+  return done;
+}
+
+ProtoUploadSaved RemoteLink::parseUploadSaved(const RemoteMessage& message) {
+  ProtoUploadSaved saved = {};
+  if (message.payload.size() >= PROTO_UPLOAD_SAVED_SIZE) {
+    const uint8_t* p = message.payload.data();
+    saved.result = p[0];
+    saved.savedMs = protoGet32(p + 1);
+  }
+  return saved;
+}
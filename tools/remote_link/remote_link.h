@@ -0,0 +1,67 @@
+/*
+ * VHC Universal Remote - Remote Link Client
+ * Linux client for the framed serial protocol (remote_protocol.h)
+ */
+
+#ifndef REMOTE_LINK_H
+#define REMOTE_LINK_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "remote_protocol.h"
+
+// FNV-1a, the same as hashName() in ir_function.h
+uint32_t nameHash(const char* name);
+
+// A frame received from the remote
+struct RemoteMessage {
+  uint8_t seq;
+  uint8_t type;             // ProtoType
+  std::vector<uint8_t> payload;
+};
+
+// Opens a serial port (or a pty) raw and speaks the protocol. Sends
+// return the frame's sequence number, which ACK and DONE messages refer
+// back to. Console text and event log bytes between frames are skipped.
+class RemoteLink {
+private:
+  int fd;
+  uint8_t txSeq;
+  std::vector<uint8_t> input;
+  
+public:
+  RemoteLink();
+  ~RemoteLink();
+  
+  bool open(const char* path);
+  void close();
+  
+  // Up to PROTO_MAX_PAYLOAD / PROTO_SEND_SIZE (18) sends per frame
+  int enqueue(const std::vector<ProtoSend>& sends);
+  int status();
+  int clear();
+  int ping();
+  
+  // Device upload: begin, data in chunks of up to PROTO_MAX_PAYLOAD
+  // (resent when acked PROTO_BUSY), end
+  int uploadBegin(const char* name, uint32_t size);
+  int uploadData(const uint8_t* data, int length);
+  int uploadEnd();
+  
+  // Waits up to timeoutMs for the next frame (event log frames are
+  // skipped); false on timeout
+  bool receive(RemoteMessage& message, int timeoutMs);
+  
+  static ProtoAck parseAck(const RemoteMessage& message);
+  static ProtoDone parseDone(const RemoteMessage& message);
+  static ProtoStatus parseStatus(const RemoteMessage& message);
+  static ProtoUploadDone parseUploadDone(const RemoteMessage& message);
+  static ProtoUploadSaved parseUploadSaved(const RemoteMessage& message);
+  
+private:
+  int sendFrame(uint8_t type, const uint8_t* payload, int length);
+  bool takeFrame(RemoteMessage& message);
+};
+
+#endif // REMOTE_LINK_H
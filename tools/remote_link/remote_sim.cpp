@@ -0,0 +1,156 @@
+/*
+ * VHC Universal Remote - Remote Simulator
+ * Stands in for the remote on a pseudo terminal, for testing host tools
+ * without hardware.
+ *
+ * Runs the firmware itself: the unchanged sketch on the host HAL (host/)
+ * with its virtual clock paced to wall time, and the pty as its USB
+ * serial port. Frames go through the real host link, send queue and
+ * device upload (parsed by the IRDB parser, written to the fake card by
+ * the background task), and console text and event log bytes come out
+ * between them as they do from the remote. Each IR frame blocks for
+ * --send-ms and the card writes at --sd-kbps, so a slow card fills the
+ * upload buffer and the PROTO_BUSY path gets exercised. Boot runs at
+ * full speed; then the pty path to connect to is printed and the
+ * simulator runs until interrupted.
+ *
+ * Built by the host build from the repository root:
+ *   cmake -S . -B build && cmake --build build --target remote_sim
+ *   ./build/remote_sim --send-ms 70 --devices TV,Soundbar
+ * Options:
+ *   --send-ms N    time one IR frame takes (70, about an NEC frame and gap)
+ *   --devices A,B  devices on the card, each with the standard functions (TV)
+ *   --sd DIR       the CSV files in DIR on the card instead
+ *   --sd-kbps N    simulated SD write speed in KB/s (200)
+ * The queue size and upload buffer are the firmware's (HOST_QUEUE_SIZE,
+ * UPLOAD_BUFFER_BYTES).
+ */
+
+#define _XOPEN_SOURCE 600
+#include <Arduino.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <time.h>
+#include <string>
+#include "hal_host.h"
+#include "menu.h"
+
+void setup();
+void loop();
+
+// NEC codes for the functions remote_bench and the UI use
+static const char* DEVICE_TEMPLATE =
+  "POWER,0,4,-1,8\n"
+  "VOLUME+,0,4,-1,2\n"
+  "VOLUME-,0,4,-1,3\n"
+  "CHANNEL+,0,4,-1,0\n"
+  "CHANNEL-,0,4,-1,1\n"
+  "MUTE,0,4,-1,9\n"
+  "INPUT,0,4,-1,11\n";
+
+static long nowMs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000L + ts.tv_nsec / 1000000;
+}
+
+static void addDevice(const char* name) {
+  // Spaces in device names are underscores in file names
+  std::string path = std::string("/") + name + ".csv";
+  for (size_t i = 0; i < path.size(); i++) {
+    if (path[i] == ' ') path[i] = '_';
+  }
+  hostSD.addFile(path.c_str(), DEVICE_TEMPLATE);
+}
+
+int main(int argc, char** argv) {
+  int sendMs = 70;
+  int sdKBps = 200;
+  const char* devices = "TV";
+  const char* sdDir = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--send-ms") == 0 && i + 1 < argc) {
+      sendMs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--sd-kbps") == 0 && i + 1 < argc) {
+      sdKBps = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--devices") == 0 && i + 1 < argc) {
+      devices = argv[++i];
+    } else if (strcmp(argv[i], "--sd") == 0 && i + 1 < argc) {
+      sdDir = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--send-ms N] [--devices A,B | --sd DIR] [--sd-kbps N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (sdDir) {
+    if (hostSD.loadDirectory(sdDir, ".csv") < 0) {
+      fprintf(stderr, "Cannot read %s\n", sdDir);
+      return 1;
+    }
+  } else {
+    std::string list = devices;
+    for (size_t start = 0; start <= list.size();) {
+      size_t end = list.find(',', start);
+      if (end == std::string::npos) end = list.size();
+      if (end > start) addDevice(list.substr(start, end - start).c_str());
+      start = end + 1;
+    }
+  }
+  hostIR.setFrameTime(sendMs * 1000);
+  hostSD.setWriteSpeed(sdKBps);
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("pty");
+    return 1;
+  }
+  termios tio;
+  tcgetattr(master, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(master, TCSANOW, &tio);
+  // Output nobody reads yet is dropped rather than blocking the remote
+  fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+  // Boot and the splash at full speed, its output discarded
+  setup();
+  while (menu.getCurrentScreen() == SCREEN_SPLASH) {
+    loop();
+  }
+  Serial.clearOutput();
+
+  printf("%s\n", ptsname(master));
+  fflush(stdout);
+
+  long wallStart = nowMs();
+  uint32_t virtualStart = hostClock.millis();
+
+  while (true) {
+    // Wait while the remote is ahead of wall time, or for host bytes
+    long ahead = (long)(hostClock.millis() - virtualStart) - (nowMs() - wallStart);
+    pollfd p = {master, POLLIN, 0};
+    if (poll(&p, 1, ahead > 0 ? (int)ahead : 0) > 0) {
+      uint8_t buf[512];
+      ssize_t n = read(master, buf, sizeof(buf));
+      if (n > 0) {
+        Serial.inject(buf, n);
+      } else if (n < 0 && errno != EAGAIN) {
+        // No client attached yet (or it went away)
+        usleep(100000);
+      }
+    }
+
+    loop();
+
+    const std::string& out = Serial.getOutput();
+    if (!out.empty()) {
+      if (write(master, out.data(), out.size()) < 0 && errno != EAGAIN) {
+        perror("write");
+      }
+      Serial.clearOutput();
+    }
+  }
+}
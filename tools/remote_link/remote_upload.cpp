@@ -0,0 +1,147 @@
+/*
+ * VHC Universal Remote - Device Upload
+ * Streams an IRDB CSV file to the remote as a new device, no SD swap.
+ *
+ * Sends the file in UPLOAD_DATA frames, one at a time, resending a
+ * chunk the remote refuses with PROTO_BUSY (its SD buffer is full), and
+ * the UPLOAD_BEGIN while an earlier upload is still being saved. The
+ * device name is the file name without .csv, as when loaded from SD.
+ * Reports upload throughput, when the device became usable and when the
+ * file was saved on the card. Works against remote_sim as well:
+ *   ./remote_sim --sd-kbps 50 &        (prints the pty to use)
+ *   ./remote_upload /dev/pts/N Samsung_TV.csv
+ *
+ * Build from the repository root:
+ *   g++ -std=c++11 -O2 -I. tools/remote_link/remote_upload.cpp tools/remote_link/remote_link.cpp -o remote_upload
+ * Usage:
+ *   remote_upload <port> <file.csv> [--no-wait]   (--no-wait: skip waiting for the SD save)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "remote_link.h"
+
+#define REPLY_TIMEOUT_MS 2000
+#define SAVE_TIMEOUT_MS  30000
+#define BUSY_RETRY_US    5000
+
+static double nowMs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Waits for the ack of one frame; returns its result, -1 on timeout
+static int waitAck(RemoteLink& link, int seq) {
+  RemoteMessage message;
+  while (link.receive(message, REPLY_TIMEOUT_MS)) {
+    if (message.type == PROTO_ACK) {
+      ProtoAck ack = RemoteLink::parseAck(message);
+      if (ack.seq == seq) return ack.result;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <port> <file.csv> [--no-wait]\n", argv[0]);
+    return 2;
+  }
+  bool wait = !(argc > 3 && strcmp(argv[3], "--no-wait") == 0);
+  
+  FILE* in = fopen(argv[2], "rb");
+  if (!in) {
+    perror(argv[2]);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    data.insert(data.end(), buf, buf + n);
+  }
+  fclose(in);
+  
+  // Device name: base name without .csv
+  std::string name = argv[2];
+  size_t slash = name.rfind('/');
+  if (slash != std::string::npos) name = name.substr(slash + 1);
+  if (name.size() > 4 && name.compare(name.size() - 4, 4, ".csv") == 0) name.resize(name.size() - 4);
+  
+  RemoteLink link;
+  if (!link.open(argv[1])) {
+    perror(argv[1]);
+    return 1;
+  }
+  
+  double start = nowMs();
+  // Busy until an earlier upload is on the card
+  int result;
+  while ((result = waitAck(link, link.uploadBegin(name.c_str(), data.size()))) == PROTO_BUSY &&
+         nowMs() - start < SAVE_TIMEOUT_MS) {
+    usleep(BUSY_RETRY_US);
+  }
+  if (result != PROTO_OK) {
+    fprintf(stderr, "upload refused: %d\n", result);
+    return 1;
+  }
+  
+  long busy = 0;
+  for (size_t offset = 0; offset < data.size(); ) {
+    int chunk = (int)std::min(data.size() - offset, (size_t)PROTO_MAX_PAYLOAD);
+    result = waitAck(link, link.uploadData(&data[offset], chunk));
+    if (result == PROTO_BUSY || result == PROTO_BAD_FRAME) {
+      busy += (result == PROTO_BUSY);
+      usleep(BUSY_RETRY_US);
+      continue;
+    }
+    if (result != PROTO_OK) {
+      fprintf(stderr, "chunk at %zu failed: %d\n", offset, result);
+      return 1;
+    }
+    offset += chunk;
+  }
+  double sentMs = nowMs() - start;
+  
+  if (waitAck(link, link.uploadEnd()) != PROTO_OK) {
+    fprintf(stderr, "upload end not acknowledged\n");
+    return 1;
+  }
+  
+  // UPLOAD_DONE, then (later) UPLOAD_SAVED
+  RemoteMessage message;
+  bool haveDone = false;
+  bool haveSaved = false;
+  ProtoUploadDone done = {};
+  ProtoUploadSaved saved = {};
+  double deadline = nowMs() + SAVE_TIMEOUT_MS;
+  while (!(haveDone && (haveSaved || !wait)) && nowMs() < deadline && link.receive(message, SAVE_TIMEOUT_MS)) {
+    if (message.type == PROTO_UPLOAD_DONE) {
+      done = RemoteLink::parseUploadDone(message);
+      haveDone = true;
+    } else if (message.type == PROTO_UPLOAD_SAVED) {
+      saved = RemoteLink::parseUploadSaved(message);
+      haveSaved = true;
+    }
+  }
+  if (!haveDone) {
+    fprintf(stderr, "no upload result\n");
+    return 1;
+  }
+  
+  printf("device \"%s\": result %d, %d commands\n", name.c_str(), done.result, done.commands);
+  printf("sent %zu bytes in %.1f ms: %.1f KB/s (%ld busy retries)\n",
+         data.size(), sentMs, sentMs > 0 ? data.size() / sentMs * 1000.0 / 1024.0 : 0.0, busy);
+  printf("usable after %u ms, remote saw the upload take %u ms\n", done.usableMs, done.elapsedMs);
+  if (haveSaved) {
+    printf("saved to SD after %u ms: result %d\n", saved.savedMs, saved.result);
+  }
+  return (done.result == PROTO_OK && (!haveSaved || saved.result == PROTO_OK)) ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * VHC Universal Remote - Host Render Benchmark
+ * Runs the firmware's render benchmark (render_bench.cpp) on the host
+ * build, without a remote.
+ *
+ * The screens are drawn by the unchanged Display code into the host
+ * panel, and ShadowGFX counts SPI transactions, address windows and
+ * pixels as on the Teensy; times are virtual, from the modelled bus. The
+ * baseline (render.csv) and a golden PPM per screen are read from a
+ * directory, normally the committed tests/golden, and copied to /bench
+ * on the fake card, where the benchmark looks for them. Exits non-zero
+ * if a screen's counts grew by more than RENDER_REGRESSION_PCT or its
+ * pixels differ from the golden.
+ *
+ * Built by the host build from the repository root:
+ *   cmake -S . -B build && cmake --build build --target render_bench
+ *   ./build/render_bench --golden tests/golden
+ * Options:
+ *   --golden DIR   compare with the baseline and goldens in DIR
+ *   --save DIR     write this run's baseline and PPMs to DIR; with
+ *                  --golden tests/golden --save tests/golden, an
+ *                  intended drawing change becomes the new golden
+ */
+
+#include <Arduino.h>
+#include "hal_host.h"
+#include "render_bench.h"
+
+void setup();
+
+int main(int argc, char** argv) {
+  const char* goldenDir = nullptr;
+  const char* saveDir = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+      goldenDir = argv[++i];
+    } else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+      saveDir = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--golden DIR] [--save DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!goldenDir && !saveDir) {
+    fprintf(stderr, "Nothing to do: give --golden DIR, --save DIR or both\n");
+    return 2;
+  }
+
+  // Boot for the display, its output discarded
+  setup();
+  Serial.clearOutput();
+  Serial.setEcho(true);
+
+  bool passed = true;
+  if (goldenDir) {
+    if (hostSD.loadDirectory(goldenDir, ".csv", "/bench") < 1 ||
+        hostSD.loadDirectory(goldenDir, ".ppm", "/bench") < 1) {
+      fprintf(stderr, "No baseline or goldens in %s\n", goldenDir);
+      return 1;
+    }
+    passed = renderBench.run(false);
+  }
+
+  if (saveDir) {
+    if (!renderBench.run(true) || hostSD.saveDirectory("/bench", saveDir) < 0) {
+      fprintf(stderr, "Cannot save to %s\n", saveDir);
+      return 1;
+    }
+    printf("Saved to %s\n", saveDir);
+  }
+  return passed ? 0 : 1;
+}
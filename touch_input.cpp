@@ -3,18 +3,29 @@
  */
 
 #include "touch_input.h"
-#include <EEPROM.h>
+#include <SPI.h>
+#include "profiler.h"
+#include "kv_store.h"
+#include "event_log.h"
+#include "loop_watchdog.h"
 
 // Global touch input instance
 TouchInput touchInput;
 
-// EEPROM addresses for calibration data
-#define CAL_FLAG_ADDR 0
-#define CAL_MINX_ADDR 1
-#define CAL_MAXX_ADDR 3
-#define CAL_MINY_ADDR 5
-#define CAL_MAXY_ADDR 7
-#define CAL_FLAG_VALUE 0xAB
+// Calibration record in the key/value store
+struct Calibration {
+  int16_t minX, maxX;
+  int16_t minY, maxY;
+};
+
+static int median3(const int v[3]) {
+  if (v[0] > v[1]) {
+    if (v[1] > v[2]) return v[1];
+    return (v[0] > v[2]) ? v[2] : v[0];
+  }
+  if (v[0] > v[2]) return v[0];
+  return (v[1] > v[2]) ? v[2] : v[1];
+}
 
 TouchInput::TouchInput() {
   ts = nullptr;
@@ -23,16 +34,36 @@ TouchInput::TouchInput() {
   calMaxX = TS_MAXX;
   calMinY = TS_MINY;
   calMaxY = TS_MAXY;
-  wasPressed = false;
-  touchStartTime = 0;
   lastX = 0;
   lastY = 0;
+  sampling = false;
+  pressed = false;
+  lightSamples = 0;
+  touchStartTime = 0;
+  pointTime = 0;
+  droppedEvents = 0;
+  medianIndex = 0;
+  filterX = 0;
+  filterY = 0;
+  gestureX = 0;
+  gestureY = 0;
+  nextHold = 0;
+  recording = false;
+  replaying = false;
+  for (int i = 0; i < 3; i++) {
+    medianX[i] = 0;
+    medianY[i] = 0;
+  }
 }
 
 void TouchInput::begin() {
-  ts = new XPT2046_Touchscreen(TOUCH_CS);
+  ts = hal.touch;
   ts->begin();
-  ts->setRotation(1); // Match display rotation
+  
+  // The sampler shares the SPI bus with the display, so keep its
+  // interrupt (and only that one) masked while a display transaction is open
+  SPI.usingInterrupt(ts->samplingIrq());
+  ts->attachPenInterrupt(penISR);
   
   // Try to load saved calibration
   loadCalibration();
@@ -52,44 +83,78 @@ void TouchInput::begin() {
 }
 
 bool TouchInput::isTouched() {
-  return ts->touched();
+  return pressed;
 }
 
 bool TouchInput::getTouchPoint(int& x, int& y) {
-  if (!ts->touched()) {
+  PROFILE_SCOPE(PROF_TOUCH_POINT);
+  
+  if (!pressed) {
     return false;
   }
   
-  TS_Point p = ts->getPoint();
+  toScreen(x, y);
   
-  // Map to screen coordinates
-  x = mapTouchX(p.x);
-  y = mapTouchY(p.y);
+  lastX = x;
+  lastY = y;
   
-  // Bounds checking
-  if (x < 0) x = 0;
-  if (x >= SCREEN_WIDTH) x = SCREEN_WIDTH - 1;
-  if (y < 0) y = 0;
-  if (y >= SCREEN_HEIGHT) y = SCREEN_HEIGHT - 1;
+  return true;
+}
+
+unsigned long TouchInput::getTouchTime() {
+  return pointTime;
+}
+
+bool TouchInput::getEvent(TouchRecord& event) {
+  WATCHDOG_STAGE(STAGE_TOUCH);
+  
+  if (!events.pop(event)) {
+    return false;
+  }
   
   #if DEBUG_TOUCH
-    Serial.print(F("Touch: Raw("));
-    Serial.print(p.x);
-    Serial.print(F(","));
-    Serial.print(p.y);
-    Serial.print(F(") Mapped("));
-    Serial.print(x);
-    Serial.print(F(","));
-    Serial.print(y);
-    Serial.println(F(")"));
+    LOG_EVENT(LOG_TOUCH_EVENT, event.type, event.x, event.y, hal.clock->millis() - event.time);
   #endif
   
-  lastX = x;
-  lastY = y;
-  
   return true;
 }
 
+void TouchInput::flushEvents() {
+  events.clear();
+}
+
+void TouchInput::setRecording(bool on) {
+  // Samples already queued stay readable after stopping
+  if (on) {
+    samples.clear();
+  }
+  recording = on;
+}
+
+bool TouchInput::getSample(TouchSample& sample) {
+  return samples.pop(sample);
+}
+
+void TouchInput::setReplay(bool on) {
+  // Drop any touch in progress so the replay starts from pen up
+  noInterrupts();
+  ts->stopSampling();
+  sampling = false;
+  replaying = on;
+  interrupts();
+  pressed = false;
+  lightSamples = 0;
+  events.clear();
+}
+
+void TouchInput::injectSample(const RawTouch& raw, unsigned long now) {
+  // Runs in the loop; the sampler is stopped while replaying, so the
+  // loop is the only producer
+  if (replaying) {
+    process(raw, now);
+  }
+}
+
 void TouchInput::setCalibration(int minX, int maxX, int minY, int maxY) {
   calMinX = minX;
   calMaxX = maxX;
@@ -107,24 +172,20 @@ void TouchInput::startCalibration() {
   calibrated = false;
 }
 
-bool TouchInput::calibratePoint(int screenX, int screenY, int& rawX, int& rawY) {
-  if (!ts->touched()) {
+bool TouchInput::calibratePoint(int, int, int& rawX, int& rawY) {
+  if (!pressed) {
     return false;
   }
   
-  TS_Point p = ts->getPoint();
-  rawX = p.x;
-  rawY = p.y;
+  rawX = filterX >> 4;
+  rawY = filterY >> 4;
   
   return true;
 }
 
 void TouchInput::saveCalibration() {
-  EEPROM.write(CAL_FLAG_ADDR, CAL_FLAG_VALUE);
-  EEPROM.put(CAL_MINX_ADDR, calMinX);
-  EEPROM.put(CAL_MAXX_ADDR, calMaxX);
-  EEPROM.put(CAL_MINY_ADDR, calMinY);
-  EEPROM.put(CAL_MAXY_ADDR, calMaxY);
+  Calibration cal = {(int16_t)calMinX, (int16_t)calMaxX, (int16_t)calMinY, (int16_t)calMaxY};
+  kvStore.set(KV_CALIBRATION, &cal, sizeof(cal));
   
   #if DEBUG_SERIAL
     Serial.println(F("Calibration saved to EEPROM"));
@@ -132,11 +193,12 @@ void TouchInput::saveCalibration() {
 }
 
 void TouchInput::loadCalibration() {
-  if (EEPROM.read(CAL_FLAG_ADDR) == CAL_FLAG_VALUE) {
-    EEPROM.get(CAL_MINX_ADDR, calMinX);
-    EEPROM.get(CAL_MAXX_ADDR, calMaxX);
-    EEPROM.get(CAL_MINY_ADDR, calMinY);
-    EEPROM.get(CAL_MAXY_ADDR, calMaxY);
+  Calibration cal;
+  if (kvStore.get(KV_CALIBRATION, &cal, sizeof(cal))) {
+    calMinX = cal.minX;
+    calMaxX = cal.maxX;
+    calMinY = cal.minY;
+    calMaxY = cal.maxY;
     calibrated = true;
     
     #if DEBUG_SERIAL
@@ -150,8 +212,8 @@ void TouchInput::loadCalibration() {
 }
 
 unsigned long TouchInput::getTouchDuration() {
-  if (wasPressed && touchStartTime > 0) {
-    return millis() - touchStartTime;
+  if (pressed) {
+    return hal.clock->millis() - touchStartTime;
   }
   return 0;
 }
@@ -161,17 +223,145 @@ bool TouchInput::isLongPress() {
 }
 
 void TouchInput::update() {
-  bool currentlyPressed = isTouched();
+  WATCHDOG_STAGE(STAGE_TOUCH);
   
-  if (currentlyPressed && !wasPressed) {
-    // New touch
-    touchStartTime = millis();
-  } else if (!currentlyPressed && wasPressed) {
-    // Touch released
-    touchStartTime = 0;
+  #if DEBUG_TOUCH
+    static uint32_t reportedDrops = 0;
+    if (droppedEvents != reportedDrops) {
+      reportedDrops = droppedEvents;
+      LOG_EVENT(LOG_TOUCH_DROPPED, reportedDrops);
+    }
+  #endif
+}
+
+void TouchInput::penISR() {
+  // Conversions toggle the pen line too; ignore it while sampling
+  if (!touchInput.sampling && !touchInput.replaying) {
+    touchInput.sampling = true;
+    touchInput.lightSamples = 0;
+    touchInput.ts->startSampling(sampleISR, TOUCH_SAMPLE_US);
   }
+}
+
+void TouchInput::sampleISR() {
+  touchInput.sample();
+}
+
+void TouchInput::sample() {
+  RawTouch p = ts->read();
+  unsigned long now = hal.clock->millis();
   
-  wasPressed = currentlyPressed;
+  if (recording) {
+    TouchSample raw = {(uint16_t)p.x, (uint16_t)p.y, (uint16_t)p.z, (uint32_t)now};
+    samples.push(raw);
+  }
+  
+  #if DEBUG_TOUCH
+    // Straight from the sampling interrupt; the log is safe here
+    LOG_EVENT(LOG_TOUCH_SAMPLE, p.x, p.y, p.z);
+  #endif
+  
+  process(p, now);
+}
+
+void TouchInput::process(const RawTouch& p, unsigned long now) {
+  if (p.z < TOUCH_PRESSURE_MIN) {
+    if (++lightSamples >= TOUCH_RELEASE_COUNT) {
+      // Pen lifted: stop until the next pen interrupt
+      ts->stopSampling();
+      sampling = false;
+      if (pressed) {
+        pressed = false;
+        queueEvent(TOUCH_RELEASE, now);
+      }
+    }
+    return;
+  }
+  lightSamples = 0;
+  
+  if (!pressed) {
+    // First contact: seed the filters so a tap lands where it was pressed
+    for (int i = 0; i < 3; i++) {
+      medianX[i] = p.x;
+      medianY[i] = p.y;
+    }
+    filterX = p.x << 4;
+    filterY = p.y << 4;
+  } else {
+    // Median removes single-sample spikes, the IIR smooths the jitter
+    medianX[medianIndex] = p.x;
+    medianY[medianIndex] = p.y;
+    medianIndex = (medianIndex + 1) % 3;
+    filterX += ((median3(medianX) << 4) - filterX) >> TOUCH_FILTER_SHIFT;
+    filterY += ((median3(medianY) << 4) - filterY) >> TOUCH_FILTER_SHIFT;
+  }
+  pointTime = now;
+  
+  recognize(now);
+}
+
+void TouchInput::recognize(unsigned long now) {
+  int x, y;
+  toScreen(x, y);
+  
+  if (!pressed) {
+    pressed = true;
+    touchStartTime = now;
+    nextHold = now + REPEAT_DELAY;
+    gestureX = x;
+    gestureY = y;
+    queueEvent(TOUCH_TAP, now);
+    return;
+  }
+  
+  // Movement first, then hold-to-repeat
+  if (abs(x - gestureX) >= LIST_DRAG_START / 2 || abs(y - gestureY) >= LIST_DRAG_START / 2) {
+    // A drag that doesn't fit is folded into the next one
+    if (queueEvent(TOUCH_DRAG, now)) {
+      gestureX = x;
+      gestureY = y;
+    }
+  } else if ((long)(now - nextHold) >= 0) {
+    nextHold += REPEAT_DELAY;
+    queueEvent(TOUCH_HOLD, now);
+  }
+}
+
+bool TouchInput::queueEvent(TouchEvent type, unsigned long now) {
+  // Drags and holds leave headroom so taps and releases always fit
+  uint16_t used = events.count();
+  if (type == TOUCH_DRAG && used >= TOUCH_QUEUE_SIZE - 8) {
+    return false;
+  }
+  if (type == TOUCH_HOLD && used >= TOUCH_QUEUE_SIZE - 4) {
+    droppedEvents++;
+    return false;
+  }
+  
+  TouchRecord event;
+  event.type = type;
+  int x, y;
+  toScreen(x, y);
+  event.x = x;
+  event.y = y;
+  event.time = now;
+  if (!events.push(event)) {
+    droppedEvents++;
+    return false;
+  }
+  return true;
+}
+
+void TouchInput::toScreen(int& x, int& y) {
+  // Map the filtered point to screen coordinates
+  x = mapTouchX(filterX >> 4);
+  y = mapTouchY(filterY >> 4);
+  
+  // Bounds checking
+  if (x < 0) x = 0;
+  if (x >= SCREEN_WIDTH) x = SCREEN_WIDTH - 1;
+  if (y < 0) y = 0;
+  if (y >= SCREEN_HEIGHT) y = SCREEN_HEIGHT - 1;
 }
 
 int TouchInput::mapTouchX(int raw) {
@@ -1,18 +1,47 @@
 /*
  * VHC Universal Remote - Touch Input Handler
  * Manages touchscreen calibration and input processing
+ *
+ * The XPT2046 is only read while the pen is down: its IRQ line starts a
+ * timer that samples at TOUCH_SAMPLE_US. Each sample is filtered (3-tap
+ * median, then IIR) and run through the gesture recognizer inside the
+ * interrupt, which queues timestamped TAP/HOLD/DRAG/RELEASE events. The
+ * main loop drains the queue in order, so slow redraws or IR sends never
+ * drop or merge a touch, and it never touches SPI itself.
  */
 
 #ifndef TOUCH_INPUT_H
 #define TOUCH_INPUT_H
 
 #include <Arduino.h>
-#include <XPT2046_Touchscreen.h>
 #include "config.h"
+#include "hal.h"
+#include "ring_buffer.h"
+
+// Touch event types
+enum TouchEvent {
+  TOUCH_NONE,
+  TOUCH_TAP,      // Pen down
+  TOUCH_HOLD,     // Every REPEAT_DELAY while held still
+  TOUCH_DRAG,     // Moved since the last TAP/DRAG
+  TOUCH_RELEASE   // Pen up
+};
+
+struct TouchRecord {
+  TouchEvent type;
+  int16_t x, y;   // Screen coordinates when the event was recognized
+  uint32_t time;  // millis() of the sample that produced it
+};
+
+// Raw controller sample, as read by the sampler
+struct TouchSample {
+  uint16_t x, y, z;
+  uint32_t time;
+};
 
 class TouchInput {
 private:
-  XPT2046_Touchscreen* ts;
+  TouchPanel* ts;
   bool calibrated;
   
   // Calibration values
@@ -20,10 +49,32 @@ private:
   int calMinY, calMaxY;
   
   // Touch state
-  bool wasPressed;
-  unsigned long touchStartTime;
   int lastX, lastY;
   
+  // Sampling (written by the sampling interrupt)
+  volatile bool sampling;
+  volatile bool pressed;
+  volatile uint8_t lightSamples;
+  volatile unsigned long touchStartTime;
+  volatile unsigned long pointTime;
+  volatile uint32_t droppedEvents;
+  
+  // Filter state
+  int medianX[3], medianY[3];
+  int medianIndex;
+  volatile int filterX, filterY;  // Raw coordinates scaled by 16
+  
+  // Gesture recognizer state
+  int gestureX, gestureY;  // Point of the last TAP or DRAG
+  unsigned long nextHold;
+  
+  RingBuffer<TouchRecord, TOUCH_QUEUE_SIZE> events;
+  
+  // Raw samples for trace recording
+  RingBuffer<TouchSample, TOUCH_QUEUE_SIZE> samples;
+  volatile bool recording;
+  bool replaying;
+  
 public:
   TouchInput();
   void begin();
@@ -31,6 +82,17 @@ public:
   // Touch detection
   bool isTouched();
   bool getTouchPoint(int& x, int& y);
+  unsigned long getTouchTime();  // millis() of the latest filtered sample
+  
+  // Event queue, oldest first
+  bool getEvent(TouchRecord& event);
+  void flushEvents();
+  
+  // Trace record/replay (touch_trace.h)
+  void setRecording(bool on);
+  bool getSample(TouchSample& sample);
+  void setReplay(bool on);  // Ignore the pen while replaying
+  void injectSample(const RawTouch& raw, unsigned long now);
   
   // Calibration
   void setCalibration(int minX, int maxX, int minY, int maxY);
@@ -45,6 +107,14 @@ public:
   void update(); // Call in main loop
   
 private:
+  static void penISR();
+  static void sampleISR();
+  void sample();
+  void process(const RawTouch& p, unsigned long now);
+  void recognize(unsigned long now);
+  bool queueEvent(TouchEvent type, unsigned long now);
+  void toScreen(int& x, int& y);
+
   int mapTouchX(int raw);
   int mapTouchY(int raw);
 };
@@ -0,0 +1,200 @@
+/*
+ * VHC Universal Remote - Touch Trace Implementation
+ */
+
+#include "touch_trace.h"
+#include "hal.h"
+#include "ir_handler.h"
+#include "sd_manager.h"
+#include "loop_watchdog.h"
+
+// Global touch trace instance
+TouchTrace touchTrace;
+
+// Stands in for the IR LED during replays
+class MutedIR : public IROutput {
+public:
+  void begin() override {}
+  void sendNEC(uint32_t, int) override {}
+  void sendSony(uint32_t, int) override {}
+  void sendRC5(uint32_t, int) override {}
+  void sendRC6(uint32_t, int) override {}
+  void sendPanasonic(uint16_t, uint32_t) override {}
+  void sendJVC(uint32_t, int, bool) override {}
+};
+
+static MutedIR mutedIR;
+static IROutput* savedOutput = nullptr;
+
+TouchTrace::TouchTrace() {
+  mode = TRACE_IDLE;
+  toSerial = false;
+  firstSample = 0;
+  sampleCount = 0;
+  haveNext = false;
+  replayStart = 0;
+  lastInjected = 0;
+  irSends = 0;
+}
+
+bool TouchTrace::startRecording(const char* name) {
+  stop();
+  
+  toSerial = (name == nullptr || *name == '\0');
+  if (!toSerial) {
+    char path[48];
+    snprintf(path, sizeof(path), "/trace/%s.csv", name);
+    hal.storage->fs().mkdir("/trace");
+    hal.storage->fs().remove(path);
+    file = hal.storage->fs().open(path, FILE_WRITE);
+    if (!file) return false;
+  }
+  
+  sampleCount = 0;
+  mode = TRACE_RECORDING;
+  touchInput.setRecording(true);
+  return true;
+}
+
+bool TouchTrace::startReplay(const char* name) {
+  stop();
+  
+  char path[48];
+  snprintf(path, sizeof(path), "/trace/%s.csv", name);
+  file = hal.storage->fs().open(path);
+  if (!file) return false;
+  
+  haveNext = readSample(next);
+  if (!haveNext) {
+    file.close();
+    return false;
+  }
+  
+  irSends = 0;
+  sampleCount = 0;
+  irLatency.reset();
+  frameLatency.reset();
+  savedOutput = irHandler.setOutput(&mutedIR);
+  touchInput.setReplay(true);
+  
+  replayStart = hal.clock->millis();
+  lastInjected = replayStart;
+  mode = TRACE_REPLAYING;
+  Serial.println(F("TRACE,replay,start"));
+  return true;
+}
+
+void TouchTrace::stop() {
+  if (mode == TRACE_RECORDING) {
+    touchInput.setRecording(false);
+    update();  // Write what was already sampled
+    if (!toSerial) {
+      file.close();
+    }
+    mode = TRACE_IDLE;
+    Serial.print(F("TRACE,recorded,"));
+    Serial.println(sampleCount);
+  } else if (mode == TRACE_REPLAYING) {
+    finishReplay();
+  }
+}
+
+void TouchTrace::update() {
+  WATCHDOG_STAGE(STAGE_TOUCH);
+  
+  if (mode == TRACE_RECORDING) {
+    TouchSample sample;
+    while (touchInput.getSample(sample)) {
+      if (sampleCount == 0) {
+        firstSample = sample.time;
+      }
+      sampleCount++;
+      
+      Print& out = toSerial ? (Print&)Serial : (Print&)file;
+      if (toSerial) {
+        out.print(F("TRACE,"));
+      }
+      out.print(sample.time - firstSample);
+      out.print(',');
+      out.print(sample.x);
+      out.print(',');
+      out.print(sample.y);
+      out.print(',');
+      out.println(sample.z);
+    }
+  } else if (mode == TRACE_REPLAYING) {
+    // Feed every sample that is due, at its recorded offset
+    uint32_t now = hal.clock->millis();
+    while (haveNext && now - replayStart >= next.time) {
+      RawTouch raw = {(int16_t)next.x, (int16_t)next.y, (int16_t)next.z};
+      touchInput.injectSample(raw, now);
+      sampleCount++;
+      lastInjected = now;
+      haveNext = readSample(next);
+    }
+    
+    // Let the last sends and redraws finish before reporting
+    if (!haveNext && now - lastInjected >= TRACE_SETTLE_MS) {
+      finishReplay();
+    }
+  }
+}
+
+void TouchTrace::noteIR(IRFunction function, uint32_t latency) {
+  if (mode != TRACE_REPLAYING) return;
+  
+  irSends++;
+  irLatency.add(latency);
+  Serial.print(F("TRACE,ir,"));
+  Serial.print(hal.clock->millis() - replayStart);
+  Serial.print(',');
+  Serial.print(getFunctionName(function));
+  Serial.print(',');
+  Serial.println(latency);
+}
+
+void TouchTrace::noteFrame(uint32_t latency) {
+  if (mode != TRACE_REPLAYING) return;
+  
+  frameLatency.add(latency);
+}
+
+void TouchTrace::printReport() {
+  Serial.print(F("TRACE,samples,"));
+  Serial.println(sampleCount);
+  Serial.print(F("TRACE,ir_sends,"));
+  Serial.println(irSends);
+  irLatency.print("Replay touch to IR");
+  frameLatency.print("Replay touch to frame");
+}
+
+bool TouchTrace::readSample(TouchSample& sample) {
+  char line[48];
+  while (file.available()) {
+    if (SDManager::readLine(file, line, sizeof(line)) == 0) continue;
+    
+    char* fields[4];
+    fields[0] = strtok(line, ",");
+    for (int i = 1; i < 4; i++) {
+      fields[i] = strtok(NULL, ",");
+    }
+    if (!fields[3]) continue;
+    
+    sample.time = strtoul(fields[0], NULL, 10);
+    sample.x = atoi(fields[1]);
+    sample.y = atoi(fields[2]);
+    sample.z = atoi(fields[3]);
+    return true;
+  }
+  return false;
+}
+
+void TouchTrace::finishReplay() {
+  file.close();
+  touchInput.setReplay(false);
+  irHandler.setOutput(savedOutput);
+  mode = TRACE_IDLE;
+  
+  Serial.println(F("TRACE,replay,done"));
+  printReport();
+}
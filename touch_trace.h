@@ -0,0 +1,71 @@
+/*
+ * VHC Universal Remote - Touch Trace
+ * Records raw touch samples and replays them with latency reports
+ */
+
+#ifndef TOUCH_TRACE_H
+#define TOUCH_TRACE_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+#include "histogram.h"
+#include "ir_function.h"
+#include "touch_input.h"
+
+// Recording logs every raw sample the touch sampler reads (including the
+// light ones that end a touch) as "ms,x,y,z" lines, to /trace/<name>.csv
+// or to Serial as TRACE lines. Replay stops the pen interrupt and feeds
+// the samples back through TouchInput's filter and gesture recognizer at
+// their recorded times, so the events go through the menu, IR sends and
+// redraws as if touched. IR is muted during a replay; each send is listed
+// instead, so a replay's output can be compared with an earlier run. The
+// report gives touch-to-IR and touch-to-frame percentiles. A replay acts
+// on whatever screen is showing, so start it where the trace began.
+class TouchTrace {
+private:
+  enum Mode {
+    TRACE_IDLE,
+    TRACE_RECORDING,
+    TRACE_REPLAYING
+  };
+  Mode mode;
+  File file;
+  bool toSerial;
+  uint32_t firstSample;     // Recording: time of the first sample
+  uint32_t sampleCount;
+  
+  // Replay state
+  TouchSample next;
+  bool haveNext;
+  uint32_t replayStart;
+  uint32_t lastInjected;
+  uint32_t irSends;
+  Histogram irLatency;      // Touch to first IR frame
+  Histogram frameLatency;   // Touch to frame complete
+  
+public:
+  TouchTrace();
+  
+  // An empty name records to Serial
+  bool startRecording(const char* name);
+  bool startReplay(const char* name);
+  void stop();
+  bool isReplaying() { return mode == TRACE_REPLAYING; }
+  
+  void update(); // Call in main loop
+  
+  // Hooks on the send and redraw paths, counted while replaying
+  void noteIR(IRFunction function, uint32_t latency);
+  void noteFrame(uint32_t latency);
+  void printReport();
+  
+private:
+  bool readSample(TouchSample& sample);
+  void finishReplay();
+};
+
+// Global touch trace instance
+extern TouchTrace touchTrace;
+
+#endif // TOUCH_TRACE_H
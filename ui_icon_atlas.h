@@ -0,0 +1,229 @@
+/*
+ * VHC Universal Remote - UI Icon Atlas
+ * Run-length encoded 1-bit icons rasterized from ui_icons.h
+ *
+ * GENERATED by tools/icon_atlas/icon_atlas_gen.cpp - do not edit by hand.
+ * Each entry blits in one address window, one color run per byte.
+ */
+
+#ifndef UI_ICON_ATLAS_H
+#define UI_ICON_ATLAS_H
+
+#include <Arduino.h>
+
+enum IconId {
+  ICON_POWER,
+  ICON_VOLUME_UP,
+  ICON_VOLUME_DOWN,
+  ICON_CHANNEL_UP,
+  ICON_CHANNEL_DOWN,
+  ICON_INPUT,
+  ICON_MENU,
+  ICON_BACK,
+  ICON_OK,
+  ICON_MUTE,
+  ICON_SETTINGS,
+  ICON_PLAY,
+  ICON_PAUSE,
+  ICON_STOP,
+  ICON_TV,
+  ICON_AUDIO,
+  ICON_DISC,
+  ICON_COUNT
+};
+
+enum IconSize {
+  ICON_SIZE_16,
+  ICON_SIZE_24,
+  ICON_SIZE_32,
+  ICON_SIZE_COUNT
+};
+
+struct IconAtlasEntry {
+  uint16_t offset; // First run in ICON_ATLAS_RLE
+  uint16_t length; // Number of run bytes
+  uint8_t width;
+  uint8_t height;
+};
+
+// Runs alternate background/foreground, starting with background
+const uint8_t ICON_ATLAS_RLE[2491] PROGMEM = {
+  6, 5, 10, 2, 1, 3, 1, 2, 7, 1, 3, 3, 3, 1, 5, 1, 
+  4, 3, 4, 1, 3, 1, 5, 3, 5, 1, 2, 1, 5, 3, 5, 1, 
+  1, 1, 6, 3, 6, 2, 6, 3, 6, 2, 6, 3, 6, 2, 15, 2, 
+  15, 1, 1, 1, 13, 1, 2, 1, 13, 1, 3, 1, 11, 1, 5, 1, 
+  9, 1, 7, 2, 5, 2, 10, 5, 6, 9, 7, 16, 2, 2, 3, 2, 
+  2, 12, 2, 4, 3, 4, 2, 9, 1, 6, 3, 6, 1, 7, 1, 7, 
+  3, 7, 1, 5, 1, 8, 3, 8, 1, 4, 1, 8, 3, 8, 1, 3, 
+  1, 9, 3, 9, 1, 2, 1, 9, 3, 9, 1, 1, 1, 10, 3, 10, 
+  2, 10, 3, 10, 2, 10, 3, 10, 2, 10, 3, 10, 2, 23, 2, 23, 
+  2, 23, 1, 1, 1, 21, 1, 2, 1, 21, 1, 3, 1, 19, 1, 4, 
+  1, 19, 1, 5, 1, 17, 1, 7, 1, 15, 1, 9, 2, 11, 2, 12, 
+  2, 7, 2, 16, 7, 9, 13, 7, 23, 3, 2, 3, 2, 3, 18, 2, 
+  5, 3, 5, 2, 15, 1, 7, 3, 7, 1, 12, 2, 8, 3, 8, 2, 
+  9, 1, 10, 3, 10, 1, 8, 1, 10, 3, 10, 1, 7, 1, 11, 3, 
+  11, 1, 5, 1, 12, 3, 12, 1, 4, 1, 12, 3, 12, 1, 3, 1, 
+  13, 3, 13, 1, 2, 1, 13, 3, 13, 1, 2, 1, 13, 3, 13, 1, 
+  1, 1, 14, 3, 14, 2, 14, 3, 14, 2, 14, 3, 14, 2, 14, 3, 
+  14, 2, 31, 2, 31, 2, 31, 1, 1, 1, 29, 1, 2, 1, 29, 1, 
+  2, 1, 29, 1, 3, 1, 27, 1, 4, 1, 27, 1, 5, 1, 25, 1, 
+  7, 1, 23, 1, 8, 1, 23, 1, 9, 2, 19, 2, 12, 1, 17, 1, 
+  15, 2, 13, 2, 18, 3, 7, 3, 23, 7, 13, 48, 1, 16, 1, 12, 
+  1, 1, 6, 4, 2, 1, 2, 4, 1, 2, 2, 3, 2, 7, 1, 2, 
+  4, 1, 2, 10, 7, 1, 5, 4, 4, 1, 2, 10, 1, 7, 1, 17, 
+  1, 17, 1, 74, 96, 1, 24, 1, 24, 1, 19, 1, 1, 7, 14, 2, 
+  5, 1, 3, 1, 7, 6, 7, 1, 3, 3, 5, 4, 9, 1, 3, 5, 
+  3, 4, 13, 7, 1, 4, 13, 19, 6, 7, 1, 4, 13, 5, 3, 4, 
+  13, 3, 5, 4, 13, 1, 11, 2, 25, 2, 25, 1, 158, 160, 1, 32, 
+  1, 32, 1, 32, 1, 24, 2, 2, 9, 18, 2, 8, 1, 4, 1, 9, 
+  5, 1, 2, 10, 1, 4, 2, 8, 5, 13, 1, 4, 4, 6, 5, 13, 
+  1, 4, 6, 4, 5, 18, 7, 3, 5, 18, 9, 1, 5, 18, 15, 1, 
+  9, 8, 9, 1, 5, 18, 7, 3, 5, 18, 5, 5, 5, 18, 3, 30, 
+  1, 15, 1, 33, 2, 33, 2, 33, 1, 255, 0, 20, 80, 6, 4, 2, 
+  10, 2, 3, 2, 10, 4, 1, 2, 10, 7, 1, 3, 6, 4, 1, 2, 
+  10, 1, 118, 168, 7, 25, 1, 7, 4, 13, 3, 5, 4, 13, 5, 3, 
+  4, 13, 7, 1, 4, 13, 17, 8, 7, 1, 4, 13, 5, 3, 4, 13, 
+  3, 5, 4, 13, 1, 224, 255, 0, 33, 9, 33, 1, 9, 5, 18, 2, 
+  8, 5, 18, 4, 6, 5, 18, 6, 4, 5, 18, 7, 3, 5, 18, 9, 
+  1, 5, 18, 15, 1, 6, 11, 9, 1, 5, 18, 7, 3, 5, 18, 5, 
+  5, 5, 18, 3, 30, 1, 255, 0, 140, 76, 1, 15, 3, 13, 5, 11, 
+  7, 9, 9, 7, 11, 9, 5, 12, 5, 12, 5, 12, 5, 57, 162, 1, 
+  23, 3, 21, 5, 19, 7, 17, 9, 15, 11, 13, 13, 11, 15, 9, 17, 
+  12, 8, 17, 8, 17, 8, 17, 8, 17, 8, 17, 8, 17, 8, 84, 255, 
+  0, 25, 1, 31, 3, 29, 5, 27, 7, 25, 9, 23, 11, 21, 13, 19, 
+  15, 17, 17, 15, 19, 13, 21, 17, 10, 23, 10, 23, 10, 23, 10, 23, 
+  10, 23, 10, 23, 10, 23, 10, 23, 10, 177, 74, 5, 12, 5, 12, 5, 
+  9, 11, 7, 9, 9, 7, 11, 5, 13, 3, 15, 1, 76, 158, 8, 17, 
+  8, 17, 8, 17, 8, 13, 17, 9, 15, 11, 13, 13, 11, 15, 9, 17, 
+  7, 19, 5, 21, 3, 23, 1, 162, 255, 0, 20, 10, 23, 10, 23, 10, 
+  23, 10, 23, 10, 23, 10, 18, 21, 13, 19, 15, 17, 17, 15, 19, 13, 
+  21, 11, 23, 9, 25, 7, 27, 5, 29, 3, 31, 1, 255, 0, 25, 68, 
+  12, 5, 1, 10, 1, 5, 1, 10, 1, 2, 1, 2, 1, 10, 1, 3, 
+  1, 1, 1, 10, 7, 10, 1, 3, 1, 1, 1, 10, 1, 2, 1, 2, 
+  12, 90, 150, 18, 7, 1, 16, 1, 7, 1, 16, 1, 7, 1, 16, 1, 
+  3, 1, 3, 1, 16, 1, 4, 1, 2, 1, 16, 1, 5, 1, 1, 1, 
+  16, 9, 16, 1, 5, 1, 1, 1, 16, 1, 4, 1, 2, 1, 16, 1, 
+  3, 1, 3, 1, 16, 1, 7, 18, 182, 255, 0, 9, 24, 9, 1, 22, 
+  1, 9, 1, 22, 1, 9, 1, 22, 1, 9, 1, 22, 1, 4, 1, 4, 
+  1, 22, 1, 5, 1, 3, 1, 22, 1, 6, 1, 2, 1, 22, 1, 7, 
+  1, 1, 1, 22, 11, 22, 1, 7, 1, 1, 1, 22, 1, 6, 1, 2, 
+  1, 22, 1, 5, 1, 3, 1, 22, 1, 4, 1, 4, 1, 22, 1, 9, 
+  1, 22, 1, 9, 24, 255, 0, 51, 51, 16, 35, 16, 35, 16, 120, 100, 
+  24, 1, 24, 51, 24, 1, 24, 51, 24, 1, 24, 255, 0, 21, 198, 32, 
+  1, 32, 1, 32, 100, 32, 1, 32, 1, 32, 100, 32, 1, 32, 1, 32, 
+  255, 0, 142, 76, 1, 15, 2, 14, 10, 6, 11, 5, 12, 6, 11, 7, 
+  3, 15, 2, 16, 1, 76, 162, 1, 23, 2, 22, 3, 21, 15, 9, 16, 
+  8, 17, 7, 18, 8, 17, 9, 16, 10, 4, 22, 3, 23, 2, 24, 1, 
+  162, 255, 0, 25, 1, 31, 2, 30, 3, 29, 4, 28, 20, 12, 21, 11, 
+  22, 10, 23, 9, 24, 10, 23, 11, 22, 12, 21, 13, 5, 29, 4, 30, 
+  3, 31, 2, 32, 1, 255, 0, 25, 80, 1, 16, 1, 15, 2, 15, 1, 
+  9, 1, 5, 2, 9, 2, 4, 1, 11, 2, 2, 2, 12, 2, 1, 1, 
+  14, 3, 15, 1, 59, 168, 1, 24, 1, 23, 2, 23, 1, 23, 2, 23, 
+  1, 14, 1, 8, 2, 14, 2, 7, 1, 16, 2, 5, 2, 17, 2, 4, 
+  1, 19, 2, 2, 2, 20, 2, 1, 1, 22, 3, 23, 1, 137, 255, 0, 
+  33, 1, 32, 1, 31, 2, 31, 1, 31, 2, 31, 1, 31, 2, 31, 1, 
+  19, 1, 11, 2, 19, 2, 10, 1, 21, 2, 8, 2, 22, 2, 7, 1, 
+  24, 2, 5, 2, 25, 2, 4, 1, 27, 2, 2, 2, 28, 2, 1, 1, 
+  30, 3, 31, 1, 247, 85, 1, 4, 2, 1, 1, 3, 1, 4, 2, 3, 
+  2, 2, 1, 1, 1, 5, 4, 1, 2, 3, 1, 6, 7, 3, 1, 6, 
+  4, 1, 2, 2, 1, 1, 1, 5, 1, 7, 1, 3, 1, 106, 200, 1, 
+  7, 5, 5, 1, 6, 3, 5, 4, 1, 1, 3, 1, 7, 5, 3, 4, 
+  1, 1, 3, 1, 7, 7, 1, 4, 2, 1, 1, 1, 8, 12, 3, 1, 
+  9, 7, 1, 4, 2, 1, 1, 1, 8, 5, 3, 4, 2, 1, 1, 1, 
+  8, 3, 5, 4, 1, 1, 3, 1, 7, 1, 11, 1, 5, 1, 206, 255, 
+  0, 75, 1, 9, 5, 1, 1, 7, 1, 8, 2, 8, 5, 2, 1, 5, 
+  1, 9, 4, 6, 5, 2, 1, 5, 1, 9, 6, 4, 5, 3, 1, 3, 
+  1, 10, 7, 3, 5, 4, 1, 1, 1, 11, 9, 1, 5, 5, 1, 12, 
+  15, 5, 1, 12, 9, 1, 5, 4, 1, 1, 1, 11, 7, 3, 5, 3, 
+  1, 3, 1, 10, 5, 5, 5, 2, 1, 5, 1, 9, 3, 14, 1, 5, 
+  1, 9, 1, 15, 1, 7, 1, 255, 0, 116, 25, 1, 16, 1, 11, 1, 
+  4, 1, 3, 1, 8, 1, 6, 1, 29, 3, 8, 3, 2, 2, 1, 2, 
+  12, 1, 3, 1, 2, 3, 7, 2, 1, 2, 13, 3, 11, 1, 6, 1, 
+  8, 1, 8, 1, 12, 1, 16, 1, 15, 1, 26, 37, 1, 24, 1, 24, 
+  1, 16, 1, 7, 1, 6, 1, 10, 1, 12, 1, 12, 1, 10, 1, 43, 
+  3, 20, 7, 18, 2, 3, 2, 10, 4, 3, 2, 5, 2, 16, 2, 5, 
+  2, 3, 4, 9, 2, 5, 2, 17, 2, 3, 2, 18, 7, 20, 3, 17, 
+  1, 10, 1, 12, 1, 12, 1, 10, 1, 14, 1, 17, 1, 24, 1, 23, 
+  1, 24, 1, 38, 82, 1, 32, 1, 32, 1, 32, 1, 22, 1, 9, 1, 
+  8, 1, 14, 1, 16, 1, 16, 1, 14, 1, 89, 5, 27, 7, 25, 9, 
+  23, 4, 3, 4, 13, 5, 4, 3, 5, 3, 22, 3, 5, 3, 4, 5, 
+  13, 3, 5, 3, 22, 4, 3, 4, 23, 9, 25, 7, 27, 5, 55, 1, 
+  14, 1, 16, 1, 16, 1, 14, 1, 18, 1, 23, 1, 32, 1, 32, 1, 
+  31, 1, 32, 1, 83, 72, 1, 16, 3, 14, 5, 12, 7, 10, 9, 8, 
+  7, 10, 5, 12, 3, 14, 1, 80, 156, 1, 24, 3, 22, 5, 20, 7, 
+  18, 9, 16, 11, 14, 13, 12, 11, 14, 9, 16, 7, 18, 5, 20, 3, 
+  22, 1, 168, 255, 0, 17, 1, 32, 3, 30, 5, 28, 7, 26, 9, 24, 
+  11, 22, 13, 20, 15, 18, 17, 16, 15, 18, 13, 20, 11, 22, 9, 24, 
+  7, 26, 5, 28, 3, 30, 1, 255, 0, 33, 72, 2, 3, 2, 10, 2, 
+  3, 2, 10, 2, 3, 2, 10, 2, 3, 2, 10, 2, 3, 2, 10, 2, 
+  3, 2, 10, 2, 3, 2, 10, 2, 3, 2, 91, 156, 4, 4, 4, 13, 
+  4, 4, 4, 13, 4, 4, 4, 13, 4, 4, 4, 13, 4, 4, 4, 13, 
+  4, 4, 4, 13, 4, 4, 4, 13, 4, 4, 4, 13, 4, 4, 4, 13, 
+  4, 4, 4, 13, 4, 4, 4, 13, 4, 4, 4, 182, 255, 0, 17, 5, 
+  5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 
+  5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 
+  5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 
+  5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 18, 5, 5, 5, 255, 0, 
+  52, 72, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 8, 9, 
+  8, 90, 156, 12, 13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 
+  13, 12, 13, 12, 13, 12, 13, 12, 13, 12, 182, 255, 0, 17, 16, 17, 
+  16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 
+  16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 16, 17, 16, 255, 0, 51, 
+  70, 12, 5, 10, 1, 1, 5, 1, 8, 1, 1, 1, 5, 1, 8, 1, 
+  1, 1, 5, 1, 8, 1, 1, 1, 5, 10, 1, 1, 5, 1, 10, 1, 
+  5, 12, 11, 1, 14, 2, 1, 1, 12, 1, 4, 1, 40, 153, 18, 7, 
+  1, 16, 1, 7, 18, 7, 2, 14, 2, 7, 2, 14, 2, 7, 2, 14, 
+  2, 7, 2, 14, 2, 7, 2, 14, 2, 7, 2, 14, 2, 7, 18, 7, 
+  1, 16, 1, 7, 18, 16, 1, 23, 1, 1, 2, 19, 2, 4, 1, 17, 
+  1, 7, 1, 83, 255, 0, 13, 24, 9, 1, 22, 1, 9, 22, 1, 1, 
+  9, 2, 19, 1, 1, 1, 9, 2, 19, 1, 1, 1, 9, 2, 19, 1, 
+  1, 1, 9, 2, 19, 1, 1, 1, 9, 2, 19, 1, 1, 1, 9, 2, 
+  19, 1, 1, 1, 9, 2, 19, 1, 1, 1, 9, 2, 19, 1, 1, 1, 
+  9, 22, 1, 1, 9, 1, 22, 1, 9, 1, 22, 1, 9, 1, 22, 1, 
+  9, 24, 21, 1, 30, 2, 1, 1, 28, 1, 4, 2, 24, 2, 7, 1, 
+  22, 1, 10, 1, 143, 104, 12, 5, 1, 1, 1, 3, 1, 3, 2, 5, 
+  4, 1, 3, 1, 3, 5, 12, 122, 228, 18, 7, 1, 1, 3, 3, 3, 
+  3, 4, 7, 6, 1, 5, 1, 5, 7, 6, 1, 5, 1, 5, 7, 6, 
+  1, 5, 1, 5, 7, 18, 254, 255, 0, 145, 24, 9, 1, 22, 1, 9, 
+  1, 2, 3, 5, 3, 5, 3, 1, 1, 9, 1, 1, 5, 3, 5, 3, 
+  6, 9, 1, 1, 5, 3, 5, 3, 6, 9, 1, 1, 5, 3, 5, 3, 
+  6, 9, 1, 2, 3, 5, 3, 5, 3, 1, 1, 9, 24, 255, 0, 179, 
+  57, 5, 11, 1, 5, 1, 9, 1, 7, 1, 7, 1, 3, 3, 3, 1, 
+  6, 1, 2, 2, 1, 2, 2, 1, 6, 1, 2, 1, 3, 1, 2, 1, 
+  6, 1, 2, 2, 1, 2, 2, 1, 6, 1, 3, 3, 3, 1, 7, 1, 
+  7, 1, 9, 1, 5, 1, 11, 5, 57, 110, 5, 18, 2, 5, 2, 15, 
+  1, 9, 1, 13, 1, 11, 1, 11, 1, 13, 1, 10, 1, 5, 3, 5, 
+  1, 9, 1, 5, 5, 5, 1, 8, 1, 4, 3, 1, 3, 4, 1, 8, 
+  1, 4, 2, 3, 2, 4, 1, 8, 1, 4, 3, 1, 3, 4, 1, 8, 
+  1, 5, 5, 5, 1, 9, 1, 5, 3, 5, 1, 10, 1, 13, 1, 11, 
+  1, 11, 1, 13, 1, 9, 1, 15, 2, 5, 2, 18, 5, 110, 211, 7, 
+  24, 2, 7, 2, 21, 1, 11, 1, 19, 1, 13, 1, 17, 1, 15, 1, 
+  15, 1, 17, 1, 14, 1, 7, 3, 7, 1, 13, 1, 6, 7, 6, 1, 
+  12, 1, 6, 2, 3, 2, 6, 1, 12, 1, 5, 2, 5, 2, 5, 1, 
+  12, 1, 5, 2, 5, 2, 5, 1, 12, 1, 5, 2, 5, 2, 5, 1, 
+  12, 1, 6, 2, 3, 2, 6, 1, 12, 1, 6, 7, 6, 1, 13, 1, 
+  7, 3, 7, 1, 14, 1, 17, 1, 15, 1, 15, 1, 17, 1, 13, 1, 
+  19, 1, 11, 1, 21, 2, 7, 2, 24, 7, 211
+};
+
+const IconAtlasEntry ICON_ATLAS[ICON_COUNT][ICON_SIZE_COUNT] PROGMEM = {
+  {{0, 73, 17, 17}, {73, 109, 25, 25}, {182, 149, 33, 33}}, // POWER
+  {{331, 41, 17, 17}, {372, 57, 25, 25}, {429, 79, 33, 33}}, // VOLUME_UP
+  {{508, 23, 17, 17}, {531, 35, 25, 25}, {566, 51, 33, 33}}, // VOLUME_DOWN
+  {{617, 21, 17, 17}, {638, 33, 25, 25}, {671, 43, 33, 33}}, // CHANNEL_UP
+  {{714, 19, 17, 17}, {733, 27, 25, 25}, {760, 39, 33, 33}}, // CHANNEL_DOWN
+  {{799, 35, 17, 17}, {834, 55, 25, 25}, {889, 79, 33, 33}}, // INPUT
+  {{968, 7, 17, 17}, {975, 15, 25, 25}, {990, 21, 33, 33}}, // MENU
+  {{1011, 19, 17, 17}, {1030, 27, 25, 25}, {1057, 39, 33, 33}}, // BACK
+  {{1096, 29, 17, 17}, {1125, 41, 25, 25}, {1166, 55, 33, 33}}, // OK
+  {{1221, 41, 17, 17}, {1262, 65, 25, 25}, {1327, 91, 33, 33}}, // MUTE
+  {{1418, 49, 17, 17}, {1467, 73, 25, 25}, {1540, 81, 33, 33}}, // SETTINGS
+  {{1621, 19, 17, 17}, {1640, 27, 25, 25}, {1667, 39, 33, 33}}, // PLAY
+  {{1706, 33, 17, 17}, {1739, 49, 25, 25}, {1788, 69, 33, 33}}, // PAUSE
+  {{1857, 17, 17, 17}, {1874, 25, 25, 25}, {1899, 37, 33, 33}}, // STOP
+  {{1936, 45, 17, 17}, {1981, 55, 25, 25}, {2036, 97, 33, 33}}, // TV
+  {{2133, 19, 17, 17}, {2152, 31, 25, 25}, {2183, 57, 33, 33}}, // AUDIO
+  {{2240, 57, 17, 17}, {2297, 85, 25, 25}, {2382, 109, 33, 33}} // DISC
+};
+
+#endif // UI_ICON_ATLAS_H
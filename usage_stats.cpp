@@ -0,0 +1,189 @@
+/*
+ * VHC Universal Remote - Usage Statistics Implementation
+ */
+
+#include "usage_stats.h"
+#include "hal.h"
+
+// Global usage statistics instance
+UsageStats usageStats;
+
+#define USAGE_MAGIC 0x5553  // "US"
+#define USAGE_ONE   16      // One use in score units
+
+UsageStats::UsageStats() {
+  memset(&table, 0, sizeof(table));
+  dirty = false;
+  dirtySince = 0;
+  tripActive = false;
+  tripTaps = 0;
+  tripCount = 0;
+  tripTapTotal = 0;
+}
+
+void UsageStats::begin() {
+  hal.memory->get(USAGE_EEPROM_ADDR, table);
+  if (table.magic != USAGE_MAGIC) {
+    memset(&table, 0, sizeof(table));
+    table.magic = USAGE_MAGIC;
+  }
+  
+  #if DEBUG_SERIAL
+    int used = 0;
+    for (int i = 0; i < USAGE_ENTRIES; i++) {
+      if (table.entries[i].nameHash) used++;
+    }
+    Serial.print(F("Usage stats: "));
+    Serial.print(used);
+    Serial.println(F(" devices"));
+  #endif
+}
+
+void UsageStats::recordUse(const char* deviceName) {
+  uint16_t hash = deviceHash(deviceName);
+  UsageEntry* entry = findEntry(hash);
+  
+  if (!entry) {
+    // Take a free slot, or replace the weakest device
+    entry = &table.entries[0];
+    for (int i = 0; i < USAGE_ENTRIES; i++) {
+      UsageEntry* candidate = &table.entries[i];
+      if (candidate->nameHash == 0) {
+        entry = candidate;
+        break;
+      }
+      if (candidate->score < entry->score) {
+        entry = candidate;
+      }
+    }
+    entry->nameHash = hash;
+    entry->score = 0;
+  }
+  
+  table.sends++;
+  entry->score = (entry->score > 0xFFFF - USAGE_ONE) ? 0xFFFF : entry->score + USAGE_ONE;
+  entry->lastUse = table.sends;
+  
+  // Decay
+  if (table.sends % USAGE_HALF_LIFE == 0) {
+    for (int i = 0; i < USAGE_ENTRIES; i++) {
+      table.entries[i].score >>= 1;
+    }
+  }
+  
+  if (!dirty) {
+    dirty = true;
+    dirtySince = hal.clock->millis();
+  }
+  
+  if (tripActive) {
+    tripActive = false;
+    tripCount++;
+    tripTapTotal += tripTaps;
+  }
+}
+
+uint32_t UsageStats::getRank(const char* deviceName) {
+  UsageEntry* entry = findEntry(deviceHash(deviceName));
+  if (!entry || entry->score == 0) return 0;
+  
+  // Recency as sends ago, so a wrapped counter still orders correctly
+  uint16_t age = table.sends - entry->lastUse;
+  return ((uint32_t)entry->score << 16) | (uint16_t)(0xFFFF - age);
+}
+
+void UsageStats::sortDevices(Device* devices, int count) {
+  uint32_t ranks[MAX_DEVICES];
+  for (int i = 0; i < count && i < MAX_DEVICES; i++) {
+    ranks[i] = getRank(devices[i].name);
+  }
+  
+  // Insertion sort: a handful of devices, and it keeps ties in SD order
+  for (int i = 1; i < count && i < MAX_DEVICES; i++) {
+    if (ranks[i] <= ranks[i - 1]) continue;
+    
+    Device moving = devices[i];
+    uint32_t rank = ranks[i];
+    int j = i;
+    while (j > 0 && ranks[j - 1] < rank) {
+      devices[j] = devices[j - 1];
+      ranks[j] = ranks[j - 1];
+      j--;
+    }
+    devices[j] = moving;
+    ranks[j] = rank;
+  }
+}
+
+void UsageStats::startTrip() {
+  tripActive = true;
+  tripTaps = 0;
+}
+
+void UsageStats::noteTap() {
+  if (tripActive) {
+    tripTaps++;
+  }
+}
+
+void UsageStats::update() {
+  if (dirty && hal.clock->millis() - dirtySince >= USAGE_FLUSH_MS) {
+    flush();
+  }
+}
+
+void UsageStats::flush() {
+  if (!dirty) return;
+  
+  // put() only rewrites bytes that changed
+  hal.memory->put(USAGE_EEPROM_ADDR, table);
+  dirty = false;
+  
+  #if DEBUG_SERIAL
+    Serial.println(F("Usage stats saved"));
+  #endif
+}
+
+void UsageStats::printStats() {
+  Serial.print(F("Sends: "));
+  Serial.println(table.sends);
+  for (int i = 0; i < menu.getDeviceCount(); i++) {
+    const char* name = menu.getDeviceName(i);
+    UsageEntry* entry = findEntry(deviceHash(name));
+    Serial.print(F("  "));
+    Serial.print(name);
+    if (entry) {
+      Serial.print(F(": score "));
+      Serial.print(entry->score / (float)USAGE_ONE, 2);
+      Serial.print(F(", last used "));
+      Serial.print((uint16_t)(table.sends - entry->lastUse));
+      Serial.println(F(" sends ago"));
+    } else {
+      Serial.println(F(": unused"));
+    }
+  }
+  
+  Serial.print(F("Taps to first IR: "));
+  if (tripCount > 0) {
+    Serial.print(tripTapTotal / (float)tripCount, 2);
+    Serial.print(F(" avg over "));
+    Serial.println(tripCount);
+  } else {
+    Serial.println(F("no data"));
+  }
+}
+
+UsageStats::UsageEntry* UsageStats::findEntry(uint16_t nameHash) {
+  for (int i = 0; i < USAGE_ENTRIES; i++) {
+    if (table.entries[i].nameHash == nameHash) {
+      return &table.entries[i];
+    }
+  }
+  return nullptr;
+}
+
+uint16_t UsageStats::deviceHash(const char* deviceName) {
+  uint32_t hash = hashName(deviceName);
+  uint16_t folded = (hash >> 16) ^ (hash & 0xFFFF);
+  return folded ? folded : 1;  // 0 marks a free entry
+}
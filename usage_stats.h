@@ -0,0 +1,73 @@
+/*
+ * VHC Universal Remote - Usage Statistics
+ * Per-device use counters with decay, kept in EEPROM
+ */
+
+#ifndef USAGE_STATS_H
+#define USAGE_STATS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "menu.h"
+
+// Each successful send adds to the device's score; every USAGE_HALF_LIFE
+// sends all scores halve, so old habits fade. Devices are keyed by a
+// 16-bit hash of their name, so the table survives SD card reordering.
+// Changes are written back in batches (only bytes that changed).
+class UsageStats {
+private:
+  struct UsageEntry {
+    uint16_t nameHash;  // 0 = free
+    uint16_t score;     // Uses, 4 fractional bits
+    uint16_t lastUse;   // Send counter at the last use
+  };
+  
+  struct UsageTable {
+    uint16_t magic;
+    uint16_t sends;     // Total sends, drives decay and recency
+    UsageEntry entries[USAGE_ENTRIES];
+  };
+  
+  UsageTable table;
+  bool dirty;
+  unsigned long dirtySince;
+  
+  // Taps from entering the main menu to the first IR send
+  bool tripActive;
+  int tripTaps;
+  unsigned long tripCount;
+  unsigned long tripTapTotal;
+  
+public:
+  UsageStats();
+  void begin();
+  
+  // Record a successful send for a device
+  void recordUse(const char* deviceName);
+  
+  // Higher ranks sort first (score, then recency); 0 if never used
+  uint32_t getRank(const char* deviceName);
+  
+  // Reorder devices most used first (stable, unused keep their order)
+  void sortDevices(Device* devices, int count);
+  
+  // Taps-to-first-IR measurement
+  void startTrip();
+  void noteTap();
+  unsigned long getTrips() { return tripCount; }
+  unsigned long getTripTaps() { return tripTapTotal; }
+  
+  // Write pending changes once USAGE_FLUSH_MS has passed
+  void update();
+  void flush();
+  void printStats();
+  
+private:
+  UsageEntry* findEntry(uint16_t nameHash);
+  uint16_t deviceHash(const char* deviceName);
+};
+
+// Global usage statistics instance
+extern UsageStats usageStats;
+
+#endif // USAGE_STATS_H